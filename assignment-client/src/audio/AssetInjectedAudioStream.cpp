@@ -0,0 +1,107 @@
+//
+//  AssetInjectedAudioStream.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetInjectedAudioStream.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+
+AssetInjectedAudioStream::AssetInjectedAudioStream(const AudioAssetInjection& injection, SharedSoundPointer sound,
+        int numStaticJitterFrames) :
+    InjectedAudioStream(injection.injectorID, sound->isStereo(), numStaticJitterFrames),
+    _sound(sound),
+    _secondOffset(injection.secondOffset),
+    _loop(injection.loop)
+{
+    // the sender has no local copy of the sound, so let it hear this one
+    _shouldLoopbackForNode = true;
+
+    setOptions(injection);
+}
+
+void AssetInjectedAudioStream::setOptions(const AudioAssetInjection& injection) {
+    _position = injection.position;
+    _orientation = injection.orientation;
+    _attenuationRatio = glm::clamp(injection.volume, 0.0f, 1.0f);
+    _ignorePenumbra = injection.ignorePenumbra;
+    _loop = injection.loop;
+}
+
+void AssetInjectedAudioStream::start() {
+    _hasLoaded = true;
+
+    // whether a sound is stereo may only be known once it has been decoded
+    if (_sound->isStereo() != _isStereo) {
+        _isStereo = _sound->isStereo();
+        _ringBuffer.resizeForFrameSize(_isStereo ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
+                                                 : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+
+    if (_sound->isAmbisonic()) {
+        qDebug() << "Ambisonic sounds cannot be played by the audio mixer:" << getURL();
+        _hasEnded = true;
+        return;
+    }
+
+    int numChannels = _isStereo ? AudioConstants::STEREO : AudioConstants::MONO;
+    int numSamples = _sound->getByteArray().size() / AudioConstants::SAMPLE_SIZE;
+    int offset = (int)(_secondOffset * AudioConstants::SAMPLE_RATE) * numChannels;
+    _nextSample = glm::clamp(offset, 0, numSamples);
+}
+
+void AssetInjectedAudioStream::writeFrames() {
+    if (_isStopped || _hasEnded) {
+        return;
+    }
+
+    if (!_hasLoaded) {
+        if (_sound->isFailed()) {
+            qDebug() << "Could not load sound for mixer injector:" << getURL();
+            _hasEnded = true;
+            return;
+        }
+        if (!_sound->isReady()) {
+            return;
+        }
+        start();
+    }
+
+    const QByteArray& soundBytes = _sound->getByteArray();
+    auto samples = reinterpret_cast<const AudioConstants::AudioSample*>(soundBytes.constData());
+    int numSamples = soundBytes.size() / AudioConstants::SAMPLE_SIZE;
+    int numFrameSamples = _ringBuffer.getNumFrameSamples();
+
+    // keep exactly the desired jitter frames ahead; there is no network jitter to absorb
+    int desiredFrames = std::max(_desiredJitterBufferFrames, 1);
+    while (!_hasEnded && _ringBuffer.framesAvailable() < desiredFrames) {
+        int frameSamples = 0;
+        while (frameSamples < numFrameSamples) {
+            if (_nextSample >= numSamples) {
+                if (!_loop || numSamples == 0) {
+                    // pad the last frame with silence
+                    _ringBuffer.addSilentSamples(numFrameSamples - frameSamples);
+                    _hasEnded = true;
+                    break;
+                }
+                _nextSample = 0;
+            }
+
+            int samplesToWrite = std::min(numFrameSamples - frameSamples, numSamples - _nextSample);
+            _ringBuffer.writeSamples(samples + _nextSample, samplesToWrite);
+            _nextSample += samplesToWrite;
+            frameSamples += samplesToWrite;
+        }
+    }
+
+    if (_isStarved && _ringBuffer.framesAvailable() >= _desiredJitterBufferFrames) {
+        _isStarved = false;
+    }
+}
@@ -0,0 +1,50 @@
+//
+//  AssetInjectedAudioStream.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetInjectedAudioStream_h
+#define hifi_AssetInjectedAudioStream_h
+
+#include <AudioAssetInjection.h>
+#include <InjectedAudioStream.h>
+#include <Sound.h>
+
+// An injector played by the mixer itself, from a sound asset decoded once by the SoundCache.
+// Instead of arriving in packets, frames are written from the decoded sound just before each pop,
+// so it is mixed exactly like an InjectedAudioStream sent by a client.
+class AssetInjectedAudioStream : public InjectedAudioStream {
+public:
+    AssetInjectedAudioStream(const AudioAssetInjection& injection, SharedSoundPointer sound, int numStaticJitterFrames = -1);
+
+    QUrl getURL() const { return _sound->getURL(); }
+
+    // update the position, orientation, volume, and looping of the sound
+    void setOptions(const AudioAssetInjection& injection);
+    void stop() { _isStopped = true; }
+
+    // fill the jitter buffer from the sound, must be called before popFrames()
+    void writeFrames();
+
+    // true once the sound was stopped, failed to load, or played out without looping
+    bool isFinished() const { return _isStopped || (_hasEnded && _ringBuffer.framesAvailable() == 0); }
+
+private:
+    void start();
+
+    SharedSoundPointer _sound;
+    float _secondOffset;
+    bool _loop;
+
+    bool _hasLoaded { false };
+    bool _hasEnded { false };
+    bool _isStopped { false };
+    int _nextSample { 0 };
+};
+
+#endif // hifi_AssetInjectedAudioStream_h
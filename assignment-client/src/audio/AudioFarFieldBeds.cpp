@@ -0,0 +1,149 @@
+//
+//  AudioFarFieldBeds.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioFarFieldBeds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <AudioSampleOps.h>
+#include <InboundAudioStream.h>
+
+#include "AudioMixerClientData.h"
+#include "AudioMixerSlave.h"
+
+const float AudioFarFieldBeds::HEADROOM = 0.25f;  // -12dB
+
+const AudioFarFieldBeds::Bed* AudioFarFieldBeds::find(const glm::ivec3& cell) const {
+    auto it = _beds.find(cell);
+    return (it != _beds.end()) ? &it->second : nullptr;
+}
+
+void AudioFarFieldBeds::prepare(ConstIter begin, ConstIter end) {
+    _numEncodes = 0;
+    if (!isEnabled()) {
+        _beds.clear();
+        return;
+    }
+
+    // mark last frame's beds as stale, then claim a bed for the cell of every listener
+    for (auto& bed : _beds) {
+        bed.second.numSources = -1;
+    }
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        auto data = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        auto listenerStream = data ? data->getAvatarAudioStream() : nullptr;
+        if (node->getType() == NodeType::Agent && listenerStream) {
+            glm::ivec3 cell = getCell(listenerStream->getPosition());
+            Bed& bed = _beds[cell];
+            bed.center = getCellCenter(cell);
+            bed.numSources = 0;
+        }
+    });
+    for (auto it = _beds.begin(); it != _beds.end();) {
+        it = (it->second.numSources < 0) ? _beds.erase(it) : std::next(it);
+    }
+
+    if (_beds.empty()) {
+        return;
+    }
+
+    // convert each audible source to mono float once; it may be encoded into any number of beds
+    _sources.clear();
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        auto data = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!data) {
+            return;
+        }
+
+        for (auto& mixableStream : data->getMixableStreams()) {
+            const PositionalAudioStream& stream = *mixableStream.stream;
+
+            // as in AudioMixerSlave::addStream, repeat starved microphones with a fade, and drop the rest
+            float fade = 1.0f;
+            if (!stream.lastPopSucceeded()) {
+                if (stream.getLastPopOutput().isNull() || stream.getType() == PositionalAudioStream::Injector) {
+                    continue;
+                }
+                fade = calculateRepeatedFrameFadeFactor(stream.getConsecutiveNotMixedCount() - 1);
+                if (fade <= 0.0f) {
+                    continue;
+                }
+            } else if (stream.getLastPopOutputLoudness() == 0.0f) {
+                continue;
+            }
+
+            _sources.emplace_back();
+            Source& source = _sources.back();
+            source.stream = &stream;
+            source.position = stream.getPosition();
+
+            AudioRingBuffer::ConstIterator output = stream.getLastPopOutput();
+            const float scale = fade / AudioConstants::MAX_SAMPLE_VALUE;
+            if (stream.isStereo()) {
+                int16_t stereo[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+                output.readSamples(stereo, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+                for (int i = 0; i < NUM_FRAMES; ++i) {
+                    source.samples[i] = (stereo[2 * i] + stereo[2 * i + 1]) * (0.5f * scale);
+                }
+            } else {
+                int16_t mono[NUM_FRAMES];
+                output.readSamples(mono, NUM_FRAMES);
+                convertInt16ToFloat(mono, source.samples, NUM_FRAMES, scale);
+            }
+        }
+    });
+
+    for (auto& bed : _beds) {
+        encode(bed.second);
+    }
+}
+
+void AudioFarFieldBeds::encode(Bed& bed) {
+    memset(_accumulator, 0, sizeof(_accumulator));
+
+    for (auto& source : _sources) {
+        glm::vec3 relativePosition = source.position - bed.center;
+        if (!isFarField(bed.center, source.position)) {
+            continue;
+        }
+
+        float gain = computeGain(bed.center, *source.stream, relativePosition, false) * HEADROOM;
+        glm::vec3 direction = glm::normalize(relativePosition);
+
+        // first-order SN3D panning gains, converted from Y-up (OpenGL) to Z-up (Ambisonic)
+        float w = gain;
+        float x = gain * -direction.z;
+        float y = gain * -direction.x;
+        float z = gain * direction.y;
+
+        for (int i = 0; i < NUM_FRAMES; ++i) {
+            float sample = source.samples[i];
+            _accumulator[0][i] += w * sample;
+            _accumulator[1][i] += y * sample;
+            _accumulator[2][i] += z * sample;
+            _accumulator[3][i] += x * sample;
+        }
+
+        ++bed.numSources;
+        ++_numEncodes;
+    }
+
+    // interleave in ambiX channel order, as AudioFOA expects, then convert with clipping
+    float interleaved[NUM_FRAMES * AudioConstants::AMBISONIC];
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        for (int channel = 0; channel < AudioConstants::AMBISONIC; ++channel) {
+            interleaved[AudioConstants::AMBISONIC * i + channel] = _accumulator[channel][i];
+        }
+    }
+    convertFloatToInt16(interleaved, bed.samples, NUM_FRAMES * AudioConstants::AMBISONIC,
+                        AudioConstants::MAX_SAMPLE_VALUE);
+}
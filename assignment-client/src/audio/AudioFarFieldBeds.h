@@ -0,0 +1,106 @@
+//
+//  AudioFarFieldBeds.h
+//  assignment-client/src/audio
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioFarFieldBeds_h
+#define hifi_AudioFarFieldBeds_h
+
+#include <math.h>
+#include <stdint.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AudioConstants.h>
+#include <AudioFOA.h>
+#include <NodeList.h>
+
+class PositionalAudioStream;
+
+//
+// Shared first-order ambisonic beds for distant sources.
+//
+// Listeners are grouped into cubic cells. Once per frame, every source farther than the far-field
+// distance from the center of an occupied cell is encoded into that cell's bed, as heard from the
+// center. Listeners in the cell then decode the bed once (see AudioMixerSlave) instead of rendering
+// an HRTF for each of those sources, so the cost of distant sources is per cell, not per listener.
+//
+class AudioFarFieldBeds {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    static const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+    static_assert(NUM_FRAMES == FOA_BLOCK, "beds are decoded one network frame at a time");
+
+    // beds are encoded this much quieter to leave headroom for many sources, and decoded with the inverse
+    static const float HEADROOM;
+
+    struct Bed {
+        glm::vec3 center;
+        int numSources { 0 };
+        int16_t samples[NUM_FRAMES * AudioConstants::AMBISONIC];  // interleaved ambiX (W, Y, Z, X)
+    };
+
+    // a distance of 0 disables the beds
+    void setFarFieldDistance(float distance) { _farFieldDistance = distance; }
+    void setCellSize(float cellSize) { _cellSize = cellSize; }
+    float getFarFieldDistance() const { return _farFieldDistance; }
+    float getCellSize() const { return _cellSize; }
+    bool isEnabled() const { return _farFieldDistance > 0.0f && _cellSize > 0.0f; }
+
+    // a listener may be anywhere in its cell, up to half the cell's diagonal from the center, so the far-field
+    // distance must be at least this for every far-field source to stay a whole cell away from the listener
+    static float getMinFarFieldDistance(float cellSize) { return cellSize * (1.0f + sqrtf(3.0f) / 2.0f); }
+
+    glm::ivec3 getCell(const glm::vec3& position) const { return glm::ivec3(glm::floor(position / _cellSize)); }
+    glm::vec3 getCellCenter(const glm::ivec3& cell) const { return (glm::vec3(cell) + 0.5f) * _cellSize; }
+    bool isFarField(const glm::vec3& cellCenter, const glm::vec3& sourcePosition) const {
+        glm::vec3 offset = sourcePosition - cellCenter;
+        return glm::dot(offset, offset) > _farFieldDistance * _farFieldDistance;
+    }
+
+    // encode the beds for every cell holding a listener
+    // must be called after the streams have been popped for the frame, and before mixing
+    void prepare(ConstIter begin, ConstIter end);
+
+    // returns the bed for the cell, or nullptr if it was not prepared this frame
+    const Bed* find(const glm::ivec3& cell) const;
+
+    // stats for the last prepare()
+    int getNumBeds() const { return (int)_beds.size(); }
+    int getNumEncodes() const { return _numEncodes; }
+
+private:
+    struct CellHash {
+        size_t operator()(const glm::ivec3& cell) const {
+            return (size_t)cell.x * 73856093 ^ (size_t)cell.y * 19349663 ^ (size_t)cell.z * 83492791;
+        }
+    };
+
+    // a distant source candidate, converted once per frame and shared by all beds
+    struct Source {
+        const PositionalAudioStream* stream;
+        glm::vec3 position;
+        float samples[NUM_FRAMES];
+    };
+
+    void encode(Bed& bed);
+
+    float _farFieldDistance { 0.0f };
+    float _cellSize { 0.0f };
+
+    std::unordered_map<glm::ivec3, Bed, CellHash> _beds;
+    std::vector<Source> _sources;
+    float _accumulator[AudioConstants::AMBISONIC][NUM_FRAMES];
+    int _numEncodes { 0 };
+};
+
+#endif // hifi_AudioFarFieldBeds_h
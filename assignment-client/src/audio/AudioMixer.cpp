@@ -24,7 +24,9 @@
 #include <plugins/PluginManager.h>
 #include <plugins/CodecPlugin.h>
 #include <udt/PacketHeaders.h>
+#include <ResourceManager.h>
 #include <SharedUtil.h>
+#include <SoundCache.h>
 #include <StDev.h>
 #include <UUID.h>
 
@@ -52,6 +54,11 @@ QVector<AudioMixer::ReverbSettings> AudioMixer::_zoneReverbSettings;
 
 AudioMixer::AudioMixer(ReceivedMessage& message) :
     ThreadedAssignment(message) {
+    // sounds injected on the mixer are fetched and decoded here
+    ResourceManager::init();
+    DependencyManager::set<ResourceCacheSharedItems>();
+    DependencyManager::set<SoundCache>();
+
     auto nodeList = DependencyManager::get<NodeList>();
     auto& packetReceiver = nodeList->getPacketReceiver();
 
@@ -67,6 +74,7 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
     packetReceiver.registerListener(PacketType::RadiusIgnoreRequest, this, "handleRadiusIgnoreRequestPacket");
     packetReceiver.registerListener(PacketType::RequestsDomainListData, this, "handleRequestsDomainListDataPacket");
     packetReceiver.registerListener(PacketType::PerAvatarGainSet, this, "handlePerAvatarGainSetDataPacket");
+    packetReceiver.registerListener(PacketType::InjectAudioAsset, this, "handleInjectAudioAssetPacket");
 
     connect(nodeList.data(), &NodeList::nodeKilled, this, &AudioMixer::handleNodeKilled);
 }
@@ -76,6 +84,20 @@ void AudioMixer::handleNodeAudioPacket(QSharedPointer<ReceivedMessage> message,
     DependencyManager::get<NodeList>()->updateNodeWithDataFromPacket(message, sendingNode);
 }
 
+void AudioMixer::handleInjectAudioAssetPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    auto injection = AudioAssetInjection::fromMessage(*message);
+    if (!injection.isPermittedFor(sendingNode->getPermissions())) {
+        qDebug() << "Ignoring mixer injection of" << injection.url << "from" << sendingNode->getUUID()
+            << "- only permitted for atp: hashes and nodes that can rez temporary entities";
+        return;
+    }
+    getOrCreateClientData(sendingNode.data())->injectAudioAsset(injection);
+}
+
+void AudioMixer::aboutToFinish() {
+    ResourceManager::cleanup();
+}
+
 void AudioMixer::handleMuteEnvironmentPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     auto nodeList = DependencyManager::get<NodeList>();
 
@@ -178,14 +200,15 @@ void AudioMixer::handleNegotiateAudioFormat(QSharedPointer<ReceivedMessage> mess
 }
 
 void AudioMixer::handleNodeKilled(SharedNodePointer killedNode) {
-    // enumerate the connected listeners to remove HRTF objects for the disconnected node
+    // the killed node's stream slots are released with its client data, so listeners reset their HRTF objects
+    // when the slots are reused; only the gains they set for it need to be forgotten here
     auto nodeList = DependencyManager::get<NodeList>();
 
     nodeList->eachNode([&killedNode](const SharedNodePointer& node) {
         auto clientData = dynamic_cast<AudioMixerClientData*>(node->getLinkedData());
         if (clientData) {
             QUuid killedUUID = killedNode->getUUID();
-            clientData->removeHRTFsForNode(killedUUID);
+            clientData->removeGainAdjustmentForNode(killedUUID);
         }
     });
 }
@@ -210,14 +233,8 @@ void AudioMixer::handleNodeMuteRequestPacket(QSharedPointer<ReceivedMessage> pac
 void AudioMixer::handleKillAvatarPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode) {
     auto clientData = dynamic_cast<AudioMixerClientData*>(sendingNode->getLinkedData());
     if (clientData) {
+        // releases the stream's slot, which resets the listeners' HRTF objects for it
         clientData->removeAgentAvatarAudioStream();
-        auto nodeList = DependencyManager::get<NodeList>();
-        nodeList->eachNode([sendingNode](const SharedNodePointer& node){
-            auto listenerClientData = dynamic_cast<AudioMixerClientData*>(node->getLinkedData());
-            if (listenerClientData) {
-                listenerClientData->removeHRTFForStream(sendingNode->getUUID());
-            }
-        });
     }
 }
 
@@ -248,7 +265,15 @@ void AudioMixer::handlePerAvatarGainSetDataPacket(QSharedPointer<ReceivedMessage
         uint8_t packedGain;
         packet->readPrimitive(&packedGain);
         float gain = unpackFloatGainFromByte(packedGain);
-        clientData->hrtfForStream(audioSourceUUID, QUuid()).setGainAdjustment(gain);
+
+        AudioSourceSlot micSlot;
+        auto audioSourceNode = DependencyManager::get<NodeList>()->nodeWithUUID(audioSourceUUID);
+        auto audioSourceClientData = audioSourceNode ?
+            dynamic_cast<AudioMixerClientData*>(audioSourceNode->getLinkedData()) : nullptr;
+        if (audioSourceClientData) {
+            micSlot = audioSourceClientData->getStreamSlot();
+        }
+        clientData->setGainAdjustmentForNode(audioSourceUUID, gain, micSlot);
         qDebug() << "Setting gain adjustment for hrtf[" << listeningNodeUUID << "][" << audioSourceUUID << "] to " << gain;
     }
 }
@@ -257,21 +282,6 @@ void AudioMixer::handleRadiusIgnoreRequestPacket(QSharedPointer<ReceivedMessage>
     sendingNode->parseIgnoreRadiusRequestMessage(packet);
 }
 
-void AudioMixer::removeHRTFsForFinishedInjector(const QUuid& streamID) {
-    auto injectorClientData = qobject_cast<AudioMixerClientData*>(sender());
-    if (injectorClientData) {
-        // enumerate the connected listeners to remove HRTF objects for the disconnected injector
-        auto nodeList = DependencyManager::get<NodeList>();
-
-        nodeList->eachNode([injectorClientData, &streamID](const SharedNodePointer& node){
-            auto listenerClientData = dynamic_cast<AudioMixerClientData*>(node->getLinkedData());
-            if (listenerClientData) {
-                listenerClientData->removeHRTFForStream(injectorClientData->getNodeID(), streamID);
-            }
-        });
-    }
-}
-
 QString AudioMixer::percentageForMixStats(int counter) {
     if (_stats.totalMixes > 0) {
         float mixPercentage = (float(counter) / _stats.totalMixes) * 100.0f;
@@ -294,7 +304,8 @@ void AudioMixer::sendStatsPacket() {
     statsObject["threads"] = _slavePool.numThreads();
 
     statsObject["trailing_mix_ratio"] = _trailingMixRatio;
-    statsObject["throttling_ratio"] = _throttlingRatio;
+    statsObject["renders_per_listener"] = _rendersPerListener;
+    statsObject["us_per_render"] = _renderCost;
 
     statsObject["avg_streams_per_frame"] = (float)_stats.sumStreams / (float)_numStatFrames;
     statsObject["avg_listeners_per_frame"] = (float)_stats.sumListeners / (float)_numStatFrames;
@@ -329,12 +340,20 @@ void AudioMixer::sendStatsPacket() {
     mixStats["%_hrtf_mixes"] = percentageForMixStats(_stats.hrtfRenders);
     mixStats["%_hrtf_silent_mixes"] = percentageForMixStats(_stats.hrtfSilentRenders);
     mixStats["%_hrtf_throttle_mixes"] = percentageForMixStats(_stats.hrtfThrottleRenders);
+    mixStats["%_downmix_mixes"] = percentageForMixStats(_stats.downmixMixes);
     mixStats["%_manual_stereo_mixes"] = percentageForMixStats(_stats.manualStereoMixes);
     mixStats["%_manual_echo_mixes"] = percentageForMixStats(_stats.manualEchoMixes);
 
     mixStats["total_mixes"] = _stats.totalMixes;
     mixStats["avg_mixes_per_block"] = _stats.totalMixes / _numStatFrames;
 
+    if (_farFieldBeds.isEnabled()) {
+        mixStats["avg_far_field_beds_per_block"] = (float)_stats.farFieldBeds / _numStatFrames;
+        mixStats["avg_far_field_encodes_per_block"] = (float)_stats.farFieldEncodes / _numStatFrames;
+        mixStats["avg_far_field_decodes_per_block"] = (float)_stats.farFieldDecodes / _numStatFrames;
+        mixStats["avg_far_field_streams_per_block"] = (float)_stats.farFieldStreams / _numStatFrames;
+    }
+
     statsObject["mix_stats"] = mixStats;
 
     _numStatFrames = 0;
@@ -384,7 +403,6 @@ AudioMixerClientData* AudioMixer::getOrCreateClientData(Node* node) {
     if (!clientData) {
         node->setLinkedData(std::unique_ptr<NodeData> { new AudioMixerClientData(node->getUUID()) });
         clientData = dynamic_cast<AudioMixerClientData*>(node->getLinkedData());
-        connect(clientData, &AudioMixerClientData::injectorStreamFinished, this, &AudioMixer::removeHRTFsForFinishedInjector);
     }
 
     return clientData;
@@ -394,7 +412,7 @@ void AudioMixer::start() {
     auto nodeList = DependencyManager::get<NodeList>();
 
     // prepare the NodeList
-    nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::Agent, NodeType::EntityScriptServer });
+    nodeList->addSetOfNodeTypesToNodeInterestSet({ NodeType::Agent, NodeType::EntityScriptServer, NodeType::AssetServer });
     nodeList->linkedDataCreateCallback = [&](Node* node) { getOrCreateClientData(node); };
 
     // parse out any AudioMixer settings
@@ -426,20 +444,30 @@ void AudioMixer::start() {
                 std::for_each(cbegin, cend, [&](const SharedNodePointer& node) {
                     _stats.sumStreams += prepareFrame(node, frame);
                 });
+
+                // encode distant sources once per cell, before the slaves need them
+                _farFieldBeds.prepare(cbegin, cend);
+                _stats.farFieldBeds += _farFieldBeds.getNumBeds();
+                _stats.farFieldEncodes += _farFieldBeds.getNumEncodes();
             }
 
             // mix across slave threads
             {
                 auto mixTimer = _mixTiming.timer();
-                _slavePool.mix(cbegin, cend, frame, _throttlingRatio);
+                auto mixStart = p_high_resolution_clock::now();
+                _slavePool.mix(cbegin, cend, frame, _rendersPerListener, &_farFieldBeds);
+                _lastMixDuration = std::chrono::duration_cast<std::chrono::microseconds>(
+                    p_high_resolution_clock::now() - mixStart).count();
             }
         });
 
-        // gather stats
+        // gather stats, keeping this frame's for the render budget
+        _lastFrameStats.reset();
         _slavePool.each([&](AudioMixerSlave& slave) {
-            _stats.accumulate(slave.stats);
+            _lastFrameStats.accumulate(slave.stats);
             slave.stats.reset();
         });
+        _stats.accumulate(_lastFrameStats);
 
         ++frame;
         ++_numStatFrames;
@@ -480,49 +508,56 @@ std::chrono::microseconds AudioMixer::timeFrame(p_high_resolution_clock::time_po
 }
 
 void AudioMixer::throttle(std::chrono::microseconds duration, int frame) {
-    // throttle using a modified proportional-integral controller
+    // budget full HRTF renders per listener, from the measured cost of a render and the time left in a frame
     const float FRAME_TIME = 10000.0f;
     float mixRatio = duration.count() / FRAME_TIME;
 
-    // constants are determined based on a "regular" 16-CPU EC2 server
-
-    // target different mix and backoff ratios (they also have different backoff rates)
-    // this is to prevent oscillation, and encourage throttling to find a steady state
+    // target different mix and backoff ratios, to prevent oscillation between budgeting and not
     const float TARGET = 0.9f;
-    // on a "regular" machine with 100 avatars, this is the largest value where
-    // - overthrottling can be recovered
-    // - oscillations will not occur after the recovery
     const float BACKOFF_TARGET = 0.44f;
 
-    // the mixer is known to struggle at about 80 on a "regular" machine
-    // so throttle 2/80 the streams to ensure smooth audio (throttling is linear)
-    const float THROTTLE_RATE = 2 / 80.0f;
-    const float BACKOFF_RATE = THROTTLE_RATE / 4;
-
-    // recovery should be bounded so that large changes in user count is a tolerable experience
-    // throttling is linear, so most cases will not need a full recovery
-    const int RECOVERY_TIME = 180;
-
-    // weight more recent frames to determine if throttling is necessary,
-    const int TRAILING_FRAMES = (int)(100 * RECOVERY_TIME * BACKOFF_RATE);
+    // weight more recent frames to determine if budgeting is necessary
+    const int TRAILING_FRAMES = 100;
     const float CURRENT_FRAME_RATIO = 1.0f / TRAILING_FRAMES;
     const float PREVIOUS_FRAMES_RATIO = 1.0f - CURRENT_FRAME_RATIO;
     _trailingMixRatio = PREVIOUS_FRAMES_RATIO * _trailingMixRatio + CURRENT_FRAME_RATIO * mixRatio;
 
-    if (frame % TRAILING_FRAMES == 0) {
-        if (_trailingMixRatio > TARGET) {
-            int proportionalTerm = 1 + (_trailingMixRatio - TARGET) / 0.1f;
-            _throttlingRatio += THROTTLE_RATE * proportionalTerm;
-            _throttlingRatio = std::min(_throttlingRatio, 1.0f);
-            qDebug("audio-mixer is struggling (%f mix/sleep) - throttling %f of streams",
-                    (double)_trailingMixRatio, (double)_throttlingRatio);
-        } else if (_throttlingRatio > 0.0f && _trailingMixRatio <= BACKOFF_TARGET) {
-            int proportionalTerm = 1 + (TARGET - _trailingMixRatio) / 0.2f;
-            _throttlingRatio -= BACKOFF_RATE * proportionalTerm;
-            _throttlingRatio = std::max(_throttlingRatio, 0.0f);
-            qDebug("audio-mixer is recovering (%f mix/sleep) - throttling %f of streams",
-                    (double)_trailingMixRatio, (double)_throttlingRatio);
-        }
+    // the cost of a render includes the per-listener overhead spread over its renders; this overestimates it when
+    // listeners render little, but then the budget is the one that fills the frame once it is applied
+    const int MIN_RENDERS_TO_MEASURE = 16;
+    int numRenders = _lastFrameStats.hrtfRenders;
+    if (numRenders >= MIN_RENDERS_TO_MEASURE) {
+        float renderCost = (float)_lastMixDuration * _slavePool.numThreads() / numRenders;
+        _renderCost = (_renderCost > 0.0f) ? PREVIOUS_FRAMES_RATIO * _renderCost + CURRENT_FRAME_RATIO * renderCost : renderCost;
+    }
+    float overhead = std::max(0.0f, (float)duration.count() - _lastMixDuration);
+    _trailingOverhead = PREVIOUS_FRAMES_RATIO * _trailingOverhead + CURRENT_FRAME_RATIO * overhead;
+
+    bool isBudgeting = _rendersPerListener != AudioMixerSlave::UNLIMITED_RENDERS;
+    bool wasOverBudget = _lastFrameStats.downmixMixes > 0 || _lastFrameStats.hrtfThrottleRenders > 0;
+    if (!isBudgeting && _trailingMixRatio > TARGET && _renderCost > 0.0f) {
+        isBudgeting = true;
+        qDebug("audio-mixer is struggling (%f mix/sleep) - budgeting renders per listener", (double)_trailingMixRatio);
+    } else if (isBudgeting && _trailingMixRatio <= BACKOFF_TARGET && !wasOverBudget) {
+        isBudgeting = false;
+        qDebug("audio-mixer has recovered (%f mix/sleep) - no longer budgeting renders", (double)_trailingMixRatio);
+    }
+
+    if (!isBudgeting) {
+        _rendersPerListener = AudioMixerSlave::UNLIMITED_RENDERS;
+        return;
+    }
+
+    // share the time left after the rest of the frame between all listeners
+    const int MIN_RENDERS_PER_LISTENER = 4;
+    float availableTime = std::max(0.0f, TARGET * FRAME_TIME - _trailingOverhead) * _slavePool.numThreads();
+    int numListeners = std::max(1, _lastFrameStats.sumListeners);
+    _rendersPerListener = std::max(MIN_RENDERS_PER_LISTENER, (int)(availableTime / (_renderCost * numListeners)));
+
+    const int LOG_INTERVAL_FRAMES = 1000;
+    if (frame % LOG_INTERVAL_FRAMES == 0) {
+        qDebug("audio-mixer is budgeting %d renders per listener (%f mix/sleep, %f us/render)",
+                _rendersPerListener, (double)_trailingMixRatio, (double)_renderCost);
     }
 }
 
@@ -643,6 +678,35 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
 
+        const QString FAR_FIELD_DISTANCE = "far_field_distance";
+        const QString FAR_FIELD_CELL_SIZE = "far_field_cell_size";
+        {
+            bool distanceOk = false, cellSizeOk = false;
+            float distance = audioEnvGroupObject[FAR_FIELD_DISTANCE].toString().toFloat(&distanceOk);
+            float cellSize = audioEnvGroupObject[FAR_FIELD_CELL_SIZE].toString().toFloat(&cellSizeOk);
+            if (!distanceOk || distance < 0.0f) {
+                distance = 0.0f;
+            }
+            if (!cellSizeOk || cellSize <= 0.0f) {
+                const float DEFAULT_FAR_FIELD_CELL_SIZE = 10.0f;
+                cellSize = DEFAULT_FAR_FIELD_CELL_SIZE;
+            }
+
+            // keep every far-field source at least a cell away from any listener in the cell it is encoded for
+            float minDistance = AudioFarFieldBeds::getMinFarFieldDistance(cellSize);
+            if (distance > 0.0f && distance < minDistance) {
+                qWarning() << "Far-field distance" << distance << "is less than the cell size plus half its diagonal,"
+                    << "raising it to" << minDistance;
+                distance = minDistance;
+            }
+
+            _farFieldBeds.setFarFieldDistance(distance);
+            _farFieldBeds.setCellSize(cellSize);
+            if (_farFieldBeds.isEnabled()) {
+                qDebug() << "Far-field beds enabled beyond" << distance << "m, with cells of" << cellSize << "m";
+            }
+        }
+
         const QString AUDIO_ZONES = "zones";
         if (audioEnvGroupObject[AUDIO_ZONES].isObject()) {
             const QJsonObject& zones = audioEnvGroupObject[AUDIO_ZONES].toObject();
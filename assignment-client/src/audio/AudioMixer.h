@@ -18,6 +18,7 @@
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
 
+#include "AudioFarFieldBeds.h"
 #include "AudioMixerStats.h"
 #include "AudioMixerSlavePool.h"
 
@@ -50,6 +51,8 @@ public:
     static const QVector<ZoneSettings>& getZoneSettings() { return _zoneSettings; }
     static const QVector<ReverbSettings>& getReverbSettings() { return _zoneReverbSettings; }
 
+    virtual void aboutToFinish() override;
+
 public slots:
     void run() override;
     void sendStatsPacket() override;
@@ -66,9 +69,9 @@ private slots:
     void handleKillAvatarPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
     void handleNodeMuteRequestPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
     void handlePerAvatarGainSetDataPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
+    void handleInjectAudioAssetPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
 
     void start();
-    void removeHRTFsForFinishedInjector(const QUuid& streamID);
 
 private:
     // mixing helpers
@@ -85,7 +88,13 @@ private:
     void parseSettingsObject(const QJsonObject& settingsObject);
 
     float _trailingMixRatio { 0.0f };
-    float _throttlingRatio { 0.0f };
+
+    // full HRTF renders allowed per listener, see throttle
+    int _rendersPerListener { AudioMixerSlave::UNLIMITED_RENDERS };
+    float _renderCost { 0.0f }; // trailing usecs per full render, on one slave thread
+    float _trailingOverhead { 0.0f }; // trailing usecs per frame not spent mixing
+    uint64_t _lastMixDuration { 0 };
+    AudioMixerStats _lastFrameStats;
 
     int _numStatFrames { 0 };
     AudioMixerStats _stats;
@@ -93,6 +102,7 @@ private:
     QString _codecPreferenceOrder;
 
     AudioMixerSlavePool _slavePool;
+    AudioFarFieldBeds _farFieldBeds;
 
     class Timer {
     public:
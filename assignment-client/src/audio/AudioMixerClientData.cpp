@@ -9,20 +9,25 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <random>
 
 #include <QtCore/QDebug>
 #include <QtCore/QJsonArray>
 
 #include <udt/PacketHeaders.h>
+#include <SoundCache.h>
 #include <UUID.h>
 
 #include "InjectedAudioStream.h"
 
+#include "AssetInjectedAudioStream.h"
 #include "AudioMixer.h"
 #include "AudioMixerClientData.h"
 
 
+AudioSourceSlotAllocator AudioMixerClientData::_slotAllocator;
+
 AudioMixerClientData::AudioMixerClientData(const QUuid& nodeID) :
     NodeData(nodeID),
     audioLimiter(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO),
@@ -44,6 +49,10 @@ AudioMixerClientData::~AudioMixerClientData() {
         _codec->releaseDecoder(_decoder);
         _codec->releaseEncoder(_encoder);
     }
+
+    for (auto& slotPair : _streamSlots) {
+        _slotAllocator.release(slotPair.second);
+    }
 }
 
 
@@ -59,18 +68,45 @@ AvatarAudioStream* AudioMixerClientData::getAvatarAudioStream() {
     return NULL;
 }
 
-void AudioMixerClientData::removeHRTFForStream(const QUuid& nodeID, const QUuid& streamID) {
-    auto it = _nodeSourcesHRTFMap.find(nodeID);
-    if (it != _nodeSourcesHRTFMap.end()) {
-        // erase the stream with the given ID from the given node
-        it->second.erase(streamID);
+AudioSourceSlot AudioMixerClientData::getStreamSlot(const QUuid& streamID) {
+    QReadLocker readLocker { &_streamsLock };
+
+    auto it = _streamSlots.find(streamID);
+    return (it != _streamSlots.end()) ? it->second : AudioSourceSlot();
+}
+
+AudioHRTF& AudioMixerClientData::hrtfForStream(const QUuid& nodeID, const QUuid& streamID, AudioSourceSlot slot) {
+    bool isNew;
+    AudioHRTF& hrtf = _hrtfSlots.get(slot, isNew);
 
-        // is the map for this node now empty?
-        // if so we can remove it
-        if (it->second.size() == 0) {
-            _nodeSourcesHRTFMap.erase(it);
+    // a new listener-source pair, restore the gain this listener has set for the source's microphone
+    if (isNew && streamID.isNull()) {
+        auto it = _nodeGainAdjustments.find(nodeID);
+        if (it != _nodeGainAdjustments.end()) {
+            hrtf.setGainAdjustment(it->second);
         }
     }
+    return hrtf;
+}
+
+void AudioMixerClientData::setGainAdjustmentForNode(const QUuid& nodeID, float gain, AudioSourceSlot micSlot) {
+    _nodeGainAdjustments[nodeID] = gain;
+
+    // apply it now if the source is already being mixed, otherwise hrtfForStream picks it up
+    AudioHRTF* hrtf = _hrtfSlots.find(micSlot);
+    if (hrtf) {
+        hrtf->setGainAdjustment(gain);
+    }
+}
+
+// NOTE: must be called with _streamsLock held for writing
+void AudioMixerClientData::releaseStreamSlot(const QUuid& streamID) {
+    auto it = _streamSlots.find(streamID);
+    if (it != _streamSlots.end()) {
+        // listeners see the generation change and reset their state for this slot when it is reused
+        _slotAllocator.release(it->second);
+        _streamSlots.erase(it);
+    }
 }
 
 void AudioMixerClientData::removeAgentAvatarAudioStream() {
@@ -78,6 +114,7 @@ void AudioMixerClientData::removeAgentAvatarAudioStream() {
     auto it = _audioStreams.find(QUuid());
     if (it != _audioStreams.end()) {
         _audioStreams.erase(it);
+        releaseStreamSlot(QUuid());
     }
     writeLocker.unlock();
 }
@@ -127,6 +164,7 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
                     QUuid(),
                     std::unique_ptr<PositionalAudioStream> { avatarAudioStream }
                 );
+                _streamSlots[QUuid()] = _slotAllocator.allocate();
 
                 micStreamIt = emplaced.first;
             }
@@ -162,6 +200,7 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
                     streamIdentifier,
                     std::unique_ptr<InjectedAudioStream> { injectorStream }
                 );
+                _streamSlots[streamIdentifier] = _slotAllocator.allocate();
 
                 streamIt = emplaced.first;
             }
@@ -188,13 +227,79 @@ int AudioMixerClientData::parseData(ReceivedMessage& message) {
     return 0;
 }
 
+void AudioMixerClientData::injectAudioAsset(const AudioAssetInjection& injection) {
+    if (injection.injectorID.isNull()) {
+        return; // reserved for the microphone stream
+    }
+
+    QWriteLocker writeLock { &_streamsLock };
+
+    auto streamIt = _audioStreams.find(injection.injectorID);
+    AssetInjectedAudioStream* assetStream = nullptr;
+    if (streamIt != _audioStreams.end()) {
+        assetStream = dynamic_cast<AssetInjectedAudioStream*>(streamIt->second.get());
+        if (!assetStream) {
+            qDebug() << "Ignoring mixer injection" << injection.injectorID << "that matches a streamed injector";
+            return;
+        }
+    }
+
+    if (injection.isStop) {
+        // removed by the next checkBuffersBeforeFrameSend
+        if (assetStream) {
+            assetStream->stop();
+        }
+        return;
+    }
+
+    if (assetStream) {
+        if (assetStream->getURL() == injection.url) {
+            assetStream->setOptions(injection);
+            return;
+        }
+
+        // a different sound under the same id starts over
+        _audioStreams.erase(streamIt);
+        releaseStreamSlot(injection.injectorID);
+    }
+
+    static const size_t MAX_ASSET_INJECTORS_PER_NODE = 256;
+    size_t numAssetStreams = std::count_if(_audioStreams.cbegin(), _audioStreams.cend(), [](const AudioStreamMap::value_type& pair) {
+        return dynamic_cast<const AssetInjectedAudioStream*>(pair.second.get()) != nullptr;
+    });
+    if (numAssetStreams >= MAX_ASSET_INJECTORS_PER_NODE) {
+        qDebug() << "Ignoring mixer injection" << injection.injectorID << "over the limit of" << MAX_ASSET_INJECTORS_PER_NODE;
+        return;
+    }
+
+    // the SoundCache keeps the decoded audio, so repeated and concurrent plays of a sound are fetched once
+    auto sound = DependencyManager::get<SoundCache>()->getSound(injection.url);
+    if (!sound) {
+        return;
+    }
+
+    auto injectorStream = new AssetInjectedAudioStream(injection, sound, AudioMixer::getStaticJitterFrames());
+    _audioStreams.emplace(injection.injectorID, std::unique_ptr<AssetInjectedAudioStream> { injectorStream });
+    _streamSlots[injection.injectorID] = _slotAllocator.allocate();
+}
+
 int AudioMixerClientData::checkBuffersBeforeFrameSend() {
     QWriteLocker writeLocker { &_streamsLock };
 
+    _mixableStreams.clear();
+
     auto it = _audioStreams.begin();
     while (it != _audioStreams.end()) {
         SharedStreamPointer stream = it->second;
 
+        // mixer-side injectors produce their frames here, rather than in packets
+        // (checked before popping, so the last frame of a sound is still mixed)
+        auto assetStream = dynamic_cast<AssetInjectedAudioStream*>(stream.get());
+        bool isAssetFinished = assetStream && assetStream->isFinished();
+        if (assetStream) {
+            assetStream->writeFrames();
+        }
+
         if (stream->popFrames(1, true) > 0) {
             stream->updateLastPopOutputLoudnessAndTrailingLoudness();
         }
@@ -203,16 +308,20 @@ int AudioMixerClientData::checkBuffersBeforeFrameSend() {
 
         // if we don't have new data for an injected stream in the last INJECTOR_MAX_INACTIVE_BLOCKS then
         // we remove the injector from our streams
-        if (stream->getType() == PositionalAudioStream::Injector
-            && stream->getConsecutiveNotMixedCount() > INJECTOR_MAX_INACTIVE_BLOCKS) {
+        // (mixer-side injectors may still be loading, and are removed as soon as they finish instead)
+        bool isInactive = assetStream ? isAssetFinished :
+            (stream->getType() == PositionalAudioStream::Injector
+             && stream->getConsecutiveNotMixedCount() > INJECTOR_MAX_INACTIVE_BLOCKS);
+        if (isInactive) {
             // this is an inactive injector, pull it from our streams
 
-            // first emit that it is finished so that the HRTF objects for this source can be cleaned up
-            emit injectorStreamFinished(it->second->getStreamIdentifier());
+            // release its slot so that the HRTF objects for this source are reset on reuse
+            releaseStreamSlot(it->first);
 
             // erase the stream to drop our ref to the shared pointer and remove it
             it = _audioStreams.erase(it);
         } else {
+            _mixableStreams.push_back({ stream, _streamSlots[it->first] });
             ++it;
         }
     }
@@ -224,10 +333,7 @@ bool AudioMixerClientData::shouldSendStats(int frameNumber) {
     return frameNumber == _frameToSendStats;
 }
 
-void AudioMixerClientData::sendAudioStreamStatsPackets(const SharedNodePointer& destinationNode) {
-
-    auto nodeList = DependencyManager::get<NodeList>();
-
+void AudioMixerClientData::sendAudioStreamStatsPackets(std::function<void(std::unique_ptr<NLPacket>)> sendPacket) {
     // The append flag is a boolean value that will be packed right after the header.
     // This flag allows the client to know when it has received all stats packets, so it can group any downstream effects,
     // and clear its cache of injector stream stats; it helps to prevent buildup of dead audio stream stats in the client.
@@ -274,7 +380,7 @@ void AudioMixerClientData::sendAudioStreamStatsPackets(const SharedNodePointer&
         numStreamStatsRemaining -= numStreamStatsToPack;
 
         // send the current packet
-        nodeList->sendPacket(std::move(statsPacket), *destinationNode);
+        sendPacket(std::move(statsPacket));
     }
 }
 
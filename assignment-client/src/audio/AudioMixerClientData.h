@@ -15,8 +15,11 @@
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
+#include <AudioAssetInjection.h>
+#include <AudioFOA.h>
 #include <AudioHRTF.h>
 #include <AudioLimiter.h>
+#include <AudioSourceSlots.h>
 #include <UUIDHasher.h>
 
 #include <plugins/CodecPlugin.h>
@@ -34,26 +37,42 @@ public:
     using SharedStreamPointer = std::shared_ptr<PositionalAudioStream>;
     using AudioStreamMap = std::unordered_map<QUuid, SharedStreamPointer>;
 
+    // a stream and its mixer-wide source slot, which indexes the per-listener HRTF state
+    struct MixableStream {
+        SharedStreamPointer stream;
+        AudioSourceSlot slot;
+    };
+    using MixableStreams = std::vector<MixableStream>;
+
     // locks the mutex to make a copy
     AudioStreamMap getAudioStreams() { QReadLocker readLock { &_streamsLock }; return _audioStreams; }
     AvatarAudioStream* getAvatarAudioStream();
+    AudioSourceSlot getStreamSlot(const QUuid& streamID = QUuid());
 
     // the following methods should be called from the AudioMixer assignment thread ONLY
     // they are not thread-safe
 
+    // snapshot of the streams taken by checkBuffersBeforeFrameSend, read without locking while mixing
+    const MixableStreams& getMixableStreams() const { return _mixableStreams; }
+
     // returns a new or existing HRTF object for the given stream from the given node
-    AudioHRTF& hrtfForStream(const QUuid& nodeID, const QUuid& streamID = QUuid()) { return _nodeSourcesHRTFMap[nodeID][streamID]; }
+    AudioHRTF& hrtfForStream(const QUuid& nodeID, const QUuid& streamID, AudioSourceSlot slot);
 
-    // remove HRTFs for all sources from this node
-    void removeHRTFsForNode(const QUuid& nodeID) { _nodeSourcesHRTFMap.erase(nodeID); }
+    // per-source gain set by this listener, kept by node so it survives the source's streams being recreated
+    void setGainAdjustmentForNode(const QUuid& nodeID, float gain, AudioSourceSlot micSlot);
+    void removeGainAdjustmentForNode(const QUuid& nodeID) { _nodeGainAdjustments.erase(nodeID); }
+    bool hasGainAdjustmentForNode(const QUuid& nodeID) const { return _nodeGainAdjustments.count(nodeID) > 0; }
 
-    // removes an AudioHRTF object for a given stream
-    void removeHRTFForStream(const QUuid& nodeID, const QUuid& streamID = QUuid());
+    // decodes the far-field bed of this listener's cell, see AudioFarFieldBeds
+    AudioFOA& getFarFieldDecoder() { return _farFieldDecoder; }
 
     void removeAgentAvatarAudioStream();
 
     int parseData(ReceivedMessage& message) override;
 
+    // start, update or stop a sound played by the mixer on behalf of this node
+    void injectAudioAsset(const AudioAssetInjection& injection);
+
     // attempt to pop a frame from each audio stream, and return the number of streams from this client
     int checkBuffersBeforeFrameSend();
 
@@ -61,7 +80,8 @@ public:
 
     QJsonObject getAudioStreamStats();
 
-    void sendAudioStreamStatsPackets(const SharedNodePointer& destinationNode);
+    // packs the stats of every stream into as many packets as needed, and hands each one to sendPacket
+    void sendAudioStreamStatsPackets(std::function<void(std::unique_ptr<NLPacket>)> sendPacket);
 
     void incrementOutgoingMixedAudioSequenceNumber() { _outgoingMixedAudioSequenceNumber++; }
     quint16 getOutgoingSequenceNumber() const { return _outgoingMixedAudioSequenceNumber; }
@@ -95,20 +115,26 @@ public:
     bool getRequestsDomainListData() { return _requestsDomainListData; }
     void setRequestsDomainListData(bool requesting) { _requestsDomainListData = requesting; }
 
-signals:
-    void injectorStreamFinished(const QUuid& streamIdentifier);
-
 public slots:
     void handleMismatchAudioFormat(SharedNodePointer node, const QString& currentCodec, const QString& recievedCodec);
     void sendSelectAudioFormat(SharedNodePointer node, const QString& selectedCodecName);
 
 private:
+    void releaseStreamSlot(const QUuid& streamID);
+
     QReadWriteLock _streamsLock;
     AudioStreamMap _audioStreams; // microphone stream from avatar is stored under key of null UUID
+    std::unordered_map<QUuid, AudioSourceSlot> _streamSlots; // guarded by _streamsLock
+
+    MixableStreams _mixableStreams;
+
+    // HRTF state for every source this listener hears, indexed by source slot
+    AudioHRTFSlots _hrtfSlots;
+    std::unordered_map<QUuid, float> _nodeGainAdjustments;
+
+    AudioFOA _farFieldDecoder;
 
-    using HRTFMap = std::unordered_map<QUuid, AudioHRTF>;
-    using NodeSourcesHRTFMap = std::unordered_map<QUuid, HRTFMap>;
-    NodeSourcesHRTFMap _nodeSourcesHRTFMap;
+    static AudioSourceSlotAllocator _slotAllocator;
 
     quint16 _outgoingMixedAudioSequenceNumber;
 
@@ -28,6 +28,7 @@
 #include <UUID.h>
 
 #include "AudioRingBuffer.h"
+#include "AudioSampleOps.h"
 #include "AudioMixer.h"
 #include "AudioMixerClientData.h"
 #include "AvatarAudioStream.h"
@@ -40,25 +41,40 @@ using AudioStreamMap = AudioMixerClientData::AudioStreamMap;
 
 // packet helpers
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec);
-void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer);
-void sendSilentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
-void sendMutePacket(const SharedNodePointer& node, AudioMixerClientData&);
-void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
+using PacketSender = AudioMixerSlave::PacketSender;
+void sendMixPacket(const PacketSender& sendPacket, const SharedNodePointer& node, AudioMixerClientData& data,
+        QByteArray& buffer);
+void sendSilentPacket(const PacketSender& sendPacket, const SharedNodePointer& node, AudioMixerClientData& data);
+void sendMutePacket(const PacketSender& sendPacket, const SharedNodePointer& node, AudioMixerClientData&);
+void sendEnvironmentPacket(const PacketSender& sendPacket, const SharedNodePointer& node, AudioMixerClientData& data);
 
 // mix helpers
 inline bool shouldIgnoreNode(const SharedNodePointer& listener, const SharedNodePointer& node);
 inline float approximateGain(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         const glm::vec3& relativePosition);
-inline float computeGain(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
-        const glm::vec3& relativePosition, bool isEcho);
+inline bool isRenderedInFull(const PositionalAudioStream& streamToAdd);
+inline float computePriority(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd);
 inline float computeAzimuth(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         const glm::vec3& relativePosition);
 
-void AudioMixerSlave::configure(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+// listeners over budget downmix up to this many streams for every stream they render in full
+static const int DOWNMIXES_PER_FULL_RENDER = 2;
+
+AudioMixerSlave::AudioMixerSlave(PacketSender sendPacket) : _sendPacket(sendPacket) {
+    if (!_sendPacket) {
+        _sendPacket = [](std::unique_ptr<NLPacket> packet, const Node& destination) {
+            DependencyManager::get<NodeList>()->sendPacket(std::move(packet), destination);
+        };
+    }
+}
+
+void AudioMixerSlave::configure(ConstIter begin, ConstIter end, unsigned int frame, int rendersPerListener,
+        const AudioFarFieldBeds* farFieldBeds) {
     _begin = begin;
     _end = end;
     _frame = frame;
-    _throttlingRatio = throttlingRatio;
+    _rendersPerListener = rendersPerListener;
+    _farFieldBeds = farFieldBeds;
 }
 
 void AudioMixerSlave::mix(const SharedNodePointer& node) {
@@ -76,7 +92,7 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
 
     // send mute packet, if necessary
     if (AudioMixer::shouldMute(avatarStream->getQuietestFrameLoudness()) || data->shouldMuteClient()) {
-        sendMutePacket(node, *data);
+        sendMutePacket(_sendPacket, node, *data);
     }
 
     // send audio packets, if necessary
@@ -98,18 +114,20 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
                 data->encodeFrameOfZeros(encodedBuffer);
             }
 
-            sendMixPacket(node, *data, encodedBuffer);
+            sendMixPacket(_sendPacket, node, *data, encodedBuffer);
         } else {
-            sendSilentPacket(node, *data);
+            sendSilentPacket(_sendPacket, node, *data);
         }
 
         // send environment packet
-        sendEnvironmentPacket(node, *data);
+        sendEnvironmentPacket(_sendPacket, node, *data);
 
         // send stats packet (about every second)
         const unsigned int NUM_FRAMES_PER_SEC = (int)ceil(AudioConstants::NETWORK_FRAMES_PER_SEC);
         if (data->shouldSendStats(_frame % NUM_FRAMES_PER_SEC)) {
-            data->sendAudioStreamStatsPackets(node);
+            data->sendAudioStreamStatsPackets([&](std::unique_ptr<NLPacket> packet) {
+                _sendPacket(std::move(packet), *node);
+            });
         }
     }
 }
@@ -121,18 +139,61 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     // zero out the mix for this listener
     memset(_mixSamples, 0, sizeof(_mixSamples));
 
-    bool isThrottling = _throttlingRatio > 0.0f;
-    std::vector<std::pair<float, SharedNodePointer>> throttledNodes;
+    bool isBudgeted = _rendersPerListener != UNLIMITED_RENDERS;
+    _rankedStreams.clear();
+
+    // distant streams are heard through the shared bed of the listener's cell, when there is one
+    const AudioFarFieldBeds::Bed* farFieldBed = nullptr;
+    if (_farFieldBeds && _farFieldBeds->isEnabled()) {
+        farFieldBed = _farFieldBeds->find(_farFieldBeds->getCell(listenerAudioStream->getPosition()));
+    }
+    auto isFarField = [&](const AudioMixerClientData::MixableStream& mixableStream) {
+        return farFieldBed && _farFieldBeds->isFarField(farFieldBed->center, mixableStream.stream->getPosition());
+    };
+
+    // the bed is shared by the whole cell, so it cannot leave out sources that only this listener ignores or
+    // adjusts, nor its own injectors; render everything individually if any of those is distant
+    if (farFieldBed) {
+        std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
+            AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+            if (!farFieldBed || !nodeData) {
+                return;
+            }
+            auto& mixableStreams = nodeData->getMixableStreams();
+            if (std::any_of(mixableStreams.cbegin(), mixableStreams.cend(), isFarField) &&
+                    (*node == *listener || listenerData->hasGainAdjustmentForNode(node->getUUID()) ||
+                     shouldIgnoreNode(listener, node))) {
+                farFieldBed = nullptr;
+            }
+        });
+    }
 
-    typedef void (AudioMixerSlave::*MixFunctor)(
-            AudioMixerClientData&, const QUuid&, const AvatarAudioStream&, const PositionalAudioStream&);
-    auto allStreams = [&](const SharedNodePointer& node, MixFunctor mixFunctor) {
+    auto allStreams = [&](const SharedNodePointer& node) {
         AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
         auto nodeID = node->getUUID();
-        for (auto& streamPair : nodeData->getAudioStreams()) {
-            auto nodeStream = streamPair.second;
-            (this->*mixFunctor)(*listenerData, nodeID, *listenerAudioStream, *nodeStream);
+        for (auto& mixableStream : nodeData->getMixableStreams()) {
+            if (isFarField(mixableStream)) {
+                ++stats.farFieldStreams;
+                continue;
+            }
+            auto& stream = *mixableStream.stream;
+            if (isBudgeted && isRenderedInFull(stream)) {
+                // competes for the listener's full renders, see mixBudgetedStreams
+                float priority = computePriority(*listenerAudioStream, stream);
+                priority *= listenerData->hrtfForStream(nodeID, stream.getStreamIdentifier(), mixableStream.slot).getGainAdjustment();
+                _rankedStreams.push_back({ priority, nodeID, mixableStream.slot, &stream });
+            } else {
+                addStream(*listenerData, nodeID, mixableStream.slot, *listenerAudioStream, stream);
+            }
+        }
+    };
+    auto hasNearStreams = [&](const SharedNodePointer& node) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!farFieldBed || !nodeData) {
+            return true;
         }
+        auto& mixableStreams = nodeData->getMixableStreams();
+        return !std::all_of(mixableStreams.cbegin(), mixableStreams.cend(), isFarField);
     };
 
     std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
@@ -140,77 +201,33 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
             AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
 
             // only mix the echo, if requested
-            for (auto& streamPair : nodeData->getAudioStreams()) {
-                auto nodeStream = streamPair.second;
-                if (nodeStream->shouldLoopbackForNode()) {
-                    mixStream(*listenerData, node->getUUID(), *listenerAudioStream, *nodeStream);
+            for (auto& mixableStream : nodeData->getMixableStreams()) {
+                if (mixableStream.stream->shouldLoopbackForNode()) {
+                    addStream(*listenerData, node->getUUID(), mixableStream.slot, *listenerAudioStream, *mixableStream.stream);
                 }
             }
+        } else if (!hasNearStreams(node)) {
+            stats.farFieldStreams += (int)static_cast<AudioMixerClientData*>(node->getLinkedData())->getMixableStreams().size();
         } else if (!shouldIgnoreNode(listener, node)) {
-            if (!isThrottling) {
-                allStreams(node, &AudioMixerSlave::mixStream);
-            } else {
-#ifdef HIFI_AUDIO_THROTTLE_DEBUG
-                auto throttleStart = p_high_resolution_clock::now();
-#endif
-
-                AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
-                auto nodeID = node->getUUID();
-
-                // compute the node's max relative volume
-                float nodeVolume;
-                for (auto& streamPair : nodeData->getAudioStreams()) {
-                    auto nodeStream = streamPair.second;
-
-                    // approximate the gain
-                    glm::vec3 relativePosition = nodeStream->getPosition() - listenerAudioStream->getPosition();
-                    float gain = approximateGain(*listenerAudioStream, *nodeStream, relativePosition);
-
-                    // modify by hrtf gain adjustment
-                    auto& hrtf = listenerData->hrtfForStream(nodeID, nodeStream->getStreamIdentifier());
-                    gain *= hrtf.getGainAdjustment();
-
-                    auto streamVolume = nodeStream->getLastPopOutputTrailingLoudness() * gain;
-                    nodeVolume = std::max(streamVolume, nodeVolume);
-                }
-
-                // max-heapify the nodes by relative volume
-                throttledNodes.push_back(std::make_pair(nodeVolume, node));
-                if (!throttledNodes.empty()) {
-                    std::push_heap(throttledNodes.begin(), throttledNodes.end());
-                }
-
-#ifdef HIFI_AUDIO_THROTTLE_DEBUG
-                auto throttleEnd = p_high_resolution_clock::now();
-                uint64_t throttleTime =
-                    std::chrono::duration_cast<std::chrono::nanoseconds>(throttleEnd - throttleStart).count();
-                stats.throttleTime += throttleTime;
-#endif
-            }
+            allStreams(node);
         }
     });
 
-    if (isThrottling) {
-        // pop the loudest nodes off the heap and mix their streams
-        int numToRetain = (int)(std::distance(_begin, _end) * (1 - _throttlingRatio));
-        for (int i = 0; i < numToRetain; i++) {
-            if (throttledNodes.empty()) {
-                break;
-            }
-
-            std::pop_heap(throttledNodes.begin(), throttledNodes.end());
+    if (isBudgeted) {
+        mixBudgetedStreams(*listenerData, *listenerAudioStream);
+    }
 
-            auto& node = throttledNodes.back().second;
-            allStreams(node, &AudioMixerSlave::mixStream);
+    if (farFieldBed && farFieldBed->numSources > 0) {
+        // rotate the bed into the listener's frame, converting from Y-up (OpenGL) to Z-up (Ambisonic) as AudioClient does
+        glm::quat orientation = glm::inverse(listenerAudioStream->getOrientation());
+        const int HRTF_DATASET_INDEX = 1;
 
-            throttledNodes.pop_back();
-        }
+        // AudioFOA only reads its input, so the bed can be shared by every listener in the cell
+        listenerData->getFarFieldDecoder().render(const_cast<int16_t*>(farFieldBed->samples), _mixSamples, HRTF_DATASET_INDEX,
+                orientation.w, -orientation.z, -orientation.x, orientation.y, 1.0f / AudioFarFieldBeds::HEADROOM,
+                AudioFarFieldBeds::NUM_FRAMES);
 
-        // throttle the remaining nodes' streams
-        for (const std::pair<float, SharedNodePointer>& nodePair : throttledNodes) {
-            auto& node = nodePair.second;
-            allStreams(node, &AudioMixerSlave::throttleStream);
-        }
+        ++stats.farFieldDecodes;
     }
 
     // use the per listener AudioLimiter to render the mixed data...
@@ -227,19 +244,49 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     return hasAudio;
 }
 
-void AudioMixerSlave::throttleStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
-        const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd) {
-    addStream(listenerNodeData, sourceNodeID, listeningNodeStream, streamToAdd, true);
-}
+void AudioMixerSlave::mixBudgetedStreams(AudioMixerClientData& listenerData, const AvatarAudioStream& listenerStream) {
+#ifdef HIFI_AUDIO_THROTTLE_DEBUG
+    auto throttleStart = p_high_resolution_clock::now();
+#endif
+
+    // the highest priority streams are rendered in full, the next are downmixed, and the tail is culled
+    size_t numStreams = _rankedStreams.size();
+    size_t numFull = std::min(numStreams, (size_t)_rendersPerListener);
+    size_t numDownmixed = std::min(numStreams - numFull, (size_t)_rendersPerListener * DOWNMIXES_PER_FULL_RENDER);
+
+    auto byPriority = [](const RankedStream& a, const RankedStream& b) { return a.priority > b.priority; };
+    auto fullEnd = _rankedStreams.begin() + numFull;
+    auto downmixEnd = fullEnd + numDownmixed;
+    if (numFull < numStreams) {
+        std::nth_element(_rankedStreams.begin(), fullEnd, _rankedStreams.end(), byPriority);
+        if (numFull + numDownmixed < numStreams) {
+            std::nth_element(fullEnd, downmixEnd, _rankedStreams.end(), byPriority);
+        }
+    }
 
-void AudioMixerSlave::mixStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
-        const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd) {
-    addStream(listenerNodeData, sourceNodeID, listeningNodeStream, streamToAdd, false);
+#ifdef HIFI_AUDIO_THROTTLE_DEBUG
+    auto throttleEnd = p_high_resolution_clock::now();
+    stats.throttleTime += std::chrono::duration_cast<std::chrono::nanoseconds>(throttleEnd - throttleStart).count();
+#endif
+
+    memset(_downmixSamples, 0, sizeof(_downmixSamples));
+
+    for (auto it = _rankedStreams.begin(); it != _rankedStreams.end(); ++it) {
+        Tier tier = (it < fullEnd) ? Tier::Full : (it < downmixEnd) ? Tier::Downmix : Tier::Culled;
+        addStream(listenerData, it->nodeID, it->slot, listenerStream, *it->stream, tier);
+    }
+
+    if (numDownmixed > 0) {
+        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++i) {
+            _mixSamples[2 * i] += _downmixSamples[i];
+            _mixSamples[2 * i + 1] += _downmixSamples[i];
+        }
+    }
 }
 
-void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
+void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID, AudioSourceSlot sourceSlot,
         const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
-        bool throttle) {
+        Tier tier) {
     ++stats.totalMixes;
 
     // to reduce artifacts we call the HRTF functor for every source, even if throttled or silent
@@ -251,7 +298,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     glm::vec3 relativePosition = streamToAdd.getPosition() - listeningNodeStream.getPosition();
 
     float distance = glm::max(glm::length(relativePosition), EPSILON);
-    float gain = computeGain(listeningNodeStream, streamToAdd, relativePosition, isEcho);
+    float gain = computeGain(listeningNodeStream.getPosition(), streamToAdd, relativePosition, isEcho);
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
     const int HRTF_DATASET_INDEX = 1;
 
@@ -279,7 +326,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
             // (this is not done for stereo streams since they do not go through the HRTF)
             if (!streamToAdd.isStereo() && !isEcho) {
                 // get the existing listener-source HRTF object, or create a new one
-                auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
+                auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier(), sourceSlot);
 
                 static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
                 hrtf.renderSilent(silentMonoBlock, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
@@ -297,9 +344,9 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
 
     // stereo sources are not passed through HRTF
     if (streamToAdd.isStereo()) {
-        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
-            _mixSamples[i] += float(streamPopOutput[i] * gain / AudioConstants::MAX_SAMPLE_VALUE);
-        }
+        streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+        accumulateInt16ToFloat(_bufferSamples, _mixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+                               gain / AudioConstants::MAX_SAMPLE_VALUE);
 
         ++stats.manualStereoMixes;
         return;
@@ -307,18 +354,16 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
 
     // echo sources are not passed through HRTF
     if (isEcho) {
-        for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i += 2) {
-            auto monoSample = float(streamPopOutput[i / 2] * gain / AudioConstants::MAX_SAMPLE_VALUE);
-            _mixSamples[i] += monoSample;
-            _mixSamples[i + 1] += monoSample;
-        }
+        streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        accumulateMonoInt16ToStereoFloat(_bufferSamples, _mixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL,
+                                         gain / AudioConstants::MAX_SAMPLE_VALUE);
 
         ++stats.manualEchoMixes;
         return;
     }
 
     // get the existing listener-source HRTF object, or create a new one
-    auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
+    auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier(), sourceSlot);
 
     streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
@@ -331,12 +376,20 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
         return;
     }
 
-    if (throttle) {
+    if (tier != Tier::Full) {
         // call renderSilent with actual frame data and a gain of 0.0f to reduce artifacts
+        // (this keeps the HRTF ready to fade the source back in if it is promoted)
         hrtf.renderSilent(_bufferSamples, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, 0.0f,
                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
-        ++stats.hrtfThrottleRenders;
+        if (tier == Tier::Downmix) {
+            gain *= hrtf.getGainAdjustment() / AudioConstants::MAX_SAMPLE_VALUE;
+            accumulateInt16ToFloat(_bufferSamples, _downmixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, gain);
+
+            ++stats.downmixMixes;
+        } else {
+            ++stats.hrtfThrottleRenders;
+        }
         return;
     }
 
@@ -353,7 +406,8 @@ std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 s
     return audioPacket;
 }
 
-void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer) {
+void sendMixPacket(const PacketSender& sendPacket, const SharedNodePointer& node, AudioMixerClientData& data,
+        QByteArray& buffer) {
     const int MIX_PACKET_SIZE =
         sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
     quint16 sequence = data.getOutgoingSequenceNumber();
@@ -364,11 +418,11 @@ void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QB
     mixPacket->write(buffer.constData(), buffer.size());
 
     // send packet
-    DependencyManager::get<NodeList>()->sendPacket(std::move(mixPacket), *node);
+    sendPacket(std::move(mixPacket), *node);
     data.incrementOutgoingMixedAudioSequenceNumber();
 }
 
-void sendSilentPacket(const SharedNodePointer& node, AudioMixerClientData& data) {
+void sendSilentPacket(const PacketSender& sendPacket, const SharedNodePointer& node, AudioMixerClientData& data) {
     const int SILENT_PACKET_SIZE =
         sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE + sizeof(quint16);
     quint16 sequence = data.getOutgoingSequenceNumber();
@@ -379,19 +433,19 @@ void sendSilentPacket(const SharedNodePointer& node, AudioMixerClientData& data)
     mixPacket->writePrimitive(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
     // send packet
-    DependencyManager::get<NodeList>()->sendPacket(std::move(mixPacket), *node);
+    sendPacket(std::move(mixPacket), *node);
     data.incrementOutgoingMixedAudioSequenceNumber();
 }
 
-void sendMutePacket(const SharedNodePointer& node, AudioMixerClientData& data) {
+void sendMutePacket(const PacketSender& sendPacket, const SharedNodePointer& node, AudioMixerClientData& data) {
     auto mutePacket = NLPacket::create(PacketType::NoisyMute, 0);
-    DependencyManager::get<NodeList>()->sendPacket(std::move(mutePacket), *node);
+    sendPacket(std::move(mutePacket), *node);
 
     // probably now we just reset the flag, once should do it (?)
     data.setShouldMuteClient(false);
 }
 
-void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData& data) {
+void sendEnvironmentPacket(const PacketSender& sendPacket, const SharedNodePointer& node, AudioMixerClientData& data) {
     bool hasReverb = false;
     float reverbTime, wetLevel;
 
@@ -448,7 +502,7 @@ void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData&
         }
 
         // send the packet
-        DependencyManager::get<NodeList>()->sendPacket(std::move(envPacket), *node);
+        sendPacket(std::move(envPacket), *node);
     }
 }
 
@@ -515,12 +569,36 @@ float approximateGain(const AvatarAudioStream& listeningNodeStream, const Positi
     // distance attenuation: approximate, ignore zone-specific attenuations
     // this is a good approximation for streams further than ATTENUATION_START_DISTANCE
     // those streams closer will be amplified; amplifying close streams is acceptable
-    // when throttling, as close streams are expected to be heard by a user
-    float distance = glm::length(relativePosition);
+    // when ranking streams, as close streams are expected to be heard by a user
+    float distance = glm::max(glm::length(relativePosition), EPSILON);
     return gain / distance;
 }
 
-float computeGain(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
+bool isRenderedInFull(const PositionalAudioStream& streamToAdd) {
+    // mirrors addStream: stereo streams are mixed manually, and silent streams only call renderSilent
+    if (streamToAdd.isStereo()) {
+        return false;
+    }
+    if (streamToAdd.lastPopSucceeded()) {
+        return streamToAdd.getLastPopOutputLoudness() > 0.0f;
+    }
+
+    // starved microphones repeat their last frame with a fade
+    return !streamToAdd.getLastPopOutput().isNull() && streamToAdd.getType() != PositionalAudioStream::Injector;
+}
+
+float computePriority(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd) {
+    glm::vec3 relativePosition = streamToAdd.getPosition() - listeningNodeStream.getPosition();
+    float gain = approximateGain(listeningNodeStream, streamToAdd, relativePosition);
+
+    // favor sources that have been speaking, so a talker is not dropped at each pause between words
+    const float SPEECH_RECENCY_FRAMES = 50.0f;
+    float recency = 1.0f / (1.0f + streamToAdd.getFramesSinceAudible() / SPEECH_RECENCY_FRAMES);
+
+    return streamToAdd.getLastPopOutputTrailingLoudness() * gain * recency;
+}
+
+float computeGain(const glm::vec3& listenerPosition, const PositionalAudioStream& streamToAdd,
         const glm::vec3& relativePosition, bool isEcho) {
     float gain = 1.0f;
 
@@ -549,7 +627,7 @@ float computeGain(const AvatarAudioStream& listeningNodeStream, const Positional
     float attenuationPerDoublingInDistance = AudioMixer::getAttenuationPerDoublingInDistance();
     for (int i = 0; i < zoneSettings.length(); ++i) {
         if (audioZones[zoneSettings[i].source].contains(streamToAdd.getPosition()) &&
-            audioZones[zoneSettings[i].listener].contains(listeningNodeStream.getPosition())) {
+            audioZones[zoneSettings[i].listener].contains(listenerPosition)) {
             attenuationPerDoublingInDistance = zoneSettings[i].coefficient;
             break;
         }
@@ -12,13 +12,17 @@
 #ifndef hifi_AudioMixerSlave_h
 #define hifi_AudioMixerSlave_h
 
+#include <functional>
+
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
+#include <AudioSourceSlots.h>
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
 #include <NodeList.h>
 
+#include "AudioFarFieldBeds.h"
 #include "AudioMixerStats.h"
 
 class PositionalAudioStream;
@@ -30,7 +34,18 @@ class AudioMixerSlave {
 public:
     using ConstIter = NodeList::const_iterator;
 
-    void configure(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    // sends a packet to a listener, see AudioMixerSlave(PacketSender)
+    using PacketSender = std::function<void(std::unique_ptr<NLPacket> packet, const Node& destination)>;
+
+    // packets go through the NodeList unless sendPacket is given, as tools/audio-mixer-bench does
+    // to measure the whole mix, encode included, without a network
+    AudioMixerSlave(PacketSender sendPacket = PacketSender());
+
+    // rendersPerListener caps the full HRTF renders per listener, see prepareMix
+    static const int UNLIMITED_RENDERS = -1;
+
+    void configure(ConstIter begin, ConstIter end, unsigned int frame, int rendersPerListener,
+            const AudioFarFieldBeds* farFieldBeds = nullptr);
 
     // mix and broadcast non-ignored streams to the node
     // returns true if a mixed packet was sent to the node
@@ -39,25 +54,49 @@ public:
     AudioMixerStats stats;
 
 private:
+    // how a stream is rendered for a listener that is over its render budget
+    enum class Tier {
+        Full,     // spatialized through its HRTF
+        Downmix,  // mixed to mono without spatialization, while its HRTF is kept current
+        Culled    // silent, while its HRTF is kept current
+    };
+
+    // an audible stream competing for the listener's full renders
+    struct RankedStream {
+        float priority;
+        QUuid nodeID;
+        AudioSourceSlot slot;
+        const PositionalAudioStream* stream;
+    };
+
     // create mix, returns true if mix has audio
     bool prepareMix(const SharedNodePointer& listener);
-    void throttleStream(AudioMixerClientData& listenerData, const QUuid& streamerID,
-            const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer);
-    void mixStream(AudioMixerClientData& listenerData, const QUuid& streamerID,
-            const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer);
-    void addStream(AudioMixerClientData& listenerData, const QUuid& streamerID,
+    void mixBudgetedStreams(AudioMixerClientData& listenerData, const AvatarAudioStream& listenerStream);
+    void addStream(AudioMixerClientData& listenerData, const QUuid& streamerID, AudioSourceSlot streamerSlot,
             const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer,
-            bool throttle);
+            Tier tier = Tier::Full);
 
     // mixing buffers
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    float _downmixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
 
+    // ranking state, reused across listeners
+    std::vector<RankedStream> _rankedStreams;
+
     // frame state
     ConstIter _begin;
     ConstIter _end;
     unsigned int _frame { 0 };
-    float _throttlingRatio { 0.0f };
+    int _rendersPerListener { UNLIMITED_RENDERS };
+    const AudioFarFieldBeds* _farFieldBeds { nullptr };
+
+    PacketSender _sendPacket;
 };
 
+// distance, zone and off-axis gain of a stream heard at the listener position
+// (also used by AudioFarFieldBeds, where the listener position is the center of a cell)
+float computeGain(const glm::vec3& listenerPosition, const PositionalAudioStream& streamToAdd,
+        const glm::vec3& relativePosition, bool isEcho);
+
 #endif // hifi_AudioMixerSlave_h
@@ -41,7 +41,7 @@ void AudioMixerSlaveThread::wait() {
         });
         ++_pool._numStarted;
     }
-    configure(_pool._begin, _pool._end, _pool._frame, _pool._throttlingRatio);
+    configure(_pool._begin, _pool._end, _pool._frame, _pool._rendersPerListener, _pool._farFieldBeds);
 }
 
 void AudioMixerSlaveThread::notify(bool stopping) {
@@ -64,14 +64,16 @@ bool AudioMixerSlaveThread::try_pop(SharedNodePointer& node) {
 static AudioMixerSlave slave;
 #endif
 
-void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, int rendersPerListener,
+        const AudioFarFieldBeds* farFieldBeds) {
     _begin = begin;
     _end = end;
     _frame = frame;
-    _throttlingRatio = throttlingRatio;
+    _rendersPerListener = rendersPerListener;
+    _farFieldBeds = farFieldBeds;
 
 #ifdef AUDIO_SINGLE_THREADED
-    slave.configure(_begin, _end, frame, throttlingRatio);
+    slave.configure(_begin, _end, frame, rendersPerListener, farFieldBeds);
     std::for_each(begin, end, [&](const SharedNodePointer& node) {
         slave.mix(node);
     });
@@ -144,7 +146,7 @@ void AudioMixerSlavePool::resize(int numThreads) {
     if (numThreads > _numThreads) {
         // start new slaves
         for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AudioMixerSlaveThread(*this);
+            auto slave = new AudioMixerSlaveThread(*this, _sendPacket);
             slave->start();
             _slaves.emplace_back(slave);
         }
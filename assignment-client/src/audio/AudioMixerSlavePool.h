@@ -31,7 +31,8 @@ class AudioMixerSlaveThread : public QThread, public AudioMixerSlave {
     using Lock = std::unique_lock<Mutex>;
 
 public:
-    AudioMixerSlaveThread(AudioMixerSlavePool& pool) : _pool(pool) {}
+    AudioMixerSlaveThread(AudioMixerSlavePool& pool, PacketSender sendPacket) :
+        AudioMixerSlave(sendPacket), _pool(pool) {}
 
     void run() override final;
 
@@ -57,11 +58,15 @@ class AudioMixerSlavePool {
 public:
     using ConstIter = NodeList::const_iterator;
 
-    AudioMixerSlavePool(int numThreads = QThread::idealThreadCount()) { setNumThreads(numThreads); }
+    // sendPacket replaces the NodeList for every slave, see AudioMixerSlave
+    AudioMixerSlavePool(int numThreads = QThread::idealThreadCount(),
+            AudioMixerSlave::PacketSender sendPacket = AudioMixerSlave::PacketSender()) :
+        _sendPacket(sendPacket) { setNumThreads(numThreads); }
     ~AudioMixerSlavePool() { resize(0); }
 
     // mix on slave threads
-    void mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    void mix(ConstIter begin, ConstIter end, unsigned int frame, int rendersPerListener,
+            const AudioFarFieldBeds* farFieldBeds = nullptr);
 
     // iterate over all slaves
     void each(std::function<void(AudioMixerSlave& slave)> functor);
@@ -73,6 +78,7 @@ private:
     void resize(int numThreads);
 
     std::vector<std::unique_ptr<AudioMixerSlaveThread>> _slaves;
+    AudioMixerSlave::PacketSender _sendPacket;
 
     friend void AudioMixerSlaveThread::wait();
     friend void AudioMixerSlaveThread::notify(bool stopping);
@@ -90,7 +96,8 @@ private:
     // frame state
     Queue _queue;
     unsigned int _frame { 0 };
-    float _throttlingRatio { 0.0f };
+    int _rendersPerListener { AudioMixerSlave::UNLIMITED_RENDERS };
+    const AudioFarFieldBeds* _farFieldBeds { nullptr };
     ConstIter _begin;
     ConstIter _end;
 };
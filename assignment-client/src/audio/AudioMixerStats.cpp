@@ -18,8 +18,13 @@ void AudioMixerStats::reset() {
     hrtfRenders = 0;
     hrtfSilentRenders = 0;
     hrtfThrottleRenders = 0;
+    downmixMixes = 0;
     manualStereoMixes = 0;
     manualEchoMixes = 0;
+    farFieldBeds = 0;
+    farFieldEncodes = 0;
+    farFieldDecodes = 0;
+    farFieldStreams = 0;
 #ifdef HIFI_AUDIO_THROTTLE_DEBUG
     throttleTime = 0;
 #endif
@@ -32,8 +37,13 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     hrtfRenders += otherStats.hrtfRenders;
     hrtfSilentRenders += otherStats.hrtfSilentRenders;
     hrtfThrottleRenders += otherStats.hrtfThrottleRenders;
+    downmixMixes += otherStats.downmixMixes;
     manualStereoMixes += otherStats.manualStereoMixes;
     manualEchoMixes += otherStats.manualEchoMixes;
+    farFieldBeds += otherStats.farFieldBeds;
+    farFieldEncodes += otherStats.farFieldEncodes;
+    farFieldDecodes += otherStats.farFieldDecodes;
+    farFieldStreams += otherStats.farFieldStreams;
 #ifdef HIFI_AUDIO_THROTTLE_DEBUG
     throttleTime += otherStats.throttleTime;
 #endif
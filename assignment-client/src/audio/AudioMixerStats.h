@@ -25,10 +25,16 @@ struct AudioMixerStats {
     int hrtfRenders { 0 };
     int hrtfSilentRenders { 0 };
     int hrtfThrottleRenders { 0 };
+    int downmixMixes { 0 };
 
     int manualStereoMixes { 0 };
     int manualEchoMixes { 0 };
 
+    int farFieldBeds { 0 };
+    int farFieldEncodes { 0 };
+    int farFieldDecodes { 0 };
+    int farFieldStreams { 0 };
+
 #ifdef HIFI_AUDIO_THROTTLE_DEBUG
     uint64_t throttleTime { 0 };
 #endif
@@ -21,6 +21,7 @@
 #include <QtCore/QThread>
 
 #include <AABox.h>
+#include <AvatarJointCodec.h>
 #include <LogHandler.h>
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
@@ -72,7 +73,8 @@ const float IDENTITY_SEND_PROBABILITY = 1.0f / 187.0f;
 void AvatarMixer::sendIdentityPacket(AvatarMixerClientData* nodeData, const SharedNodePointer& destinationNode) {
     QByteArray individualData = nodeData->getAvatar().identityByteArray();
 
-    auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size());
+    // reliable, as it announces the local ID the avatar's data is sent with
+    auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size(), true);
 
     individualData.replace(0, NUM_BYTES_RFC4122_UUID, nodeData->getNodeID().toRfc4122());
 
@@ -80,9 +82,37 @@ void AvatarMixer::sendIdentityPacket(AvatarMixerClientData* nodeData, const Shar
 
     DependencyManager::get<NodeList>()->sendPacket(std::move(identityPacket), *destinationNode);
 
+    auto destinationData = reinterpret_cast<AvatarMixerClientData*>(destinationNode->getLinkedData());
+    if (destinationData) {
+        destinationData->flagLocalIDAnnounced(nodeData->getNodeID());
+    }
+
     ++_sumIdentityPackets;
 }
 
+AvatarLocalID AvatarMixer::allocateLocalID() {
+    std::lock_guard<std::mutex> lock(_localIDsMutex);
+    if (_nextLocalID != UNKNOWN_AVATAR_LOCAL_ID) {
+        // wraps around to UNKNOWN_AVATAR_LOCAL_ID once all have been handed out
+        return _nextLocalID++;
+    }
+    if (!_releasedLocalIDs.empty()) {
+        AvatarLocalID localID = _releasedLocalIDs.front();
+        _releasedLocalIDs.pop_front();
+        return localID;
+    }
+
+    // all in use, the avatar is sent with its session UUID
+    return UNKNOWN_AVATAR_LOCAL_ID;
+}
+
+void AvatarMixer::releaseLocalID(AvatarLocalID localID) {
+    if (localID != UNKNOWN_AVATAR_LOCAL_ID) {
+        std::lock_guard<std::mutex> lock(_localIDsMutex);
+        _releasedLocalIDs.push_back(localID);
+    }
+}
+
 // NOTE: some additional optimizations to consider.
 //    1) use the view frustum to cull those avatars that are out of view. Since avatar data doesn't need to be present
 //       if the avatar is not in view or in the keyhole.
@@ -422,12 +452,20 @@ void AvatarMixer::broadcastAvatarData() {
                         detail = AvatarData::MinimumData;
                         nodeData->incrementAvatarOutOfView();
                     } else {
-                        detail = distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO
+                        detail = nodeData->shouldSendFullUpdate(otherNode->getUUID())
                                         ? AvatarData::SendAllData : AvatarData::CullSmallData;
                         nodeData->incrementAvatarInView();
                     }
 
-                    numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
+                    // the receiver can only resolve the local ID once it has received the avatar's identity
+                    AvatarLocalID otherLocalID = otherAvatar.getSessionLocalID();
+                    if (!nodeData->shouldSendLocalID(otherNode->getUUID())) {
+                        otherLocalID = UNKNOWN_AVATAR_LOCAL_ID;
+                    }
+                    numAvatarDataBytes += avatarPacketList->writePrimitive(otherLocalID);
+                    if (otherLocalID == UNKNOWN_AVATAR_LOCAL_ID) {
+                        numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
+                    }
                     auto lastEncodeForOther = nodeData->getLastOtherAvatarEncodeTime(otherNode->getUUID());
                     QVector<JointData>& lastSentJointsForOther = nodeData->getLastOtherAvatarSentJoints(otherNode->getUUID());
                     bool distanceAdjust = true;
@@ -548,6 +586,13 @@ void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
             }
         );
     }
+
+    if (killedNode->getLinkedData()) {
+        AvatarMixerClientData* nodeData = dynamic_cast<AvatarMixerClientData*>(killedNode->getLinkedData());
+        if (nodeData) {
+            releaseLocalID(nodeData->getAvatar().getSessionLocalID());
+        }
+    }
 }
 
 void AvatarMixer::handleViewFrustumPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -699,10 +744,11 @@ void AvatarMixer::domainSettingsRequestComplete() {
     float domainMinimumScale = _domainMinimumScale;
     float domainMaximumScale = _domainMaximumScale;
 
-    nodeList->linkedDataCreateCallback = [domainMinimumScale, domainMaximumScale] (Node* node) {
+    nodeList->linkedDataCreateCallback = [this, domainMinimumScale, domainMaximumScale] (Node* node) {
         auto clientData = std::unique_ptr<AvatarMixerClientData> { new AvatarMixerClientData(node->getUUID()) };
         clientData->getAvatar().setDomainMinimumScale(domainMinimumScale);
         clientData->getAvatar().setDomainMaximumScale(domainMaximumScale);
+        clientData->getAvatar().setSessionLocalID(allocateLocalID());
 
         node->setLinkedData(std::move(clientData));
     };
@@ -738,6 +784,17 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qDebug() << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps.";
 
+    const QString JOINT_ROTATION_BITS_KEY = "joint_rotation_bits";
+    const QString JOINT_TRANSLATION_BITS_KEY = "joint_translation_bits";
+    QJsonObject avatarMixerSettings = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject();
+    int jointRotationBits = avatarMixerSettings[JOINT_ROTATION_BITS_KEY].toInt(AvatarJointCodec::DEFAULT_ROTATION_BITS);
+    int jointTranslationBits =
+        avatarMixerSettings[JOINT_TRANSLATION_BITS_KEY].toInt(AvatarJointCodec::DEFAULT_TRANSLATION_BITS);
+    AvatarJointCodec jointCodec(jointRotationBits, jointTranslationBits);
+    AvatarData::setJointEncodingPrecision(jointCodec.getRotationBits(), jointCodec.getTranslationBits());
+    qDebug() << "Joints are sent with" << jointCodec.getRotationBits() << "bits per rotation component and"
+        << jointCodec.getTranslationBits() << "bits per translation component.";
+
     const QString AVATARS_SETTINGS_KEY = "avatars";
 
     static const QString MIN_SCALE_OPTION = "min_avatar_scale";
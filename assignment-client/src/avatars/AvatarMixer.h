@@ -15,6 +15,9 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <deque>
+#include <mutex>
+
 #include <shared/RateCounter.h>
 #include <PortableHighResolutionClock.h>
 
@@ -52,6 +55,9 @@ private:
     void parseDomainServerSettings(const QJsonObject& domainSettings);
     void sendIdentityPacket(AvatarMixerClientData* nodeData, const SharedNodePointer& destinationNode);
 
+    AvatarLocalID allocateLocalID();
+    void releaseLocalID(AvatarLocalID localID);
+
     QThread _broadcastThread;
 
     p_high_resolution_clock::time_point _lastFrameTimestamp;
@@ -73,6 +79,12 @@ private:
     RateCounter<> _broadcastRate;
     p_high_resolution_clock::time_point _lastDebugMessage;
     QHash<QString, QPair<int, int>> _sessionDisplayNames;
+
+    // every local ID is handed out once before released ones are reused, oldest first, so that a client
+    // which missed the release is unlikely to still hold the old mapping
+    std::mutex _localIDsMutex;
+    AvatarLocalID _nextLocalID { UNKNOWN_AVATAR_LOCAL_ID + 1 };
+    std::deque<AvatarLocalID> _releasedLocalIDs;
 };
 
 #endif // hifi_AvatarMixer_h
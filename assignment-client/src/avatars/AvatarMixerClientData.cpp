@@ -16,6 +16,9 @@
 
 #include "AvatarMixerClientData.h"
 
+// about a second of updates, for the identity to make it through the handshake and a few retransmissions
+const int AVATAR_UPDATES_BEFORE_LOCAL_ID = 45;
+
 int AvatarMixerClientData::parseData(ReceivedMessage& message) {
     // pull the sequence number from the data first
     message.readPrimitive(&_lastReceivedSequenceNumber);
@@ -42,6 +45,32 @@ uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& node
     }
 }
 
+bool AvatarMixerClientData::shouldSendLocalID(const QUuid& uuid) {
+    auto announcedMatch = _updatesSinceLocalIDAnnounced.find(uuid);
+    if (announcedMatch == _updatesSinceLocalIDAnnounced.end()) {
+        return false;
+    }
+    if (announcedMatch->second < AVATAR_UPDATES_BEFORE_LOCAL_ID) {
+        ++announcedMatch->second;
+        return false;
+    }
+    return true;
+}
+
+bool AvatarMixerClientData::shouldSendFullUpdate(const QUuid& otherAvatar) {
+    auto updatesMatch = _updatesUntilFullUpdate.find(otherAvatar);
+    if (updatesMatch == _updatesUntilFullUpdate.end()) {
+        _updatesUntilFullUpdate[otherAvatar] = (int)(qHash(otherAvatar) % AVATAR_UPDATES_PER_FULL_UPDATE);
+        return true;
+    }
+    if (updatesMatch->second > 0) {
+        --updatesMatch->second;
+        return false;
+    }
+    updatesMatch->second = AVATAR_UPDATES_PER_FULL_UPDATE - 1;
+    return true;
+}
+
 void AvatarMixerClientData::ignoreOther(SharedNodePointer self, SharedNodePointer other) {
     if (!isRadiusIgnoring(other->getUUID())) {
         addToRadiusIgnoringSet(other->getUUID());
@@ -54,6 +83,8 @@ void AvatarMixerClientData::ignoreOther(SharedNodePointer self, SharedNodePointe
         }
         DependencyManager::get<NodeList>()->sendUnreliablePacket(*killPacket, *self);
         _hasReceivedFirstPacketsFrom.erase(other->getUUID());
+        // the avatar is gone on the client, with the local ID it had been announced with
+        _updatesSinceLocalIDAnnounced.erase(other->getUUID());
     }
 }
 
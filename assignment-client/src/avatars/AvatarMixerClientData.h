@@ -44,10 +44,20 @@ public:
 
     bool checkAndSetHasReceivedFirstPacketsFrom(const QUuid& uuid);
 
+    // the identity announcing the local ID of the other avatar is reliable, so it can be held back by the handshake
+    // of a new connection while its data goes out right away. the data keeps the full UUID for the first
+    // AVATAR_UPDATES_BEFORE_LOCAL_ID updates after the identity was sent, counted by shouldSendLocalID.
+    bool shouldSendLocalID(const QUuid& uuid);
+    void flagLocalIDAnnounced(const QUuid& uuid) { _updatesSinceLocalIDAnnounced.emplace(uuid, 0); }
+
     uint16_t getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const;
     void setLastBroadcastSequenceNumber(const QUuid& nodeUUID, uint16_t sequenceNumber)
         { _lastBroadcastSequenceNumbers[nodeUUID] = sequenceNumber; }
-    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) { _lastBroadcastSequenceNumbers.erase(nodeUUID); }
+    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) {
+        _lastBroadcastSequenceNumbers.erase(nodeUUID);
+        _updatesUntilFullUpdate.erase(nodeUUID);
+        _updatesSinceLocalIDAnnounced.erase(nodeUUID);
+    }
 
     uint16_t getLastReceivedSequenceNumber() const { return _lastReceivedSequenceNumber; }
 
@@ -113,10 +123,12 @@ public:
         return result;
     }
 
-    QVector<JointData>& getLastOtherAvatarSentJoints(QUuid otherAvatar) {
-        _lastOtherAvatarSentJoints[otherAvatar].resize(_avatar->getJointCount());
-        return _lastOtherAvatarSentJoints[otherAvatar];
-    }
+    // sized by AvatarData::toByteArray to the other avatar's joints
+    QVector<JointData>& getLastOtherAvatarSentJoints(QUuid otherAvatar) { return _lastOtherAvatarSentJoints[otherAvatar]; }
+
+    // true for the first update of the other avatar sent to this node, then once every AVATAR_UPDATES_PER_FULL_UPDATE,
+    // staggered across other avatars so that their full updates don't all land in the same frame
+    bool shouldSendFullUpdate(const QUuid& otherAvatar);
 
     
 
@@ -126,11 +138,13 @@ private:
     uint16_t _lastReceivedSequenceNumber { 0 };
     std::unordered_map<QUuid, uint16_t> _lastBroadcastSequenceNumbers;
     std::unordered_set<QUuid> _hasReceivedFirstPacketsFrom;
+    std::unordered_map<QUuid, int> _updatesSinceLocalIDAnnounced;
 
     // this is a map of the last time we encoded an "other" avatar for
     // sending to "this" node
     std::unordered_map<QUuid, quint64> _lastOtherAvatarEncodeTime;
     std::unordered_map<QUuid, QVector<JointData>> _lastOtherAvatarSentJoints;
+    std::unordered_map<QUuid, int> _updatesUntilFullUpdate;
 
     HRCTime _identityChangeTimestamp;
     bool _avatarSessionDisplayNameMustChange{ false };
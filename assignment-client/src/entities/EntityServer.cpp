@@ -62,6 +62,7 @@ OctreePointer EntityServer::createTree() {
     EntityTreePointer tree = EntityTreePointer(new EntityTree(true));
     tree->createRootElement();
     tree->addNewlyCreatedHook(this);
+    tree->enableEncodedEntityCache();
     if (!_entitySimulation) {
         SimpleEntitySimulationPointer simpleSimulation { new SimpleEntitySimulation() };
         simpleSimulation->setEntityTree(tree);
@@ -424,6 +425,24 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    // display encoded entity cache stats
+    EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
+    if (auto encodedEntityCache = tree->getEncodedEntityCache()) {
+        quint64 hits = encodedEntityCache->getNumHits();
+        quint64 misses = encodedEntityCache->getNumMisses();
+        float hitRate = (hits + misses) > 0 ? (float)hits / (float)(hits + misses) : 0.0f;
+
+        statsString += "<b>Entity Server Encoded Entity Cache</b>\r\n";
+        statsString += QString().sprintf("          Hit rate... %6.2f%% (%llu hits, %llu misses)\r\n",
+                                         (double)(hitRate * 100.0f), hits, misses);
+        statsString += QString("       Bytes saved... %1 bytes\r\n")
+            .arg(locale.toString(encodedEntityCache->getBytesSaved()));
+        statsString += QString("     Cached entities... %1 (%2 bytes)\r\n")
+            .arg(locale.toString(encodedEntityCache->getNumEntries()))
+            .arg(locale.toString(encodedEntityCache->getSize()));
+        statsString += "\r\n\r\n";
+    }
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
@@ -24,6 +24,7 @@ int main(int argc, char* argv[]) {
     QCoreApplication::setApplicationVersion(BuildInfo::VERSION);
 
     qInstallMessageHandler(LogHandler::verboseMessageHandler);
+    LogHandler::getInstance().setAsyncOutput(true);
     qInfo() << "Starting.";
 
     AssignmentClientApp app(argc, argv);
@@ -0,0 +1,143 @@
+//
+//  OctreeSendPool.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+
+#include <SharedUtil.h>
+
+#include "OctreeSendPool.h"
+#include "OctreeSendThread.h"
+#include "OctreeServer.h"
+#include "OctreeServerConsts.h"
+
+void OctreeSendWorker::run() {
+    while (_pool.runNext()) {
+    }
+}
+
+OctreeSendPool::OctreeSendPool(int numThreads) {
+    if (numThreads <= 0) {
+        // idealThreadCount returns -1 if cores cannot be detected
+        static const int NUM_THREADS_IF_UNKNOWN = 4;
+        numThreads = NUM_THREADS_IF_UNKNOWN;
+    }
+    qDebug("%s: starting %d threads", __FUNCTION__, numThreads);
+
+    for (int i = 0; i < numThreads; ++i) {
+        auto worker = new OctreeSendWorker(*this);
+        worker->setObjectName(QString("Octree Send Worker %1").arg(i));
+        worker->start();
+        _workers.emplace_back(worker);
+    }
+}
+
+OctreeSendPool::~OctreeSendPool() {
+    {
+        Lock lock(_mutex);
+        _stop = true;
+    }
+    _workerCondition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker->wait();
+    }
+    assert(_running.empty());
+}
+
+void OctreeSendPool::add(OctreeSendThread* sender) {
+    {
+        Lock lock(_mutex);
+        uint64_t id = _nextID++;
+        _senders[sender] = id;
+        _queue.push({ usecTimestampNow(), id, sender });
+    }
+    _workerCondition.notify_one();
+}
+
+void OctreeSendPool::remove(OctreeSendThread* sender) {
+    Lock lock(_mutex);
+    _senders.erase(sender);
+
+    // its queued job is dropped once it reaches the front
+    _removeCondition.wait(lock, [&] {
+        return _running.find(sender) == _running.end();
+    });
+}
+
+int OctreeSendPool::numSenders() const {
+    Lock lock(_mutex);
+    return (int)_senders.size();
+}
+
+bool OctreeSendPool::isScheduled(const Job& job) const {
+    auto it = _senders.find(job.sender);
+    return it != _senders.end() && it->second == job.id;
+}
+
+bool OctreeSendPool::runNext() {
+    Lock lock(_mutex);
+
+    // wait for the earliest job to come due
+    Job job;
+    while (true) {
+        if (_stop) {
+            return false;
+        }
+        if (_queue.empty()) {
+            _workerCondition.wait(lock);
+            continue;
+        }
+
+        job = _queue.top();
+        if (!isScheduled(job)) {
+            _queue.pop();
+            continue;
+        }
+
+        quint64 now = usecTimestampNow();
+        if (job.deadline > now) {
+            _workerCondition.wait_for(lock, std::chrono::microseconds(job.deadline - now));
+            continue;
+        }
+
+        _queue.pop();
+        break;
+    }
+    _running.insert(job.sender);
+    lock.unlock();
+
+    quint64 start = usecTimestampNow();
+    OctreeServer::trackSendQueueLag((float)(start - job.deadline));
+
+    bool keepRunning = job.sender->processInterval();
+    if (!keepRunning) {
+        // while still marked as running, so that the sender cannot be removed and destroyed under us
+        emit job.sender->finished();
+    }
+
+    lock.lock();
+    _running.erase(job.sender);
+    if (isScheduled(job)) {
+        if (keepRunning) {
+            // keep to the sender's cadence, without bursting to catch up if it fell behind
+            job.deadline = std::max(job.deadline + OCTREE_SEND_INTERVAL_USECS, usecTimestampNow());
+            _queue.push(job);
+        } else {
+            _senders.erase(job.sender);
+        }
+    }
+    lock.unlock();
+
+    _removeCondition.notify_all();
+    _workerCondition.notify_one();
+    return true;
+}
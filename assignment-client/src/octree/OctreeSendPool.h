@@ -0,0 +1,93 @@
+//
+//  OctreeSendPool.h
+//  assignment-client/src/octree
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendPool_h
+#define hifi_OctreeSendPool_h
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <QThread>
+
+class OctreeSendPool;
+class OctreeSendThread;
+
+class OctreeSendWorker : public QThread {
+    Q_OBJECT
+public:
+    OctreeSendWorker(OctreeSendPool& pool) : _pool(pool) {}
+
+    void run() override final;
+
+private:
+    OctreeSendPool& _pool;
+};
+
+// Worker pool for octree servers
+//   Runs the OctreeSendThreads of all clients on a fixed number of workers, in place of a thread each.
+//   Each sender is run once per send interval, earliest deadline first, so that its own pacing is unchanged.
+//   How late senders are run is tracked through OctreeServer::trackSendQueueLag().
+class OctreeSendPool {
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+    using ConditionVariable = std::condition_variable;
+
+public:
+    OctreeSendPool(int numThreads = QThread::idealThreadCount());
+    ~OctreeSendPool();
+
+    // schedule the sender, until its processInterval() returns false or it is removed
+    void add(OctreeSendThread* sender);
+
+    // unschedule the sender, waiting for a worker to be done with it
+    void remove(OctreeSendThread* sender);
+
+    int numThreads() const { return (int)_workers.size(); }
+    int numSenders() const;
+
+private:
+    friend class OctreeSendWorker;
+
+    class Job {
+    public:
+        quint64 deadline;
+        uint64_t id;
+        OctreeSendThread* sender;
+
+        bool operator>(const Job& other) const { return deadline > other.deadline; }
+    };
+    using Queue = std::priority_queue<Job, std::vector<Job>, std::greater<Job>>;
+
+    // run the next sender that is due, returns false once stopping
+    bool runNext();
+
+    bool isScheduled(const Job& job) const;
+
+    std::vector<std::unique_ptr<OctreeSendWorker>> _workers;
+
+    mutable Mutex _mutex;
+    ConditionVariable _workerCondition;
+    ConditionVariable _removeCondition;
+    bool _stop { false }; // guarded by _mutex
+
+    // senders are identified by id, so that queued jobs of a removed sender are never run for another at its address
+    Queue _queue; // guarded by _mutex
+    std::unordered_map<OctreeSendThread*, uint64_t> _senders; // guarded by _mutex
+    std::unordered_set<OctreeSendThread*> _running; // guarded by _mutex
+    uint64_t _nextID { 0 }; // guarded by _mutex
+};
+
+#endif // hifi_OctreeSendPool_h
@@ -18,6 +18,7 @@
 #include <PerfStat.h>
 
 #include "OctreeQueryNode.h"
+#include "OctreeSendPool.h"
 #include "OctreeSendThread.h"
 #include "OctreeServer.h"
 #include "OctreeServerConsts.h"
@@ -48,7 +49,10 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
 
 OctreeSendThread::~OctreeSendThread() {
     setIsShuttingDown();
-    
+    if (_pool) {
+        _pool->remove(this);
+    }
+
     QString safeServerName("Octree");
     if (_myServer) {
         safeServerName = _myServer->getMyServerName();
@@ -65,16 +69,47 @@ void OctreeSendThread::setIsShuttingDown() {
     _isShuttingDown = true;
 }
 
+void OctreeSendThread::initializeInPool(OctreeSendPool* pool) {
+    _pool = pool;
+    initialize(false);
+    _pool->add(this);
+}
 
 bool OctreeSendThread::process() {
+    quint64  start = usecTimestampNow();
+
+    if (!processInterval()) {
+        return false; // exit early if we're shutting down
+    }
+
+    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
+    if (isStillRunning()) {
+        // dynamically sleep until we need to fire off the next set of octree elements
+        int elapsed = (usecTimestampNow() - start);
+        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
+
+        if (usecToSleep <= 0) {
+            const int MIN_USEC_TO_SLEEP = 1;
+            usecToSleep = MIN_USEC_TO_SLEEP;
+        }
+
+        {
+            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
+            std::this_thread::sleep_for(std::chrono::microseconds(usecToSleep));
+        }
+
+    }
+
+    return isStillRunning();  // keep running till they terminate us
+}
+
+bool OctreeSendThread::processInterval() {
     if (_isShuttingDown) {
         return false; // exit early if we're shutting down
     }
 
     OctreeServer::didProcess(this);
 
-    quint64  start = usecTimestampNow();
-
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
 
@@ -94,29 +129,7 @@ bool OctreeSendThread::process() {
         }
     }
 
-    if (_isShuttingDown) {
-        return false; // exit early if we're shutting down
-    }
-
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
-
-        if (usecToSleep <= 0) {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usecToSleep = MIN_USEC_TO_SLEEP;
-        }
-
-        {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            std::this_thread::sleep_for(std::chrono::microseconds(usecToSleep));
-        }
-
-    }
-
-    return isStillRunning();  // keep running till they terminate us
+    return !_isShuttingDown;
 }
 
 AtomicUIntStat OctreeSendThread::_usleepTime { 0 };
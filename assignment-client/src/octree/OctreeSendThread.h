@@ -19,6 +19,7 @@
 #include <GenericThread.h>
 
 class OctreeQueryNode;
+class OctreeSendPool;
 class OctreeServer;
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
@@ -30,6 +31,12 @@ public:
     OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node);
     virtual ~OctreeSendThread();
 
+    /// Runs this sender on the pool's workers rather than on a thread of its own.
+    void initializeInPool(OctreeSendPool* pool);
+
+    /// Does one interval's worth of sending, without sleeping. Returns false once the sender should stop.
+    bool processInterval();
+
     void setIsShuttingDown();
     bool isShuttingDown() { return _isShuttingDown; }
     
@@ -55,6 +62,7 @@ private:
     
     
     OctreeServer* _myServer { nullptr };
+    OctreeSendPool* _pool { nullptr };
     QWeakPointer<Node> _node;
     QUuid _nodeUuid;
 
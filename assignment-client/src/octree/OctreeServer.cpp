@@ -81,6 +81,7 @@ int OctreeServer::_longProcessWait = 0;
 int OctreeServer::_shortProcessWait = 0;
 int OctreeServer::_noProcessWait = 0;
 
+SimpleMovingAverage OctreeServer::_averageSendQueueLag(MOVING_AVERAGE_SAMPLE_COUNTS);
 
 void OctreeServer::resetSendingStats() {
     _averageLoopTime.reset();
@@ -126,6 +127,8 @@ void OctreeServer::resetSendingStats() {
     _longProcessWait = 0;
     _shortProcessWait = 0;
     _noProcessWait = 0;
+
+    _averageSendQueueLag.reset();
 }
 
 void OctreeServer::trackEncodeTime(float time) {
@@ -442,6 +445,18 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("      writeDatagram() last second: %1 clients\r\n\r\n")
             .arg(locale.toString((uint)howManyThreadsDidCallWriteDatagram(oneSecondAgo)).rightJustified(COLUMN_WIDTH, ' '));
 
+        if (_sendPool) {
+            statsString += QString("              Send Worker Threads: %1 threads\r\n")
+                .arg(locale.toString((uint)_sendPool->numThreads()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("                Scheduled Senders: %1 clients\r\n")
+                .arg(locale.toString((uint)_sendPool->numSenders()).rightJustified(COLUMN_WIDTH, ' '));
+
+            float averageSendQueueLag = getAverageSendQueueLag();
+            statsString += QString().sprintf("         Average send queue lag:    %9.2f usecs"
+                                             "                 samples: %12d \r\n\r\n",
+                                             (double)averageSendQueueLag, _averageSendQueueLag.getSampleCount());
+        }
+
         float averageLoopTime = getAverageLoopTime();
         statsString += QString().sprintf("           Average packetLoop() time:      %7.2f msecs"
                                          "                 samples: %12d \r\n",
@@ -877,7 +892,11 @@ OctreeServer::UniqueSendThread OctreeServer::createSendThread(const SharedNodePo
     
     // we want to be notified when the thread finishes
     connect(sendThread.get(), &GenericThread::finished, this, &OctreeServer::removeSendThread);
-    sendThread->initialize(true);
+    if (_sendPool) {
+        sendThread->initializeInPool(_sendPool.get());
+    } else {
+        sendThread->initialize(true);
+    }
 
     return sendThread;
 }
@@ -1111,6 +1130,13 @@ void OctreeServer::readConfiguration() {
     qDebug("packetsPerSecondTotalMax=%d _packetsTotalPerInterval=%d",
                     packetsPerSecondTotalMax, _packetsTotalPerInterval);
 
+    // Check to see if the user wants clients sent to from a pool of workers rather than a thread each,
+    // 0 sizes the pool to the machine
+    int sendWorkerThreads = -1;
+    if (readOptionInt(QString("sendWorkerThreads"), settingsSectionObject, sendWorkerThreads) && sendWorkerThreads >= 0) {
+        _sendPool.reset(sendWorkerThreads > 0 ? new OctreeSendPool(sendWorkerThreads) : new OctreeSendPool());
+    }
+    qDebug("sendWorkerThreads=%d", _sendPool ? _sendPool->numThreads() : -1);
 
     readAdditionalConfiguration(settingsSectionObject);
 }
@@ -1355,6 +1381,7 @@ void OctreeServer::aboutToFinish() {
     // Clear will destruct all the unique_ptr to OctreeSendThreads which will call the GenericThread's dtor
     // which waits on the thread to be done before returning
     _sendThreads.clear(); // Cleans up all the send threads.
+    _sendPool.reset();
 
     if (_persistThread) {
         _persistThread->aboutToFinish();
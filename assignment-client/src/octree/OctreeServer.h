@@ -23,6 +23,7 @@
 #include <ThreadedAssignment.h>
 
 #include "OctreePersistThread.h"
+#include "OctreeSendPool.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
@@ -108,6 +109,10 @@ public:
     static void trackProcessWaitTime(float time);
     static float getAverageProcessWaitTime() { return _averageProcessWaitTime.getAverage(); }
 
+    // how late pooled senders are run past their deadline
+    static void trackSendQueueLag(float time) { _averageSendQueueLag.updateAverage(time); }
+    static float getAverageSendQueueLag() { return _averageSendQueueLag.getAverage(); }
+
     // these methods allow us to track which threads got to various states
     static void didProcess(OctreeSendThread* thread);
     static void didPacketDistributor(OctreeSendThread* thread);
@@ -198,6 +203,7 @@ protected:
     QString _safeServerName;
     
     SendThreads _sendThreads;
+    std::unique_ptr<OctreeSendPool> _sendPool; // null when each client has a thread of its own
 
     static int _clientCount;
     static SimpleMovingAverage _averageLoopTime;
@@ -245,6 +251,8 @@ protected:
     static int _shortProcessWait;
     static int _noProcessWait;
 
+    static SimpleMovingAverage _averageSendQueueLag;
+
     static QMap<OctreeSendThread*, quint64> _threadsDidProcess;
     static QMap<OctreeSendThread*, quint64> _threadsDidPacketDistributor;
     static QMap<OctreeSendThread*, quint64> _threadsDidHandlePacketSend;
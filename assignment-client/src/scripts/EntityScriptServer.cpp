@@ -17,6 +17,7 @@
 #include <AudioInjectorManager.h>
 #include <ClientServerUtils.h>
 #include <EntityScriptingInterface.h>
+#include <EntityTreeElement.h>
 #include <LogHandler.h>
 #include <MessagesClient.h>
 #include <plugins/CodecPlugin.h>
@@ -85,6 +86,11 @@ EntityScriptServer::EntityScriptServer(ReceivedMessage& message) : ThreadedAssig
     timer->setInterval(LOG_INTERVAL);
     connect(timer, &QTimer::timeout, this, &EntityScriptServer::pushLogs);
     timer->start();
+
+    static const int REBALANCE_INTERVAL = MSECS_PER_SECOND;
+    _rebalanceTimer = new QTimer(this);
+    _rebalanceTimer->setInterval(REBALANCE_INTERVAL);
+    connect(_rebalanceTimer, &QTimer::timeout, this, &EntityScriptServer::rebalanceScriptEngines);
 }
 
 EntityScriptServer::~EntityScriptServer() {
@@ -101,7 +107,10 @@ void EntityScriptServer::handleReloadEntityServerScriptPacket(QSharedPointer<Rec
 
         if (_entityViewer.getTree() && !_shuttingDown) {
             qCDebug(entity_script_server) << "Reloading: " << entityID;
-            _entitiesScriptEngine->unloadEntityScript(entityID);
+            auto engine = engineForEntity(entityID);
+            if (engine) {
+                engine->unloadEntityScript(entityID);
+            }
             checkAndCallPreload(entityID, true);
         }
     }
@@ -119,7 +128,8 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        auto engine = engineForEntity(entityID);
+        if (engine && engine->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -150,6 +160,32 @@ void EntityScriptServer::handleSettings() {
 
     static const QString MAX_ENTITY_PPS_OPTION = "max_total_entity_pps";
     static const QString ENTITY_PPS_PER_SCRIPT = "entity_pps_per_script";
+    static const QString SCRIPT_ENGINE_SHARDS_OPTION = "script_engine_shards";
+    static const QString SHARD_FRAME_BUDGET_OPTION = "shard_frame_budget_msecs";
+    static const QString ALLOW_PROFILE_TIMELINES_OPTION = "allow_profile_timelines";
+
+    ScriptEngine::setProfileTimelinesAllowed(entityScriptServerSettings[ALLOW_PROFILE_TIMELINES_OPTION].toBool());
+
+    if (entityScriptServerSettings.contains(SHARD_FRAME_BUDGET_OPTION)) {
+        _shardFrameBudgetMsecs = std::max(1, entityScriptServerSettings[SHARD_FRAME_BUDGET_OPTION].toInt());
+        _loadBalancer.setFrameBudgetMsecs(_shardFrameBudgetMsecs);
+    }
+
+    if (entityScriptServerSettings.contains(SCRIPT_ENGINE_SHARDS_OPTION)) {
+        int numShards = entityScriptServerSettings[SCRIPT_ENGINE_SHARDS_OPTION].toInt();
+        numShards = std::min(std::max(numShards, 1), MAX_NUM_SCRIPT_ENGINE_SHARDS);
+        if (numShards != _numShards) {
+            qCDebug(entity_script_server) << "Script engine shards changed from" << _numShards << "to" << numShards;
+            _numShards = numShards;
+
+            // entity scripts are redistributed across the new set of engines, which restarts them
+            if (!_shards.empty() && !_shuttingDown) {
+                stopEntitiesScriptEngines();
+                resetEntitiesScriptEngines();
+                reloadAllEntityScripts();
+            }
+        }
+    }
 
     if (!entityScriptServerSettings.contains(MAX_ENTITY_PPS_OPTION) || !entityScriptServerSettings.contains(ENTITY_PPS_PER_SCRIPT)) {
         qWarning() << "Received settings from the domain-server with no max_total_entity_pps or entity_pps_per_script properties.";
@@ -164,7 +200,10 @@ void EntityScriptServer::handleSettings() {
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = 0;
+    for (auto& shard : _shards) {
+        numRunningScripts += shard->engine->getNumRunningEntityScripts();
+    }
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplaction would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -251,8 +290,9 @@ void EntityScriptServer::run() {
         NodeType::EntityServer, NodeType::MessagesMixer, NodeType::AssetServer
     });
 
-    // Setup Script Engine
-    resetEntitiesScriptEngine();
+    // Setup Script Engines
+    resetEntitiesScriptEngines();
+    _rebalanceTimer->start();
 
     // we need to make sure that init has been called for our EntityScriptingInterface
     // so that it actually has a jurisdiction listener when we ask it for it next
@@ -318,12 +358,9 @@ void EntityScriptServer::nodeKilled(SharedNodePointer killedNode) {
     switch (killedNode->getType()) {
         case NodeType::EntityServer: {
             if (!_shuttingDown) {
-                if (_entitiesScriptEngine) {
-                    _entitiesScriptEngine->unloadAllEntityScripts();
-                    _entitiesScriptEngine->stop();
-                }
+                stopEntitiesScriptEngines();
 
-                resetEntitiesScriptEngine();
+                resetEntitiesScriptEngines();
 
                 _entityViewer.clear();
             }
@@ -394,7 +431,7 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
     }
 }
 
-void EntityScriptServer::resetEntitiesScriptEngine() {
+QSharedPointer<ScriptEngine> EntityScriptServer::createEntitiesScriptEngine(bool isPrimary) {
     auto engineName = QString("Entities %1").arg(++_entitiesScriptEngineCount);
     auto newEngine = QSharedPointer<ScriptEngine>(new ScriptEngine(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName));
 
@@ -410,39 +447,202 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
     connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
     connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
-        _entityViewer.queryOctree();
-    });
+    // only one engine needs to drive the octree query
+    if (isPrimary) {
+        connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+            _entityViewer.queryOctree();
+        });
+    }
 
+    connect(newEngine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
 
     newEngine->runInThread();
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngine.data());
 
-    disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
+    return newEngine;
 }
 
+void EntityScriptServer::resetEntitiesScriptEngines() {
+    std::vector<ScriptEngineShardPointer> newShards;
+    for (int i = 0; i < _numShards; ++i) {
+        auto shard = std::make_shared<ScriptEngineShard>();
+        shard->engine = createEntitiesScriptEngine(i == 0);
+        newShards.push_back(shard);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_shardsMutex);
+        _shards.swap(newShards);
+        _loadBalancer = ScriptEngineLoadBalancer(_numShards, _shardFrameBudgetMsecs);
+        _entityShards.clear();
+    }
+
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(this);
+
+    qCDebug(entity_script_server) << "Running entity scripts on" << _numShards << "script engine(s)";
+}
+
+void EntityScriptServer::stopEntitiesScriptEngines() {
+    for (auto& shard : _shards) {
+        disconnect(shard->engine.data(), &ScriptEngine::entityScriptDetailsUpdated, this, &EntityScriptServer::updateEntityPPS);
 
-void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
         // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
+        shard->engine->unloadAllEntityScripts();
+        shard->engine->stop();
+    }
+}
+
+void EntityScriptServer::reloadAllEntityScripts() {
+    if (!_entityViewer.getTree()) {
+        return;
+    }
+
+    QVector<EntityItemID> entityIDs;
+    _entityViewer.getTree()->withReadLock([&] {
+        _entityViewer.getTree()->recurseTreeWithOperation([](OctreeElementPointer element, void* extraData) {
+            auto entityIDs = static_cast<QVector<EntityItemID>*>(extraData);
+            std::static_pointer_cast<EntityTreeElement>(element)->forEachEntity([&](EntityItemPointer entity) {
+                if (!entity->getServerScripts().isEmpty()) {
+                    entityIDs.push_back(entity->getEntityItemID());
+                }
+            });
+            return true;
+        }, &entityIDs);
+    });
+
+    for (auto& entityID : entityIDs) {
+        checkAndCallPreload(entityID);
+    }
+}
+
+int EntityScriptServer::shardIndexForEntity(const EntityItemID& entityID) const {
+    // caller must hold _shardsMutex
+    auto it = _entityShards.constFind(entityID);
+    if (it != _entityShards.constEnd()) {
+        return it.value();
+    }
+
+    // consistent default assignment, so an entity lands on the same shard across reloads
+    return (int)(qHash(entityID) % (uint)_shards.size());
+}
+
+QSharedPointer<ScriptEngine> EntityScriptServer::engineForEntity(const EntityItemID& entityID) const {
+    std::lock_guard<std::mutex> lock(_shardsMutex);
+    if (_shards.empty()) {
+        return QSharedPointer<ScriptEngine>();
+    }
+    return _shards[shardIndexForEntity(entityID)]->engine;
+}
+
+void EntityScriptServer::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                const QStringList& params) {
+    // called from any script engine thread, the engine marshals the call onto its own thread
+    auto engine = engineForEntity(entityID);
+    if (engine) {
+        engine->callEntityScriptMethod(entityID, methodName, params);
+    }
+}
+
+void EntityScriptServer::moveEntityScript(const EntityItemID& entityID, int toShardIndex) {
+    EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
+    if (!entity) {
+        return;
+    }
+
+    QSharedPointer<ScriptEngine> fromEngine;
+    QSharedPointer<ScriptEngine> toEngine;
+    {
+        std::lock_guard<std::mutex> lock(_shardsMutex);
+        fromEngine = _shards[shardIndexForEntity(entityID)]->engine;
+        toEngine = _shards[toShardIndex]->engine;
+        _entityShards[entityID] = toShardIndex;
+    }
+
+    // the script restarts on its new engine, its unload/preload run as for a reload
+    fromEngine->unloadEntityScript(entityID);
+    auto scriptUrl = ResourceManager::normalizeURL(entity->getServerScripts());
+    ScriptEngine::loadEntityScript(toEngine, entityID, scriptUrl, false);
+}
+
+void EntityScriptServer::rebalanceScriptEngines() {
+    if (_shards.empty() || _shuttingDown) {
+        return;
+    }
+
+    // the busy time of each entity script, per frame of its engine
+    std::vector<QHash<EntityItemID, float>> scriptBusyMsecs(_shards.size());
+    for (size_t i = 0; i < _shards.size(); ++i) {
+        auto& engine = _shards[i]->engine;
+        int numFrames;
+        quint64 busyUsecs;
+        engine->takeBusyTime(numFrames, busyUsecs);
+        auto scriptBusyUsecs = engine->takeEntityScriptBusyTime();
+
+        // an engine that produced no frame in the whole window is stalled
+        float averageBusyMsecs = (numFrames > 0) ?
+            (float)busyUsecs / (numFrames * USECS_PER_MSEC) : (float)_rebalanceTimer->interval();
+        _loadBalancer.updateShard((int)i, averageBusyMsecs, engine->getNumRunningEntityScripts());
+
+        for (auto it = scriptBusyUsecs.constBegin(); it != scriptBusyUsecs.constEnd(); ++it) {
+            scriptBusyMsecs[i][it.key()] = (float)it.value() / (std::max(numFrames, 1) * USECS_PER_MSEC);
+        }
+    }
+
+    int from;
+    int to;
+    if (!_loadBalancer.pickMove(from, to)) {
+        return;
     }
 
-    // reset the engine
+    // the costliest script moves, as moving cheap ones would take many windows to make a difference
+    EntityItemID candidate;
+    float candidateBusyMsecs = -1.0f;
+    {
+        std::lock_guard<std::mutex> lock(_shardsMutex);
+        for (auto it = _entityShards.constBegin(); it != _entityShards.constEnd(); ++it) {
+            if (it.value() == from) {
+                float busyMsecs = scriptBusyMsecs[from].value(it.key(), 0.0f);
+                if (busyMsecs > candidateBusyMsecs) {
+                    candidate = it.key();
+                    candidateBusyMsecs = busyMsecs;
+                }
+            }
+        }
+    }
+
+    if (candidate.isNull()) {
+        return;
+    }
+
+    // a script that would overload the target on its own only moves the problem there
+    if (!_loadBalancer.hasHeadroomFor(to, candidateBusyMsecs)) {
+        qCDebug(entity_script_server) << "Shard" << from << "over budget ("
+            << _loadBalancer.getShard(from).averageBusyMsecs << "ms ), but its busiest script" << candidate << "("
+            << candidateBusyMsecs << "ms ) does not fit on shard" << to
+            << "(" << _loadBalancer.getShard(to).averageBusyMsecs << "ms )";
+        return;
+    }
+
+    qCDebug(entity_script_server) << "Shard" << from << "over budget ("
+        << _loadBalancer.getShard(from).averageBusyMsecs << "ms ), moving" << candidate << "("
+        << candidateBusyMsecs << "ms ) to shard" << to << "(" << _loadBalancer.getShard(to).averageBusyMsecs << "ms )";
+    moveEntityScript(candidate, to);
+}
+
+void EntityScriptServer::clear() {
+    // unload and stop the engines
+    stopEntitiesScriptEngines();
+
+    // reset the engines
     if (!_shuttingDown) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
     }
 
     _entityViewer.clear();
 }
 
 void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    for (auto& shard : _shards) {
+        shard->engine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
     }
     _shuttingDown = true;
 
@@ -454,37 +654,68 @@ void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID);
+    auto engine = engineForEntity(entityID);
+    if (_entityViewer.getTree() && !_shuttingDown && engine) {
+        engine->unloadEntityScript(entityID);
+
+        std::lock_guard<std::mutex> lock(_shardsMutex);
+        _entityShards.remove(entityID);
     }
 }
 
 void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID, const bool reload) {
-    if (_entityViewer.getTree() && !_shuttingDown) {
-        _entitiesScriptEngine->unloadEntityScript(entityID);
+    auto engine = engineForEntity(entityID);
+    if (_entityViewer.getTree() && !_shuttingDown && engine) {
+        engine->unloadEntityScript(entityID);
         checkAndCallPreload(entityID, reload);
     }
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, const bool reload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    auto engine = engineForEntity(entityID);
+    if (_entityViewer.getTree() && !_shuttingDown && engine) {
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
         EntityScriptDetails details;
-        bool notRunning = !_entitiesScriptEngine->getEntityScriptDetails(entityID, details);
+        bool notRunning = !engine->getEntityScriptDetails(entityID, details);
         if (entity && (reload || notRunning || details.scriptText != entity->getServerScripts())) {
             QString scriptUrl = entity->getServerScripts();
             if (!scriptUrl.isEmpty()) {
+                {
+                    // pin the assignment so later lookups agree even if the shard count changes
+                    std::lock_guard<std::mutex> lock(_shardsMutex);
+                    _entityShards[entityID] = shardIndexForEntity(entityID);
+                }
                 scriptUrl = ResourceManager::normalizeURL(scriptUrl);
                 qCDebug(entity_script_server) << "Loading entity server script" << scriptUrl << "for" << entityID;
-                ScriptEngine::loadEntityScript(_entitiesScriptEngine, entityID, scriptUrl, reload);
+                ScriptEngine::loadEntityScript(engine, entityID, scriptUrl, reload);
             }
         }
     }
 }
 
 void EntityScriptServer::sendStatsPacket() {
+    QJsonObject statsObject;
+
+    statsObject["num_script_engine_shards"] = (int)_shards.size();
+    statsObject["shard_frame_budget_msecs"] = _shardFrameBudgetMsecs;
+
+    QJsonObject shardsObject;
+    for (size_t i = 0; i < _shards.size(); ++i) {
+        auto& shard = _shards[i];
+        auto& load = _loadBalancer.getShard((int)i);
+        QJsonObject shardStats;
+        shardStats["running_scripts"] = load.numScripts;
+        shardStats["avg_busy_msecs"] = load.averageBusyMsecs;
+        shardStats["windows_over_budget"] = load.numWindowsOverBudget;
+        if (shard->engine) {
+            shardStats["script_profile"] = shard->engine->getProfiler().toJson();
+        }
+        shardsObject[QString("shard_%1").arg(i)] = shardStats;
+    }
+    statsObject["script_engine_shards"] = shardsObject;
 
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -532,6 +763,7 @@ void EntityScriptServer::aboutToFinish() {
 
     // our entity tree is going to go away so tell that to the EntityScriptingInterface
     DependencyManager::get<EntityScriptingInterface>()->setEntityTree(nullptr);
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(nullptr);
 
     ResourceManager::cleanup();
 
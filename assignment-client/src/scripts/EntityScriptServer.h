@@ -12,22 +12,33 @@
 #ifndef hifi_EntityScriptServer_h
 #define hifi_EntityScriptServer_h
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
+#include <QtCore/QTimer>
 #include <QtCore/QUuid>
 
+#include <EntitiesScriptEngineProvider.h>
 #include <EntityEditPacketSender.h>
 #include <EntityTreeHeadlessViewer.h>
 #include <plugins/CodecPlugin.h>
 #include <ScriptEngine.h>
+#include <ScriptEngineLoadBalancer.h>
 #include <ThreadedAssignment.h>
 
 static const int DEFAULT_MAX_ENTITY_PPS = 9000;
 static const int DEFAULT_ENTITY_PPS_PER_SCRIPT = 900;
 
-class EntityScriptServer : public ThreadedAssignment {
+static const int DEFAULT_NUM_SCRIPT_ENGINE_SHARDS = 1;
+static const int MAX_NUM_SCRIPT_ENGINE_SHARDS = 64;
+static const int DEFAULT_SHARD_FRAME_BUDGET_MSECS = (int)(MSECS_PER_SECOND / SCRIPT_FPS);
+
+class EntityScriptServer : public ThreadedAssignment, public EntitiesScriptEngineProvider {
     Q_OBJECT
 
 public:
@@ -36,6 +47,10 @@ public:
 
     virtual void aboutToFinish() override;
 
+    // routes the call to the script engine shard that is running this entity's script
+    virtual void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                        const QStringList& params = QStringList()) override;
+
 public slots:
     void run() override;
     void nodeActivated(SharedNodePointer activatedNode);
@@ -57,11 +72,28 @@ private slots:
 
     void pushLogs();
 
+    void rebalanceScriptEngines();
+
 private:
     void negotiateAudioFormat();
     void selectAudioFormat(const QString& selectedCodecName);
 
-    void resetEntitiesScriptEngine();
+    // a ScriptEngine on its own thread, running a subset of the entity scripts
+    class ScriptEngineShard {
+    public:
+        QSharedPointer<ScriptEngine> engine;
+    };
+    using ScriptEngineShardPointer = std::shared_ptr<ScriptEngineShard>;
+
+    void resetEntitiesScriptEngines();
+    QSharedPointer<ScriptEngine> createEntitiesScriptEngine(bool isPrimary);
+    void stopEntitiesScriptEngines();
+    void reloadAllEntityScripts();
+
+    int shardIndexForEntity(const EntityItemID& entityID) const;
+    QSharedPointer<ScriptEngine> engineForEntity(const EntityItemID& entityID) const;
+    void moveEntityScript(const EntityItemID& entityID, int toShardIndex);
+
     void clear();
     void shutdownScriptEngine();
 
@@ -75,7 +107,17 @@ private:
     bool _shuttingDown { false };
 
     static int _entitiesScriptEngineCount;
-    QSharedPointer<ScriptEngine> _entitiesScriptEngine;
+
+    // guards _shards and _entityShards, which are read from other script engine threads via callEntityScriptMethod
+    mutable std::mutex _shardsMutex;
+    std::vector<ScriptEngineShardPointer> _shards;
+    QHash<EntityItemID, int> _entityShards;
+
+    int _numShards { DEFAULT_NUM_SCRIPT_ENGINE_SHARDS };
+    int _shardFrameBudgetMsecs { DEFAULT_SHARD_FRAME_BUDGET_MSECS };
+    ScriptEngineLoadBalancer _loadBalancer { DEFAULT_NUM_SCRIPT_ENGINE_SHARDS, DEFAULT_SHARD_FRAME_BUDGET_MSECS };
+    QTimer* _rebalanceTimer { nullptr };
+
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
 
@@ -11,22 +11,68 @@
 
 #include "DomainGatekeeper.h"
 
+#include <algorithm>
+
 #include <openssl/err.h>
 #include <openssl/rsa.h>
 #include <openssl/x509.h>
 
 #include <AccountManager.h>
 #include <Assignment.h>
+#include <NumericalConstants.h>
 
 #include "DomainServer.h"
 #include "DomainServerNodeData.h"
 
 using SharedAssignmentPointer = QSharedPointer<Assignment>;
 
+const QString ADMISSION_RATE = "security.admission_rate";
+const int ADMISSION_INTERVAL_MSECS = 50;
+
+// with this many username signatures waiting on the pool, a login is stalled as if its public key had not arrived yet,
+// so that a crowd logging in at once can't pile up RSA work. The agent tries again on its next check in.
+const int MAX_PENDING_VERIFICATIONS = 1024;
+
+class UserSignatureVerification : public QRunnable {
+public:
+    UserSignatureVerification(DomainGatekeeper* gatekeeper, const HifiSockAddr& senderSockAddr,
+            const QByteArray& usernameWithToken, const QByteArray& usernameSignature,
+            DomainGatekeeper::SharedUserPublicKey publicKey) :
+        _gatekeeper(gatekeeper),
+        _senderSockAddr(senderSockAddr),
+        _usernameWithToken(usernameWithToken),
+        _usernameSignature(usernameSignature),
+        _publicKey(publicKey) {}
+
+    void run() override;
+
+private:
+    DomainGatekeeper* _gatekeeper;
+    HifiSockAddr _senderSockAddr;
+    QByteArray _usernameWithToken;
+    QByteArray _usernameSignature;
+    DomainGatekeeper::SharedUserPublicKey _publicKey;
+};
+
+void UserSignatureVerification::run() {
+    int decryptResult;
+    {
+        std::lock_guard<std::mutex> lock(_publicKey->mutex);
+        decryptResult = RSA_verify(NID_sha256,
+                                   reinterpret_cast<const unsigned char*>(_usernameWithToken.constData()),
+                                   _usernameWithToken.size(),
+                                   reinterpret_cast<const unsigned char*>(_usernameSignature.constData()),
+                                   _usernameSignature.size(),
+                                   _publicKey->rsa);
+    }
+
+    _gatekeeper->userSignatureVerified(_senderSockAddr, decryptResult == 1);
+}
+
 DomainGatekeeper::DomainGatekeeper(DomainServer* server) :
     _server(server)
 {
-
+    connect(&_admissionTimer, &QTimer::timeout, this, &DomainGatekeeper::admitQueuedConnections);
 }
 
 void DomainGatekeeper::addPendingAssignedNode(const QUuid& nodeUUID, const QUuid& assignmentUUID,
@@ -83,10 +129,9 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
     // check if this connect request matches an assignment in the queue
     auto pendingAssignment = _pendingAssignedNodes.find(nodeConnection.connectUUID);
 
-    SharedNodePointer node;
-
     if (pendingAssignment != _pendingAssignedNodes.end()) {
-        node = processAssignmentConnectRequest(nodeConnection, pendingAssignment->second);
+        SharedNodePointer node = processAssignmentConnectRequest(nodeConnection, pendingAssignment->second);
+        connectNode(node, nodeConnection);
     } else if (!STATICALLY_ASSIGNED_NODES.contains(nodeConnection.nodeType)) {
         QString username;
         QByteArray usernameSignature;
@@ -101,13 +146,18 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
             }
         }
 
-        node = processAgentConnectRequest(nodeConnection, username, usernameSignature);
+        // the node is connected once it is admitted from the queue
+        processAgentConnectRequest(nodeConnection, username, usernameSignature);
+    } else {
+        connectNode(SharedNodePointer(), nodeConnection);
     }
+}
 
+void DomainGatekeeper::connectNode(const SharedNodePointer& node, const NodeConnectionData& nodeConnection) {
     if (node) {
         // set the sending sock addr and node interest set on this node
         DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-        nodeData->setSendingSockAddr(message->getSenderSockAddr());
+        nodeData->setSendingSockAddr(nodeConnection.senderSockAddr);
 
         // guard against patched agents asking to hear about other agents
         auto safeInterestSet = nodeConnection.interestList.toSet();
@@ -119,14 +169,14 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
         nodeData->setPlaceName(nodeConnection.placeName);
 
         qDebug() << "Allowed connection from node" << uuidStringWithoutCurlyBraces(node->getUUID())
-            << "on" << message->getSenderSockAddr() << "with MAC" << nodeConnection.hardwareAddress
+            << "on" << nodeConnection.senderSockAddr << "with MAC" << nodeConnection.hardwareAddress
             << "and machine fingerprint" << nodeConnection.machineFingerprint;
 
         // signal that we just connected a node so the DomainServer can get it a list
         // and broadcast its presence right away
         emit connectedNode(node);
     } else {
-        qDebug() << "Refusing connection from node at" << message->getSenderSockAddr()
+        qDebug() << "Refusing connection from node at" << nodeConnection.senderSockAddr
             << "with hardware address" << nodeConnection.hardwareAddress
             << "and machine fingerprint" << nodeConnection.machineFingerprint;
     }
@@ -364,49 +414,119 @@ SharedNodePointer DomainGatekeeper::processAssignmentConnectRequest(const NodeCo
 const QString MAXIMUM_USER_CAPACITY = "security.maximum_user_capacity";
 const QString MAXIMUM_USER_CAPACITY_REDIRECT_LOCATION = "security.maximum_user_capacity_redirect_location";
 
-SharedNodePointer DomainGatekeeper::processAgentConnectRequest(const NodeConnectionData& nodeConnection,
-                                                               const QString& username,
-                                                               const QByteArray& usernameSignature) {
-
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+void DomainGatekeeper::processAgentConnectRequest(const NodeConnectionData& nodeConnection,
+                                                  const QString& username,
+                                                  const QByteArray& usernameSignature) {
+    auto pendingIt = _pendingConnections.find(nodeConnection.senderSockAddr);
+    if (pendingIt != _pendingConnections.end()) {
+        // a queued agent may have re-discovered its sockets since, admit it with the latest
+        if (pendingIt->isQueued && pendingIt->username == username) {
+            pendingIt->nodeConnection = nodeConnection;
+        }
+        return;
+    }
 
-    // start with empty permissions
-    NodePermissions userPerms(NodePermissionsKey(username, 0));
-    userPerms.setAll(false);
+    PendingConnection connection;
+    connection.nodeConnection = nodeConnection;
+    connection.username = username;
+    connection.receivedUsecs = usecTimestampNow();
 
-    // check if this user is on our local machine - if this is true set permissions to those for a "localhost" connection
-    QHostAddress senderHostAddress = nodeConnection.senderSockAddr.getAddress();
-    bool isLocalUser =
-        (senderHostAddress == limitedNodeList->getLocalSockAddr().getAddress() || senderHostAddress == QHostAddress::LocalHost);
+    if (username.isEmpty()) {
+        // an anonymous connection attempt
+        queueAdmission(connection);
+        return;
+    }
 
-    QString verifiedUsername; // if this remains empty, consider this an anonymous connection attempt
-    if (!username.isEmpty()) {
-        if (usernameSignature.isEmpty()) {
-            // user is attempting to prove their identity to us, but we don't have enough information
-            sendConnectionTokenPacket(username, nodeConnection.senderSockAddr);
-            // ask for their public key right now to make sure we have it
-            requestUserPublicKey(username);
-            getGroupMemberships(username); // optimistically get started on group memberships
+    if (usernameSignature.isEmpty()) {
+        // user is attempting to prove their identity to us, but we don't have enough information
+        sendConnectionTokenPacket(username, nodeConnection.senderSockAddr);
+        // ask for their public key right now to make sure we have it
+        requestUserPublicKey(username);
+        getGroupMemberships(username); // optimistically get started on group memberships
 #ifdef WANT_DEBUG
-            qDebug() << "stalling login because we have no username-signature:" << username;
+        qDebug() << "stalling login because we have no username-signature:" << username;
 #endif
-            return SharedNodePointer();
-        } else if (verifyUserSignature(username, usernameSignature, nodeConnection.senderSockAddr)) {
-            // they sent us a username and the signature verifies it
-            getGroupMemberships(username);
-            verifiedUsername = username;
-        } else {
-            // they sent us a username, but it didn't check out
-            requestUserPublicKey(username);
+        return;
+    }
+
+    if (startUserSignatureVerification(username, usernameSignature, nodeConnection.senderSockAddr)) {
+        // admission continues in processVerifiedSignatures
+        _pendingConnections.insert(nodeConnection.senderSockAddr, connection);
+    } else {
+        // they sent us a username, but we can't check it yet
+        requestUserPublicKey(username);
 #ifdef WANT_DEBUG
-            qDebug() << "stalling login because signature verification failed:" << username;
+        qDebug() << "stalling login because signature verification could not start:" << username;
 #endif
-            return SharedNodePointer();
+    }
+}
+
+void DomainGatekeeper::queueAdmission(PendingConnection& connection) {
+    connection.isQueued = true;
+    _pendingConnections.insert(connection.nodeConnection.senderSockAddr, connection);
+    _admissionQueue.push_back(connection.nodeConnection.senderSockAddr);
+
+    if (getAdmissionRate() <= 0.0f) {
+        admitQueuedConnections();
+    } else if (!_admissionTimer.isActive()) {
+        _lastAdmissionUsecs = usecTimestampNow();
+        _admissionTimer.start(ADMISSION_INTERVAL_MSECS);
+    }
+}
+
+float DomainGatekeeper::getAdmissionRate() const {
+    const QVariant* admissionRateVariant = valueForKeyPath(_server->_settingsManager.getSettingsMap(), ADMISSION_RATE);
+    return admissionRateVariant ? admissionRateVariant->toFloat() : 0.0f;
+}
+
+void DomainGatekeeper::admitQueuedConnections() {
+    float admissionRate = getAdmissionRate();
+    quint64 now = usecTimestampNow();
+
+    if (admissionRate > 0.0f) {
+        // allow bursts of up to a second's worth of admissions after a quiet period
+        _admissionBudget += admissionRate * (float)(now - _lastAdmissionUsecs) / (float)USECS_PER_SECOND;
+        _admissionBudget = std::min(_admissionBudget, std::max(admissionRate, 1.0f));
+    }
+    _lastAdmissionUsecs = now;
+
+    while (!_admissionQueue.empty() && (admissionRate <= 0.0f || _admissionBudget >= 1.0f)) {
+        PendingConnection connection = _pendingConnections.take(_admissionQueue.front());
+        _admissionQueue.pop_front();
+
+        SharedNodePointer node = admitAgent(connection);
+        connectNode(node, connection.nodeConnection);
+
+        if (node) {
+            ++_numAdmitted;
+        }
+        _admissionWaitStats.update(usecTimestampNow() - connection.receivedUsecs);
+
+        if (admissionRate > 0.0f) {
+            _admissionBudget -= 1.0f;
         }
     }
 
-    userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, nodeConnection.senderSockAddr.getAddress(),
-                                      nodeConnection.hardwareAddress, nodeConnection.machineFingerprint);
+    if (_admissionQueue.empty()) {
+        _admissionTimer.stop();
+    }
+}
+
+SharedNodePointer DomainGatekeeper::admitAgent(const PendingConnection& connection) {
+    const NodeConnectionData& nodeConnection = connection.nodeConnection;
+    const QString& username = connection.username;
+    const QString& verifiedUsername = connection.verifiedUsername;
+
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+
+    // check if this user is on our local machine - if this is true set permissions to those for a "localhost" connection
+    QHostAddress senderHostAddress = nodeConnection.senderSockAddr.getAddress();
+    bool isLocalUser =
+        (senderHostAddress == limitedNodeList->getLocalSockAddr().getAddress() || senderHostAddress == QHostAddress::LocalHost);
+
+    NodePermissions userPerms = setPermissionsForUser(isLocalUser, verifiedUsername,
+                                                      nodeConnection.senderSockAddr.getAddress(),
+                                                      nodeConnection.hardwareAddress, nodeConnection.machineFingerprint);
 
     if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
         sendConnectionDeniedPacket("You lack the required permissions to connect to this domain.",
@@ -510,72 +630,83 @@ SharedNodePointer DomainGatekeeper::addVerifiedNodeFromConnectRequest(const Node
     return newNode;
 }
 
-bool DomainGatekeeper::verifyUserSignature(const QString& username,
-                                           const QByteArray& usernameSignature,
-                                           const HifiSockAddr& senderSockAddr) {
+bool DomainGatekeeper::startUserSignatureVerification(const QString& username,
+                                                      const QByteArray& usernameSignature,
+                                                      const HifiSockAddr& senderSockAddr) {
     // it's possible this user can be allowed to connect, but we need to check their username signature
     auto lowerUsername = username.toLower();
-    QByteArray publicKeyArray = _userPublicKeys.value(lowerUsername);
+    SharedUserPublicKey publicKey = _userPublicKeys.value(lowerUsername);
 
     const QUuid& connectionToken = _connectionTokenHash.value(lowerUsername);
 
-    if (!publicKeyArray.isEmpty() && !connectionToken.isNull()) {
-        // if we do have a public key for the user, check for a signature match
+    if (!publicKey || connectionToken.isNull()) {
+        qDebug() << "Insufficient data to decrypt username signature - delaying connection.";
+        return false;
+    }
 
-        const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(publicKeyArray.constData());
+    if (_numPendingVerifications >= MAX_PENDING_VERIFICATIONS) {
+        qDebug() << "Too many username signatures waiting for verification - delaying connection.";
+        return false;
+    }
 
-        // first load up the public key into an RSA struct
-        RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, publicKeyArray.size());
+    QByteArray lowercaseUsernameUTF8 = lowerUsername.toUtf8();
+    QByteArray usernameWithToken = QCryptographicHash::hash(lowercaseUsernameUTF8.append(connectionToken.toRfc4122()),
+                                                            QCryptographicHash::Sha256);
+
+    // keep RSA verification off the main thread, which also serves domain list requests of connected nodes
+    ++_numPendingVerifications;
+    _verificationPool.start(new UserSignatureVerification(this, senderSockAddr, usernameWithToken, usernameSignature,
+                                                          publicKey));
+    return true;
+}
 
-        QByteArray lowercaseUsernameUTF8 = lowerUsername.toUtf8();
-        QByteArray usernameWithToken = QCryptographicHash::hash(lowercaseUsernameUTF8.append(connectionToken.toRfc4122()),
-                                                                QCryptographicHash::Sha256);
+void DomainGatekeeper::userSignatureVerified(const HifiSockAddr& senderSockAddr, bool verified) {
+    _signatureResults.push({ senderSockAddr, verified });
+    QMetaObject::invokeMethod(this, "processVerifiedSignatures", Qt::QueuedConnection);
+}
 
-        if (rsaPublicKey) {
-            int decryptResult = RSA_verify(NID_sha256,
-                                           reinterpret_cast<const unsigned char*>(usernameWithToken.constData()),
-                                           usernameWithToken.size(),
-                                           reinterpret_cast<const unsigned char*>(usernameSignature.constData()),
-                                           usernameSignature.size(),
-                                           rsaPublicKey);
-
-            if (decryptResult == 1) {
-                qDebug() << "Username signature matches for" << username;
-
-                // free up the public key and remove connection token before we return
-                RSA_free(rsaPublicKey);
-                _connectionTokenHash.remove(username);
-
-                return true;
-
-            } else {
-                if (!senderSockAddr.isNull()) {
-                    qDebug() << "Error decrypting username signature for " << username << "- denying connection.";
-                    sendConnectionDeniedPacket("Error decrypting username signature.", senderSockAddr,
-                        DomainHandler::ConnectionRefusedReason::LoginError);
-                }
+void DomainGatekeeper::processVerifiedSignatures() {
+    SignatureResult result;
+    while (_signatureResults.try_pop(result)) {
+        --_numPendingVerifications;
 
-                // free up the public key, we don't need it anymore
-                RSA_free(rsaPublicKey);
-            }
+        auto it = _pendingConnections.find(result.senderSockAddr);
+        if (it == _pendingConnections.end()) {
+            continue;
+        }
+        PendingConnection& connection = it.value();
+
+        if (result.verified) {
+            qDebug() << "Username signature matches for" << connection.username;
 
+            // they sent us a username and the signature verifies it
+            _connectionTokenHash.remove(connection.username.toLower());
+            getGroupMemberships(connection.username);
+            connection.verifiedUsername = connection.username;
+
+            queueAdmission(connection);
         } else {
+            qDebug() << "Error decrypting username signature for " << connection.username << "- denying connection.";
+            sendConnectionDeniedPacket("Error decrypting username signature.", result.senderSockAddr,
+                DomainHandler::ConnectionRefusedReason::LoginError);
 
-            // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-            if (!senderSockAddr.isNull()) {
-                qDebug() << "Couldn't convert data to RSA key for" << username << "- denying connection.";
-                sendConnectionDeniedPacket("Couldn't convert data to RSA key.", senderSockAddr,
-                    DomainHandler::ConnectionRefusedReason::LoginError);
-            }
-        }
-    } else {
-        if (!senderSockAddr.isNull()) {
-            qDebug() << "Insufficient data to decrypt username signature - delaying connection.";
+            ++_numFailedVerifications;
+            requestUserPublicKey(connection.username); // no joy.  maybe next time?
+            _pendingConnections.erase(it);
         }
     }
+}
 
-    requestUserPublicKey(username); // no joy.  maybe next time?
-    return false;
+QJsonObject DomainGatekeeper::getAdmissionStats() const {
+    QJsonObject statsObject;
+    statsObject["admission_rate"] = getAdmissionRate();
+    statsObject["queue_depth"] = (int)_admissionQueue.size();
+    statsObject["pending_verifications"] = _numPendingVerifications;
+    statsObject["admitted"] = (double)_numAdmitted;
+    statsObject["failed_verifications"] = (double)_numFailedVerifications;
+    statsObject["wait_usecs_avg"] = _admissionWaitStats.getWindowAverage();
+    statsObject["wait_usecs_max"] = (double)_admissionWaitStats.getWindowMax();
+    return statsObject;
 }
 
 bool DomainGatekeeper::isWithinMaxCapacity() {
@@ -661,8 +792,19 @@ void DomainGatekeeper::publicKeyJSONCallback(QNetworkReply& requestReply) {
         const QString JSON_DATA_KEY = "data";
         const QString JSON_PUBLIC_KEY_KEY = "public_key";
 
-        _userPublicKeys[username.toLower()] =
+        QByteArray publicKeyArray =
             QByteArray::fromBase64(jsonObject[JSON_DATA_KEY].toObject()[JSON_PUBLIC_KEY_KEY].toString().toUtf8());
+
+        // load up the public key into an RSA struct once, rather than for every connect request
+        const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(publicKeyArray.constData());
+        RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, publicKeyArray.size());
+
+        if (rsaPublicKey) {
+            _userPublicKeys[username] = std::make_shared<UserPublicKey>(rsaPublicKey);
+        } else {
+            qDebug() << "Couldn't convert data to RSA key for" << username;
+            _userPublicKeys.remove(username);
+        }
     }
 
     _inFlightPublicKeyRequests.remove(username);
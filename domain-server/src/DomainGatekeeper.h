@@ -14,13 +14,23 @@
 #ifndef hifi_DomainGatekeeper_h
 #define hifi_DomainGatekeeper_h
 
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
+#include <QtCore/QJsonObject>
 #include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
 
+#include <openssl/rsa.h>
+#include <tbb/concurrent_queue.h>
+
 #include <DomainHandler.h>
 
+#include <MovingMinMaxAvg.h>
 #include <NLPacket.h>
 #include <Node.h>
 #include <UUIDHasher.h>
@@ -44,6 +54,12 @@ public:
     void removeICEPeer(const QUuid& peerUUID) { _icePeers.remove(peerUUID); }
 
     static void sendProtocolMismatchConnectionDenial(const HifiSockAddr& senderSockAddr);
+
+    // hands the outcome of a username signature check from a pool thread over to the main thread, which admits or denies
+    void userSignatureVerified(const HifiSockAddr& senderSockAddr, bool verified);
+
+    QJsonObject getAdmissionStats() const;
+
 public slots:
     void processConnectRequestPacket(QSharedPointer<ReceivedMessage> message);
     void processICEPingPacket(QSharedPointer<ReceivedMessage> message);
@@ -70,17 +86,54 @@ public slots:
 
 private slots:
     void handlePeerPingTimeout();
+    void processVerifiedSignatures();
+    void admitQueuedConnections();
+
 private:
+    friend class UserSignatureVerification;
+
+    // decoded once when it arrives from the API, verifications using the same key are serialized on its mutex
+    class UserPublicKey {
+    public:
+        UserPublicKey(RSA* rsa) : rsa(rsa) {}
+        ~UserPublicKey() { RSA_free(rsa); }
+
+        RSA* rsa;
+        std::mutex mutex;
+    };
+    using SharedUserPublicKey = std::shared_ptr<UserPublicKey>;
+
+    // an agent connect request, from its arrival until its node is added or it is refused
+    class PendingConnection {
+    public:
+        NodeConnectionData nodeConnection;
+        QString username;
+        QString verifiedUsername;
+        quint64 receivedUsecs { 0 };
+        bool isQueued { false };
+    };
+
+    class SignatureResult {
+    public:
+        HifiSockAddr senderSockAddr;
+        bool verified;
+    };
+
+    void connectNode(const SharedNodePointer& node, const NodeConnectionData& nodeConnection);
+
     SharedNodePointer processAssignmentConnectRequest(const NodeConnectionData& nodeConnection,
                                                       const PendingAssignedNodeData& pendingAssignment);
-    SharedNodePointer processAgentConnectRequest(const NodeConnectionData& nodeConnection,
-                                                 const QString& username,
-                                                 const QByteArray& usernameSignature);
+    void processAgentConnectRequest(const NodeConnectionData& nodeConnection,
+                                    const QString& username,
+                                    const QByteArray& usernameSignature);
+    SharedNodePointer admitAgent(const PendingConnection& connection);
     SharedNodePointer addVerifiedNodeFromConnectRequest(const NodeConnectionData& nodeConnection,
                                                         QUuid nodeID = QUuid());
     
-    bool verifyUserSignature(const QString& username, const QByteArray& usernameSignature,
-                             const HifiSockAddr& senderSockAddr);
+    bool startUserSignatureVerification(const QString& username, const QByteArray& usernameSignature,
+                                        const HifiSockAddr& senderSockAddr);
+    void queueAdmission(PendingConnection& connection);
+    float getAdmissionRate() const;
     bool isWithinMaxCapacity();
     
     bool shouldAllowConnectionFromNode(const QString& username, const QByteArray& usernameSignature,
@@ -102,7 +155,7 @@ private:
     QHash<QUuid, SharedNetworkPeer> _icePeers;
     
     QHash<QString, QUuid> _connectionTokenHash;
-    QHash<QString, QByteArray> _userPublicKeys;
+    QHash<QString, SharedUserPublicKey> _userPublicKeys;
     QSet<QString> _inFlightPublicKeyRequests; // keep track of which we've already asked for
     QSet<QString> _domainOwnerFriends; // keep track of friends of the domain owner
     QSet<QString> _inFlightGroupMembershipsRequests; // keep track of which we've already asked for
@@ -113,6 +166,24 @@ private:
     void getGroupMemberships(const QString& username);
     // void getIsGroupMember(const QString& username, const QUuid groupID);
     void getDomainOwnerFriendsList();
+
+    // agents re-send their connect request until they hear back, while one is pending the others are dropped
+    QHash<HifiSockAddr, PendingConnection> _pendingConnections;
+    std::deque<HifiSockAddr> _admissionQueue;
+    QTimer _admissionTimer;
+    quint64 _lastAdmissionUsecs { 0 };
+    float _admissionBudget { 0.0f };
+
+    int _numPendingVerifications { 0 }; // started and not yet processed, only touched by the main thread
+    tbb::concurrent_queue<SignatureResult> _signatureResults; // pushed to by the pool, popped by processVerifiedSignatures
+
+    quint64 _numAdmitted { 0 };
+    quint64 _numFailedVerifications { 0 };
+    MovingMinMaxAvg<quint64> _admissionWaitStats { 1, 100 };
+
+    // destroying the pool waits for the verifications still running, which push to _signatureResults,
+    // so it has to go first, hence after every other member
+    QThreadPool _verificationPool;
 };
 
 
@@ -211,6 +211,11 @@ void DomainServer::parseCommandLine() {
     const QCommandLineOption masterConfigOption("master-config", "Deprecated config-file option");
     parser.addOption(masterConfigOption);
 
+    // read into the settings along with the other command-line parameters, points the domain-server at a local
+    // stand-in for the metaverse API when testing
+    const QCommandLineOption oauthProviderOption("oauth-provider", "metaverse API URL", "URL");
+    parser.addOption(oauthProviderOption);
+
 
     if (!parser.parse(QCoreApplication::arguments())) {
         qWarning() << parser.errorText() << endl;
@@ -1794,6 +1799,15 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             // send the response
             connection->respond(HTTPConnection::StatusCode200, nodesDocument.toJson(), qPrintable(JSON_MIME_TYPE));
 
+            return true;
+        } else if (url.path() == "/stats.json") {
+            // stats of the domain-server itself
+            QJsonObject rootJSON;
+            rootJSON["admission"] = _gatekeeper.getAdmissionStats();
+
+            QJsonDocument statsDocument(rootJSON);
+            connection->respond(HTTPConnection::StatusCode200, statsDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+
             return true;
         } else {
             // check if this is for json stats for a node
@@ -34,6 +34,7 @@ int main(int argc, char* argv[]) {
 #endif
 
     qInstallMessageHandler(LogHandler::verboseMessageHandler);
+    LogHandler::getInstance().setAsyncOutput(true);
     qInfo() << "Starting.";
 
     int currentExitCode = 0;
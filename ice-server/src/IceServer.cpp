@@ -11,8 +11,13 @@
 
 #include "IceServer.h"
 
+#include <algorithm>
+
+#include <openssl/rsa.h>
 #include <openssl/x509.h>
 
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
@@ -21,18 +26,81 @@
 #include <LimitedNodeList.h>
 #include <NetworkAccessManager.h>
 #include <NetworkingConstants.h>
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 
 const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
 const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
 
+const quint64 VERIFIED_HEARTBEAT_LIFETIME_USECS = 60 * USECS_PER_SECOND;
+
+// heartbeats beyond this are dropped unanswered rather than queued, their domains retry on their next heartbeat
+const int MAX_PENDING_VERIFICATIONS = 4096;
+
+class HeartbeatVerification : public QRunnable {
+public:
+    HeartbeatVerification(IceServer* server, IceServer::Heartbeat heartbeat, QByteArray publicKey) :
+        _server(server), _heartbeat(std::move(heartbeat)), _publicKey(publicKey) {}
+
+    void run() override;
+
+private:
+    IceServer* _server;
+    IceServer::Heartbeat _heartbeat;
+    QByteArray _publicKey;
+};
+
+void HeartbeatVerification::run() {
+    const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(_publicKey.constData());
+    RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, _publicKey.size());
+
+    if (rsaPublicKey) {
+        auto hashedPlaintext = QCryptographicHash::hash(_heartbeat.plaintext, QCryptographicHash::Sha256);
+        int verificationResult = RSA_verify(NID_sha256,
+                                            reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
+                                            hashedPlaintext.size(),
+                                            reinterpret_cast<const unsigned char*>(_heartbeat.signature.constData()),
+                                            _heartbeat.signature.size(),
+                                            rsaPublicKey);
+        RSA_free(rsaPublicKey);
+
+        _heartbeat.verified = (verificationResult == 1);
+    }
+
+    _server->heartbeatVerified(std::move(_heartbeat));
+}
+
 IceServer::IceServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
     _id(QUuid::createUuid()),
     _serverSocket(0, false),
-    _activePeers()
+    _activePeers(),
+    _metaverseURL(NetworkingConstants::METAVERSE_SERVER_URL)
 {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity ICE server");
+    parser.addHelpOption();
+
+    const QCommandLineOption metaverseURLOption("metaverse-url", "URL of the API to request domain public keys from", "URL");
+    parser.addOption(metaverseURLOption);
+
+    const QCommandLineOption verificationThreadsOption("verification-threads",
+        "number of threads verifying heartbeat signatures", "threads");
+    parser.addOption(verificationThreadsOption);
+
+    parser.process(*this);
+
+    if (parser.isSet(metaverseURLOption)) {
+        _metaverseURL = QUrl(parser.value(metaverseURLOption));
+        qDebug() << "Requesting domain public keys from" << _metaverseURL;
+    }
+
+    if (parser.isSet(verificationThreadsOption)) {
+        _verificationPool.setMaxThreadCount(std::max(parser.value(verificationThreadsOption).toInt(), 1));
+    }
+    qDebug() << "Verifying heartbeats on" << _verificationPool.maxThreadCount() << "threads";
+
     // start the ice-server socket
     qDebug() << "ice-server socket is listening on" << ICE_SERVER_DEFAULT_PORT;
     _serverSocket.bind(QHostAddress::AnyIPv4, ICE_SERVER_DEFAULT_PORT);
@@ -73,20 +141,7 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     if (nlPacket->getPayloadSize() >= NLPacket::localHeaderSize(PacketType::ICEServerHeartbeat)) {
         
         if (nlPacket->getType() == PacketType::ICEServerHeartbeat) {
-            SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(*nlPacket);
-            if (peer) {
-                // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
-                peer->activateMatchingOrNewSymmetricSocket(nlPacket->getSenderSockAddr());
-
-                // we have an active and verified heartbeating peer
-                // send them an ACK packet so they know that they are being heard and ready for ICE
-                static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
-                _serverSocket.writePacket(*ackPacket, nlPacket->getSenderSockAddr());
-            } else {
-                // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
-                static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
-                _serverSocket.writePacket(*deniedPacket, nlPacket->getSenderSockAddr());
-            }
+            processHeartbeat(*nlPacket);
         } else if (nlPacket->getType() == PacketType::ICEServerQuery) {
             QDataStream heartbeatStream(nlPacket.get());
             
@@ -123,92 +178,134 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     }
 }
 
-SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
+void IceServer::processHeartbeat(NLPacket& packet) {
+    Heartbeat heartbeat;
+    heartbeat.senderSocket = packet.getSenderSockAddr();
 
     // pull the UUID, public and private sock addrs for this peer
-    QUuid senderUUID;
-    HifiSockAddr publicSocket, localSocket;
-    QByteArray signature;
-
     QDataStream heartbeatStream(&packet);
-    heartbeatStream >> senderUUID >> publicSocket >> localSocket;
+    heartbeatStream >> heartbeat.domainID >> heartbeat.publicSocket >> heartbeat.localSocket;
 
-    auto signedPlaintext = QByteArray::fromRawData(packet.getPayload(), heartbeatStream.device()->pos());
-    heartbeatStream >> signature;
+    // copied, since it may outlive the packet in the verification pool
+    heartbeat.plaintext = QByteArray(packet.getPayload(), heartbeatStream.device()->pos());
+    heartbeatStream >> heartbeat.signature;
 
-    // make sure this is a verified heartbeat before performing any more processing
-    if (isVerifiedHeartbeat(senderUUID, signedPlaintext, signature)) {
-        // make sure we have this sender in our peer hash
-        SharedNetworkPeer matchingPeer = _activePeers.value(senderUUID);
+    // make sure we're not already waiting for a public key for this domain-server
+    if (_pendingPublicKeyRequests.contains(heartbeat.domainID)) {
+        denyHeartbeat(heartbeat.senderSocket);
+        return;
+    }
 
-        if (!matchingPeer) {
-            // if we don't have this sender we need to create them now
-            matchingPeer = QSharedPointer<NetworkPeer>::create(senderUUID, publicSocket, localSocket);
-            _activePeers.insert(senderUUID, matchingPeer);
+    // check if we have a public key for this domain ID - if we do not then fire off the request for it
+    auto it = _domainPublicKeys.find(heartbeat.domainID);
+    if (it == _domainPublicKeys.end()) {
+        requestDomainPublicKey(heartbeat.domainID);
+        denyHeartbeat(heartbeat.senderSocket);
+        return;
+    }
+    heartbeat.keyFingerprint = it->second.fingerprint;
 
-            qDebug() << "Added a new network peer" << *matchingPeer;
-        } else {
-            // we already had the peer so just potentially update their sockets
-            matchingPeer->setPublicSocket(publicSocket);
-            matchingPeer->setLocalSocket(localSocket);
-        }
+    if (isCachedHeartbeat(heartbeat)) {
+        acceptHeartbeat(heartbeat);
+        return;
+    }
 
-        // update our last heard microstamp for this network peer to now
-        matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
-        
-        return matchingPeer;
-    } else {
-        // not verified, return the empty peer object
-        return SharedNetworkPeer();
+    if (_numPendingVerifications >= MAX_PENDING_VERIFICATIONS) {
+        return;
     }
+
+    // hashing and RSA verification are the bulk of the work for a heartbeat, keep them off the socket thread
+    ++_numPendingVerifications;
+    _verificationPool.start(new HeartbeatVerification(this, std::move(heartbeat), it->second.key));
 }
 
-bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature) {
-    // make sure we're not already waiting for a public key for this domain-server
-    if (!_pendingPublicKeyRequests.contains(domainID)) {
-        // check if we have a public key for this domain ID - if we do not then fire off the request for it
-        auto it = _domainPublicKeys.find(domainID);
-        if (it != _domainPublicKeys.end()) {
-
-            // attempt to verify the signature for this heartbeat
-            const auto rsaPublicKey = it->second.get();
-
-            if (rsaPublicKey) {
-                auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
-                int verificationResult = RSA_verify(NID_sha256,
-                                                    reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
-                                                    hashedPlaintext.size(),
-                                                    reinterpret_cast<const unsigned char*>(signature.constData()),
-                                                    signature.size(),
-                                                    rsaPublicKey);
-
-                if (verificationResult == 1) {
-                    // this is the only success case - we return true here to indicate that the heartbeat is verified
-                    return true;
-                } else {
-                    qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
-                }
+void IceServer::heartbeatVerified(Heartbeat heartbeat) {
+    _verificationResults.push(std::move(heartbeat));
+    QMetaObject::invokeMethod(this, "processVerifiedHeartbeats", Qt::QueuedConnection);
+}
 
-            } else {
-                // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-                qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
-                qWarning() << "Re-requesting public key from API";
+void IceServer::processVerifiedHeartbeats() {
+    Heartbeat heartbeat;
+    while (_verificationResults.try_pop(heartbeat)) {
+        --_numPendingVerifications;
+
+        if (heartbeat.verified) {
+            _verifiedHeartbeats[heartbeat.domainID] = {
+                heartbeat.keyFingerprint, heartbeat.plaintext, heartbeat.signature, usecTimestampNow()
+            };
+            acceptHeartbeat(heartbeat);
+        } else {
+            // we could not verify this heartbeat (could not load public key, stale public key, bad actor)
+            // ask the metaverse API for the right public key
+            qDebug() << "Failed to verify heartbeat for" << heartbeat.domainID << "- re-requesting public key from API.";
+
+            if (!_pendingPublicKeyRequests.contains(heartbeat.domainID)) {
+                requestDomainPublicKey(heartbeat.domainID);
             }
+            denyHeartbeat(heartbeat.senderSocket);
         }
+    }
+}
 
-        // we could not verify this heartbeat (missing public key, could not load public key, bad actor)
-        // ask the metaverse API for the right public key and return false to indicate that this is not verified
-        requestDomainPublicKey(domainID);
+bool IceServer::isCachedHeartbeat(const Heartbeat& heartbeat) const {
+    auto it = _verifiedHeartbeats.find(heartbeat.domainID);
+    if (it == _verifiedHeartbeats.end()) {
+        return false;
     }
 
-    return false;
+    const VerifiedHeartbeat& verified = it->second;
+    return verified.keyFingerprint == heartbeat.keyFingerprint &&
+        verified.plaintext == heartbeat.plaintext &&
+        verified.signature == heartbeat.signature &&
+        (usecTimestampNow() - verified.verifiedUsecs) < VERIFIED_HEARTBEAT_LIFETIME_USECS;
+}
+
+void IceServer::acceptHeartbeat(const Heartbeat& heartbeat) {
+    SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(heartbeat);
+
+    // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
+    peer->activateMatchingOrNewSymmetricSocket(heartbeat.senderSocket);
+
+    // we have an active and verified heartbeating peer
+    // send them an ACK packet so they know that they are being heard and ready for ICE
+    static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
+    _serverSocket.writePacket(*ackPacket, heartbeat.senderSocket);
+}
+
+void IceServer::denyHeartbeat(const HifiSockAddr& senderSocket) {
+    // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
+    static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
+    _serverSocket.writePacket(*deniedPacket, senderSocket);
+}
+
+SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(const Heartbeat& heartbeat) {
+    // make sure we have this sender in our peer hash
+    SharedNetworkPeer matchingPeer = _activePeers.value(heartbeat.domainID);
+
+    if (!matchingPeer) {
+        // if we don't have this sender we need to create them now
+        matchingPeer = QSharedPointer<NetworkPeer>::create(heartbeat.domainID, heartbeat.publicSocket,
+                                                           heartbeat.localSocket);
+        _activePeers.insert(heartbeat.domainID, matchingPeer);
+
+        qDebug() << "Added a new network peer" << *matchingPeer;
+    } else {
+        // we already had the peer so just potentially update their sockets
+        matchingPeer->setPublicSocket(heartbeat.publicSocket);
+        matchingPeer->setLocalSocket(heartbeat.localSocket);
+    }
+
+    // update our last heard microstamp for this network peer to now
+    matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
+
+    return matchingPeer;
 }
 
 void IceServer::requestDomainPublicKey(const QUuid& domainID) {
     // send a request to the metaverse API for the public key for this domain
     auto& networkAccessManager = NetworkAccessManager::getInstance();
 
-    QUrl publicKeyURL { NetworkingConstants::METAVERSE_SERVER_URL };
+    QUrl publicKeyURL { _metaverseURL };
     QString publicKeyPath = QString("/api/v1/domains/%1/public_key").arg(uuidStringWithoutCurlyBraces(domainID));
     publicKeyURL.setPath(publicKeyPath);
 
@@ -253,7 +350,12 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
                 RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, apiPublicKey.size());
 
                 if (rsaPublicKey) {
-                    _domainPublicKeys[domainID] = { rsaPublicKey, RSA_free };
+                    RSA_free(rsaPublicKey);
+
+                    // heartbeats verified with a previous key are no longer accepted, their fingerprint won't match
+                    _domainPublicKeys[domainID] = {
+                        apiPublicKey, QCryptographicHash::hash(apiPublicKey, QCryptographicHash::Sha256)
+                    };
                 } else {
                     qWarning() << "Could not convert in-memory public key for" << domainID << "to usable RSA public key.";
                     qWarning() << "Public key will be re-requested on next heartbeat.";
@@ -300,6 +402,7 @@ void IceServer::clearInactivePeers() {
 
             // if we had a public key for this domain, remove it now
             _domainPublicKeys.erase(peer->getUUID());
+            _verifiedHeartbeats.erase(peer->getUUID());
 
             // remove the peer object
             peerItem = _activePeers.erase(peerItem);
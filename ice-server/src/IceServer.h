@@ -14,9 +14,11 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
+#include <QtCore/QUrl>
 #include <QUdpSocket>
 
-#include <openssl/rsa.h>
+#include <tbb/concurrent_queue.h>
 
 #include <UUIDHasher.h>
 
@@ -32,17 +34,39 @@ class IceServer : public QCoreApplication {
     Q_OBJECT
 public:
     IceServer(int argc, char* argv[]);
+
+    class Heartbeat {
+    public:
+        QUuid domainID;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr senderSocket;
+        QByteArray plaintext;
+        QByteArray signature;
+        QByteArray keyFingerprint;
+        bool verified { false };
+    };
+
+    // called from the verification pool once a heartbeat has been checked against its domain's public key
+    void heartbeatVerified(Heartbeat heartbeat);
+
 private slots:
     void clearInactivePeers();
     void publicKeyReplyFinished(QNetworkReply* reply);
+    void processVerifiedHeartbeats();
+
 private:
     bool packetVersionMatch(const udt::Packet& packet);
     void processPacket(std::unique_ptr<udt::Packet> packet);
-    
-    SharedNetworkPeer addOrUpdateHeartbeatingPeer(NLPacket& incomingPacket);
+
+    void processHeartbeat(NLPacket& packet);
+    void acceptHeartbeat(const Heartbeat& heartbeat);
+    void denyHeartbeat(const HifiSockAddr& senderSocket);
+
+    SharedNetworkPeer addOrUpdateHeartbeatingPeer(const Heartbeat& heartbeat);
     void sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr);
 
-    bool isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature);
+    bool isCachedHeartbeat(const Heartbeat& heartbeat) const;
     void requestDomainPublicKey(const QUuid& domainID);
 
     QUuid _id;
@@ -51,11 +75,37 @@ private:
     using NetworkPeerHash = QHash<QUuid, SharedNetworkPeer>;
     NetworkPeerHash _activePeers;
 
-    using RSAUniquePtr = std::unique_ptr<RSA, std::function<void(RSA*)>>;
-    using DomainPublicKeyHash = std::unordered_map<QUuid, RSAUniquePtr>;
+    QUrl _metaverseURL;
+
+    // DER encoded, each verification decodes its own RSA struct so that none is shared between pool threads
+    class DomainPublicKey {
+    public:
+        QByteArray key;
+        QByteArray fingerprint;
+    };
+    using DomainPublicKeyHash = std::unordered_map<QUuid, DomainPublicKey>;
     DomainPublicKeyHash _domainPublicKeys;
 
     QSet<QUuid> _pendingPublicKeyRequests;
+
+    // a domain re-sends the same signed heartbeat until its sockets or keypair change,
+    // so the last one verified for each domain is accepted again without a signature check for a while.
+    // the signed heartbeat has no nonce or timestamp, and its sender address isn't signed, so a captured one
+    // passes verification from anywhere at any time: the cache accepts nothing that a full check wouldn't
+    class VerifiedHeartbeat {
+    public:
+        QByteArray keyFingerprint;
+        QByteArray plaintext;
+        QByteArray signature;
+        quint64 verifiedUsecs;
+    };
+    std::unordered_map<QUuid, VerifiedHeartbeat> _verifiedHeartbeats;
+
+    int _numPendingVerifications { 0 };
+    tbb::concurrent_queue<Heartbeat> _verificationResults;
+
+    // declared last, so that it is done with its jobs before the members they use are destroyed
+    QThreadPool _verificationPool;
 };
 
 #endif // hifi_IceServer_h
@@ -21,6 +21,7 @@ int main(int argc, char* argv[]) {
 #endif
 
     qInstallMessageHandler(LogHandler::verboseMessageHandler);
+    LogHandler::getInstance().setAsyncOutput(true);
     qInfo() << "Starting.";
     
     IceServer iceServer(argc, argv);
@@ -2049,7 +2049,7 @@ void Application::paintGL() {
 
     auto lastPaintBegin = usecTimestampNow();
     PROFILE_RANGE_EX(render, __FUNCTION__, 0xff0000ff, (uint64_t)_frameCount);
-    PerformanceTimer perfTimer("paintGL");
+    PERFORMANCE_TIMER("paintGL");
 
     if (nullptr == _displayPlugin) {
         return;
@@ -2098,7 +2098,7 @@ void Application::paintGL() {
 
     auto inputs = AvatarInputs::getInstance();
     if (inputs->mirrorVisible()) {
-        PerformanceTimer perfTimer("Mirror");
+        PERFORMANCE_TIMER("Mirror");
 
         renderArgs._renderMode = RenderArgs::MIRROR_RENDER_MODE;
         renderArgs._blitFramebuffer = DependencyManager::get<FramebufferCache>()->getSelfieFramebuffer();
@@ -2112,7 +2112,7 @@ void Application::paintGL() {
     }
 
     {
-        PerformanceTimer perfTimer("renderOverlay");
+        PERFORMANCE_TIMER("renderOverlay");
         // NOTE: There is no batch associated with this renderArgs
         // the ApplicationOverlay class assumes it's viewport is setup to be the device size
         QSize size = getDeviceSize();
@@ -2122,7 +2122,7 @@ void Application::paintGL() {
 
     glm::vec3 boomOffset;
     {
-        PerformanceTimer perfTimer("CameraUpdates");
+        PERFORMANCE_TIMER("CameraUpdates");
 
         auto myAvatar = getMyAvatar();
         boomOffset = myAvatar->getScale() * myAvatar->getBoomLength() * -IDENTITY_FRONT;
@@ -2226,7 +2226,7 @@ void Application::paintGL() {
 
     {
         PROFILE_RANGE(render, "/mainRender");
-        PerformanceTimer perfTimer("mainRender");
+        PERFORMANCE_TIMER("mainRender");
         renderArgs._boomOffset = boomOffset;
         // Viewport is assigned to the size of the framebuffer
         renderArgs._viewport = ivec4(0, 0, size.width(), size.height());
@@ -2281,7 +2281,7 @@ void Application::paintGL() {
     // deliver final scene rendering commands to the display plugin
     {
         PROFILE_RANGE(render, "/pluginOutput");
-        PerformanceTimer perfTimer("pluginOutput");
+        PERFORMANCE_TIMER("pluginOutput");
         _frameCounter.increment();
         displayPlugin->submitFrame(frame);
     }
@@ -3394,7 +3394,7 @@ void getCpuUsage(vec3& systemAndUser) {
 
 
 void Application::idle(float nsecsElapsed) {
-    PerformanceTimer perfTimer("idle");
+    PERFORMANCE_TIMER("idle");
 
     // Update the deadlock watchdog
     updateHeartbeat();
@@ -3471,7 +3471,7 @@ void Application::idle(float nsecsElapsed) {
     PerformanceWarning warn(showWarnings, "idle()");
 
     {
-        PerformanceTimer perfTimer("update");
+        PERFORMANCE_TIMER("update");
         PerformanceWarning warn(showWarnings, "Application::idle()... update()");
         static const float BIGGEST_DELTA_TIME_SECS = 0.25f;
         update(glm::clamp(secondsSinceLastUpdate, 0.0f, BIGGEST_DELTA_TIME_SECS));
@@ -3508,7 +3508,7 @@ void Application::idle(float nsecsElapsed) {
     }
 
     {
-        PerformanceTimer perfTimer("pluginIdle");
+        PERFORMANCE_TIMER("pluginIdle");
         PerformanceWarning warn(showWarnings, "Application::idle()... pluginIdle()");
         getActiveDisplayPlugin()->idle();
         auto inputPlugins = PluginManager::getInstance()->getInputPlugins();
@@ -3519,7 +3519,7 @@ void Application::idle(float nsecsElapsed) {
         }
     }
     {
-        PerformanceTimer perfTimer("rest");
+        PERFORMANCE_TIMER("rest");
         PerformanceWarning warn(showWarnings, "Application::idle()... rest of it");
         _idleLoopStdev.addValue(secondsSinceLastUpdate);
 
@@ -3865,7 +3865,7 @@ void Application::init() {
 }
 
 void Application::updateLOD() const {
-    PerformanceTimer perfTimer("LOD");
+    PERFORMANCE_TIMER("LOD");
     // adjust it unless we were asked to disable this feature, or if we're currently in throttleRendering mode
     if (!isThrottleRendering()) {
         DependencyManager::get<LODManager>()->autoAdjustLOD(_frameCounter.rate());
@@ -3884,7 +3884,7 @@ void Application::pushPostUpdateLambda(void* key, std::function<void()> func) {
 // The principal result is to call updateLookAtTargetAvatar() and then setLookAtPosition().
 // Note that it is called BEFORE we update position or joints based on sensors, etc.
 void Application::updateMyAvatarLookAtPosition() {
-    PerformanceTimer perfTimer("lookAt");
+    PERFORMANCE_TIMER("lookAt");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateMyAvatarLookAtPosition()");
 
@@ -3973,7 +3973,7 @@ void Application::updateMyAvatarLookAtPosition() {
 }
 
 void Application::updateThreads(float deltaTime) {
-    PerformanceTimer perfTimer("updateThreads");
+    PERFORMANCE_TIMER("updateThreads");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateThreads()");
 
@@ -4192,7 +4192,7 @@ void Application::setKeyboardFocusOverlay(unsigned int overlayID) {
 }
 
 void Application::updateDialogs(float deltaTime) const {
-    PerformanceTimer perfTimer("updateDialogs");
+    PERFORMANCE_TIMER("updateDialogs");
     bool showWarnings = Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings);
     PerformanceWarning warn(showWarnings, "Application::updateDialogs()");
     auto dialogsManager = DependencyManager::get<DialogsManager>();
@@ -4261,7 +4261,7 @@ void Application::update(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("devices");
+        PERFORMANCE_TIMER("devices");
         DeviceTracker::updateAll();
 
         FaceTracker* tracker = getSelectedFaceTracker();
@@ -4353,12 +4353,12 @@ void Application::update(float deltaTime) {
     if (_physicsEnabled) {
         PROFILE_RANGE_EX(simulation_physics, "Physics", 0xffff0000, (uint64_t)getActiveDisplayPlugin()->presentCount());
 
-        PerformanceTimer perfTimer("physics");
+        PERFORMANCE_TIMER("physics");
 
         {
             PROFILE_RANGE_EX(simulation_physics, "UpdateStats", 0xffffff00, (uint64_t)getActiveDisplayPlugin()->presentCount());
 
-            PerformanceTimer perfTimer("updateStates)");
+            PERFORMANCE_TIMER("updateStates)");
             static VectorOfMotionStates motionStates;
             _entitySimulation->getObjectsToRemoveFromPhysics(motionStates);
             _physicsEngine->removeObjects(motionStates);
@@ -4391,21 +4391,21 @@ void Application::update(float deltaTime) {
         }
         {
             PROFILE_RANGE_EX(simulation_physics, "StepSimulation", 0xffff8000, (uint64_t)getActiveDisplayPlugin()->presentCount());
-            PerformanceTimer perfTimer("stepSimulation");
+            PERFORMANCE_TIMER("stepSimulation");
             getEntities()->getTree()->withWriteLock([&] {
                 _physicsEngine->stepSimulation();
             });
         }
         {
             PROFILE_RANGE_EX(simulation_physics, "HarvestChanges", 0xffffff00, (uint64_t)getActiveDisplayPlugin()->presentCount());
-            PerformanceTimer perfTimer("harvestChanges");
+            PERFORMANCE_TIMER("harvestChanges");
             if (_physicsEngine->hasOutgoingChanges()) {
                 // grab the collision events BEFORE handleOutgoingChanges() because at this point
                 // we have a better idea of which objects we own or should own.
                 auto& collisionEvents = _physicsEngine->getCollisionEvents();
 
                 getEntities()->getTree()->withWriteLock([&] {
-                    PerformanceTimer perfTimer("handleOutgoingChanges");
+                    PERFORMANCE_TIMER("handleOutgoingChanges");
                     const VectorOfMotionStates& outgoingChanges = _physicsEngine->getOutgoingChanges();
                     _entitySimulation->handleOutgoingChanges(outgoingChanges);
                     avatarManager->handleOutgoingChanges(outgoingChanges);
@@ -4413,7 +4413,7 @@ void Application::update(float deltaTime) {
 
                 if (!_aboutToQuit) {
                     // handleCollisionEvents() AFTER handleOutgoinChanges()
-                    PerformanceTimer perfTimer("entities");
+                    PERFORMANCE_TIMER("entities");
                     avatarManager->handleCollisionEvents(collisionEvents);
                     // Collision events (and their scripts) must not be handled when we're locked, above. (That would risk
                     // deadlock.)
@@ -4438,7 +4438,7 @@ void Application::update(float deltaTime) {
 
     // AvatarManager update
     {
-        PerformanceTimer perfTimer("AvatarManager");
+        PERFORMANCE_TIMER("AvatarManager");
         _avatarSimCounter.increment();
 
         {
@@ -4456,7 +4456,7 @@ void Application::update(float deltaTime) {
 
     {
         PROFILE_RANGE_EX(app, "Overlays", 0xffff0000, (uint64_t)getActiveDisplayPlugin()->presentCount());
-        PerformanceTimer perfTimer("overlays");
+        PERFORMANCE_TIMER("overlays");
         _overlays.update(deltaTime);
     }
 
@@ -4477,7 +4477,7 @@ void Application::update(float deltaTime) {
     {
         PROFILE_RANGE_EX(app, "QueryOctree", 0xffff0000, (uint64_t)getActiveDisplayPlugin()->presentCount());
         QMutexLocker viewLocker(&_viewMutex);
-        PerformanceTimer perfTimer("queryOctree");
+        PERFORMANCE_TIMER("queryOctree");
         quint64 sinceLastQuery = now - _lastQueriedTime;
         const quint64 TOO_LONG_SINCE_LAST_QUERY = 3 * USECS_PER_SECOND;
         bool queryIsDue = sinceLastQuery > TOO_LONG_SINCE_LAST_QUERY;
@@ -4875,7 +4875,7 @@ namespace render {
     template <> const Item::Bound payloadGetBound(const WorldBoxRenderData::Pointer& stuff) { return Item::Bound(); }
     template <> void payloadRender(const WorldBoxRenderData::Pointer& stuff, RenderArgs* args) {
         if (args->_renderMode != RenderArgs::MIRROR_RENDER_MODE && Menu::getInstance()->isOptionChecked(MenuOption::WorldAxes)) {
-            PerformanceTimer perfTimer("worldBox");
+            PERFORMANCE_TIMER("worldBox");
 
             auto& batch = *args->_batch;
             DependencyManager::get<GeometryCache>()->bindSimpleProgram(batch);
@@ -4928,7 +4928,7 @@ namespace render {
             case model::SunSkyStage::SKY_BOX: {
                 auto skybox = skyStage->getSkybox();
                 if (!skybox->empty()) {
-                    PerformanceTimer perfTimer("skybox");
+                    PERFORMANCE_TIMER("skybox");
                     skybox->render(batch, args->getViewFrustum());
                     break;
                 }
@@ -4977,7 +4977,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
 
     activeRenderingThread = QThread::currentThread();
     PROFILE_RANGE(render, __FUNCTION__);
-    PerformanceTimer perfTimer("display");
+    PERFORMANCE_TIMER("display");
     PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings), "Application::displaySide()");
 
     // load the view frustum
@@ -5004,7 +5004,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
     if (!selfAvatarOnly) {
         if (DependencyManager::get<SceneScriptingInterface>()->shouldRenderEntities()) {
             // render models...
-            PerformanceTimer perfTimer("entities");
+            PERFORMANCE_TIMER("entities");
             PerformanceWarning warn(Menu::getInstance()->isOptionChecked(MenuOption::PipelineWarnings),
                 "Application::displaySide() ... entities...");
 
@@ -5042,7 +5042,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
     }
 
     {
-        PerformanceTimer perfTimer("SceneProcessPendingChanges");
+        PERFORMANCE_TIMER("SceneProcessPendingChanges");
         _main3DScene->enqueuePendingChanges(pendingChanges);
 
         _main3DScene->processPendingChangesQueue();
@@ -5050,7 +5050,7 @@ void Application::displaySide(RenderArgs* renderArgs, Camera& theCamera, bool se
 
     // For now every frame pass the renderContext
     {
-        PerformanceTimer perfTimer("EngineRun");
+        PERFORMANCE_TIMER("EngineRun");
 
         {
             QMutexLocker viewLocker(&_viewMutex);
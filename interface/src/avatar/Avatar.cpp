@@ -205,7 +205,7 @@ void Avatar::setTargetScale(float targetScale) {
 }
 
 void Avatar::updateAvatarEntities() {
-    PerformanceTimer perfTimer("attachments");
+    PERFORMANCE_TIMER("attachments");
     // - if queueEditEntityMessage sees clientOnly flag it does _myAvatar->updateAvatarEntity()
     // - updateAvatarEntity saves the bytes and sets _avatarEntityDataLocallyEdited
     // - MyAvatar::update notices _avatarEntityDataLocallyEdited and calls sendIdentityPacket
@@ -314,7 +314,7 @@ void Avatar::simulate(float deltaTime, bool inView) {
     }
 
 
-    PerformanceTimer perfTimer("simulate");
+    PERFORMANCE_TIMER("simulate");
     {
         PROFILE_RANGE(simulation, "updateJoints");
         if (inView && _hasNewJointData) {
@@ -404,7 +404,7 @@ void Avatar::applyPositionDelta(const glm::vec3& delta) {
 }
 
 void Avatar::measureMotionDerivatives(float deltaTime) {
-    PerformanceTimer perfTimer("derivatives");
+    PERFORMANCE_TIMER("derivatives");
     // linear
     float invDeltaTime = 1.0f / deltaTime;
     // Floating point error prevents us from computing velocity in a naive way
@@ -673,7 +673,7 @@ bool Avatar::shouldRenderHead(const RenderArgs* renderArgs) const {
 
 // virtual
 void Avatar::simulateAttachments(float deltaTime) {
-    PerformanceTimer perfTimer("attachments");
+    PERFORMANCE_TIMER("attachments");
     for (int i = 0; i < (int)_attachmentModels.size(); i++) {
         const AttachmentData& attachment = _attachmentData.at(i);
         auto& model = _attachmentModels.at(i);
@@ -1092,7 +1092,7 @@ void Avatar::setAttachmentData(const QVector<AttachmentData>& attachmentData) {
 
 
 int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
-    PerformanceTimer perfTimer("unpack");
+    PERFORMANCE_TIMER("unpack");
     if (!_initialized) {
         // now that we have data for this Avatar we are go for init
         init();
@@ -1312,7 +1312,7 @@ void Avatar::setOrientation(const glm::quat& orientation) {
 }
 
 void Avatar::updatePalms() {
-    PerformanceTimer perfTimer("palms");
+    PERFORMANCE_TIMER("palms");
     // update thread-safe caches
     _leftPalmRotationCache.set(getUncachedLeftPalmRotation());
     _rightPalmRotationCache.set(getUncachedRightPalmRotation());
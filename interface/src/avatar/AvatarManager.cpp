@@ -122,7 +122,7 @@ void AvatarManager::updateMyAvatar(float deltaTime) {
 
     if (dt > MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS) {
         // send head/hand data to the avatar mixer and voxel server
-        PerformanceTimer perfTimer("send");
+        PERFORMANCE_TIMER("send");
         _myAvatar->sendAvatarDataPacket();
         _lastSendAvatarDataTime = now;
         _myAvatarSendRate.increment();
@@ -166,7 +166,7 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     }
     lock.unlock();
 
-    PerformanceTimer perfTimer("otherAvatars");
+    PERFORMANCE_TIMER("otherAvatars");
     uint64_t startTime = usecTimestampNow();
 
     auto avatarMap = getHashCopy();
@@ -102,7 +102,7 @@ void CauterizedModel::updateRig(float deltaTime, glm::mat4 parentTransform) {
 }
 
 void CauterizedModel::updateClusterMatrices() {
-    PerformanceTimer perfTimer("CauterizedModel::updateClusterMatrices");
+    PERFORMANCE_TIMER("CauterizedModel::updateClusterMatrices");
 
     if (!_needsUpdateClusterMatrices || !isLoaded()) {
         return;
@@ -428,12 +428,12 @@ extern QByteArray avatarStateToFrame(const AvatarData* _avatar);
 extern void avatarStateFromFrame(const QByteArray& frameData, AvatarData* _avatar);
 
 void MyAvatar::simulate(float deltaTime) {
-    PerformanceTimer perfTimer("simulate");
+    PERFORMANCE_TIMER("simulate");
 
     animateScaleChanges(deltaTime);
 
     {
-        PerformanceTimer perfTimer("transform");
+        PERFORMANCE_TIMER("transform");
         bool stepAction = false;
         // When there are no step values, we zero out the last step pulse.
         // This allows a user to do faster snapping by tapping a control
@@ -452,7 +452,7 @@ void MyAvatar::simulate(float deltaTime) {
     updateSensorToWorldMatrix();
 
     {
-        PerformanceTimer perfTimer("skeleton");
+        PERFORMANCE_TIMER("skeleton");
         _skeletonModel->simulate(deltaTime);
     }
 
@@ -467,13 +467,13 @@ void MyAvatar::simulate(float deltaTime) {
     }
 
     {
-        PerformanceTimer perfTimer("joints");
+        PERFORMANCE_TIMER("joints");
         // copy out the skeleton joints from the model
         _rig->copyJointsIntoJointData(_jointData);
     }
 
     {
-        PerformanceTimer perfTimer("head");
+        PERFORMANCE_TIMER("head");
         Head* head = getHead();
         glm::vec3 headPosition;
         if (!_skeletonModel->getHeadPosition(headPosition)) {
@@ -528,7 +528,7 @@ void MyAvatar::simulate(float deltaTime) {
             });
             // also update the position of children in our local octree
             if (moveOperator.hasMovingEntities()) {
-                PerformanceTimer perfTimer("recurseTreeWithOperator");
+                PERFORMANCE_TIMER("recurseTreeWithOperator");
                 entityTree->recurseTreeWithOperator(&moveOperator);
             }
         });
@@ -713,7 +713,7 @@ PointerEvent Overlays::calculatePointerEvent(Overlay::Pointer overlay, PickRay r
 }
 
 void Overlays::mousePressEvent(QMouseEvent* event) {
-    PerformanceTimer perfTimer("Overlays::mousePressEvent");
+    PERFORMANCE_TIMER("Overlays::mousePressEvent");
 
     PickRay ray = qApp->computePickRay(event->x(), event->y());
     RayToOverlayIntersectionResult rayPickResult = findRayIntersection(ray);
@@ -734,7 +734,7 @@ void Overlays::mousePressEvent(QMouseEvent* event) {
 }
 
 void Overlays::mouseReleaseEvent(QMouseEvent* event) {
-    PerformanceTimer perfTimer("Overlays::mouseReleaseEvent");
+    PERFORMANCE_TIMER("Overlays::mouseReleaseEvent");
 
     PickRay ray = qApp->computePickRay(event->x(), event->y());
     RayToOverlayIntersectionResult rayPickResult = findRayIntersection(ray);
@@ -752,7 +752,7 @@ void Overlays::mouseReleaseEvent(QMouseEvent* event) {
 }
 
 void Overlays::mouseMoveEvent(QMouseEvent* event) {
-    PerformanceTimer perfTimer("Overlays::mouseMoveEvent");
+    PERFORMANCE_TIMER("Overlays::mouseMoveEvent");
 
     PickRay ray = qApp->computePickRay(event->x(), event->y());
     RayToOverlayIntersectionResult rayPickResult = findRayIntersection(ray);
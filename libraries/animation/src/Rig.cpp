@@ -903,12 +903,12 @@ void Rig::updateAnimationStateHandlers() { // called on avatar update thread (wh
 void Rig::updateAnimations(float deltaTime, glm::mat4 rootTransform) {
 
     PROFILE_RANGE_EX(simulation_animation_detail, __FUNCTION__, 0xffff00ff, 0);
-    PerformanceTimer perfTimer("updateAnimations");
+    PERFORMANCE_TIMER("updateAnimations");
 
     setModelOffset(rootTransform);
 
     if (_animNode) {
-        PerformanceTimer perfTimer("handleTriggers");
+        PERFORMANCE_TIMER("handleTriggers");
 
         updateAnimationStateHandlers();
         _animVars.setRigToGeometryTransform(_rigToGeometryTransform);
@@ -1196,7 +1196,7 @@ bool Rig::getModelRegistrationPoint(glm::vec3& modelRegistrationPointOut) const
 }
 
 void Rig::applyOverridePoses() {
-    PerformanceTimer perfTimer("override");
+    PERFORMANCE_TIMER("override");
     if (_numOverrides == 0 || !_animSkeleton) {
         return;
     }
@@ -1213,7 +1213,7 @@ void Rig::applyOverridePoses() {
 }
 
 void Rig::buildAbsoluteRigPoses(const AnimPoseVec& relativePoses, AnimPoseVec& absolutePosesOut) {
-    PerformanceTimer perfTimer("buildAbsolute");
+    PERFORMANCE_TIMER("buildAbsolute");
     if (!_animSkeleton) {
         return;
     }
@@ -1268,7 +1268,7 @@ void Rig::copyJointsIntoJointData(QVector<JointData>& jointDataVec) const {
 }
 
 void Rig::copyJointsFromJointData(const QVector<JointData>& jointDataVec) {
-    PerformanceTimer perfTimer("copyJoints");
+    PERFORMANCE_TIMER("copyJoints");
     PROFILE_RANGE(simulation_animation_detail, "copyJoints");
     if (_animSkeleton && jointDataVec.size() == (int)_internalPoseSet._relativePoses.size()) {
         // make a vector of rotations in absolute-geometry-frame
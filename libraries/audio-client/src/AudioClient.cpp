@@ -35,6 +35,7 @@
 #include <QtMultimedia/QAudioInput>
 #include <QtMultimedia/QAudioOutput>
 
+#include <AudioSampleOps.h>
 #include <NodeList.h>
 #include <plugins/CodecPlugin.h>
 #include <plugins/PluginManager.h>
@@ -144,10 +145,6 @@ static void channelDownmix(int16_t* source, int16_t* dest, int numSamples) {
     }
 }
 
-static inline float convertToFloat(int16_t sample) {
-    return (float)sample * (1 / 32768.0f);
-}
-
 AudioClient::AudioClient() :
     AbstractAudioInterface(),
     _gate(this),
@@ -1209,9 +1206,8 @@ bool AudioClient::mixLocalAudioInjectors(float* mixBuffer) {
 
                     // stereo gets directly mixed into mixBuffer
                     float gain = injector->getVolume();
-                    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
-                        mixBuffer[i] += convertToFloat(_localScratchBuffer[i]) * gain;
-                    }
+                    accumulateInt16ToFloat(_localScratchBuffer, mixBuffer, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+                                           gain * (1 / 32768.0f));
                     
                 } else {
 
@@ -1662,9 +1658,7 @@ qint64 AudioClient::AudioOutputIODevice::readData(char * data, qint64 maxSize) {
         AudioRingBuffer::ConstIterator lastPopOutput = _receivedAudioStream.getLastPopOutput();
         lastPopOutput.readSamples(scratchBuffer, networkSamplesPopped);
 
-        for (int i = 0; i < networkSamplesPopped; i++) {
-            mixBuffer[i] = convertToFloat(scratchBuffer[i]);
-        }
+        convertInt16ToFloat(scratchBuffer, mixBuffer, networkSamplesPopped, 1 / 32768.0f);
 
         samplesRequested = networkSamplesPopped;
     }
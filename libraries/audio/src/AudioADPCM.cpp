@@ -0,0 +1,370 @@
+//
+//  AudioADPCM.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <assert.h>
+#include <string.h>
+
+#include "AudioADPCM.h"
+
+// IMA ADPCM quantizer step sizes (shared with the AVX2 kernels)
+const int32_t ADPCM_STEP_TABLE[ADPCM_MAX_INDEX + 1] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static inline int32_t clampIndex(int32_t i) {
+    return (i < 0) ? 0 : ((i > ADPCM_MAX_INDEX) ? ADPCM_MAX_INDEX : i);
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+static inline __m128i gatherStep(const __m128i index) {
+    int32_t i[4];
+    _mm_storeu_si128((__m128i*)i, index);
+    return _mm_setr_epi32(ADPCM_STEP_TABLE[i[0]], ADPCM_STEP_TABLE[i[1]], ADPCM_STEP_TABLE[i[2]], ADPCM_STEP_TABLE[i[3]]);
+}
+
+// saturate to int16_t range, using pack/unpack (SSE2 has no 32-bit min/max)
+static inline __m128i clampSample(const __m128i x) {
+    __m128i t = _mm_packs_epi32(x, x);
+    return _mm_srai_epi32(_mm_unpacklo_epi16(t, t), 16);
+}
+
+static inline __m128i clampIndex(__m128i x) {
+    const __m128i maxIndex = _mm_set1_epi32(ADPCM_MAX_INDEX);
+    x = _mm_andnot_si128(_mm_cmplt_epi32(x, _mm_setzero_si128()), x);
+    __m128i over = _mm_cmpgt_epi32(x, maxIndex);
+    return _mm_or_si128(_mm_and_si128(over, maxIndex), _mm_andnot_si128(over, x));
+}
+
+static inline __m128i indexDelta(const __m128i code) {
+    __m128i m = _mm_and_si128(code, _mm_set1_epi32(7));
+    __m128i big = _mm_cmpgt_epi32(m, _mm_set1_epi32(3));
+    __m128i up = _mm_sub_epi32(_mm_add_epi32(m, m), _mm_set1_epi32(6));
+    return _mm_or_si128(_mm_and_si128(big, up), _mm_andnot_si128(big, _mm_set1_epi32(-1)));
+}
+
+// quantize one step of 4 lanes, returns the 4-bit codes
+static inline __m128i encode4(const __m128i x, __m128i& pred, __m128i& index) {
+
+    __m128i step = gatherStep(index);
+    __m128i diff = _mm_sub_epi32(x, pred);
+    __m128i sign = _mm_srai_epi32(diff, 31);
+    diff = _mm_sub_epi32(_mm_xor_si128(diff, sign), sign);  // abs
+
+    __m128i vpdiff = _mm_srai_epi32(step, 3);
+    __m128i code;
+    __m128i m;
+
+    m = _mm_cmpgt_epi32(step, diff);    // m = (diff < step)
+    code = _mm_andnot_si128(m, _mm_set1_epi32(4));
+    diff = _mm_sub_epi32(diff, _mm_andnot_si128(m, step));
+    vpdiff = _mm_add_epi32(vpdiff, _mm_andnot_si128(m, step));
+    step = _mm_srai_epi32(step, 1);
+
+    m = _mm_cmpgt_epi32(step, diff);
+    code = _mm_or_si128(code, _mm_andnot_si128(m, _mm_set1_epi32(2)));
+    diff = _mm_sub_epi32(diff, _mm_andnot_si128(m, step));
+    vpdiff = _mm_add_epi32(vpdiff, _mm_andnot_si128(m, step));
+    step = _mm_srai_epi32(step, 1);
+
+    m = _mm_cmpgt_epi32(step, diff);
+    code = _mm_or_si128(code, _mm_andnot_si128(m, _mm_set1_epi32(1)));
+    vpdiff = _mm_add_epi32(vpdiff, _mm_andnot_si128(m, step));
+
+    vpdiff = _mm_sub_epi32(_mm_xor_si128(vpdiff, sign), sign);  // apply sign
+    pred = clampSample(_mm_add_epi32(pred, vpdiff));
+    index = clampIndex(_mm_add_epi32(index, indexDelta(code)));
+
+    return _mm_or_si128(code, _mm_and_si128(sign, _mm_set1_epi32(8)));
+}
+
+static inline __m128i decode4(const __m128i code, __m128i& pred, __m128i& index) {
+
+    __m128i step = gatherStep(index);
+    __m128i vpdiff = _mm_srai_epi32(step, 3);
+
+    __m128i m4 = _mm_cmpeq_epi32(_mm_and_si128(code, _mm_set1_epi32(4)), _mm_set1_epi32(4));
+    __m128i m2 = _mm_cmpeq_epi32(_mm_and_si128(code, _mm_set1_epi32(2)), _mm_set1_epi32(2));
+    __m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(code, _mm_set1_epi32(1)), _mm_set1_epi32(1));
+    __m128i sign = _mm_cmpeq_epi32(_mm_and_si128(code, _mm_set1_epi32(8)), _mm_set1_epi32(8));
+
+    vpdiff = _mm_add_epi32(vpdiff, _mm_and_si128(m4, step));
+    vpdiff = _mm_add_epi32(vpdiff, _mm_and_si128(m2, _mm_srai_epi32(step, 1)));
+    vpdiff = _mm_add_epi32(vpdiff, _mm_and_si128(m1, _mm_srai_epi32(step, 2)));
+
+    vpdiff = _mm_sub_epi32(_mm_xor_si128(vpdiff, sign), sign);  // apply sign
+    pred = clampSample(_mm_add_epi32(pred, vpdiff));
+    index = clampIndex(_mm_add_epi32(index, indexDelta(code)));
+
+    return pred;
+}
+
+static void ADPCM_encode_SSE2(const int16_t* src, uint8_t* dst, int32_t* pred, int32_t* index, int numSteps) {
+
+    static_assert(ADPCM_LANES == 8, "SSE2 kernel assumes 8 lanes");
+
+    __m128i pred0 = _mm_loadu_si128((__m128i*)&pred[0]);
+    __m128i pred1 = _mm_loadu_si128((__m128i*)&pred[4]);
+    __m128i index0 = _mm_loadu_si128((__m128i*)&index[0]);
+    __m128i index1 = _mm_loadu_si128((__m128i*)&index[4]);
+
+    for (int i = 0; i < numSteps; i++) {
+
+        // load 8 lanes, sign-extend to int32
+        __m128i x = _mm_loadu_si128((__m128i*)&src[ADPCM_LANES * i]);
+        __m128i x0 = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        __m128i x1 = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+
+        __m128i c0 = encode4(x0, pred0, index0);
+        __m128i c1 = encode4(x1, pred1, index1);
+
+        // pack nibbles: each int32 of c holds (code[2k] | code[2k+1] << 16)
+        __m128i c = _mm_packs_epi32(c0, c1);
+        c = _mm_and_si128(_mm_or_si128(c, _mm_srli_epi32(c, 12)), _mm_set1_epi32(0xff));
+        c = _mm_packs_epi32(c, c);
+        c = _mm_packus_epi16(c, c);
+
+        int32_t bytes = _mm_cvtsi128_si32(c);
+        memcpy(&dst[ADPCM_BYTES_PER_STEP * i], &bytes, ADPCM_BYTES_PER_STEP);
+    }
+
+    _mm_storeu_si128((__m128i*)&pred[0], pred0);
+    _mm_storeu_si128((__m128i*)&pred[4], pred1);
+    _mm_storeu_si128((__m128i*)&index[0], index0);
+    _mm_storeu_si128((__m128i*)&index[4], index1);
+}
+
+static void ADPCM_decode_SSE2(const uint8_t* src, int16_t* dst, int32_t* pred, int32_t* index, int numSteps) {
+
+    static_assert(ADPCM_LANES == 8, "SSE2 kernel assumes 8 lanes");
+
+    __m128i pred0 = _mm_loadu_si128((__m128i*)&pred[0]);
+    __m128i pred1 = _mm_loadu_si128((__m128i*)&pred[4]);
+    __m128i index0 = _mm_loadu_si128((__m128i*)&index[0]);
+    __m128i index1 = _mm_loadu_si128((__m128i*)&index[4]);
+
+    for (int i = 0; i < numSteps; i++) {
+
+        int32_t bytes;
+        memcpy(&bytes, &src[ADPCM_BYTES_PER_STEP * i], ADPCM_BYTES_PER_STEP);
+
+        // unpack nibbles into 8 int32 lanes
+        __m128i b = _mm_cvtsi32_si128(bytes);
+        __m128i lo = _mm_and_si128(b, _mm_set1_epi8(0xf));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), _mm_set1_epi8(0xf));
+        __m128i c = _mm_unpacklo_epi8(_mm_unpacklo_epi8(lo, hi), _mm_setzero_si128());
+        __m128i c0 = _mm_unpacklo_epi16(c, _mm_setzero_si128());
+        __m128i c1 = _mm_unpackhi_epi16(c, _mm_setzero_si128());
+
+        __m128i y0 = decode4(c0, pred0, index0);
+        __m128i y1 = decode4(c1, pred1, index1);
+
+        _mm_storeu_si128((__m128i*)&dst[ADPCM_LANES * i], _mm_packs_epi32(y0, y1));
+    }
+
+    _mm_storeu_si128((__m128i*)&pred[0], pred0);
+    _mm_storeu_si128((__m128i*)&pred[4], pred1);
+    _mm_storeu_si128((__m128i*)&index[0], index0);
+    _mm_storeu_si128((__m128i*)&index[4], index1);
+}
+
+//
+// Runtime CPU dispatch
+//
+
+#include "CPUDetect.h"
+
+void ADPCM_encode_AVX2(const int16_t* src, uint8_t* dst, int32_t* pred, int32_t* index, int numSteps);
+void ADPCM_decode_AVX2(const uint8_t* src, int16_t* dst, int32_t* pred, int32_t* index, int numSteps);
+
+static void ADPCM_encode(const int16_t* src, uint8_t* dst, int32_t* pred, int32_t* index, int numSteps) {
+
+    static auto f = cpuSupportsAVX2() ? ADPCM_encode_AVX2 : ADPCM_encode_SSE2;
+    (*f)(src, dst, pred, index, numSteps); // dispatch
+}
+
+static void ADPCM_decode(const uint8_t* src, int16_t* dst, int32_t* pred, int32_t* index, int numSteps) {
+
+    static auto f = cpuSupportsAVX2() ? ADPCM_decode_AVX2 : ADPCM_decode_SSE2;
+    (*f)(src, dst, pred, index, numSteps); // dispatch
+}
+
+#else   // portable reference code
+
+// all SIMD variants must produce bit-identical results
+
+static inline int32_t clampSample(int32_t x) {
+    return (x < -32768) ? -32768 : ((x > 32767) ? 32767 : x);
+}
+
+// index adjustment for a 3-bit magnitude code is {-1,-1,-1,-1,2,4,6,8}
+static inline int32_t indexDelta(int32_t code) {
+    int32_t m = code & 7;
+    return (m > 3) ? (2 * m - 6) : -1;
+}
+
+static void ADPCM_encode(const int16_t* src, uint8_t* dst, int32_t* pred, int32_t* index, int numSteps) {
+
+    for (int i = 0; i < numSteps; i++) {
+
+        int32_t codes[ADPCM_LANES];
+
+        for (int j = 0; j < ADPCM_LANES; j++) {
+
+            int32_t step = ADPCM_STEP_TABLE[index[j]];
+            int32_t diff = src[ADPCM_LANES * i + j] - pred[j];
+            int32_t sign = (diff < 0) ? 8 : 0;
+            if (sign) {
+                diff = -diff;
+            }
+
+            int32_t code = 0;
+            int32_t vpdiff = step >> 3;
+
+            if (diff >= step) {
+                code |= 4;
+                diff -= step;
+                vpdiff += step;
+            }
+            step >>= 1;
+            if (diff >= step) {
+                code |= 2;
+                diff -= step;
+                vpdiff += step;
+            }
+            step >>= 1;
+            if (diff >= step) {
+                code |= 1;
+                vpdiff += step;
+            }
+
+            pred[j] = clampSample(sign ? pred[j] - vpdiff : pred[j] + vpdiff);
+            index[j] = clampIndex(index[j] + indexDelta(code));
+            codes[j] = code | sign;
+        }
+
+        for (int k = 0; k < ADPCM_BYTES_PER_STEP; k++) {
+            dst[ADPCM_BYTES_PER_STEP * i + k] = (uint8_t)(codes[2*k+0] | (codes[2*k+1] << 4));
+        }
+    }
+}
+
+static void ADPCM_decode(const uint8_t* src, int16_t* dst, int32_t* pred, int32_t* index, int numSteps) {
+
+    for (int i = 0; i < numSteps; i++) {
+        for (int j = 0; j < ADPCM_LANES; j++) {
+
+            int32_t code = (src[ADPCM_BYTES_PER_STEP * i + (j >> 1)] >> (4 * (j & 1))) & 0xf;
+            int32_t step = ADPCM_STEP_TABLE[index[j]];
+
+            int32_t vpdiff = step >> 3;
+            if (code & 4) {
+                vpdiff += step;
+            }
+            if (code & 2) {
+                vpdiff += step >> 1;
+            }
+            if (code & 1) {
+                vpdiff += step >> 2;
+            }
+
+            pred[j] = clampSample((code & 8) ? pred[j] - vpdiff : pred[j] + vpdiff);
+            index[j] = clampIndex(index[j] + indexDelta(code));
+            dst[ADPCM_LANES * i + j] = (int16_t)pred[j];
+        }
+    }
+}
+
+
+#endif
+
+//
+// Lane j holds channel (j % numChannels), frames [b * laneFrames, (b+1) * laneFrames) where b = j / numChannels.
+// Lanes are stored time-major, so each SIMD step reads or writes one sample of every lane.
+//
+static void deinterleaveLanes(const int16_t* input, int16_t* lanes, int numChannels, int laneFrames) {
+    for (int j = 0; j < ADPCM_LANES; j++) {
+        int channel = j % numChannels;
+        const int16_t* src = &input[(j / numChannels) * laneFrames * numChannels + channel];
+        for (int i = 0; i < laneFrames; i++) {
+            lanes[ADPCM_LANES * i + j] = src[numChannels * i];
+        }
+    }
+}
+
+static void interleaveLanes(const int16_t* lanes, int16_t* output, int numChannels, int laneFrames) {
+    for (int j = 0; j < ADPCM_LANES; j++) {
+        int channel = j % numChannels;
+        int16_t* dst = &output[(j / numChannels) * laneFrames * numChannels + channel];
+        for (int i = 0; i < laneFrames; i++) {
+            dst[numChannels * i] = lanes[ADPCM_LANES * i + j];
+        }
+    }
+}
+
+AudioADPCMEncoder::AudioADPCMEncoder(int numChannels) : _numChannels(numChannels) {
+    assert(AudioADPCM::isValidChannelCount(numChannels));
+}
+
+void AudioADPCMEncoder::encode(const int16_t* input, uint8_t* output, int numFrames) {
+
+    assert(numFrames * _numChannels <= ADPCM_MAX_SAMPLES);
+    assert((numFrames * _numChannels) % ADPCM_LANES == 0);
+
+    int laneFrames = (numFrames * _numChannels) / ADPCM_LANES;
+    deinterleaveLanes(input, _lanes, _numChannels, laneFrames);
+
+    // header: the first sample is sent verbatim, and seeds the predictor
+    int32_t pred[ADPCM_LANES];
+    for (int j = 0; j < ADPCM_LANES; j++) {
+        pred[j] = _lanes[j];
+        memcpy(&output[sizeof(int16_t) * j], &_lanes[j], sizeof(int16_t));
+        output[sizeof(int16_t) * ADPCM_LANES + j] = (uint8_t)_index[j];
+    }
+
+    ADPCM_encode(&_lanes[ADPCM_LANES], &output[ADPCM_HEADER_BYTES], pred, _index, laneFrames - 1);
+}
+
+AudioADPCMDecoder::AudioADPCMDecoder(int numChannels) : _numChannels(numChannels) {
+    assert(AudioADPCM::isValidChannelCount(numChannels));
+}
+
+void AudioADPCMDecoder::decode(const uint8_t* input, int16_t* output, int numFrames) {
+
+    assert(numFrames * _numChannels <= ADPCM_MAX_SAMPLES);
+    assert((numFrames * _numChannels) % ADPCM_LANES == 0);
+
+    int laneFrames = (numFrames * _numChannels) / ADPCM_LANES;
+
+    int32_t pred[ADPCM_LANES];
+    int32_t index[ADPCM_LANES];
+    for (int j = 0; j < ADPCM_LANES; j++) {
+        memcpy(&_lanes[j], &input[sizeof(int16_t) * j], sizeof(int16_t));
+        pred[j] = _lanes[j];
+        index[j] = clampIndex(input[sizeof(int16_t) * ADPCM_LANES + j]);   // untrusted
+    }
+
+    ADPCM_decode(&input[ADPCM_HEADER_BYTES], &_lanes[ADPCM_LANES], pred, index, laneFrames - 1);
+
+    interleaveLanes(_lanes, output, _numChannels, laneFrames);
+}
@@ -0,0 +1,88 @@
+//
+//  AudioADPCM.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioADPCM_h
+#define hifi_AudioADPCM_h
+
+#include <stdint.h>
+
+//
+// Fixed-ratio (4 bits/sample) adaptive differential codec, based on IMA ADPCM.
+//
+// Each frame is split into ADPCM_LANES independent lanes (contiguous runs of a single channel),
+// which are coded in parallel using SIMD. Every lane carries its own predictor and step index
+// in the frame header, so frames decode independently and packet loss does not corrupt
+// subsequent frames.
+//
+// Frame layout:
+//   int16_t  first sample of each lane      [ADPCM_LANES]
+//   uint8_t  initial step index of each lane [ADPCM_LANES]
+//   uint8_t  packed codes, time-major, two lanes per byte [laneFrames-1][ADPCM_LANES/2]
+//
+
+static const int ADPCM_LANES = 8;
+static const int ADPCM_HEADER_BYTES = ADPCM_LANES * (sizeof(int16_t) + sizeof(uint8_t));
+static const int ADPCM_BYTES_PER_STEP = ADPCM_LANES / 2;
+static const int ADPCM_MAX_INDEX = 88;
+
+extern const int32_t ADPCM_STEP_TABLE[ADPCM_MAX_INDEX + 1];
+
+static const int ADPCM_MAX_SAMPLES = 8192;  // max interleaved samples per call
+
+class AudioADPCM {
+public:
+    // numChannels must divide ADPCM_LANES (1, 2, 4 or 8)
+    static bool isValidChannelCount(int numChannels) {
+        return numChannels > 0 && numChannels <= ADPCM_LANES && (ADPCM_LANES % numChannels) == 0;
+    }
+
+    // numFrames must be a multiple of (ADPCM_LANES / numChannels)
+    static int getEncodedSize(int numChannels, int numFrames) {
+        int laneFrames = (numFrames * numChannels) / ADPCM_LANES;
+        return ADPCM_HEADER_BYTES + (laneFrames - 1) * ADPCM_BYTES_PER_STEP;
+    }
+};
+
+class AudioADPCMEncoder {
+public:
+    AudioADPCMEncoder(int numChannels);
+
+    //
+    // input: interleaved int16_t samples
+    // output: AudioADPCM::getEncodedSize(numChannels, numFrames) bytes
+    //
+    void encode(const int16_t* input, uint8_t* output, int numFrames);
+
+private:
+    int _numChannels;
+
+    // step index at the end of the previous frame, used to seed the next one
+    int32_t _index[ADPCM_LANES] {};
+
+    int16_t _lanes[ADPCM_MAX_SAMPLES];  // deinterleaved, time-major
+};
+
+class AudioADPCMDecoder {
+public:
+    AudioADPCMDecoder(int numChannels);
+
+    //
+    // input: AudioADPCM::getEncodedSize(numChannels, numFrames) bytes
+    // output: interleaved int16_t samples
+    //
+    void decode(const uint8_t* input, int16_t* output, int numFrames);
+
+private:
+    int _numChannels;
+
+    int16_t _lanes[ADPCM_MAX_SAMPLES];  // deinterleaved, time-major
+};
+
+#endif // hifi_AudioADPCM_h
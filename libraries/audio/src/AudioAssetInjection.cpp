@@ -0,0 +1,107 @@
+//
+//  AudioAssetInjection.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioAssetInjection.h"
+
+#include <AssetUtils.h>
+#include <ResourceManager.h>
+#include <UUID.h>
+#include <udt/PacketHeaders.h>
+
+AudioAssetInjection::AudioAssetInjection(const QUuid& injectorID, const QUrl& url, const AudioInjectorOptions& options) :
+    injectorID(injectorID),
+    url(url),
+    position(options.position),
+    orientation(options.orientation),
+    volume(options.volume),
+    secondOffset(options.secondOffset),
+    loop(options.loop),
+    ignorePenumbra(options.ignorePenumbra)
+{
+}
+
+QUrl AudioAssetInjection::urlForSound(const QString& urlOrHash) {
+    if (isValidHash(urlOrHash)) {
+        return QUrl(URL_SCHEME_ATP + ":" + urlOrHash + ".wav");
+    }
+    QUrl url(urlOrHash);
+    return isPermittedURL(url) ? url : QUrl();
+}
+
+bool AudioAssetInjection::isPermittedURL(const QUrl& url) {
+    if (!url.isValid() || url.scheme() != URL_SCHEME_ATP || !url.host().isEmpty() ||
+        url.hasQuery() || url.hasFragment()) {
+        return false;
+    }
+
+    // the hash, with an optional extension telling the SoundCache how to decode it
+    QString path = url.path();
+    int extensionStart = path.indexOf('.');
+    QString hash = (extensionStart >= 0) ? path.left(extensionStart) : path;
+    QString extension = (extensionStart >= 0) ? path.mid(extensionStart + 1) : QString();
+    for (auto c : extension) {
+        if (!c.isLetterOrNumber()) {
+            return false;
+        }
+    }
+    return isValidHash(hash);
+}
+
+bool AudioAssetInjection::isPermittedFor(const NodePermissions& permissions) const {
+    return isStop || (permissions.can(NodePermissions::Permission::canRezTemporaryEntities) && isPermittedURL(url));
+}
+
+AudioAssetInjection AudioAssetInjection::stop(const QUuid& injectorID) {
+    AudioAssetInjection injection;
+    injection.injectorID = injectorID;
+    injection.isStop = true;
+    return injection;
+}
+
+std::unique_ptr<NLPacket> AudioAssetInjection::toPacket() const {
+    // start and stop requests are not repeated like audio frames, so they must not be lost
+    auto packet = NLPacket::create(PacketType::InjectAudioAsset, -1, true);
+
+    packet->write(injectorID.toRfc4122());
+
+    quint8 flags = (loop ? LOOP : 0) | (isStop ? STOP : 0) | (ignorePenumbra ? IGNORE_PENUMBRA : 0);
+    packet->writePrimitive(flags);
+
+    if (!isStop) {
+        packet->writeString(url.toString());
+        packet->writePrimitive(position);
+        packet->writePrimitive(orientation);
+        packet->writePrimitive(volume);
+        packet->writePrimitive(secondOffset);
+    }
+
+    return packet;
+}
+
+AudioAssetInjection AudioAssetInjection::fromMessage(ReceivedMessage& message) {
+    AudioAssetInjection injection;
+    injection.injectorID = QUuid::fromRfc4122(message.readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+
+    quint8 flags;
+    message.readPrimitive(&flags);
+    injection.loop = (flags & LOOP) != 0;
+    injection.isStop = (flags & STOP) != 0;
+    injection.ignorePenumbra = (flags & IGNORE_PENUMBRA) != 0;
+
+    if (!injection.isStop) {
+        injection.url = QUrl(message.readString());
+        message.readPrimitive(&injection.position);
+        message.readPrimitive(&injection.orientation);
+        message.readPrimitive(&injection.volume);
+        message.readPrimitive(&injection.secondOffset);
+    }
+
+    return injection;
+}
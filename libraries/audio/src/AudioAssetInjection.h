@@ -0,0 +1,69 @@
+//
+//  AudioAssetInjection.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioAssetInjection_h
+#define hifi_AudioAssetInjection_h
+
+#include <memory>
+
+#include <QtCore/QUrl>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <NLPacket.h>
+#include <NodePermissions.h>
+#include <ReceivedMessage.h>
+
+#include "AudioInjectorOptions.h"
+
+// A request for the audio mixer to play a sound asset itself, mixed like an injected stream.
+// Only the URL and options cross the network; the mixer fetches, decodes and caches the audio.
+// Sending it again with the same injectorID updates the options of a playing sound.
+class AudioAssetInjection {
+public:
+    enum Flag : quint8 {
+        LOOP = 1 << 0,
+        STOP = 1 << 1,
+        IGNORE_PENUMBRA = 1 << 2
+    };
+
+    AudioAssetInjection() = default;
+    AudioAssetInjection(const QUuid& injectorID, const QUrl& url, const AudioInjectorOptions& options);
+
+    // a bare asset hash is played as a WAV asset from the asset server. anything but a hash or an atp: URL of
+    // one gives an empty URL, see isPermittedURL
+    static QUrl urlForSound(const QString& urlOrHash);
+
+    // the mixer only fetches assets of the domain's asset server by hash, e.g. atp:<hash>.wav. any other
+    // scheme, host or path would let a client make the mixer fetch and play back arbitrary resources.
+    static bool isPermittedURL(const QUrl& url);
+
+    // starting or updating a sound needs the permission to rez temporary entities, stopping one is always allowed
+    bool isPermittedFor(const NodePermissions& permissions) const;
+
+    static AudioAssetInjection stop(const QUuid& injectorID);
+
+    std::unique_ptr<NLPacket> toPacket() const;
+    static AudioAssetInjection fromMessage(ReceivedMessage& message);
+
+    QUuid injectorID;
+    QUrl url;
+    glm::vec3 position;
+    glm::quat orientation;
+    float volume { 1.0f };
+    float secondOffset { 0.0f };
+    bool loop { false };
+    bool ignorePenumbra { false };
+    bool isStop { false };
+};
+
+#endif // hifi_AudioAssetInjection_h
@@ -243,14 +243,14 @@ int AudioRingBufferTemplate<T>::addSilentSamples(int silentSamples) {
 template <class T>
 float AudioRingBufferTemplate<T>::getFrameLoudness(const Sample* frameStart) const {
     // FIXME: This is a bad measure of loudness - normal estimation uses sqrt(sum(x*x))
-    float loudness = 0.0f;
-    const Sample* sampleAt = frameStart;
-    const Sample* bufferLastAt = _buffer + _bufferLength - 1;
-
-    for (int i = 0; i < _numFrameSamples; ++i) {
-        loudness += (float) std::abs(*sampleAt);
-        // wrap if necessary
-        sampleAt = sampleAt == bufferLastAt ? _buffer : sampleAt + 1;
+    float loudness;
+    int numSamplesToEnd = (_buffer + _bufferLength) - frameStart;
+
+    if (numSamplesToEnd < _numFrameSamples) {
+        // the frame wraps around the edge
+        loudness = sumAbsSamples(frameStart, numSamplesToEnd) + sumAbsSamples(_buffer, _numFrameSamples - numSamplesToEnd);
+    } else {
+        loudness = sumAbsSamples(frameStart, _numFrameSamples);
     }
     loudness /= _numFrameSamples;
     loudness /= AudioConstants::MAX_SAMPLE_VALUE;
@@ -278,12 +278,12 @@ int AudioRingBufferTemplate<T>::writeSamples(ConstIterator source, int maxSample
         qCDebug(audio) << qPrintable(RING_BUFFER_OVERFLOW_DEBUG);
     }
 
-    Sample* bufferLast = _buffer + _bufferLength - 1;
-    for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = *source;
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
-        ++source;
-    }
+    // write to the end of the buffer, then the rest to the beginning (the source wraps on its own)
+    int numSamplesToEnd = std::min(samplesToCopy, (int)((_buffer + _bufferLength) - _endOfLastWrite));
+    source.readSamples(_endOfLastWrite, numSamplesToEnd);
+    source.readSamples(_buffer, samplesToCopy - numSamplesToEnd);
+
+    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, samplesToCopy);
 
     return samplesToCopy;
 }
@@ -300,12 +300,12 @@ int AudioRingBufferTemplate<T>::writeSamplesWithFade(ConstIterator source, int m
         qCDebug(audio) << qPrintable(RING_BUFFER_OVERFLOW_DEBUG);
     }
 
-    Sample* bufferLast = _buffer + _bufferLength - 1;
-    for (int i = 0; i < samplesToCopy; i++) {
-        *_endOfLastWrite = (Sample)((float)(*source) * fade);
-        _endOfLastWrite = (_endOfLastWrite == bufferLast) ? _buffer : _endOfLastWrite + 1;
-        ++source;
-    }
+    // write to the end of the buffer, then the rest to the beginning (the source wraps on its own)
+    int numSamplesToEnd = std::min(samplesToCopy, (int)((_buffer + _bufferLength) - _endOfLastWrite));
+    source.readSamplesWithFade(_endOfLastWrite, numSamplesToEnd, fade);
+    (source + numSamplesToEnd).readSamplesWithFade(_buffer, samplesToCopy - numSamplesToEnd, fade);
+
+    _endOfLastWrite = shiftedPositionAccomodatingWrap(_endOfLastWrite, samplesToCopy);
 
     return samplesToCopy;
 }
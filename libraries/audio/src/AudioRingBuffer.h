@@ -13,6 +13,9 @@
 #define hifi_AudioRingBuffer_h
 
 #include "AudioConstants.h"
+#include "AudioSampleOps.h"
+
+#include <cmath>
 
 #include <QtCore/QIODevice>
 
@@ -174,11 +177,14 @@ public:
             }
         }
         void readSamplesWithFade(Sample* dest, int numSamples, float fade) {
-            Sample* at = _at;
-            for (int i = 0; i < numSamples; i++) {
-                *dest = (float)*at * fade;
-                ++dest;
-                at = (at == _bufferLast) ? _bufferFirst : at + 1;
+            auto samplesToEnd = _bufferLast - _at + 1;
+
+            if (samplesToEnd >= numSamples) {
+                fadeSamples(_at, dest, numSamples, fade);
+            } else {
+                auto samplesFromStart = numSamples - samplesToEnd;
+                fadeSamples(_at, dest, samplesToEnd, fade);
+                fadeSamples(_bufferFirst, dest + samplesToEnd, samplesFromStart, fade);
             }
         }
 
@@ -211,6 +217,26 @@ public:
     float getFrameLoudness(ConstIterator frameStart) const;
 
 protected:
+    // bulk kernels for each sample type, applied to contiguous runs of the buffer
+    static void fadeSamples(const int16_t* source, int16_t* dest, int numSamples, float fade) {
+        scaleInt16(source, dest, numSamples, fade);
+    }
+    static void fadeSamples(const float* source, float* dest, int numSamples, float fade) {
+        for (int i = 0; i < numSamples; i++) {
+            dest[i] = source[i] * fade;
+        }
+    }
+    static float sumAbsSamples(const int16_t* source, int numSamples) {
+        return (float)sumAbsInt16(source, numSamples);
+    }
+    static float sumAbsSamples(const float* source, int numSamples) {
+        float sum = 0.0f;
+        for (int i = 0; i < numSamples; i++) {
+            sum += std::abs(source[i]);
+        }
+        return sum;
+    }
+
     Sample* shiftedPositionAccomodatingWrap(Sample* position, int numSamplesShift) const;
     float getFrameLoudness(const Sample* frameStart) const;
 
@@ -0,0 +1,262 @@
+//
+//  AudioSampleOps.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <math.h>
+
+#include "AudioSampleOps.h"
+
+// sumAbsInt16 is computed in blocks small enough that 32-bit lanes cannot overflow
+static const int SUM_ABS_BLOCK = 32768;
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+// sign-extend 4 samples to int32, and convert to float
+static inline __m128 loadInt16x4(const int16_t* src) {
+    __m128i x = _mm_loadl_epi64((const __m128i*)src);
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+}
+
+static void convertInt16ToFloat_SSE2(const int16_t* src, float* dst, int numSamples, float scale) {
+
+    __m128 s = _mm_set1_ps(scale);
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)&src[i]);
+        __m128 x0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+        __m128 x1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+        _mm_storeu_ps(&dst[i+0], _mm_mul_ps(x0, s));
+        _mm_storeu_ps(&dst[i+4], _mm_mul_ps(x1, s));
+    }
+    for (; i < numSamples; i++) {
+        dst[i] = (float)src[i] * scale;
+    }
+}
+
+static void convertFloatToInt16_SSE2(const float* src, int16_t* dst, int numSamples, float scale) {
+
+    __m128 s = _mm_set1_ps(scale);
+    __m128 lo = _mm_set1_ps(-32768.0f);
+    __m128 hi = _mm_set1_ps(32767.0f);
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        __m128 x0 = _mm_mul_ps(_mm_loadu_ps(&src[i+0]), s);
+        __m128 x1 = _mm_mul_ps(_mm_loadu_ps(&src[i+4]), s);
+
+        // clamp before converting, as out-of-range conversions return 0x80000000
+        x0 = _mm_min_ps(_mm_max_ps(x0, lo), hi);
+        x1 = _mm_min_ps(_mm_max_ps(x1, lo), hi);
+
+        // round to nearest, as lrintf()
+        __m128i y = _mm_packs_epi32(_mm_cvtps_epi32(x0), _mm_cvtps_epi32(x1));
+        _mm_storeu_si128((__m128i*)&dst[i], y);
+    }
+    for (; i < numSamples; i++) {
+        float x = src[i] * scale;
+        x = (x < -32768.0f) ? -32768.0f : ((x > 32767.0f) ? 32767.0f : x);
+        dst[i] = (int16_t)lrintf(x);
+    }
+}
+
+static void accumulateInt16ToFloat_SSE2(const int16_t* src, float* dst, int numSamples, float gain) {
+
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)&src[i]);
+        __m128 x0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+        __m128 x1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+        _mm_storeu_ps(&dst[i+0], _mm_add_ps(_mm_loadu_ps(&dst[i+0]), _mm_mul_ps(x0, g)));
+        _mm_storeu_ps(&dst[i+4], _mm_add_ps(_mm_loadu_ps(&dst[i+4]), _mm_mul_ps(x1, g)));
+    }
+    for (; i < numSamples; i++) {
+        dst[i] += (float)src[i] * gain;
+    }
+}
+
+static void accumulateMonoInt16ToStereoFloat_SSE2(const int16_t* src, float* dst, int numFrames, float gain) {
+
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        __m128 x = _mm_mul_ps(loadInt16x4(&src[i]), g);
+
+        // duplicate each sample into left and right
+        __m128 x0 = _mm_unpacklo_ps(x, x);
+        __m128 x1 = _mm_unpackhi_ps(x, x);
+        _mm_storeu_ps(&dst[2*i+0], _mm_add_ps(_mm_loadu_ps(&dst[2*i+0]), x0));
+        _mm_storeu_ps(&dst[2*i+4], _mm_add_ps(_mm_loadu_ps(&dst[2*i+4]), x1));
+    }
+    for (; i < numFrames; i++) {
+        float x = (float)src[i] * gain;
+        dst[2*i+0] += x;
+        dst[2*i+1] += x;
+    }
+}
+
+static void scaleInt16_SSE2(const int16_t* src, int16_t* dst, int numSamples, float gain) {
+
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)&src[i]);
+        __m128 x0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+        __m128 x1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+
+        // truncate, as a C cast
+        __m128i y = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(x0, g)), _mm_cvttps_epi32(_mm_mul_ps(x1, g)));
+        _mm_storeu_si128((__m128i*)&dst[i], y);
+    }
+    for (; i < numSamples; i++) {
+        dst[i] = (int16_t)((float)src[i] * gain);
+    }
+}
+
+// numSamples <= SUM_ABS_BLOCK
+static int32_t sumAbsInt16_SSE2(const int16_t* src, int numSamples) {
+
+    __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)&src[i]);
+
+        // |x| = (x ^ sign) - sign, summed in pairs at 32 bits so that |-32768| does not wrap
+        __m128i sign = _mm_srai_epi16(x, 15);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_xor_si128(x, sign), ones));
+        acc = _mm_sub_epi32(acc, _mm_madd_epi16(sign, ones));
+    }
+
+    // horizontal sum
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    int32_t sum = _mm_cvtsi128_si32(acc);
+
+    for (; i < numSamples; i++) {
+        sum += (src[i] < 0) ? -(int32_t)src[i] : (int32_t)src[i];
+    }
+    return sum;
+}
+
+//
+// Runtime CPU dispatch
+//
+
+#include "CPUDetect.h"
+
+void convertInt16ToFloat_AVX2(const int16_t* src, float* dst, int numSamples, float scale);
+void convertFloatToInt16_AVX2(const float* src, int16_t* dst, int numSamples, float scale);
+void accumulateInt16ToFloat_AVX2(const int16_t* src, float* dst, int numSamples, float gain);
+void accumulateMonoInt16ToStereoFloat_AVX2(const int16_t* src, float* dst, int numFrames, float gain);
+void scaleInt16_AVX2(const int16_t* src, int16_t* dst, int numSamples, float gain);
+int32_t sumAbsInt16_AVX2(const int16_t* src, int numSamples);
+
+void convertInt16ToFloat(const int16_t* src, float* dst, int numSamples, float scale) {
+
+    static auto f = cpuSupportsAVX2() ? convertInt16ToFloat_AVX2 : convertInt16ToFloat_SSE2;
+    (*f)(src, dst, numSamples, scale); // dispatch
+}
+
+void convertFloatToInt16(const float* src, int16_t* dst, int numSamples, float scale) {
+
+    static auto f = cpuSupportsAVX2() ? convertFloatToInt16_AVX2 : convertFloatToInt16_SSE2;
+    (*f)(src, dst, numSamples, scale); // dispatch
+}
+
+void accumulateInt16ToFloat(const int16_t* src, float* dst, int numSamples, float gain) {
+
+    static auto f = cpuSupportsAVX2() ? accumulateInt16ToFloat_AVX2 : accumulateInt16ToFloat_SSE2;
+    (*f)(src, dst, numSamples, gain); // dispatch
+}
+
+void accumulateMonoInt16ToStereoFloat(const int16_t* src, float* dst, int numFrames, float gain) {
+
+    static auto f = cpuSupportsAVX2() ? accumulateMonoInt16ToStereoFloat_AVX2 : accumulateMonoInt16ToStereoFloat_SSE2;
+    (*f)(src, dst, numFrames, gain); // dispatch
+}
+
+void scaleInt16(const int16_t* src, int16_t* dst, int numSamples, float gain) {
+
+    static auto f = cpuSupportsAVX2() ? scaleInt16_AVX2 : scaleInt16_SSE2;
+    (*f)(src, dst, numSamples, gain); // dispatch
+}
+
+static int32_t sumAbsInt16Block(const int16_t* src, int numSamples) {
+
+    static auto f = cpuSupportsAVX2() ? sumAbsInt16_AVX2 : sumAbsInt16_SSE2;
+    return (*f)(src, numSamples); // dispatch
+}
+
+#else   // portable reference code
+
+// all SIMD variants must produce bit-identical conversions
+
+void convertInt16ToFloat(const int16_t* src, float* dst, int numSamples, float scale) {
+    for (int i = 0; i < numSamples; i++) {
+        dst[i] = (float)src[i] * scale;
+    }
+}
+
+void convertFloatToInt16(const float* src, int16_t* dst, int numSamples, float scale) {
+    for (int i = 0; i < numSamples; i++) {
+        float x = src[i] * scale;
+        x = (x < -32768.0f) ? -32768.0f : ((x > 32767.0f) ? 32767.0f : x);
+        dst[i] = (int16_t)lrintf(x);
+    }
+}
+
+void accumulateInt16ToFloat(const int16_t* src, float* dst, int numSamples, float gain) {
+    for (int i = 0; i < numSamples; i++) {
+        dst[i] += (float)src[i] * gain;
+    }
+}
+
+void accumulateMonoInt16ToStereoFloat(const int16_t* src, float* dst, int numFrames, float gain) {
+    for (int i = 0; i < numFrames; i++) {
+        float x = (float)src[i] * gain;
+        dst[2*i+0] += x;
+        dst[2*i+1] += x;
+    }
+}
+
+void scaleInt16(const int16_t* src, int16_t* dst, int numSamples, float gain) {
+    for (int i = 0; i < numSamples; i++) {
+        dst[i] = (int16_t)((float)src[i] * gain);
+    }
+}
+
+static int32_t sumAbsInt16Block(const int16_t* src, int numSamples) {
+    int32_t sum = 0;
+    for (int i = 0; i < numSamples; i++) {
+        sum += (src[i] < 0) ? -(int32_t)src[i] : (int32_t)src[i];
+    }
+    return sum;
+}
+
+#endif
+
+int64_t sumAbsInt16(const int16_t* src, int numSamples) {
+    int64_t sum = 0;
+    for (int i = 0; i < numSamples; i += SUM_ABS_BLOCK) {
+        int n = (numSamples - i < SUM_ABS_BLOCK) ? (numSamples - i) : SUM_ABS_BLOCK;
+        sum += sumAbsInt16Block(&src[i], n);
+    }
+    return sum;
+}
@@ -0,0 +1,42 @@
+//
+//  AudioSampleOps.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSampleOps_h
+#define hifi_AudioSampleOps_h
+
+#include <stdint.h>
+
+//
+// Bulk sample-format kernels, vectorized with SSE2/AVX2 (runtime dispatch) on x86.
+//
+// Buffers need not be aligned, and any numSamples >= 0 is allowed.
+// Conversions are bit-identical to the scalar expressions noted below; accumulations may
+// differ in the last bit, as the AVX2 kernels use fused multiply-add.
+//
+
+// dst[i] = (float)src[i] * scale
+void convertInt16ToFloat(const int16_t* src, float* dst, int numSamples, float scale);
+
+// dst[i] = (int16_t)lrintf(clamp(src[i] * scale, -32768.0f, 32767.0f))
+void convertFloatToInt16(const float* src, int16_t* dst, int numSamples, float scale);
+
+// dst[i] += (float)src[i] * gain
+void accumulateInt16ToFloat(const int16_t* src, float* dst, int numSamples, float gain);
+
+// mono into interleaved stereo: dst[2*i] += (float)src[i] * gain, dst[2*i+1] += (float)src[i] * gain
+void accumulateMonoInt16ToStereoFloat(const int16_t* src, float* dst, int numFrames, float gain);
+
+// dst[i] = (int16_t)((float)src[i] * gain), truncating toward zero
+void scaleInt16(const int16_t* src, int16_t* dst, int numSamples, float gain);
+
+// sum of |src[i]|
+int64_t sumAbsInt16(const int16_t* src, int numSamples);
+
+#endif // hifi_AudioSampleOps_h
@@ -0,0 +1,75 @@
+//
+//  AudioSourceSlots.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSourceSlots.h"
+
+#include <new>
+
+AudioSourceSlot AudioSourceSlotAllocator::allocate() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    AudioSourceSlot slot;
+    if (!_freeIndices.empty()) {
+        slot.index = _freeIndices.top();
+        _freeIndices.pop();
+    } else {
+        slot.index = (uint32_t)_generations.size();
+        _generations.push_back(1);
+    }
+    slot.generation = _generations[slot.index];
+    return slot;
+}
+
+void AudioSourceSlotAllocator::release(AudioSourceSlot slot) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!slot.isValid() || slot.index >= _generations.size() || _generations[slot.index] != slot.generation) {
+        return; // already released
+    }
+
+    // skip 0 on wrap, it marks unused entries
+    uint32_t& generation = _generations[slot.index];
+    if (++generation == 0) {
+        generation = 1;
+    }
+    _freeIndices.push(slot.index);
+}
+
+uint32_t AudioSourceSlotAllocator::getCapacity() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (uint32_t)_generations.size();
+}
+
+AudioHRTF& AudioHRTFSlots::get(AudioSourceSlot slot, bool& isNew) {
+    uint32_t chunk = slot.index / CHUNK_SIZE;
+    while (chunk >= _chunks.size()) {
+        _chunks.emplace_back(new Entry[CHUNK_SIZE]);
+    }
+
+    Entry& entry = _chunks[chunk][slot.index % CHUNK_SIZE];
+    isNew = (entry.generation != slot.generation);
+    if (isNew) {
+        // AudioHRTF cannot be assigned, so rebuild it in place to clear the filter history
+        entry.hrtf.~AudioHRTF();
+        new (&entry.hrtf) AudioHRTF();
+        entry.generation = slot.generation;
+    }
+    return entry.hrtf;
+}
+
+AudioHRTF* AudioHRTFSlots::find(AudioSourceSlot slot) {
+    uint32_t chunk = slot.index / CHUNK_SIZE;
+    if (!slot.isValid() || chunk >= _chunks.size()) {
+        return nullptr;
+    }
+
+    Entry& entry = _chunks[chunk][slot.index % CHUNK_SIZE];
+    return (entry.generation == slot.generation) ? &entry.hrtf : nullptr;
+}
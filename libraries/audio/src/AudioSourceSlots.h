@@ -0,0 +1,83 @@
+//
+//  AudioSourceSlots.h
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSourceSlots_h
+#define hifi_AudioSourceSlots_h
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include "AudioHRTF.h"
+
+//
+// Small-integer handles for audio sources, so per-listener state can live in flat arrays
+// instead of hash maps keyed by node and stream UUIDs.
+//
+// Indices are recycled lowest-first to keep the arrays dense. Every release bumps the
+// generation of the index, so state left behind by a previous owner of the index is
+// detected and reset rather than inherited.
+//
+struct AudioSourceSlot {
+    uint32_t index { 0 };
+    uint32_t generation { 0 };  // 0 is never handed out, and marks an unused slot
+
+    bool isValid() const { return generation != 0; }
+};
+
+class AudioSourceSlotAllocator {
+public:
+    AudioSourceSlot allocate();
+    void release(AudioSourceSlot slot);
+
+    // one past the highest index ever handed out
+    uint32_t getCapacity() const;
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<uint32_t> _generations;
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> _freeIndices;
+};
+
+//
+// Per-listener HRTF state, indexed by source slot.
+//
+// AudioHRTF is neither copyable nor movable, so the array grows in fixed-size chunks;
+// each chunk is contiguous and entries never move once created.
+//
+class AudioHRTFSlots {
+public:
+    static const uint32_t CHUNK_SIZE = 64;
+
+    // returns the HRTF for the slot; it is reset first if the slot was reused since the last call,
+    // in which case isNew is set so the caller can restore any per-source settings
+    AudioHRTF& get(AudioSourceSlot slot, bool& isNew);
+
+    AudioHRTF& get(AudioSourceSlot slot) { bool isNew; return get(slot, isNew); }
+
+    // returns the HRTF for the slot only if it is current, without creating it
+    AudioHRTF* find(AudioSourceSlot slot);
+
+    size_t getNumChunks() const { return _chunks.size(); }
+
+private:
+    struct Entry {
+        uint32_t generation { 0 };
+        AudioHRTF hrtf;
+    };
+
+    std::vector<std::unique_ptr<Entry[]>> _chunks;
+};
+
+#endif // hifi_AudioSourceSlots_h
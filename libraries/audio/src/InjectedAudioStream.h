@@ -34,6 +34,8 @@ private:
     int parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) override;
 
     const QUuid _streamIdentifier;
+
+protected:
     float _radius;
     float _attenuationRatio;
 };
@@ -36,7 +36,8 @@ PositionalAudioStream::PositionalAudioStream(PositionalAudioStream::Type type, b
     _lastPopOutputLoudness(0.0f),
     _quietestTrailingFrameLoudness(std::numeric_limits<float>::max()),
     _quietestFrameLoudness(0.0f),
-    _frameCounter(0) {}
+    _frameCounter(0),
+    _framesSinceAudible(std::numeric_limits<int>::max()) {}
 
 void PositionalAudioStream::resetStats() {
     _lastPopOutputTrailingLoudness = 0.0f;
@@ -52,6 +53,12 @@ void PositionalAudioStream::updateLastPopOutputLoudnessAndTrailingLoudness() {
     const float PREVIOUS_FRAMES_RATIO = 1.0f - CURRENT_FRAME_RATIO;
     const float LOUDNESS_EPSILON = 0.000001f;
 
+    if (_lastPopOutputLoudness > 0.0f) {
+        _framesSinceAudible = 0;
+    } else if (_framesSinceAudible < std::numeric_limits<int>::max()) {
+        ++_framesSinceAudible;
+    }
+
     if (_lastPopOutputLoudness >= _lastPopOutputTrailingLoudness) {
         _lastPopOutputTrailingLoudness = _lastPopOutputLoudness;
     } else {
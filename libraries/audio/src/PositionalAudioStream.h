@@ -40,6 +40,7 @@ public:
     float getLastPopOutputTrailingLoudness() const { return _lastPopOutputTrailingLoudness; }
     float getLastPopOutputLoudness() const { return _lastPopOutputLoudness; }
     float getQuietestFrameLoudness() const { return _quietestFrameLoudness; }
+    int getFramesSinceAudible() const { return _framesSinceAudible; }
 
     bool shouldLoopbackForNode() const { return _shouldLoopbackForNode; }
     bool isStereo() const { return _isStereo; }
@@ -75,6 +76,7 @@ protected:
     float _quietestTrailingFrameLoudness;
     float _quietestFrameLoudness;
     int _frameCounter;
+    int _framesSinceAudible;
 };
 
 #endif // hifi_PositionalAudioStream_h
@@ -0,0 +1,136 @@
+//
+//  AudioADPCM_avx2.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <string.h>
+#include <immintrin.h>  // AVX2
+
+#include "../AudioADPCM.h"
+
+#ifndef __AVX2__
+#error Must be compiled with /arch:AVX2 or -mavx2 -mfma.
+#endif
+
+static inline __m256i indexDelta(const __m256i code) {
+    __m256i m = _mm256_and_si256(code, _mm256_set1_epi32(7));
+    __m256i big = _mm256_cmpgt_epi32(m, _mm256_set1_epi32(3));
+    __m256i up = _mm256_sub_epi32(_mm256_add_epi32(m, m), _mm256_set1_epi32(6));
+    return _mm256_blendv_epi8(_mm256_set1_epi32(-1), up, big);
+}
+
+static inline __m256i clampSample(const __m256i x) {
+    return _mm256_min_epi32(_mm256_max_epi32(x, _mm256_set1_epi32(-32768)), _mm256_set1_epi32(32767));
+}
+
+static inline __m256i clampIndex(const __m256i x) {
+    return _mm256_min_epi32(_mm256_max_epi32(x, _mm256_setzero_si256()), _mm256_set1_epi32(ADPCM_MAX_INDEX));
+}
+
+void ADPCM_encode_AVX2(const int16_t* src, uint8_t* dst, int32_t* pred, int32_t* index, int numSteps) {
+
+    static_assert(ADPCM_LANES == 8, "AVX2 kernel assumes 8 lanes");
+
+    __m256i p = _mm256_loadu_si256((__m256i*)pred);
+    __m256i idx = _mm256_loadu_si256((__m256i*)index);
+
+    for (int i = 0; i < numSteps; i++) {
+
+        __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)&src[ADPCM_LANES * i]));
+
+        __m256i step = _mm256_i32gather_epi32((const int*)ADPCM_STEP_TABLE, idx, 4);
+        __m256i diff = _mm256_sub_epi32(x, p);
+        __m256i sign = _mm256_srai_epi32(diff, 31);
+        diff = _mm256_abs_epi32(diff);
+
+        __m256i vpdiff = _mm256_srai_epi32(step, 3);
+        __m256i code;
+        __m256i m;
+
+        m = _mm256_cmpgt_epi32(step, diff);     // m = (diff < step)
+        code = _mm256_andnot_si256(m, _mm256_set1_epi32(4));
+        diff = _mm256_sub_epi32(diff, _mm256_andnot_si256(m, step));
+        vpdiff = _mm256_add_epi32(vpdiff, _mm256_andnot_si256(m, step));
+        step = _mm256_srai_epi32(step, 1);
+
+        m = _mm256_cmpgt_epi32(step, diff);
+        code = _mm256_or_si256(code, _mm256_andnot_si256(m, _mm256_set1_epi32(2)));
+        diff = _mm256_sub_epi32(diff, _mm256_andnot_si256(m, step));
+        vpdiff = _mm256_add_epi32(vpdiff, _mm256_andnot_si256(m, step));
+        step = _mm256_srai_epi32(step, 1);
+
+        m = _mm256_cmpgt_epi32(step, diff);
+        code = _mm256_or_si256(code, _mm256_andnot_si256(m, _mm256_set1_epi32(1)));
+        vpdiff = _mm256_add_epi32(vpdiff, _mm256_andnot_si256(m, step));
+
+        vpdiff = _mm256_sub_epi32(_mm256_xor_si256(vpdiff, sign), sign);  // apply sign
+        p = clampSample(_mm256_add_epi32(p, vpdiff));
+        idx = clampIndex(_mm256_add_epi32(idx, indexDelta(code)));
+
+        code = _mm256_or_si256(code, _mm256_and_si256(sign, _mm256_set1_epi32(8)));
+
+        // pack nibbles: each int32 of c holds (code[2k] | code[2k+1] << 16)
+        __m128i c = _mm_packs_epi32(_mm256_castsi256_si128(code), _mm256_extracti128_si256(code, 1));
+        c = _mm_and_si128(_mm_or_si128(c, _mm_srli_epi32(c, 12)), _mm_set1_epi32(0xff));
+        c = _mm_packs_epi32(c, c);
+        c = _mm_packus_epi16(c, c);
+
+        int32_t bytes = _mm_cvtsi128_si32(c);
+        memcpy(&dst[ADPCM_BYTES_PER_STEP * i], &bytes, ADPCM_BYTES_PER_STEP);
+    }
+
+    _mm256_storeu_si256((__m256i*)pred, p);
+    _mm256_storeu_si256((__m256i*)index, idx);
+}
+
+void ADPCM_decode_AVX2(const uint8_t* src, int16_t* dst, int32_t* pred, int32_t* index, int numSteps) {
+
+    static_assert(ADPCM_LANES == 8, "AVX2 kernel assumes 8 lanes");
+
+    __m256i p = _mm256_loadu_si256((__m256i*)pred);
+    __m256i idx = _mm256_loadu_si256((__m256i*)index);
+
+    for (int i = 0; i < numSteps; i++) {
+
+        int32_t bytes;
+        memcpy(&bytes, &src[ADPCM_BYTES_PER_STEP * i], ADPCM_BYTES_PER_STEP);
+
+        // unpack nibbles into 8 int32 lanes
+        __m128i b = _mm_cvtsi32_si128(bytes);
+        __m128i lo = _mm_and_si128(b, _mm_set1_epi8(0xf));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), _mm_set1_epi8(0xf));
+        __m256i code = _mm256_cvtepu8_epi32(_mm_unpacklo_epi8(lo, hi));
+
+        __m256i step = _mm256_i32gather_epi32((const int*)ADPCM_STEP_TABLE, idx, 4);
+        __m256i vpdiff = _mm256_srai_epi32(step, 3);
+
+        // move code bits 2,1,0 into the sign bit, to use as blend masks
+        __m256i m4 = _mm256_slli_epi32(code, 29);
+        __m256i m2 = _mm256_slli_epi32(code, 30);
+        __m256i m1 = _mm256_slli_epi32(code, 31);
+        __m256i sign = _mm256_srai_epi32(_mm256_slli_epi32(code, 28), 31);
+
+        vpdiff = _mm256_add_epi32(vpdiff, _mm256_and_si256(_mm256_srai_epi32(m4, 31), step));
+        vpdiff = _mm256_add_epi32(vpdiff, _mm256_and_si256(_mm256_srai_epi32(m2, 31), _mm256_srai_epi32(step, 1)));
+        vpdiff = _mm256_add_epi32(vpdiff, _mm256_and_si256(_mm256_srai_epi32(m1, 31), _mm256_srai_epi32(step, 2)));
+
+        vpdiff = _mm256_sub_epi32(_mm256_xor_si256(vpdiff, sign), sign);  // apply sign
+        p = clampSample(_mm256_add_epi32(p, vpdiff));
+        idx = clampIndex(_mm256_add_epi32(idx, indexDelta(code)));
+
+        __m128i y = _mm_packs_epi32(_mm256_castsi256_si128(p), _mm256_extracti128_si256(p, 1));
+        _mm_storeu_si128((__m128i*)&dst[ADPCM_LANES * i], y);
+    }
+
+    _mm256_storeu_si256((__m256i*)pred, p);
+    _mm256_storeu_si256((__m256i*)index, idx);
+}
+
+#endif
@@ -0,0 +1,164 @@
+//
+//  AudioSampleOps_avx2.cpp
+//  libraries/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <math.h>
+#include <immintrin.h>  // AVX2
+
+#include "../AudioSampleOps.h"
+
+#ifndef __AVX2__
+#error Must be compiled with /arch:AVX2 or -mavx2 -mfma.
+#endif
+
+// sign-extend 8 samples to int32, and convert to float
+static inline __m256 loadInt16x8(const int16_t* src) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)src)));
+}
+
+void convertInt16ToFloat_AVX2(const int16_t* src, float* dst, int numSamples, float scale) {
+
+    __m256 s = _mm256_set1_ps(scale);
+
+    int i = 0;
+    for (; i < numSamples - 15; i += 16) {
+        _mm256_storeu_ps(&dst[i+0], _mm256_mul_ps(loadInt16x8(&src[i+0]), s));
+        _mm256_storeu_ps(&dst[i+8], _mm256_mul_ps(loadInt16x8(&src[i+8]), s));
+    }
+    for (; i < numSamples; i++) {
+        dst[i] = (float)src[i] * scale;
+    }
+
+    _mm256_zeroupper();
+}
+
+void convertFloatToInt16_AVX2(const float* src, int16_t* dst, int numSamples, float scale) {
+
+    __m256 s = _mm256_set1_ps(scale);
+    __m256 lo = _mm256_set1_ps(-32768.0f);
+    __m256 hi = _mm256_set1_ps(32767.0f);
+
+    int i = 0;
+    for (; i < numSamples - 15; i += 16) {
+        __m256 x0 = _mm256_mul_ps(_mm256_loadu_ps(&src[i+0]), s);
+        __m256 x1 = _mm256_mul_ps(_mm256_loadu_ps(&src[i+8]), s);
+
+        // clamp before converting, as out-of-range conversions return 0x80000000
+        x0 = _mm256_min_ps(_mm256_max_ps(x0, lo), hi);
+        x1 = _mm256_min_ps(_mm256_max_ps(x1, lo), hi);
+
+        // round to nearest, as lrintf(), then undo the in-lane interleave of packs
+        __m256i y = _mm256_packs_epi32(_mm256_cvtps_epi32(x0), _mm256_cvtps_epi32(x1));
+        y = _mm256_permute4x64_epi64(y, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)&dst[i], y);
+    }
+    for (; i < numSamples; i++) {
+        float x = src[i] * scale;
+        x = (x < -32768.0f) ? -32768.0f : ((x > 32767.0f) ? 32767.0f : x);
+        dst[i] = (int16_t)lrintf(x);
+    }
+
+    _mm256_zeroupper();
+}
+
+void accumulateInt16ToFloat_AVX2(const int16_t* src, float* dst, int numSamples, float gain) {
+
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numSamples - 15; i += 16) {
+        __m256 y0 = _mm256_fmadd_ps(loadInt16x8(&src[i+0]), g, _mm256_loadu_ps(&dst[i+0]));
+        __m256 y1 = _mm256_fmadd_ps(loadInt16x8(&src[i+8]), g, _mm256_loadu_ps(&dst[i+8]));
+        _mm256_storeu_ps(&dst[i+0], y0);
+        _mm256_storeu_ps(&dst[i+8], y1);
+    }
+    for (; i < numSamples; i++) {
+        dst[i] += (float)src[i] * gain;
+    }
+
+    _mm256_zeroupper();
+}
+
+void accumulateMonoInt16ToStereoFloat_AVX2(const int16_t* src, float* dst, int numFrames, float gain) {
+
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256 x = _mm256_mul_ps(loadInt16x8(&src[i]), g);
+
+        // duplicate each sample into left and right, then restore frame order across lanes
+        __m256 a = _mm256_unpacklo_ps(x, x);    // 0 0 1 1 | 4 4 5 5
+        __m256 b = _mm256_unpackhi_ps(x, x);    // 2 2 3 3 | 6 6 7 7
+        __m256 x0 = _mm256_permute2f128_ps(a, b, 0x20);
+        __m256 x1 = _mm256_permute2f128_ps(a, b, 0x31);
+        _mm256_storeu_ps(&dst[2*i+0], _mm256_add_ps(_mm256_loadu_ps(&dst[2*i+0]), x0));
+        _mm256_storeu_ps(&dst[2*i+8], _mm256_add_ps(_mm256_loadu_ps(&dst[2*i+8]), x1));
+    }
+    for (; i < numFrames; i++) {
+        float x = (float)src[i] * gain;
+        dst[2*i+0] += x;
+        dst[2*i+1] += x;
+    }
+
+    _mm256_zeroupper();
+}
+
+void scaleInt16_AVX2(const int16_t* src, int16_t* dst, int numSamples, float gain) {
+
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numSamples - 15; i += 16) {
+        __m256i y0 = _mm256_cvttps_epi32(_mm256_mul_ps(loadInt16x8(&src[i+0]), g));
+        __m256i y1 = _mm256_cvttps_epi32(_mm256_mul_ps(loadInt16x8(&src[i+8]), g));
+
+        // truncate, as a C cast, then undo the in-lane interleave of packs
+        __m256i y = _mm256_permute4x64_epi64(_mm256_packs_epi32(y0, y1), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)&dst[i], y);
+    }
+    for (; i < numSamples; i++) {
+        dst[i] = (int16_t)((float)src[i] * gain);
+    }
+
+    _mm256_zeroupper();
+}
+
+int32_t sumAbsInt16_AVX2(const int16_t* src, int numSamples) {
+
+    __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+
+    int i = 0;
+    for (; i < numSamples - 15; i += 16) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)&src[i]);
+
+        // _mm256_abs_epi16 wraps |-32768|, so widen in pairs first
+        __m256i sign = _mm256_srai_epi16(x, 15);
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_xor_si256(x, sign), ones));
+        acc = _mm256_sub_epi32(acc, _mm256_madd_epi16(sign, ones));
+    }
+
+    // horizontal sum
+    __m128i sum4 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum4 = _mm_add_epi32(sum4, _mm_shuffle_epi32(sum4, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum4 = _mm_add_epi32(sum4, _mm_shuffle_epi32(sum4, _MM_SHUFFLE(2, 3, 0, 1)));
+    int32_t sum = _mm_cvtsi128_si32(sum4);
+
+    for (; i < numSamples; i++) {
+        sum += (src[i] < 0) ? -(int32_t)src[i] : (int32_t)src[i];
+    }
+
+    _mm256_zeroupper();
+    return sum;
+}
+
+#endif
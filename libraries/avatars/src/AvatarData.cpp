@@ -37,6 +37,7 @@
 #include <ShapeInfo.h>
 #include <AudioHelpers.h>
 
+#include "AvatarJointCodec.h"
 #include "AvatarLogging.h"
 
 //#define WANT_DEBUG
@@ -97,6 +98,9 @@ AvatarData::~AvatarData() {
 // We cannot have a file-level variable (const or otherwise) in the AvatarInfo if it uses PathUtils, because that references Application, which will not yet initialized.
 // Thus we have a static class getter, referencing a static class var.
 QUrl AvatarData::_defaultFullAvatarModelUrl = {}; // In C++, if this initialization were in the AvatarInfo, every file would have it's own copy, even for class vars.
+std::atomic<int> AvatarData::_jointRotationBits { AvatarJointCodec::DEFAULT_ROTATION_BITS };
+std::atomic<int> AvatarData::_jointTranslationBits { AvatarJointCodec::DEFAULT_TRANSLATION_BITS };
+
 const QUrl& AvatarData::defaultFullAvatarModelUrl() {
     if (_defaultFullAvatarModelUrl.isEmpty()) {
         _defaultFullAvatarModelUrl = QUrl::fromLocalFile(PathUtils::resourcesPath() + "meshes/defaultAvatar_full.fst");
@@ -104,6 +108,12 @@ const QUrl& AvatarData::defaultFullAvatarModelUrl() {
     return _defaultFullAvatarModelUrl;
 }
 
+void AvatarData::setJointEncodingPrecision(int rotationBits, int translationBits) {
+    AvatarJointCodec codec(rotationBits, translationBits);
+    _jointRotationBits = codec.getRotationBits();
+    _jointTranslationBits = codec.getTranslationBits();
+}
+
 // There are a number of possible strategies for this set of tools through endRender, below.
 void AvatarData::nextAttitude(glm::vec3 position, glm::quat orientation) {
     bool success;
@@ -234,8 +244,7 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
     //
     // TODO consider these additional optimizations in the future
     // 1) SensorToWorld - should we only send this for avatars with attachments?? - 20 bytes - 7.20 kbps
-    // 2) GUIID for the session change to 2byte index                   (savings) - 14 bytes - 5.04 kbps
-    // 3) Improve Joints -- currently we use rotational tolerances, but if we had skeleton/bone length data
+    // 2) Improve Joints -- currently we use rotational tolerances, but if we had skeleton/bone length data
     //    we could do a better job of determining if the change in joints actually translates to visible
     //    changes at distance.
     //
@@ -455,128 +464,54 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         auto startSection = destinationBuffer;
         QReadLocker readLock(&_jointDataLock);
 
-        // joint rotation data
         int numJoints = _jointData.size();
-        *destinationBuffer++ = (uint8_t)numJoints;
-
-        unsigned char* validityPosition = destinationBuffer;
-        unsigned char validity = 0;
-        int validityBit = 0;
-
-#ifdef WANT_DEBUG
-        int rotationSentCount = 0;
-        unsigned char* beforeRotations = destinationBuffer;
-#endif
-
         if (sentJointDataOut) {
-            sentJointDataOut->resize(_jointData.size()); // Make sure the destination is resized before using it
+            sentJointDataOut->resize(numJoints); // Make sure the destination is resized before using it
         }
         float minRotationDOT = !distanceAdjust ? AVATAR_MIN_ROTATION_DOT : getDistanceBasedMinRotationDOT(viewerPosition);
+        float minTranslation = !distanceAdjust ? AVATAR_MIN_TRANSLATION : getDistanceBasedMinTranslationDistance(viewerPosition);
 
-        for (int i = 0; i < _jointData.size(); i++) {
-            const JointData& data = _jointData[i];
-
-            // The dot product for smaller rotations is a smaller number.
-            // So if the dot() is less than the value, then the rotation is a larger angle of rotation
-            bool largeEnoughRotation = fabsf(glm::dot(data.rotation, lastSentJointData[i].rotation)) < minRotationDOT;
+        AvatarJointCodec codec(_jointRotationBits, _jointTranslationBits);
+        int translationScaleExponent = AvatarJointCodec::computeTranslationScaleExponent(_jointData);
 
-            if (sendAll || lastSentJointData[i].rotation != data.rotation) {
+        QVector<bool> sendRotations(numJoints);
+        QVector<bool> sendTranslations(numJoints);
+        for (int i = 0; i < numJoints; i++) {
+            const JointData& data = _jointData[i];
+            JointData lastSent = i < lastSentJointData.size() ? lastSentJointData[i] : JointData();
+
+            // changes that are lost to quantization would decode to what the receiver already has
+            if (data.rotationSet &&
+                (sendAll || codec.quantizeRotation(data.rotation) != codec.quantizeRotation(lastSent.rotation))) {
+                // The dot product for smaller rotations is a smaller number.
+                // So if the dot() is less than the value, then the rotation is a larger angle of rotation
+                bool largeEnoughRotation = fabsf(glm::dot(data.rotation, lastSent.rotation)) < minRotationDOT;
                 if (sendAll || !cullSmallChanges || largeEnoughRotation) {
-                    if (data.rotationSet) {
-                        validity |= (1 << validityBit);
-#ifdef WANT_DEBUG
-                        rotationSentCount++;
-#endif
-                        if (sentJointDataOut) {
-                            auto jointDataOut = *sentJointDataOut;
-                            jointDataOut[i].rotation = data.rotation;
-                        }
-
+                    sendRotations[i] = true;
+                    if (sentJointDataOut) {
+                        (*sentJointDataOut)[i].rotation = data.rotation;
                     }
                 }
             }
-            if (++validityBit == BITS_IN_BYTE) {
-                *destinationBuffer++ = validity;
-                validityBit = validity = 0;
-            }
-        }
-        if (validityBit != 0) {
-            *destinationBuffer++ = validity;
-        }
-
-        validityBit = 0;
-        validity = *validityPosition++;
-        for (int i = 0; i < _jointData.size(); i++) {
-            const JointData& data = _jointData[i];
-            if (validity & (1 << validityBit)) {
-                destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
-            }
-            if (++validityBit == BITS_IN_BYTE) {
-                validityBit = 0;
-                validity = *validityPosition++;
-            }
-        }
-
-
-        // joint translation data
-        validityPosition = destinationBuffer;
-        validity = 0;
-        validityBit = 0;
-
-#ifdef WANT_DEBUG
-        int translationSentCount = 0;
-        unsigned char* beforeTranslations = destinationBuffer;
-#endif
-
-        float minTranslation = !distanceAdjust ? AVATAR_MIN_TRANSLATION : getDistanceBasedMinTranslationDistance(viewerPosition);
-
-        float maxTranslationDimension = 0.0;
-        for (int i = 0; i < _jointData.size(); i++) {
-            const JointData& data = _jointData[i];
-            if (sendAll || lastSentJointData[i].translation != data.translation) {
-                if (sendAll ||
-                    !cullSmallChanges ||
-                    glm::distance(data.translation, lastSentJointData[i].translation) > minTranslation) {
-                    if (data.translationSet) {
-                        validity |= (1 << validityBit);
-                        #ifdef WANT_DEBUG
-                        translationSentCount++;
-                        #endif
-                        maxTranslationDimension = glm::max(fabsf(data.translation.x), maxTranslationDimension);
-                        maxTranslationDimension = glm::max(fabsf(data.translation.y), maxTranslationDimension);
-                        maxTranslationDimension = glm::max(fabsf(data.translation.z), maxTranslationDimension);
-
-                        if (sentJointDataOut) {
-                            auto jointDataOut = *sentJointDataOut;
-                            jointDataOut[i].translation = data.translation;
-                        }
 
+            if (data.translationSet && (sendAll ||
+                codec.quantizeTranslation(data.translation, translationScaleExponent) !=
+                codec.quantizeTranslation(lastSent.translation, translationScaleExponent))) {
+                if (sendAll || !cullSmallChanges || glm::distance(data.translation, lastSent.translation) > minTranslation) {
+                    sendTranslations[i] = true;
+                    if (sentJointDataOut) {
+                        (*sentJointDataOut)[i].translation = data.translation;
                     }
                 }
             }
-            if (++validityBit == BITS_IN_BYTE) {
-                *destinationBuffer++ = validity;
-                validityBit = validity = 0;
-            }
         }
 
-        if (validityBit != 0) {
-            *destinationBuffer++ = validity;
-        }
+        destinationBuffer += codec.encode(destinationBuffer, _jointData, sendRotations, sendTranslations,
+            translationScaleExponent);
 
-        validityBit = 0;
-        validity = *validityPosition++;
-        for (int i = 0; i < _jointData.size(); i++) {
-            const JointData& data = _jointData[i];
-            if (validity & (1 << validityBit)) {
-                destinationBuffer +=
-                    packFloatVec3ToSignedTwoByteFixed(destinationBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
-            }
-            if (++validityBit == BITS_IN_BYTE) {
-                validityBit = 0;
-                validity = *validityPosition++;
-            }
-        }
+#ifdef WANT_DEBUG
+        unsigned char* beforeFauxJoints = destinationBuffer;
+#endif
 
         // faux joints
         Transform controllerLeftHandTransform = Transform(getControllerLeftHandMatrix());
@@ -591,12 +526,11 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 #ifdef WANT_DEBUG
         if (sendAll) {
             qCDebug(avatars) << "AvatarData::toByteArray" << cullSmallChanges << sendAll
-                    << "rotations:" << rotationSentCount << "translations:" << translationSentCount
-                    << "largest:" << maxTranslationDimension
+                    << "rotations:" << sendRotations.count(true) << "translations:" << sendTranslations.count(true)
                     << "size:"
-                    << (beforeRotations - startPosition) << "+"
-                    << (beforeTranslations - beforeRotations) << "+"
-                    << (destinationBuffer - beforeTranslations) << "="
+                    << (startSection - startPosition) << "+"
+                    << (beforeFauxJoints - startSection) << "+"
+                    << (destinationBuffer - beforeFauxJoints) << "="
                     << (destinationBuffer - startPosition);
         }
 #endif
@@ -965,78 +899,21 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     if (hasJointData) {
         auto startSection = sourceBuffer;
 
-        PACKET_READ_CHECK(NumJoints, sizeof(uint8_t));
-        int numJoints = *sourceBuffer++;
-        const int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
-        PACKET_READ_CHECK(JointRotationValidityBits, bytesOfValidity);
-
         int numValidJointRotations = 0;
-        QVector<bool> validRotations;
-        validRotations.resize(numJoints);
-        { // rotation validity bits
-            unsigned char validity = 0;
-            int validityBit = 0;
-            for (int i = 0; i < numJoints; i++) {
-                if (validityBit == 0) {
-                    validity = *sourceBuffer++;
-                }
-                bool valid = (bool)(validity & (1 << validityBit));
-                if (valid) {
-                    ++numValidJointRotations;
-                }
-                validRotations[i] = valid;
-                validityBit = (validityBit + 1) % BITS_IN_BYTE;
-            }
-        }
-
-        // each joint rotation is stored in 6 bytes.
+        int numValidJointTranslations = 0;
         QWriteLocker writeLock(&_jointDataLock);
-        _jointData.resize(numJoints);
-
-        const int COMPRESSED_QUATERNION_SIZE = 6;
-        PACKET_READ_CHECK(JointRotations, numValidJointRotations * COMPRESSED_QUATERNION_SIZE);
-        for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (validRotations[i]) {
-                sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, data.rotation);
-                _hasNewJointData = true;
-                data.rotationSet = true;
+        int jointBytesRead = AvatarJointCodec::decode(sourceBuffer, (int)(endPosition - sourceBuffer), _jointData,
+            &numValidJointRotations, &numValidJointTranslations);
+        if (jointBytesRead < 0) {
+            if (shouldLogError(now)) {
+                qCWarning(avatars) << "AvatarData packet too small or malformed, attempting to read JointData, only"
+                    << (endPosition - sourceBuffer) << "bytes left," << getSessionUUID();
             }
+            return buffer.size();
         }
-
-        PACKET_READ_CHECK(JointTranslationValidityBits, bytesOfValidity);
-
-        // get translation validity bits -- these indicate which translations were packed
-        int numValidJointTranslations = 0;
-        QVector<bool> validTranslations;
-        validTranslations.resize(numJoints);
-        { // translation validity bits
-            unsigned char validity = 0;
-            int validityBit = 0;
-            for (int i = 0; i < numJoints; i++) {
-                if (validityBit == 0) {
-                    validity = *sourceBuffer++;
-                }
-                bool valid = (bool)(validity & (1 << validityBit));
-                if (valid) {
-                    ++numValidJointTranslations;
-                }
-                validTranslations[i] = valid;
-                validityBit = (validityBit + 1) % BITS_IN_BYTE;
-            }
-        } // 1 + bytesOfValidity bytes
-
-        // each joint translation component is stored in 6 bytes.
-        const int COMPRESSED_TRANSLATION_SIZE = 6;
-        PACKET_READ_CHECK(JointTranslation, numValidJointTranslations * COMPRESSED_TRANSLATION_SIZE);
-
-        for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (validTranslations[i]) {
-                sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
-                _hasNewJointData = true;
-                data.translationSet = true;
-            }
+        sourceBuffer += jointBytesRead;
+        if (numValidJointRotations > 0 || numValidJointTranslations > 0) {
+            _hasNewJointData = true;
         }
 
 #ifdef WANT_DEBUG
@@ -1047,6 +924,8 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         }
 #endif
         // faux joints
+        const int FAUX_JOINT_SIZE = 12;
+        PACKET_READ_CHECK(FauxJoints, 2 * FAUX_JOINT_SIZE);
         sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerLeftHandMatrixCache);
         sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerRightHandMatrixCache);
 
@@ -1444,7 +1323,7 @@ QStringList AvatarData::getJointNames() const {
 void AvatarData::parseAvatarIdentityPacket(const QByteArray& data, Identity& identityOut) {
     QDataStream packetStream(data);
 
-    packetStream >> identityOut.uuid >> identityOut.skeletonModelURL >> identityOut.attachmentData >> identityOut.displayName >> identityOut.sessionDisplayName >> identityOut.avatarEntityData;
+    packetStream >> identityOut.uuid >> identityOut.localID >> identityOut.skeletonModelURL >> identityOut.attachmentData >> identityOut.displayName >> identityOut.sessionDisplayName >> identityOut.avatarEntityData;
 }
 
 static const QUrl emptyURL("");
@@ -1492,7 +1371,7 @@ QByteArray AvatarData::identityByteArray() {
     const QUrl& urlToSend = cannonicalSkeletonModelURL(emptyURL);
 
     _avatarEntitiesLock.withReadLock([&] {
-        identityStream << getSessionUUID() << urlToSend << _attachmentData << _displayName << getSessionDisplayNameForTransport() << _avatarEntityData;
+        identityStream << getSessionUUID() << _sessionLocalID << urlToSend << _attachmentData << _displayName << getSessionDisplayNameForTransport() << _avatarEntityData;
     });
 
     return identityData;
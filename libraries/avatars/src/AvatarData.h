@@ -12,6 +12,7 @@
 #ifndef hifi_AvatarData_h
 #define hifi_AvatarData_h
 
+#include <atomic>
 #include <string>
 #include <memory>
 /* VS2010 defines stdint.h, but not inttypes.h */
@@ -70,6 +71,10 @@ using AvatarEntityIDs = QSet<QUuid>;
 
 using AvatarDataSequenceNumber = uint16_t;
 
+// compact id of an avatar in the avatar mixer's session, announced to clients in its identity packets
+using AvatarLocalID = uint16_t;
+const AvatarLocalID UNKNOWN_AVATAR_LOCAL_ID = 0;
+
 // avatar motion behaviors
 const quint32 AVATAR_MOTION_ACTION_MOTOR_ENABLED = 1U << 0;
 const quint32 AVATAR_MOTION_SCRIPTED_MOTOR_ENABLED = 1U << 1;
@@ -227,11 +232,11 @@ namespace AvatarDataPacket {
     // variable length structure follows
     /*
     struct JointData {
-        uint8_t numJoints;
-        uint8_t rotationValidityBits[ceil(numJoints / 8)];     // one bit per joint, if true then a compressed rotation follows.
-        SixByteQuat rotation[numValidRotations];               // encodeded and compressed by packOrientationQuatToSixBytes()
-        uint8_t translationValidityBits[ceil(numJoints / 8)];  // one bit per joint, if true then a compressed translation follows.
-        SixByteTrans translation[numValidTranslations];        // encodeded and compressed by packFloatVec3ToSignedTwoByteFixed()
+        JointStream joints;                                    // bit packed by AvatarJointCodec, see AvatarJointCodec.h
+        SixByteQuat leftHandControllerRotation;                // faux joints, encoded by packOrientationQuatToSixBytes()
+        SixByteTrans leftHandControllerTranslation;            // and packFloatVec3ToSignedTwoByteFixed()
+        SixByteQuat rightHandControllerRotation;
+        SixByteTrans rightHandControllerTranslation;
     };
     */
 }
@@ -248,6 +253,9 @@ const QString DEFAULT_FULL_AVATAR_MODEL_NAME = QString("Default");
 
 // how often should we send a full report about joint rotations, even if they haven't changed?
 const float AVATAR_SEND_FULL_UPDATE_RATIO = 0.02f;
+// the avatar mixer sends each receiver a full report of an avatar once every this many updates of it, on a fixed
+// schedule, so that a joint whose last change was lost on the way is resent in bounded time
+const int AVATAR_UPDATES_PER_FULL_UPDATE = 50;
 // this controls how large a change in joint-rotation must be before the interface sends it to the avatar mixer
 const float AVATAR_MIN_ROTATION_DOT = 0.9999999f;
 const float AVATAR_MIN_TRANSLATION = 0.0001f;
@@ -337,10 +345,17 @@ public:
 
     static const QUrl& defaultFullAvatarModelUrl();
 
+    // precision of the joints encoded by toByteArray, in bits per component, see AvatarJointCodec
+    static void setJointEncodingPrecision(int rotationBits, int translationBits);
+
     virtual bool isMyAvatar() const { return false; }
 
     const QUuid getSessionUUID() const { return getID(); }
 
+    // assigned by the avatar mixer, see AvatarLocalID
+    AvatarLocalID getSessionLocalID() const { return _sessionLocalID; }
+    void setSessionLocalID(AvatarLocalID sessionLocalID) { _sessionLocalID = sessionLocalID; }
+
     glm::vec3 getHandPosition() const;
     void setHandPosition(const glm::vec3& handPosition);
 
@@ -481,6 +496,7 @@ public:
 
     struct Identity {
         QUuid uuid;
+        AvatarLocalID localID { UNKNOWN_AVATAR_LOCAL_ID };
         QUrl skeletonModelURL;
         QVector<AttachmentData> attachmentData;
         QString displayName;
@@ -620,6 +636,7 @@ protected:
 
     QUrl _skeletonModelURL;
     bool _firstSkeletonCheck { true };
+    AvatarLocalID _sessionLocalID { UNKNOWN_AVATAR_LOCAL_ID };
     QUrl _skeletonFBXURL;
     QVector<AttachmentData> _attachmentData;
     QString _displayName;
@@ -727,6 +744,8 @@ protected:
 private:
     friend void avatarStateFromFrame(const QByteArray& frameData, AvatarData* _avatar);
     static QUrl _defaultFullAvatarModelUrl;
+    static std::atomic<int> _jointRotationBits;
+    static std::atomic<int> _jointTranslationBits;
     // privatize the copy constructor and assignment operator so they cannot be called
     AvatarData(const AvatarData&);
     AvatarData& operator= (const AvatarData&);
@@ -23,6 +23,7 @@ AvatarHashMap::AvatarHashMap() {
     auto nodeList = DependencyManager::get<NodeList>();
 
     connect(nodeList.data(), &NodeList::uuidChanged, this, &AvatarHashMap::sessionUUIDChanged);
+    connect(nodeList.data(), &NodeList::nodeKilled, this, &AvatarHashMap::nodeKilled);
 }
 
 QVector<QUuid> AvatarHashMap::getAvatarIdentifiers() {
@@ -99,20 +100,31 @@ AvatarSharedPointer AvatarHashMap::findAvatar(const QUuid& sessionUUID) const {
 }
 
 void AvatarHashMap::processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
-    PerformanceTimer perfTimer("receiveAvatar");
+    PERFORMANCE_TIMER("receiveAvatar");
     // enumerate over all of the avatars in this packet
     // only add them if mixerWeakPointer points to something (meaning that mixer is still around)
     while (message->getBytesLeftToRead()) {
-        QUuid sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        // avatars are identified by their local ID, or by their session UUID before it was announced to us
+        // or when the mixer has run out of local IDs
+        AvatarLocalID localID;
+        message->readPrimitive(&localID);
+        QUuid sessionUUID;
+        if (localID != UNKNOWN_AVATAR_LOCAL_ID) {
+            sessionUUID = _sessionUUIDsByLocalID.value(localID);
+        } else {
+            sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        }
 
         int positionBeforeRead = message->getPosition();
 
         QByteArray byteArray = message->readWithoutCopy(message->getBytesLeftToRead());
 
-        // make sure this isn't our own avatar data or for a previously ignored node
+        // make sure this isn't our own avatar data, for a previously ignored node,
+        // or for an avatar whose identity (and with it its local ID) hasn't arrived yet
         auto nodeList = DependencyManager::get<NodeList>();
 
-        if (sessionUUID != _lastOwnerSessionUUID && (!nodeList->isIgnoringNode(sessionUUID) || nodeList->getRequestsDomainListData())) {
+        if (!sessionUUID.isNull() && sessionUUID != _lastOwnerSessionUUID &&
+            (!nodeList->isIgnoringNode(sessionUUID) || nodeList->getRequestsDomainListData())) {
             auto avatar = newOrExistingAvatar(sessionUUID, sendingNode);
 
             // have the matching (or new) avatar parse the data from the packet
@@ -131,6 +143,11 @@ void AvatarHashMap::processAvatarIdentityPacket(QSharedPointer<ReceivedMessage>
     AvatarData::Identity identity;
     AvatarData::parseAvatarIdentityPacket(message->getMessage(), identity);
 
+    // remember the local ID even for ignored avatars, so that their data keeps being recognized after an unignore
+    if (identity.localID != UNKNOWN_AVATAR_LOCAL_ID) {
+        _sessionUUIDsByLocalID[identity.localID] = identity.uuid;
+    }
+
     // make sure this isn't for an ignored avatar
     auto nodeList = DependencyManager::get<NodeList>();
     static auto EMPTY = QUuid();
@@ -161,6 +178,17 @@ void AvatarHashMap::processKillAvatar(QSharedPointer<ReceivedMessage> message, S
     KillAvatarReason reason;
     message->readPrimitive(&reason);
     removeAvatar(sessionUUID, reason);
+
+    // an avatar that is only out of reach keeps its local ID, the mixer only releases it once the avatar is gone
+    if (reason == KillAvatarReason::AvatarDisconnected) {
+        for (auto it = _sessionUUIDsByLocalID.begin(); it != _sessionUUIDsByLocalID.end();) {
+            if (it.value() == sessionUUID) {
+                it = _sessionUUIDsByLocalID.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
 }
 
 void AvatarHashMap::processExitingSpaceBubble(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
@@ -186,6 +214,13 @@ void AvatarHashMap::handleRemovedAvatar(const AvatarSharedPointer& removedAvatar
     emit avatarRemovedEvent(removedAvatar->getSessionUUID());
 }
 
+void AvatarHashMap::nodeKilled(SharedNodePointer killedNode) {
+    // local IDs are only meaningful to the mixer that assigned them
+    if (killedNode->getType() == NodeType::AvatarMixer) {
+        _sessionUUIDsByLocalID.clear();
+    }
+}
+
 void AvatarHashMap::sessionUUIDChanged(const QUuid& sessionUUID, const QUuid& oldUUID) {
     _lastOwnerSessionUUID = oldUUID;
     emit avatarSessionChangedEvent(sessionUUID, oldUUID);
@@ -53,6 +53,7 @@ public slots:
     
 private slots:
     void sessionUUIDChanged(const QUuid& sessionUUID, const QUuid& oldUUID);
+    void nodeKilled(SharedNodePointer killedNode);
     
     void processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
     void processAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
@@ -77,6 +78,10 @@ protected:
 
 private:
     QUuid _lastOwnerSessionUUID;
+
+    // the session UUIDs behind the local IDs of BulkAvatarData, as announced by the avatar mixer in identity packets.
+    // Only used from the packet handlers, no locking needed.
+    QHash<AvatarLocalID, QUuid> _sessionUUIDsByLocalID;
 };
 
 #endif // hifi_AvatarHashMap_h
@@ -0,0 +1,316 @@
+//
+//  AvatarJointCodec.cpp
+//  libraries/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarJointCodec.h"
+
+#include <assert.h>
+#include <math.h>
+
+#include <NumericalConstants.h>
+
+const int AvatarJointCodec::MIN_BITS = 6;
+const int AvatarJointCodec::MAX_BITS = 15;
+const int AvatarJointCodec::DEFAULT_ROTATION_BITS = 12;
+const int AvatarJointCodec::DEFAULT_TRANSLATION_BITS = 12;
+const int AvatarJointCodec::MIN_TRANSLATION_SCALE_EXPONENT = -32;
+const int AvatarJointCodec::MAX_TRANSLATION_SCALE_EXPONENT = 32;
+const int AvatarJointCodec::TRANSLATION_SCALE_EXPONENT_BIAS = 128;
+const int AvatarJointCodec::MAX_JOINTS = 255;
+
+namespace {
+
+const int HEADER_SIZE = 3;
+const int PRECISION_BITS = 4;
+const int LARGEST_COMPONENT_BITS = 2;
+
+// most significant bit first
+class BitWriter {
+public:
+    BitWriter(unsigned char* destination) : _start(destination), _position(destination) {}
+
+    void write(uint32_t value, int numBits) {
+        assert(numBits > 0 && numBits <= 32);
+        _bits = (_bits << numBits) | (value & (uint32_t)((1ULL << numBits) - 1));
+        _numBits += numBits;
+        while (_numBits >= BITS_IN_BYTE) {
+            _numBits -= BITS_IN_BYTE;
+            *_position++ = (unsigned char)(_bits >> _numBits);
+        }
+    }
+
+    // pads the last byte, returns the number of bytes written
+    int finish() {
+        if (_numBits > 0) {
+            *_position++ = (unsigned char)(_bits << (BITS_IN_BYTE - _numBits));
+            _numBits = 0;
+        }
+        return (int)(_position - _start);
+    }
+
+private:
+    unsigned char* _start;
+    unsigned char* _position;
+    uint64_t _bits { 0 };
+    int _numBits { 0 };
+};
+
+class BitReader {
+public:
+    BitReader(const unsigned char* source, int size) : _start(source), _position(source), _end(source + size) {}
+
+    bool read(uint32_t& value, int numBits) {
+        assert(numBits > 0 && numBits <= 32);
+        while (_numBits < numBits) {
+            if (_position == _end) {
+                return false;
+            }
+            _bits = (_bits << BITS_IN_BYTE) | *_position++;
+            _numBits += BITS_IN_BYTE;
+        }
+        _numBits -= numBits;
+        value = (uint32_t)((_bits >> _numBits) & ((1ULL << numBits) - 1));
+        return true;
+    }
+
+    // the padding of the last byte read is skipped
+    int getBytesRead() const { return (int)(_position - _start); }
+
+private:
+    const unsigned char* _start;
+    const unsigned char* _position;
+    const unsigned char* _end;
+    uint64_t _bits { 0 };
+    int _numBits { 0 };
+};
+
+// the smallest three components are within +-1/sqrt(2)
+const float SMALLEST_THREE_MAGNITUDE = 1.0f / sqrtf(2.0f);
+
+}
+
+AvatarJointCodec::AvatarJointCodec(int rotationBits, int translationBits) :
+    _rotationBits(glm::clamp(rotationBits, MIN_BITS, MAX_BITS)),
+    _translationBits(glm::clamp(translationBits, MIN_BITS, MAX_BITS))
+{
+}
+
+uint64_t AvatarJointCodec::quantizeRotation(const glm::quat& rotation) const {
+    int largestComponent = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(rotation[i]) > fabsf(rotation[largestComponent])) {
+            largestComponent = i;
+        }
+    }
+
+    // q and -q are the same rotation, keep the dropped component positive so that it can be recovered
+    glm::quat q = rotation[largestComponent] < 0.0f ? -rotation : rotation;
+
+    const uint32_t range = (1U << _rotationBits) - 1;
+    uint64_t code = (uint64_t)largestComponent;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestComponent) {
+            float value = (q[i] + SMALLEST_THREE_MAGNITUDE) / (2.0f * SMALLEST_THREE_MAGNITUDE);
+            uint32_t component = (uint32_t)glm::clamp(roundf(value * range), 0.0f, (float)range);
+            code = (code << _rotationBits) | component;
+        }
+    }
+    return code;
+}
+
+glm::quat AvatarJointCodec::dequantizeRotation(uint64_t code) const {
+    const uint32_t mask = (1U << _rotationBits) - 1;
+    const float range = (float)mask;
+    int largestComponent = (int)(code >> (3 * _rotationBits)) & 0x3;
+
+    glm::quat q;
+    float sumOfSquares = 0.0f;
+    for (int i = 3, shift = 0; i >= 0; i--) {
+        if (i != largestComponent) {
+            uint32_t component = (uint32_t)(code >> shift) & mask;
+            q[i] = ((float)component / range) * 2.0f * SMALLEST_THREE_MAGNITUDE - SMALLEST_THREE_MAGNITUDE;
+            sumOfSquares += q[i] * q[i];
+            shift += _rotationBits;
+        }
+    }
+    q[largestComponent] = sqrtf(glm::max(0.0f, 1.0f - sumOfSquares));
+    return glm::normalize(q);
+}
+
+uint64_t AvatarJointCodec::quantizeTranslation(const glm::vec3& translation, int scaleExponent) const {
+    // symmetric around zero, so that zero is exact
+    const int32_t range = (1 << (_translationBits - 1)) - 1;
+    const float scale = ldexpf(1.0f, scaleExponent);
+
+    uint64_t code = 0;
+    for (int i = 0; i < 3; i++) {
+        float value = glm::clamp(translation[i] / scale, -1.0f, 1.0f);
+        int32_t component = (int32_t)roundf(value * range);
+        code = (code << _translationBits) | (uint32_t)(component + range);
+    }
+    return code;
+}
+
+glm::vec3 AvatarJointCodec::dequantizeTranslation(uint64_t code, int scaleExponent) const {
+    const uint32_t mask = (1U << _translationBits) - 1;
+    const int32_t range = (1 << (_translationBits - 1)) - 1;
+    const float scale = ldexpf(1.0f, scaleExponent);
+
+    glm::vec3 translation;
+    for (int i = 2, shift = 0; i >= 0; i--, shift += _translationBits) {
+        int32_t component = (int32_t)((code >> shift) & mask) - range;
+        translation[i] = ((float)component / (float)range) * scale;
+    }
+    return translation;
+}
+
+int AvatarJointCodec::computeTranslationScaleExponent(const QVector<JointData>& joints) {
+    float maxComponent = 0.0f;
+    for (const auto& joint : joints) {
+        if (joint.translationSet) {
+            maxComponent = glm::max(maxComponent, fabsf(joint.translation.x));
+            maxComponent = glm::max(maxComponent, fabsf(joint.translation.y));
+            maxComponent = glm::max(maxComponent, fabsf(joint.translation.z));
+        }
+    }
+    if (!(maxComponent > 0.0f)) {
+        return MIN_TRANSLATION_SCALE_EXPONENT;
+    }
+
+    // maxComponent = mantissa * 2^exponent, with mantissa in [0.5, 1)
+    int exponent;
+    frexpf(maxComponent, &exponent);
+    return glm::clamp(exponent, MIN_TRANSLATION_SCALE_EXPONENT, MAX_TRANSLATION_SCALE_EXPONENT);
+}
+
+int AvatarJointCodec::getMaxEncodedSize(int numJoints) {
+    int numBits = numJoints * (1 + LARGEST_COMPONENT_BITS + 3 * MAX_BITS) + numJoints * (1 + 3 * MAX_BITS);
+    return HEADER_SIZE + (numBits + BITS_IN_BYTE - 1) / BITS_IN_BYTE;
+}
+
+int AvatarJointCodec::encode(unsigned char* destination, const QVector<JointData>& joints, const QVector<bool>& sendRotations,
+        const QVector<bool>& sendTranslations, int scaleExponent) const {
+    int numJoints = glm::min(joints.size(), MAX_JOINTS);
+    scaleExponent = glm::clamp(scaleExponent, MIN_TRANSLATION_SCALE_EXPONENT, MAX_TRANSLATION_SCALE_EXPONENT);
+
+    BitWriter writer(destination);
+    writer.write(numJoints, BITS_IN_BYTE);
+    writer.write(_rotationBits, PRECISION_BITS);
+    writer.write(_translationBits, PRECISION_BITS);
+    writer.write(scaleExponent + TRANSLATION_SCALE_EXPONENT_BIAS, BITS_IN_BYTE);
+
+    for (int i = 0; i < numJoints; i++) {
+        writer.write(sendRotations[i] ? 1 : 0, 1);
+    }
+    for (int i = 0; i < numJoints; i++) {
+        if (sendRotations[i]) {
+            uint64_t code = quantizeRotation(joints[i].rotation);
+            writer.write((uint32_t)(code >> (3 * _rotationBits)), LARGEST_COMPONENT_BITS);
+            writer.write((uint32_t)(code >> (2 * _rotationBits)), _rotationBits);
+            writer.write((uint32_t)(code >> _rotationBits), _rotationBits);
+            writer.write((uint32_t)code, _rotationBits);
+        }
+    }
+
+    for (int i = 0; i < numJoints; i++) {
+        writer.write(sendTranslations[i] ? 1 : 0, 1);
+    }
+    for (int i = 0; i < numJoints; i++) {
+        if (sendTranslations[i]) {
+            uint64_t code = quantizeTranslation(joints[i].translation, scaleExponent);
+            writer.write((uint32_t)(code >> (2 * _translationBits)), _translationBits);
+            writer.write((uint32_t)(code >> _translationBits), _translationBits);
+            writer.write((uint32_t)code, _translationBits);
+        }
+    }
+
+    return writer.finish();
+}
+
+int AvatarJointCodec::decode(const unsigned char* source, int size, QVector<JointData>& joints,
+        int* numRotationsOut, int* numTranslationsOut) {
+    BitReader reader(source, size);
+
+    uint32_t numJoints, rotationBits, translationBits, biasedScaleExponent;
+    if (!reader.read(numJoints, BITS_IN_BYTE) || !reader.read(rotationBits, PRECISION_BITS) ||
+        !reader.read(translationBits, PRECISION_BITS) || !reader.read(biasedScaleExponent, BITS_IN_BYTE)) {
+        return -1;
+    }
+    if ((int)rotationBits < MIN_BITS || (int)translationBits < MIN_BITS) {
+        return -1;
+    }
+    AvatarJointCodec codec(rotationBits, translationBits);
+    int scaleExponent = (int)biasedScaleExponent - TRANSLATION_SCALE_EXPONENT_BIAS;
+
+    // read everything before touching joints, a truncated stream leaves them as they were
+    QVector<bool> validRotations(numJoints);
+    QVector<bool> validTranslations(numJoints);
+    QVector<JointData> received(numJoints);
+    uint32_t bit;
+
+    for (uint32_t i = 0; i < numJoints; i++) {
+        if (!reader.read(bit, 1)) {
+            return -1;
+        }
+        validRotations[i] = (bit != 0);
+    }
+    for (uint32_t i = 0; i < numJoints; i++) {
+        if (validRotations[i]) {
+            uint32_t largestComponent, a, b, c;
+            if (!reader.read(largestComponent, LARGEST_COMPONENT_BITS) || !reader.read(a, rotationBits) ||
+                !reader.read(b, rotationBits) || !reader.read(c, rotationBits)) {
+                return -1;
+            }
+            uint64_t code = ((((((uint64_t)largestComponent << rotationBits) | a) << rotationBits) | b) << rotationBits) | c;
+            received[i].rotation = codec.dequantizeRotation(code);
+        }
+    }
+
+    for (uint32_t i = 0; i < numJoints; i++) {
+        if (!reader.read(bit, 1)) {
+            return -1;
+        }
+        validTranslations[i] = (bit != 0);
+    }
+    for (uint32_t i = 0; i < numJoints; i++) {
+        if (validTranslations[i]) {
+            uint32_t x, y, z;
+            if (!reader.read(x, translationBits) || !reader.read(y, translationBits) || !reader.read(z, translationBits)) {
+                return -1;
+            }
+            uint64_t code = ((((uint64_t)x << translationBits) | y) << translationBits) | z;
+            received[i].translation = codec.dequantizeTranslation(code, scaleExponent);
+        }
+    }
+
+    int numRotations = 0;
+    int numTranslations = 0;
+    joints.resize(numJoints);
+    for (uint32_t i = 0; i < numJoints; i++) {
+        JointData& joint = joints[i];
+        if (validRotations[i]) {
+            joint.rotation = received[i].rotation;
+            joint.rotationSet = true;
+            numRotations++;
+        }
+        if (validTranslations[i]) {
+            joint.translation = received[i].translation;
+            joint.translationSet = true;
+            numTranslations++;
+        }
+    }
+
+    if (numRotationsOut) {
+        *numRotationsOut = numRotations;
+    }
+    if (numTranslationsOut) {
+        *numTranslationsOut = numTranslations;
+    }
+    return reader.getBytesRead();
+}
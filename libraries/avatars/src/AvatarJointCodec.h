@@ -0,0 +1,84 @@
+//
+//  AvatarJointCodec.h
+//  libraries/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarJointCodec_h
+#define hifi_AvatarJointCodec_h
+
+#include <stdint.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <QVector>
+
+#include <JointData.h>
+
+// Bit packed encoding of the joint data section of avatar data.
+//
+// Rotations are sent as the smallest three components of the quaternion, the index of the dropped largest one
+// in two bits. Translations are sent as signed fixed point against a power of two scale covering every
+// translation of the avatar, so that the scale stays put from frame to frame. The precisions and the scale are
+// part of the stream, a decoder needs no configuration. Validity masks take one bit per joint.
+//
+//    uint8   numJoints
+//    uint4   rotationBits
+//    uint4   translationBits
+//    uint8   translationScaleExponent + TRANSLATION_SCALE_EXPONENT_BIAS
+//    bit     rotationValidity[numJoints]
+//    { uint2 largestComponent; uint smallestThree[3] : rotationBits } rotations[numValidRotations]
+//    bit     translationValidity[numJoints]
+//    { uint xyz[3] : translationBits } translations[numValidTranslations]
+//    zero bits up to a whole byte
+class AvatarJointCodec {
+public:
+    static const int MIN_BITS;
+    static const int MAX_BITS;
+    static const int DEFAULT_ROTATION_BITS;
+    static const int DEFAULT_TRANSLATION_BITS;
+
+    static const int MIN_TRANSLATION_SCALE_EXPONENT;
+    static const int MAX_TRANSLATION_SCALE_EXPONENT;
+    static const int TRANSLATION_SCALE_EXPONENT_BIAS;
+
+    static const int MAX_JOINTS;
+
+    // precisions are in bits per component, clamped to MIN_BITS..MAX_BITS
+    AvatarJointCodec(int rotationBits = DEFAULT_ROTATION_BITS, int translationBits = DEFAULT_TRANSLATION_BITS);
+
+    int getRotationBits() const { return _rotationBits; }
+    int getTranslationBits() const { return _translationBits; }
+
+    // quantized values, two values with the same code are decoded to the same value
+    uint64_t quantizeRotation(const glm::quat& rotation) const;
+    uint64_t quantizeTranslation(const glm::vec3& translation, int scaleExponent) const;
+    glm::quat dequantizeRotation(uint64_t code) const;
+    glm::vec3 dequantizeTranslation(uint64_t code, int scaleExponent) const;
+
+    // exponent of the smallest power of two that covers every component of the set translations
+    static int computeTranslationScaleExponent(const QVector<JointData>& joints);
+
+    // upper bound of the size of an encoding of numJoints
+    static int getMaxEncodedSize(int numJoints);
+
+    // encode the joints flagged in sendRotations and sendTranslations, returns the number of bytes written
+    int encode(unsigned char* destination, const QVector<JointData>& joints, const QVector<bool>& sendRotations,
+        const QVector<bool>& sendTranslations, int scaleExponent) const;
+
+    // decode into joints, setting the values and flags of those received and leaving the others as they were.
+    // returns the number of bytes read, or -1 if the stream is truncated or malformed, leaving joints untouched.
+    static int decode(const unsigned char* source, int size, QVector<JointData>& joints,
+        int* numRotationsOut = nullptr, int* numTranslationsOut = nullptr);
+
+private:
+    int _rotationBits;
+    int _translationBits;
+};
+
+#endif // hifi_AvatarJointCodec_h
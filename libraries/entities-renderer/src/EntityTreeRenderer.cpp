@@ -185,7 +185,7 @@ void EntityTreeRenderer::setTree(OctreePointer newTree) {
 }
 
 void EntityTreeRenderer::update() {
-    PerformanceTimer perfTimer("ETRupdate");
+    PERFORMANCE_TIMER("ETRupdate");
     if (_tree && !_shuttingDown) {
         EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
         tree->update();
@@ -272,7 +272,7 @@ bool EntityTreeRenderer::findBestZoneAndMaybeContainingEntities(QVector<EntityIt
 }
 
 bool EntityTreeRenderer::checkEnterLeaveEntities() {
-    PerformanceTimer perfTimer("checkEnterLeaveEntities");
+    PERFORMANCE_TIMER("checkEnterLeaveEntities");
     auto now = usecTimestampNow();
     bool didUpdate = false;
 
@@ -695,7 +695,7 @@ void EntityTreeRenderer::mousePressEvent(QMouseEvent* event) {
     if (!_tree || _shuttingDown) {
         return;
     }
-    PerformanceTimer perfTimer("EntityTreeRenderer::mousePressEvent");
+    PERFORMANCE_TIMER("EntityTreeRenderer::mousePressEvent");
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
 
     bool precisionPicking = !_dontDoPrecisionPicking;
@@ -742,7 +742,7 @@ void EntityTreeRenderer::mouseReleaseEvent(QMouseEvent* event) {
         return;
     }
 
-    PerformanceTimer perfTimer("EntityTreeRenderer::mouseReleaseEvent");
+    PERFORMANCE_TIMER("EntityTreeRenderer::mouseReleaseEvent");
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
     bool precisionPicking = !_dontDoPrecisionPicking;
     RayToEntityIntersectionResult rayPickResult = findRayIntersectionWorker(ray, Octree::Lock, precisionPicking);
@@ -791,7 +791,7 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event) {
     if (!_tree || _shuttingDown) {
         return;
     }
-    PerformanceTimer perfTimer("EntityTreeRenderer::mouseMoveEvent");
+    PERFORMANCE_TIMER("EntityTreeRenderer::mouseMoveEvent");
 
     PickRay ray = _viewState->computePickRay(event->x(), event->y());
 
@@ -47,7 +47,7 @@ void RenderableLineEntityItem::updateGeometry() {
 
 
 void RenderableLineEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableLineEntityItem::render");
+    PERFORMANCE_TIMER("RenderableLineEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::Line);
     updateGeometry();
     
@@ -71,7 +71,7 @@ void RenderableModelEntityItem::loader() {
     auto renderer = DependencyManager::get<EntityTreeRenderer>();
     assert(renderer);
     {
-        PerformanceTimer perfTimer("getModel");
+        PERFORMANCE_TIMER("getModel");
         getModel(renderer);
     }
 }
@@ -177,7 +177,7 @@ void RenderableModelEntityItem::doInitialModelSimulation() {
     _model->setRotation(getRotation());
     _model->setTranslation(getPosition());
     {
-        PerformanceTimer perfTimer("_model->simulate");
+        PERFORMANCE_TIMER("_model->simulate");
         _model->simulate(0.0f);
     }
     _needsInitialSimulation = false;
@@ -362,7 +362,7 @@ void RenderableModelEntityItem::updateModelBounds() {
 // NOTE: this only renders the "meta" portion of the Model, namely it renders debugging items, and it handles
 // the per frame simulation/update that might be required if the models properties changed.
 void RenderableModelEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RMEIrender");
+    PERFORMANCE_TIMER("RMEIrender");
     assert(getType() == EntityTypes::Model);
 
     // When the individual mesh parts of a model finish fading, they will mark their Model as needing updating
@@ -376,7 +376,7 @@ void RenderableModelEntityItem::render(RenderArgs* args) {
         {
             if (!_model || _needsModelReload) {
                 // TODO: this getModel() appears to be about 3% of model render time. We should optimize
-                PerformanceTimer perfTimer("getModel");
+                PERFORMANCE_TIMER("getModel");
                 auto renderer = qSharedPointerCast<EntityTreeRenderer>(args->_renderer);
                 getModel(renderer);
 
@@ -644,7 +644,7 @@ bool RenderableModelEntityItem::isReadyToComputeShape() {
                 // we have both URLs AND both geometries AND they are both fully loaded.
                 if (_needsInitialSimulation) {
                     // the _model's offset will be wrong until _needsInitialSimulation is false
-                    PerformanceTimer perfTimer("_model->simulate");
+                    PERFORMANCE_TIMER("_model->simulate");
                     doInitialModelSimulation();
                 }
                 return true;
@@ -1186,7 +1186,7 @@ void RenderableModelEntityItem::setJointTranslationsSet(const QVector<bool>& tra
 
 
 void RenderableModelEntityItem::locationChanged(bool tellPhysics) {
-    PerformanceTimer pertTimer("locationChanged");
+    PERFORMANCE_TIMER("locationChanged");
     EntityItem::locationChanged(tellPhysics);
     if (_model && _model->isActive()) {
         _model->updateRenderItems();
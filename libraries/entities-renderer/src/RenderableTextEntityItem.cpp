@@ -33,7 +33,7 @@ RenderableTextEntityItem::~RenderableTextEntityItem() {
 }
 
 void RenderableTextEntityItem::render(RenderArgs* args) {
-    PerformanceTimer perfTimer("RenderableTextEntityItem::render");
+    PERFORMANCE_TIMER("RenderableTextEntityItem::render");
     Q_ASSERT(getType() == EntityTypes::Text);
     checkFading();
     
@@ -0,0 +1,124 @@
+//
+//  EncodedEntityCache.cpp
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EncodedEntityCache.h"
+
+#include "EntityItem.h"
+
+const int EncodedEntityCache::DEFAULT_MAX_SIZE = 64 * 1024 * 1024;
+
+EncodedEntityCache::Stamp EncodedEntityCache::Stamp::of(const EntityItem& entity) {
+    Stamp stamp;
+    stamp.changedOnServer = entity.getLastChangedOnServer();
+    stamp.lastEdited = entity.getLastEdited();
+    stamp.lastUpdated = entity.getLastUpdated();
+    stamp.lastSimulated = entity.getLastSimulated();
+    return stamp;
+}
+
+bool EncodedEntityCache::append(const EntityItemID& id, const Stamp& stamp, const EntityPropertyFlags& properties,
+        OctreePacketData* packetData) {
+    bool found = false;
+    bool appended = false;
+    withReadLock([&] {
+        auto it = _entries.constFind(id);
+        if (it == _entries.constEnd() || !(it->stamp == stamp) || !(it->properties == properties)) {
+            return;
+        }
+        found = true;
+        appended = packetData->appendRawData((const unsigned char*)it->data.constData(), it->data.size());
+        if (appended) {
+            _bytesSaved += it->data.size();
+        }
+    });
+
+    // an entry that doesn't fit is neither, the entity will be encoded partially
+    if (!found) {
+        ++_numMisses;
+    } else if (appended) {
+        ++_numHits;
+    }
+    return appended;
+}
+
+void EncodedEntityCache::insert(const EntityItemID& id, const Stamp& stamp, const EntityPropertyFlags& properties,
+        const unsigned char* data, int length) {
+    if (length > _maxSize) {
+        return;
+    }
+
+    withWriteLock([&] {
+        auto it = _entries.find(id);
+        if (it != _entries.end()) {
+            _size -= it->data.size();
+        } else if (_size + length > _maxSize) {
+            // start over rather than track recency, entries of the current scene are back within an interval
+            _entries.clear();
+            _size = 0;
+            it = _entries.end();
+        }
+        if (it == _entries.end()) {
+            it = _entries.insert(id, Entry());
+        }
+        it->stamp = stamp;
+        it->properties = properties;
+        it->data = QByteArray((const char*)data, length);
+        _size += length;
+    });
+}
+
+bool EncodedEntityCache::append(const EntityItem& entity, const EntityPropertyFlags& properties,
+        OctreePacketData* packetData) {
+    return append(entity.getEntityItemID(), Stamp::of(entity), properties, packetData);
+}
+
+void EncodedEntityCache::insert(const EntityItem& entity, const EntityPropertyFlags& properties,
+        const unsigned char* data, int length) {
+    insert(entity.getEntityItemID(), Stamp::of(entity), properties, data, length);
+}
+
+void EncodedEntityCache::remove(const EntityItemID& id) {
+    withWriteLock([&] {
+        auto it = _entries.find(id);
+        if (it != _entries.end()) {
+            _size -= it->data.size();
+            _entries.erase(it);
+        }
+    });
+}
+
+void EncodedEntityCache::clear() {
+    withWriteLock([&] {
+        _entries.clear();
+        _size = 0;
+    });
+}
+
+int EncodedEntityCache::getSize() const {
+    int size;
+    withReadLock([&] {
+        size = _size;
+    });
+    return size;
+}
+
+int EncodedEntityCache::getNumEntries() const {
+    int numEntries;
+    withReadLock([&] {
+        numEntries = _entries.size();
+    });
+    return numEntries;
+}
+
+void EncodedEntityCache::resetStats() {
+    _numHits = 0;
+    _numMisses = 0;
+    _bytesSaved = 0;
+}
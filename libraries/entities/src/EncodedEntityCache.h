@@ -0,0 +1,91 @@
+//
+//  EncodedEntityCache.h
+//  libraries/entities/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EncodedEntityCache_h
+#define hifi_EncodedEntityCache_h
+
+#include <atomic>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+
+#include <OctreePacketData.h>
+#include <shared/ReadWriteLockable.h>
+
+#include "EntityItemID.h"
+#include "EntityPropertyFlags.h"
+
+class EntityItem;
+
+// Entities encoded by the entity server, shared between the send threads of all its viewers.
+//
+// Once an entity passes a viewer's view and LOD checks, its complete encoding does not depend on the viewer, so
+// when many viewers look at the same scene it only needs to be encoded once per change. Entries are keyed by
+// entity and checked against the entity's change timestamps and the requested properties, so that a stale
+// encoding is never sent. Partial encodings are never cached.
+class EncodedEntityCache : public ReadWriteLockable {
+public:
+    static const int DEFAULT_MAX_SIZE;
+
+    class Stamp {
+    public:
+        quint64 changedOnServer { 0 };
+        quint64 lastEdited { 0 };
+        quint64 lastUpdated { 0 };
+        quint64 lastSimulated { 0 };
+
+        static Stamp of(const EntityItem& entity);
+
+        bool operator==(const Stamp& other) const {
+            return changedOnServer == other.changedOnServer && lastEdited == other.lastEdited &&
+                lastUpdated == other.lastUpdated && lastSimulated == other.lastSimulated;
+        }
+    };
+
+    EncodedEntityCache(int maxSize = DEFAULT_MAX_SIZE) : _maxSize(maxSize) {}
+
+    // appends the cached encoding, returns false if there is no current one or it doesn't fit in the packet
+    bool append(const EntityItemID& id, const Stamp& stamp, const EntityPropertyFlags& properties,
+        OctreePacketData* packetData);
+    void insert(const EntityItemID& id, const Stamp& stamp, const EntityPropertyFlags& properties,
+        const unsigned char* data, int length);
+
+    bool append(const EntityItem& entity, const EntityPropertyFlags& properties, OctreePacketData* packetData);
+    void insert(const EntityItem& entity, const EntityPropertyFlags& properties, const unsigned char* data, int length);
+
+    void remove(const EntityItemID& id);
+    void clear();
+
+    quint64 getNumHits() const { return _numHits; }
+    quint64 getNumMisses() const { return _numMisses; }
+    quint64 getBytesSaved() const { return _bytesSaved; }
+    int getSize() const;
+    int getNumEntries() const;
+
+    void resetStats();
+
+private:
+    class Entry {
+    public:
+        Stamp stamp;
+        EntityPropertyFlags properties;
+        QByteArray data;
+    };
+
+    const int _maxSize;
+    QHash<EntityItemID, Entry> _entries; // guarded by the lock
+    int _size { 0 }; // guarded by the lock
+
+    std::atomic<quint64> _numHits { 0 };
+    std::atomic<quint64> _numMisses { 0 };
+    std::atomic<quint64> _bytesSaved { 0 };
+};
+
+#endif // hifi_EncodedEntityCache_h
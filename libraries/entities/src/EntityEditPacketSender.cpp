@@ -85,6 +85,21 @@ void EntityEditPacketSender::queueEditAvatarEntityMessage(PacketType type,
 }
 
 
+bool EntityEditPacketSender::encodeEditEntityMessage(PacketType type, EntityItemID entityItemID,
+                                                     const EntityItemProperties& properties, QByteArray& bufferOut) {
+    bufferOut.resize(NLPacket::maxPayloadSize(type));
+    bufferOut.fill(0);
+
+    if (properties.parentIDChanged() && properties.getParentID() == AVATAR_SELF_ID) {
+        EntityItemProperties propertiesCopy = properties;
+        auto nodeList = DependencyManager::get<NodeList>();
+        const QUuid myNodeID = nodeList->getSessionUUID();
+        propertiesCopy.setParentID(myNodeID);
+        return EntityItemProperties::encodeEntityEditPacket(type, entityItemID, propertiesCopy, bufferOut);
+    }
+    return EntityItemProperties::encodeEntityEditPacket(type, entityItemID, properties, bufferOut);
+}
+
 void EntityEditPacketSender::queueEditEntityMessage(PacketType type,
                                                     EntityTreePointer entityTree,
                                                     EntityItemID entityItemID,
@@ -98,20 +113,8 @@ void EntityEditPacketSender::queueEditEntityMessage(PacketType type,
         return;
     }
 
-    QByteArray bufferOut(NLPacket::maxPayloadSize(type), 0);
-
-    bool success;
-    if (properties.parentIDChanged() && properties.getParentID() == AVATAR_SELF_ID) {
-        EntityItemProperties propertiesCopy = properties;
-        auto nodeList = DependencyManager::get<NodeList>();
-        const QUuid myNodeID = nodeList->getSessionUUID();
-        propertiesCopy.setParentID(myNodeID);
-        success = EntityItemProperties::encodeEntityEditPacket(type, entityItemID, propertiesCopy, bufferOut);
-    } else {
-        success = EntityItemProperties::encodeEntityEditPacket(type, entityItemID, properties, bufferOut);
-    }
-
-    if (success) {
+    QByteArray bufferOut;
+    if (encodeEditEntityMessage(type, entityItemID, properties, bufferOut)) {
         #ifdef WANT_DEBUG
             qCDebug(entities) << "calling queueOctreeEditMessage()...";
             qCDebug(entities) << "    id:" << entityItemID;
@@ -121,6 +124,29 @@ void EntityEditPacketSender::queueEditEntityMessage(PacketType type,
     }
 }
 
+void EntityEditPacketSender::queueEditEntityMessages(PacketType type,
+                                                     EntityTreePointer entityTree,
+                                                     const EntityEdits& edits) {
+    if (!_shouldSend) {
+        return; // bail early
+    }
+
+    std::vector<QByteArray> editMessages;
+    editMessages.reserve(edits.size());
+    for (auto& edit : edits) {
+        if (edit.second.getClientOnly()) {
+            queueEditAvatarEntityMessage(type, entityTree, edit.first, edit.second);
+            continue;
+        }
+
+        QByteArray bufferOut;
+        if (encodeEditEntityMessage(type, edit.first, edit.second, bufferOut)) {
+            editMessages.push_back(bufferOut);
+        }
+    }
+    queueOctreeEditMessages(type, editMessages);
+}
+
 void EntityEditPacketSender::queueEraseEntityMessage(const EntityItemID& entityItemID) {
     if (!_shouldSend) {
         return; // bail early
@@ -38,6 +38,11 @@ public:
     void queueEditEntityMessage(PacketType type, EntityTreePointer entityTree,
                                 EntityItemID entityItemID, const EntityItemProperties& properties);
 
+    using EntityEdits = std::vector<std::pair<EntityItemID, EntityItemProperties>>;
+
+    /// Queues edits for several entities at once, packed into as few packets as possible.
+    void queueEditEntityMessages(PacketType type, EntityTreePointer entityTree, const EntityEdits& edits);
+
 
     void queueEraseEntityMessage(const EntityItemID& entityItemID);
 
@@ -49,6 +54,9 @@ public slots:
     void processEntityEditNackPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
 
 private:
+    bool encodeEditEntityMessage(PacketType type, EntityItemID entityItemID,
+                                 const EntityItemProperties& properties, QByteArray& bufferOut);
+
     AvatarData* _myAvatar { nullptr };
     QScriptEngine _scriptEngine;
 };
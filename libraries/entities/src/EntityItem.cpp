@@ -1415,11 +1415,14 @@ void EntityItem::setDimensions(const glm::vec3& value) {
 /// This accounts for the registration point (upon which rotation occurs around).
 ///
 AACube EntityItem::getMaximumAACube(bool& success) const {
-    if (_recalcMaxAACube) {
+    // the world transform generation also catches reparenting, which doesn't call locationChanged(), here and below
+    quint64 generation = getWorldTransformGeneration();
+    if (_recalcMaxAACube || _maxAACubeGeneration != generation) {
         // * we know that the position is the center of rotation
         glm::vec3 centerOfRotation = getPosition(success); // also where _registration point is
         if (success) {
             _recalcMaxAACube = false;
+            _maxAACubeGeneration = generation;
             // * we know that the registration point is the center of rotation
             // * we can calculate the length of the furthest extent from the registration point
             //   as the dimensions * max (registrationPoint, (1.0,1.0,1.0) - registrationPoint)
@@ -1448,11 +1451,13 @@ AACube EntityItem::getMaximumAACube(bool& success) const {
 /// This accounts for the registration point (upon which rotation occurs around).
 ///
 AACube EntityItem::getMinimumAACube(bool& success) const {
-    if (_recalcMinAACube) {
+    quint64 generation = getWorldTransformGeneration();
+    if (_recalcMinAACube || _minAACubeGeneration != generation) {
         // position represents the position of the registration point.
         glm::vec3 position = getPosition(success);
         if (success) {
             _recalcMinAACube = false;
+            _minAACubeGeneration = generation;
             glm::vec3 dimensions = getDimensions();
             glm::vec3 unrotatedMinRelativeToEntity = - (dimensions * _registrationPoint);
             glm::vec3 unrotatedMaxRelativeToEntity = dimensions * (glm::vec3(1.0f, 1.0f, 1.0f) - _registrationPoint);
@@ -1478,11 +1483,13 @@ AACube EntityItem::getMinimumAACube(bool& success) const {
 }
 
 AABox EntityItem::getAABox(bool& success) const {
-    if (_recalcAABox) {
+    quint64 generation = getWorldTransformGeneration();
+    if (_recalcAABox || _cachedAABoxGeneration != generation) {
         // position represents the position of the registration point.
         glm::vec3 position = getPosition(success);
         if (success) {
             _recalcAABox = false;
+            _cachedAABoxGeneration = generation;
             glm::vec3 dimensions = getDimensions();
             glm::vec3 unrotatedMinRelativeToEntity = - (dimensions * _registrationPoint);
             glm::vec3 unrotatedMaxRelativeToEntity = dimensions * (glm::vec3(1.0f, 1.0f, 1.0f) - _registrationPoint);
@@ -501,6 +501,9 @@ protected:
     mutable bool _recalcAABox { true };
     mutable bool _recalcMinAACube { true };
     mutable bool _recalcMaxAACube { true };
+    mutable quint64 _cachedAABoxGeneration { 0 };
+    mutable quint64 _minAACubeGeneration { 0 };
+    mutable quint64 _maxAACubeGeneration { 0 };
 
     float _localRenderAlpha;
     float _density { ENTITY_ITEM_DEFAULT_DENSITY }; // kg/m^3
@@ -339,6 +339,7 @@ private:
 };
 
 Q_DECLARE_METATYPE(EntityItemProperties);
+Q_DECLARE_METATYPE(QVector<EntityItemProperties>);
 QScriptValue EntityItemPropertiesToScriptValue(QScriptEngine* engine, const EntityItemProperties& properties);
 QScriptValue EntityItemNonDefaultPropertiesToScriptValue(QScriptEngine* engine, const EntityItemProperties& properties);
 void EntityItemPropertiesFromScriptValueIgnoreReadOnly(const QScriptValue& object, EntityItemProperties& properties);
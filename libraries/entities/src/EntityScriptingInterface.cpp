@@ -269,44 +269,74 @@ EntityItemProperties EntityScriptingInterface::getEntityProperties(QUuid identit
         _entityTree->withReadLock([&] {
             EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(identity));
             if (entity) {
-                if (desiredProperties.getHasProperty(PROP_POSITION) ||
-                    desiredProperties.getHasProperty(PROP_ROTATION) ||
-                    desiredProperties.getHasProperty(PROP_LOCAL_POSITION) ||
-                    desiredProperties.getHasProperty(PROP_LOCAL_ROTATION)) {
-                    // if we are explicitly getting position or rotation, we need parent information to make sense of them.
-                    desiredProperties.setHasProperty(PROP_PARENT_ID);
-                    desiredProperties.setHasProperty(PROP_PARENT_JOINT_INDEX);
-                }
+                results = getEntityPropertiesWithLock(entity, desiredProperties);
+            }
+        });
+    }
 
-                if (desiredProperties.isEmpty()) {
-                    // these are left out of EntityItem::getEntityProperties so that localPosition and localRotation
-                    // don't end up in json saves, etc.  We still want them here, though.
-                    EncodeBitstreamParams params; // unknown
-                    desiredProperties = entity->getEntityProperties(params);
-                    desiredProperties.setHasProperty(PROP_LOCAL_POSITION);
-                    desiredProperties.setHasProperty(PROP_LOCAL_ROTATION);
-                 }
-
-                results = entity->getProperties(desiredProperties);
-
-                // TODO: improve sitting points and naturalDimensions in the future,
-                //       for now we've included the old sitting points model behavior for entity types that are models
-                //        we've also added this hack for setting natural dimensions of models
-                if (entity->getType() == EntityTypes::Model) {
-                    const FBXGeometry* geometry = _entityTree->getGeometryForEntity(entity);
-                    if (geometry) {
-                        results.setSittingPoints(geometry->sittingPoints);
-                        Extents meshExtents = geometry->getUnscaledMeshExtents();
-                        results.setNaturalDimensions(meshExtents.maximum - meshExtents.minimum);
-                        results.calculateNaturalPosition(meshExtents.minimum, meshExtents.maximum);
-                    }
-                }
+    return convertLocationToScriptSemantics(results);
+}
+
+QVector<EntityItemProperties> EntityScriptingInterface::getMultipleEntityProperties(QVector<QUuid> entityIDs,
+                                                                                    EntityPropertyFlags desiredProperties) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
 
+    // results line up with entityIDs; unknown entities get default (empty) properties, as getEntityProperties does
+    QVector<EntityItemProperties> results(entityIDs.size());
+    if (_entityTree) {
+        _entityTree->withReadLock([&] {
+            for (int i = 0; i < entityIDs.size(); ++i) {
+                EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(entityIDs[i]));
+                if (entity) {
+                    results[i] = getEntityPropertiesWithLock(entity, desiredProperties);
+                }
             }
         });
     }
 
-    return convertLocationToScriptSemantics(results);
+    for (auto& properties : results) {
+        properties = convertLocationToScriptSemantics(properties);
+    }
+    return results;
+}
+
+// NOTE: must be called with the tree read lock held
+EntityItemProperties EntityScriptingInterface::getEntityPropertiesWithLock(const EntityItemPointer& entity,
+                                                                           EntityPropertyFlags desiredProperties) {
+    if (desiredProperties.getHasProperty(PROP_POSITION) ||
+        desiredProperties.getHasProperty(PROP_ROTATION) ||
+        desiredProperties.getHasProperty(PROP_LOCAL_POSITION) ||
+        desiredProperties.getHasProperty(PROP_LOCAL_ROTATION)) {
+        // if we are explicitly getting position or rotation, we need parent information to make sense of them.
+        desiredProperties.setHasProperty(PROP_PARENT_ID);
+        desiredProperties.setHasProperty(PROP_PARENT_JOINT_INDEX);
+    }
+
+    if (desiredProperties.isEmpty()) {
+        // these are left out of EntityItem::getEntityProperties so that localPosition and localRotation
+        // don't end up in json saves, etc.  We still want them here, though.
+        EncodeBitstreamParams params; // unknown
+        desiredProperties = entity->getEntityProperties(params);
+        desiredProperties.setHasProperty(PROP_LOCAL_POSITION);
+        desiredProperties.setHasProperty(PROP_LOCAL_ROTATION);
+     }
+
+    EntityItemProperties results = entity->getProperties(desiredProperties);
+
+    // TODO: improve sitting points and naturalDimensions in the future,
+    //       for now we've included the old sitting points model behavior for entity types that are models
+    //        we've also added this hack for setting natural dimensions of models
+    if (entity->getType() == EntityTypes::Model) {
+        const FBXGeometry* geometry = _entityTree->getGeometryForEntity(entity);
+        if (geometry) {
+            results.setSittingPoints(geometry->sittingPoints);
+            Extents meshExtents = geometry->getUnscaledMeshExtents();
+            results.setNaturalDimensions(meshExtents.maximum - meshExtents.minimum);
+            results.calculateNaturalPosition(meshExtents.minimum, meshExtents.maximum);
+        }
+    }
+
+    return results;
 }
 
 QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties& scriptSideProperties) {
@@ -314,46 +344,106 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties&
 
     _activityTracking.editedEntityCount++;
 
-    EntityItemProperties properties = scriptSideProperties;
-
-    auto dimensions = properties.getDimensions();
-    float volume = dimensions.x * dimensions.y * dimensions.z;
-    auto density = properties.getDensity();
-    auto newVelocity = properties.getVelocity().length();
-    float oldVelocity = { 0.0f };
-
     EntityItemID entityID(id);
     if (!_entityTree) {
-        queueEntityMessage(PacketType::EntityEdit, entityID, properties);
+        queueEntityMessage(PacketType::EntityEdit, entityID, scriptSideProperties);
 
         //if there is no local entity entity tree, no existing velocity, use 0.
-        float cost = calculateCost(density * volume, oldVelocity, newVelocity);
-        cost *= costMultiplier;
-
-        if (cost > _currentAvatarEnergy) {
+        if (!debitEditCost(scriptSideProperties)) {
             return QUuid();
-        } else {
-            //debit the avatar energy and continue
-            emit debitEnergySource(cost);
         }
-
         return id;
     }
     // If we have a local entity tree set, then also update it.
 
-    bool updatedEntity = false;
+    EntityEditPacketSender::EntityEdits edits;
     _entityTree->withWriteLock([&] {
-        EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
-        if (!entity) {
-            return;
+        editEntityWithLock(entityID, scriptSideProperties, edits);
+    });
+    for (auto& edit : edits) {
+        queueEntityMessage(PacketType::EntityEdit, edit.first, edit.second);
+    }
+    return id;
+}
+
+QVector<QUuid> EntityScriptingInterface::editEntities(const QScriptValue& entityEdits) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    // convert everything up front, so the tree is only locked for the edits themselves
+    QVector<QPair<EntityItemID, EntityItemProperties>> scriptSideEdits;
+    int length = entityEdits.property("length").toInt32();
+    scriptSideEdits.reserve(length);
+    for (int i = 0; i < length; ++i) {
+        QScriptValue entityEdit = entityEdits.property(i);
+        EntityItemID entityID(QUuid(entityEdit.property("id").toString()));
+        if (entityID.isNull()) {
+            continue;
         }
+        EntityItemProperties properties;
+        EntityItemPropertiesFromScriptValueHonorReadOnly(entityEdit.property("properties"), properties);
+        scriptSideEdits.push_back({ entityID, properties });
+    }
 
-        auto nodeList = DependencyManager::get<NodeList>();
-        if (entity->getClientOnly() && entity->getOwningAvatarID() != nodeList->getSessionUUID()) {
-            // don't edit other avatar's avatarEntities
-            return;
+    _activityTracking.editedEntityCount += scriptSideEdits.size();
+
+    QVector<QUuid> result;
+    result.reserve(scriptSideEdits.size());
+    EntityEditPacketSender::EntityEdits edits;
+    if (!_entityTree) {
+        for (auto& scriptSideEdit : scriptSideEdits) {
+            edits.push_back({ scriptSideEdit.first, scriptSideEdit.second });
+            if (debitEditCost(scriptSideEdit.second)) {
+                result.push_back(scriptSideEdit.first);
+            }
         }
+    } else {
+        _entityTree->withWriteLock([&] {
+            for (auto& scriptSideEdit : scriptSideEdits) {
+                if (editEntityWithLock(scriptSideEdit.first, scriptSideEdit.second, edits)) {
+                    result.push_back(scriptSideEdit.first);
+                }
+            }
+        });
+    }
+
+    getEntityPacketSender()->queueEditEntityMessages(PacketType::EntityEdit, _entityTree, edits);
+    return result;
+}
+
+// used when there is no local tree, and so no existing velocity
+bool EntityScriptingInterface::debitEditCost(const EntityItemProperties& properties) {
+    auto dimensions = properties.getDimensions();
+    float volume = dimensions.x * dimensions.y * dimensions.z;
+    auto density = properties.getDensity();
+    auto newVelocity = properties.getVelocity().length();
+    float oldVelocity = { 0.0f };
+
+    float cost = calculateCost(density * volume, oldVelocity, newVelocity);
+    cost *= costMultiplier;
+
+    if (cost > _currentAvatarEnergy) {
+        return false;
+    }
+    //debit the avatar energy and continue
+    emit debitEnergySource(cost);
+    return true;
+}
+
+// NOTE: must be called with the tree write lock held. Appends the edit for entityID, and for any descendants whose
+// queryAACube it moved, to edits. Returns false if the entity is in the local tree but refused the edit.
+bool EntityScriptingInterface::editEntityWithLock(const EntityItemID& entityID, const EntityItemProperties& scriptSideProperties,
+                                                  EntityEditPacketSender::EntityEdits& edits) {
+    EntityItemProperties properties = scriptSideProperties;
+    float oldVelocity = { 0.0f };
+
+    EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
+
+    // don't edit other avatar's avatarEntities
+    auto nodeList = DependencyManager::get<NodeList>();
+    bool canEdit = entity && !(entity->getClientOnly() && entity->getOwningAvatarID() != nodeList->getSessionUUID());
+    bool updated = false;
 
+    if (canEdit) {
         if (scriptSideProperties.parentRelatedPropertyChanged()) {
             // All of parentID, parentJointIndex, position, rotation are needed to make sense of any of them.
             // If any of these changed, pull any missing properties from the entity.
@@ -378,19 +468,20 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties&
         properties.setClientOnly(entity->getClientOnly());
         properties.setOwningAvatarID(entity->getOwningAvatarID());
 
-        float cost = calculateCost(density * volume, oldVelocity, newVelocity);
+        auto dimensions = scriptSideProperties.getDimensions();
+        float volume = dimensions.x * dimensions.y * dimensions.z;
+        float cost = calculateCost(scriptSideProperties.getDensity() * volume, oldVelocity,
+                                   scriptSideProperties.getVelocity().length());
         cost *= costMultiplier;
 
-        if (cost > _currentAvatarEnergy) {
-            updatedEntity = false;
-        } else {
+        if (cost <= _currentAvatarEnergy) {
             //debit the avatar energy and continue
-            updatedEntity = _entityTree->updateEntity(entityID, properties);
-            if (updatedEntity) {
+            if (_entityTree->updateEntity(entityID, properties)) {
                 emit debitEnergySource(cost);
+                updated = true;
             }
         }
-    });
+    }
 
     // FIXME: We need to figure out a better way to handle this. Allowing these edits to go through potentially
     // breaks avatar energy and entities that are parented.
@@ -401,65 +492,62 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties&
     //     return QUuid();
     // }
 
-    _entityTree->withReadLock([&] {
-        EntityItemPointer entity = _entityTree->findEntityByEntityItemID(entityID);
-        if (entity) {
-            // make sure the properties has a type, so that the encode can know which properties to include
-            properties.setType(entity->getType());
-            bool hasTerseUpdateChanges = properties.hasTerseUpdateChanges();
-            bool hasPhysicsChanges = properties.hasMiscPhysicsChanges() || hasTerseUpdateChanges;
-            if (_bidOnSimulationOwnership && hasPhysicsChanges) {
-                auto nodeList = DependencyManager::get<NodeList>();
-                const QUuid myNodeID = nodeList->getSessionUUID();
-
-                if (entity->getSimulatorID() == myNodeID) {
-                    // we think we already own the simulation, so make sure to send ALL TerseUpdate properties
-                    if (hasTerseUpdateChanges) {
-                        entity->getAllTerseUpdateProperties(properties);
-                    }
-                    // TODO: if we knew that ONLY TerseUpdate properties have changed in properties AND the object
-                    // is dynamic AND it is active in the physics simulation then we could chose to NOT queue an update
-                    // and instead let the physics simulation decide when to send a terse update.  This would remove
-                    // the "slide-no-rotate" glitch (and typical double-update) that we see during the "poke rolling
-                    // balls" test.  However, even if we solve this problem we still need to provide a "slerp the visible
-                    // proxy toward the true physical position" feature to hide the final glitches in the remote watcher's
-                    // simulation.
-
-                    if (entity->getSimulationPriority() < SCRIPT_POKE_SIMULATION_PRIORITY) {
-                        // we re-assert our simulation ownership at a higher priority
-                        properties.setSimulationOwner(myNodeID, SCRIPT_POKE_SIMULATION_PRIORITY);
-                    }
-                } else {
-                    // we make a bid for simulation ownership
+    if (entity) {
+        // make sure the properties has a type, so that the encode can know which properties to include
+        properties.setType(entity->getType());
+        bool hasTerseUpdateChanges = properties.hasTerseUpdateChanges();
+        bool hasPhysicsChanges = properties.hasMiscPhysicsChanges() || hasTerseUpdateChanges;
+        if (_bidOnSimulationOwnership && hasPhysicsChanges) {
+            const QUuid myNodeID = nodeList->getSessionUUID();
+
+            if (entity->getSimulatorID() == myNodeID) {
+                // we think we already own the simulation, so make sure to send ALL TerseUpdate properties
+                if (hasTerseUpdateChanges) {
+                    entity->getAllTerseUpdateProperties(properties);
+                }
+                // TODO: if we knew that ONLY TerseUpdate properties have changed in properties AND the object
+                // is dynamic AND it is active in the physics simulation then we could chose to NOT queue an update
+                // and instead let the physics simulation decide when to send a terse update.  This would remove
+                // the "slide-no-rotate" glitch (and typical double-update) that we see during the "poke rolling
+                // balls" test.  However, even if we solve this problem we still need to provide a "slerp the visible
+                // proxy toward the true physical position" feature to hide the final glitches in the remote watcher's
+                // simulation.
+
+                if (entity->getSimulationPriority() < SCRIPT_POKE_SIMULATION_PRIORITY) {
+                    // we re-assert our simulation ownership at a higher priority
                     properties.setSimulationOwner(myNodeID, SCRIPT_POKE_SIMULATION_PRIORITY);
-                    entity->pokeSimulationOwnership();
-                    entity->rememberHasSimulationOwnershipBid();
                 }
+            } else {
+                // we make a bid for simulation ownership
+                properties.setSimulationOwner(myNodeID, SCRIPT_POKE_SIMULATION_PRIORITY);
+                entity->pokeSimulationOwnership();
+                entity->rememberHasSimulationOwnershipBid();
             }
-            if (properties.parentRelatedPropertyChanged() && entity->computePuffedQueryAACube()) {
-                properties.setQueryAACube(entity->getQueryAACube());
-            }
-            entity->setLastBroadcast(usecTimestampNow());
-            properties.setLastEdited(entity->getLastEdited());
-
-            // if we've moved an entity with children, check/update the queryAACube of all descendents and tell the server
-            // if they've changed.
-            entity->forEachDescendant([&](SpatiallyNestablePointer descendant) {
-                if (descendant->getNestableType() == NestableType::Entity) {
-                    if (descendant->computePuffedQueryAACube()) {
-                        EntityItemPointer entityDescendant = std::static_pointer_cast<EntityItem>(descendant);
-                        EntityItemProperties newQueryCubeProperties;
-                        newQueryCubeProperties.setQueryAACube(descendant->getQueryAACube());
-                        newQueryCubeProperties.setLastEdited(properties.getLastEdited());
-                        queueEntityMessage(PacketType::EntityEdit, descendant->getID(), newQueryCubeProperties);
-                        entityDescendant->setLastBroadcast(usecTimestampNow());
-                    }
-                }
-            });
         }
-    });
-    queueEntityMessage(PacketType::EntityEdit, entityID, properties);
-    return id;
+        if (properties.parentRelatedPropertyChanged() && entity->computePuffedQueryAACube()) {
+            properties.setQueryAACube(entity->getQueryAACube());
+        }
+        entity->setLastBroadcast(usecTimestampNow());
+        properties.setLastEdited(entity->getLastEdited());
+
+        // if we've moved an entity with children, check/update the queryAACube of all descendents and tell the server
+        // if they've changed.
+        entity->forEachDescendant([&](SpatiallyNestablePointer descendant) {
+            if (descendant->getNestableType() == NestableType::Entity) {
+                if (descendant->computePuffedQueryAACube()) {
+                    EntityItemPointer entityDescendant = std::static_pointer_cast<EntityItem>(descendant);
+                    EntityItemProperties newQueryCubeProperties;
+                    newQueryCubeProperties.setQueryAACube(descendant->getQueryAACube());
+                    newQueryCubeProperties.setLastEdited(properties.getLastEdited());
+                    edits.push_back({ descendant->getID(), newQueryCubeProperties });
+                    entityDescendant->setLastBroadcast(usecTimestampNow());
+                }
+            }
+        });
+    }
+    edits.push_back({ entityID, properties });
+
+    return !entity || updated;
 }
 
 void EntityScriptingInterface::deleteEntity(QUuid id) {
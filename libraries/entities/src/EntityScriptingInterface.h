@@ -144,6 +144,19 @@ public slots:
     Q_INVOKABLE EntityItemProperties getEntityProperties(QUuid entityID);
     Q_INVOKABLE EntityItemProperties getEntityProperties(QUuid identity, EntityPropertyFlags desiredProperties);
 
+    /**jsdoc
+     * Return the properties for several entities at once, taking the entity tree lock only once.
+     *
+     * @function Entities.getMultipleEntityProperties
+     * @param {EntityID[]} entityIDs The IDs of the entities to get the properties of.
+     * @param {EntityPropertyFlags} [desiredProperties=[]] Array containing the names of the properties you
+     *     would like to get. If the array is empty, all properties will be returned.
+     * @return {EntityItemProperties[]} The properties of each entity, in the same order as `entityIDs`. Entities
+     *     that could not be found have empty properties.
+     */
+    Q_INVOKABLE QVector<EntityItemProperties> getMultipleEntityProperties(QVector<QUuid> entityIDs,
+                                                                          EntityPropertyFlags desiredProperties = EntityPropertyFlags());
+
     /**jsdoc
      * Updates an entity with the specified properties.
      *
@@ -152,6 +165,19 @@ public slots:
      */
     Q_INVOKABLE QUuid editEntity(QUuid entityID, const EntityItemProperties& properties);
 
+    /**jsdoc
+     * Updates several entities at once. The entity tree is locked once for all of the edits, and they are sent to
+     * the entity server packed into as few packets as possible.
+     *
+     * @function Entities.editEntities
+     * @param {Object[]} edits Array of `{ id: EntityID, properties: EntityItemProperties }` objects.
+     * @return {EntityID[]} The EntityIDs of the edits that were accepted: those applied to the local copy of the
+     *     entity, and those of entities not known locally, which are passed on to the entity server as they are. An edit
+     *     the local entity refused, e.g. for lack of avatar energy or because it is another avatar's entity, is left out.
+     *     Edits without a valid <code>id</code> are ignored.
+     */
+    Q_INVOKABLE QVector<QUuid> editEntities(const QScriptValue& edits);
+
     /**jsdoc
      * Deletes an entity.
      *
@@ -323,6 +349,11 @@ private:
     bool setPoints(QUuid entityID, std::function<bool(LineEntityItem&)> actor);
     void queueEntityMessage(PacketType packetType, EntityItemID entityID, const EntityItemProperties& properties);
 
+    EntityItemProperties getEntityPropertiesWithLock(const EntityItemPointer& entity, EntityPropertyFlags desiredProperties);
+    bool editEntityWithLock(const EntityItemID& entityID, const EntityItemProperties& scriptSideProperties,
+                            EntityEditPacketSender::EntityEdits& edits);
+    bool debitEditCost(const EntityItemProperties& properties);
+
     EntityItemPointer checkForTreeEntityAndTypeMatch(const QUuid& entityID,
                                                      EntityTypes::EntityType entityType = EntityTypes::Unknown);
 
@@ -92,6 +92,9 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         }
         _entityToElementMap.clear();
     }
+    if (_encodedEntityCache) {
+        _encodedEntityCache->clear();
+    }
     Octree::eraseAllOctreeElements(createNewRoot);
 
     resetClientEditStats();
@@ -505,6 +508,10 @@ void EntityTree::deleteEntities(QSet<EntityItemID> entityIDs, bool force, bool i
     }
 }
 
+void EntityTree::enableEncodedEntityCache(int maxSize) {
+    _encodedEntityCache.reset(new EncodedEntityCache(maxSize));
+}
+
 void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator) {
     quint64 deletedAt = usecTimestampNow();
     const RemovedEntities& entities = theOperator.getEntities();
@@ -523,6 +530,10 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
 
         theEntity->die();
 
+        if (_encodedEntityCache) {
+            _encodedEntityCache->remove(theEntity->getEntityItemID());
+        }
+
         if (getIsServer()) {
             // set up the deleted entities ID
             QWriteLocker locker(&_recentlyDeletedEntitiesLock);
@@ -1289,7 +1300,7 @@ void EntityTree::fixupMissingParents() {
     }
 
     if (moveOperator.hasMovingEntities()) {
-        PerformanceTimer perfTimer("recurseTreeWithOperator");
+        PERFORMANCE_TIMER("recurseTreeWithOperator");
         recurseTreeWithOperator(&moveOperator);
     }
 }
@@ -24,6 +24,7 @@ typedef std::shared_ptr<EntityTree> EntityTreePointer;
 
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
+#include "EncodedEntityCache.h"
 
 class Model;
 using ModelPointer = std::shared_ptr<Model>;
@@ -215,6 +216,10 @@ public:
     void setSimulation(EntitySimulationPointer simulation);
     EntitySimulationPointer getSimulation() const { return _simulation; }
 
+    // server trees may share the encoding of unchanged entities between the viewers they are sent to
+    void enableEncodedEntityCache(int maxSize = EncodedEntityCache::DEFAULT_MAX_SIZE);
+    EncodedEntityCache* getEncodedEntityCache() const { return _encodedEntityCache.get(); }
+
     bool wantEditLogging() const { return _wantEditLogging; }
     void setWantEditLogging(bool value) { _wantEditLogging = value; }
 
@@ -329,6 +334,8 @@ protected:
 
     EntitySimulationPointer _simulation;
 
+    std::unique_ptr<EncodedEntityCache> _encodedEntityCache;
+
     bool _wantEditLogging = false;
     bool _wantTerseEditLogging = false;
 
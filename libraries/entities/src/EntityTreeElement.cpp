@@ -393,11 +393,35 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
         bool successAppendEntityCount = packetData->appendValue(numberOfEntities);
 
         if (successAppendEntityCount) {
+            EncodedEntityCache* encodedEntityCache = _myTree ? _myTree->getEncodedEntityCache() : nullptr;
+
             foreach(uint16_t i, indexesOfEntitiesToInclude) {
                 EntityItemPointer entity = _entityItems[i];
                 LevelDetails entityLevel = packetData->startLevel();
-                OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData,
-                    params, entityTreeElementExtraEncodeData);
+                OctreeElement::AppendState appendEntityState;
+
+                // an entity encoded in full is the same for every viewer, so it can be spliced from the tree's cache,
+                // but one continued from an earlier partial pass only has some of its properties left to send
+                EntityPropertyFlags requestedProperties;
+                bool cacheable = false;
+                if (encodedEntityCache) {
+                    requestedProperties = entity->getEntityProperties(params);
+                    cacheable = entityTreeElementExtraEncodeData->entities.value(entity->getEntityItemID(),
+                        requestedProperties) == requestedProperties;
+                }
+
+                int entityOffset = packetData->getUncompressedByteOffset();
+                if (cacheable && encodedEntityCache->append(*entity, requestedProperties, packetData)) {
+                    params.trackSend(entity->getID(), entity->getLastEdited());
+                    appendEntityState = OctreeElement::COMPLETED;
+                } else {
+                    appendEntityState = entity->appendEntityData(packetData, params, entityTreeElementExtraEncodeData);
+                    if (cacheable && appendEntityState == OctreeElement::COMPLETED) {
+                        encodedEntityCache->insert(*entity, requestedProperties,
+                            packetData->getUncompressedData(entityOffset),
+                            packetData->getUncompressedByteOffset() - entityOffset);
+                    }
+                }
 
                 // If none of this entity data was able to be appended, then discard it
                 // and don't include it in our entity count
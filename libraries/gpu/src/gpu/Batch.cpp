@@ -11,6 +11,7 @@
 #include "Batch.h"
 
 #include <string.h>
+#include <atomic>
 
 #include <QDebug>
 
@@ -37,25 +38,67 @@ size_t Batch::_dataMax { BATCH_PREALLOCATE_MIN };
 size_t Batch::_objectsMax { BATCH_PREALLOCATE_MIN };
 size_t Batch::_drawCallInfosMax { BATCH_PREALLOCATE_MIN };
 
+// Retired batch storage, and the emptied batches which carry it
+static const size_t MAX_POOLED_BATCHES = 256;
+static std::mutex _storagePoolMutex;
+static std::vector<std::unique_ptr<Batch>> _storagePool;
+static std::vector<std::unique_ptr<Batch>> _spareBatches;
+static std::atomic<uint32> _numBatches { 0 };
+static std::atomic<uint32> _numAllocatedBatches { 0 };
+
 Batch::Batch() {
+    _numBatches++;
+
+    {
+        std::lock_guard<std::mutex> lock(_storagePoolMutex);
+        if (!_storagePool.empty()) {
+            std::unique_ptr<Batch> pooled = std::move(_storagePool.back());
+            _storagePool.pop_back();
+            swapStorage(*pooled);
+            _spareBatches.push_back(std::move(pooled));
+            return;
+        }
+    }
+
+    _numAllocatedBatches++;
     _commands.reserve(_commandsMax);
     _commandOffsets.reserve(_commandOffsetsMax);
     _params.reserve(_paramsMax);
     _data.reserve(_dataMax);
     _objects.reserve(_objectsMax);
     _drawCallInfos.reserve(_drawCallInfosMax);
+
+    _buffers.reserve();
+    _textures.reserve();
+    _streamFormats.reserve();
+    _transforms.reserve();
+    _pipelines.reserve();
+    _framebuffers.reserve();
+    _queries.reserve();
+    _lambdas.reserve();
+    _profileRanges.reserve();
+    _names.reserve();
+}
+
+Batch::Batch(NoStorage) {
 }
 
 Batch::Batch(const Batch& batch_) {
     Batch& batch = *const_cast<Batch*>(&batch_);
+    swapStorage(batch);
+    _invalidModel = batch._invalidModel;
+    _currentModel = batch._currentModel;
+    _currentNamedCall = batch._currentNamedCall;
+    _enableStereo = batch._enableStereo;
+    _enableSkybox = batch._enableSkybox;
+}
+
+void Batch::swapStorage(Batch& batch) {
     _commands.swap(batch._commands);
     _commandOffsets.swap(batch._commandOffsets);
     _params.swap(batch._params);
     _data.swap(batch._data);
-    _invalidModel = batch._invalidModel;
-    _currentModel = batch._currentModel;
     _objects.swap(batch._objects);
-    _currentNamedCall = batch._currentNamedCall;
 
     _buffers._items.swap(batch._buffers._items);
     _textures._items.swap(batch._textures._items);
@@ -69,8 +112,46 @@ Batch::Batch(const Batch& batch_) {
     _profileRanges._items.swap(batch._profileRanges._items);
     _names._items.swap(batch._names._items);
     _namedData.swap(batch._namedData);
-    _enableStereo = batch._enableStereo;
-    _enableSkybox = batch._enableSkybox;
+}
+
+void Batch::clearStorage() {
+    clear();
+    _queries.clear();
+    _lambdas.clear();
+    _profileRanges.clear();
+    _names.clear();
+    _namedData.clear();
+}
+
+void Batch::recycle(Batch& batch) {
+    // Release the referenced resources outside of the lock
+    batch.clearStorage();
+
+    std::lock_guard<std::mutex> lock(_storagePoolMutex);
+    if (_storagePool.size() >= MAX_POOLED_BATCHES) {
+        return; // the storage is freed with the batch
+    }
+
+    std::unique_ptr<Batch> carrier;
+    if (!_spareBatches.empty()) {
+        carrier = std::move(_spareBatches.back());
+        _spareBatches.pop_back();
+    } else {
+        carrier.reset(new Batch(NoStorage()));
+    }
+    carrier->swapStorage(batch);
+    _storagePool.push_back(std::move(carrier));
+}
+
+Batch::StorageStats Batch::getStorageStats() {
+    StorageStats stats;
+    stats.numBatches = _numBatches.load();
+    stats.numAllocated = _numAllocatedBatches.load();
+    {
+        std::lock_guard<std::mutex> lock(_storagePoolMutex);
+        stats.numPooled = (uint32)_storagePool.size();
+    }
+    return stats;
 }
 
 Batch::~Batch() {
@@ -113,6 +194,140 @@ size_t Batch::cacheData(size_t size, const void* data) {
     return offset;
 }
 
+void Batch::append(const Batch& batch) {
+    Q_ASSERT(_currentNamedCall.empty() && batch._currentNamedCall.empty());
+
+    size_t paramsOffset = _params.size();
+    uint32 dataOffset = (uint32)_data.size();
+    uint16 objectsOffset = (uint16)_objects.size();
+
+    _params.insert(_params.end(), batch._params.begin(), batch._params.end());
+    _data.insert(_data.end(), batch._data.begin(), batch._data.end());
+    _objects.insert(_objects.end(), batch._objects.begin(), batch._objects.end());
+
+    uint32 buffersOffset = (uint32)_buffers.append(batch._buffers);
+    uint32 texturesOffset = (uint32)_textures.append(batch._textures);
+    uint32 streamFormatsOffset = (uint32)_streamFormats.append(batch._streamFormats);
+    uint32 transformsOffset = (uint32)_transforms.append(batch._transforms);
+    uint32 pipelinesOffset = (uint32)_pipelines.append(batch._pipelines);
+    uint32 framebuffersOffset = (uint32)_framebuffers.append(batch._framebuffers);
+    uint32 queriesOffset = (uint32)_queries.append(batch._queries);
+    uint32 lambdasOffset = (uint32)_lambdas.append(batch._lambdas);
+    uint32 profileRangesOffset = (uint32)_profileRanges.append(batch._profileRanges);
+    uint32 namesOffset = (uint32)_names.append(batch._names);
+
+    // Rebase the params that index into the caches and the data, in the layout the backends read them
+    bool hasModelTransform = false;
+    for (size_t i = 0; i < batch._commands.size(); i++) {
+        Command command = batch._commands[i];
+        size_t offset = paramsOffset + batch._commandOffsets[i];
+        _commands.emplace_back(command);
+        _commandOffsets.emplace_back(offset);
+
+        switch (command) {
+            case COMMAND_setInputFormat:
+                _params[offset]._uint += streamFormatsOffset;
+                break;
+            case COMMAND_setInputBuffer:
+            case COMMAND_setUniformBuffer:
+                _params[offset + 2]._uint += buffersOffset;
+                break;
+            case COMMAND_setIndexBuffer:
+                _params[offset + 1]._uint += buffersOffset;
+                break;
+            case COMMAND_setIndirectBuffer:
+                _params[offset]._uint += buffersOffset;
+                break;
+            case COMMAND_setModelTransform:
+                hasModelTransform = true;
+                break;
+            case COMMAND_setViewTransform:
+                _params[offset]._uint += transformsOffset;
+                break;
+            case COMMAND_setProjectionTransform:
+            case COMMAND_setViewportTransform:
+            case COMMAND_setStateScissorRect:
+            case COMMAND_glUniform3fv:
+            case COMMAND_glUniform4fv:
+            case COMMAND_glUniform4iv:
+            case COMMAND_glUniformMatrix3fv:
+            case COMMAND_glUniformMatrix4fv:
+                _params[offset]._uint += dataOffset;
+                break;
+            case COMMAND_setPipeline:
+                _params[offset]._uint += pipelinesOffset;
+                break;
+            case COMMAND_setResourceTexture:
+            case COMMAND_generateTextureMips:
+                _params[offset]._uint += texturesOffset;
+                break;
+            case COMMAND_setFramebuffer:
+                _params[offset]._uint += framebuffersOffset;
+                break;
+            case COMMAND_blit:
+                _params[offset]._uint += framebuffersOffset;
+                _params[offset + 5]._uint += framebuffersOffset;
+                break;
+            case COMMAND_beginQuery:
+            case COMMAND_endQuery:
+            case COMMAND_getQuery:
+                _params[offset]._uint += queriesOffset;
+                break;
+            case COMMAND_runLambda:
+                _params[offset]._uint += lambdasOffset;
+                break;
+            case COMMAND_startNamedCall:
+                _params[offset]._uint += namesOffset;
+                break;
+            case COMMAND_pushProfileRange:
+                _params[offset]._uint += profileRangesOffset;
+                break;
+            default:
+                break;
+        }
+    }
+
+    for (auto drawCallInfo : batch._drawCallInfos) {
+        drawCallInfo.index += objectsOffset;
+        _drawCallInfos.emplace_back(drawCallInfo);
+    }
+
+    // Named calls accumulate, with their instance buffers concatenated in the same order as their draw call infos
+    for (auto& mapItem : batch._namedData) {
+        auto& source = mapItem.second;
+        NamedBatchData& instance = _namedData[mapItem.first];
+        if (!instance.function) {
+            instance.function = source.function;
+        }
+
+        for (auto drawCallInfo : source.drawCallInfos) {
+            drawCallInfo.index += objectsOffset;
+            instance.drawCallInfos.emplace_back(drawCallInfo);
+        }
+
+        if (instance.buffers.size() < source.buffers.size()) {
+            instance.buffers.resize(source.buffers.size());
+        }
+        for (size_t i = 0; i < source.buffers.size(); i++) {
+            if (!source.buffers[i]) {
+                continue;
+            }
+            if (!instance.buffers[i]) {
+                instance.buffers[i] = std::make_shared<Buffer>();
+            }
+            instance.buffers[i]->append(source.buffers[i]->getSize(), source.buffers[i]->getData());
+        }
+    }
+
+    // The next draw captures the model transform in effect after the appended commands
+    if (hasModelTransform) {
+        _currentModel = batch._currentModel;
+    }
+    if (hasModelTransform || !batch._objects.empty()) {
+        _invalidModel = true;
+    }
+}
+
 void Batch::draw(Primitive primitiveType, uint32 numVertices, uint32 startVertex) {
     ADD_COMMAND(draw);
 
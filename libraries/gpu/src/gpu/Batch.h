@@ -103,6 +103,26 @@ public:
 
     void clear();
 
+    // The storage of retired batches is pooled: a recycled batch hands its vectors, cleared but keeping
+    // their capacity, to the next batch constructed, so steady-state recording rarely reaches the allocator.
+    // Frame recycles its batches when it retires. Thread-safe.
+    static void recycle(Batch& batch);
+
+    class StorageStats {
+    public:
+        uint32 numBatches { 0 };    // batches constructed
+        uint32 numAllocated { 0 };  // batches which could not reuse pooled storage
+        uint32 numPooled { 0 };     // storage waiting in the pool, at the time of the call
+    };
+    // Running counts since startup, delta them between frames
+    static StorageStats getStorageStats();
+
+    // Append the commands recorded in another batch, as if they had been recorded in this one.
+    // Independent sub-batches can be recorded concurrently, each on a single thread, then appended
+    // in a fixed order on the recording thread. A sub-batch starts from no state, so it must set
+    // its own model transform before drawing.
+    void append(const Batch& batch);
+
     // Batches may need to override the context level stereo settings
     // if they're performing framebuffer copy operations, like the 
     // deferred lighting resolution mechanism
@@ -368,26 +388,42 @@ public:
         Cache<T>(const Data& data) : _data(data) {}
         static size_t _max;
 
+        // Only shared resources are compared, other data is cached every time
+        template <typename U>
+        static bool isSame(const U& a, const U& b) { return false; }
+        template <typename U>
+        static bool isSame(const std::shared_ptr<U>& a, const std::shared_ptr<U>& b) { return a == b; }
+
         class Vector {
         public:
             std::vector< Cache<T> > _items;
 
-            Vector() {
-                _items.reserve(_max);
-            }
-
             ~Vector() {
                 _max = std::max(_items.size(), _max);
             }
 
+            void reserve() {
+                _items.reserve(_max);
+            }
 
             size_t size() const { return _items.size(); }
             size_t cache(const Data& data) {
+                // consecutive uses of the same resource share an entry, and a reference
+                if (!_items.empty() && isSame(_items.back()._data, data)) {
+                    return _items.size() - 1;
+                }
                 size_t offset = _items.size();
                 _items.emplace_back(data);
                 return offset;
             }
 
+            // returns the offset of the first appended item
+            size_t append(const Vector& other) {
+                size_t offset = _items.size();
+                _items.insert(_items.end(), other._items.begin(), other._items.end());
+                return offset;
+            }
+
             Data get(uint32 offset) const {
                 if (offset >= _items.size()) {
                     return Data();
@@ -491,6 +527,16 @@ protected:
     void runLambda(std::function<void()> f);
 
     void captureDrawCallInfoImpl();
+
+    // An empty batch, without preallocated storage, to carry pooled storage
+    class NoStorage {};
+    explicit Batch(NoStorage);
+
+    // Exchange the recorded commands and cached data, keeping each batch's settings
+    void swapStorage(Batch& batch);
+
+    // Clear everything recorded, keeping the capacity
+    void clearStorage();
 };
 
 template <typename T>
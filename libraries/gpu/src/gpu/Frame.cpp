@@ -21,6 +21,11 @@ Frame::~Frame() {
     if (!bufferUpdates.empty()) {
         qFatal("Buffer sync error... frame destroyed without buffer updates being applied");
     }
+
+    // Hand the batch storage over to the batches of the frames to come
+    for (auto& batch : batches) {
+        Batch::recycle(batch);
+    }
 }
 
 void Frame::finish() {
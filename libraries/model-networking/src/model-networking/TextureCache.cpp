@@ -20,6 +20,7 @@
 #include <QImageReader>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QStandardPaths>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/random.hpp>
@@ -56,6 +57,15 @@ TextureCache::TextureCache() {
 TextureCache::~TextureCache() {
 }
 
+model::ProcessedTextureCache& TextureCache::getProcessedTextureCache() {
+    std::call_once(_processedTextureCacheOnce, [this] {
+        QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        cachePath = !cachePath.isEmpty() ? cachePath : "interfaceCache";
+        _processedTextureCache.reset(new model::ProcessedTextureCache(cachePath + "/processedTextures"));
+    });
+    return *_processedTextureCache;
+}
+
 // use fixed table of permutations. Could also make ordered list programmatically
 // and then shuffle algorithm. For testing, this ensures consistent behavior in each run.
 // this list taken from Ken Perlin's Improved Noise reference implementation (orig. in Java) at
@@ -301,6 +311,8 @@ public:
 private:
     static void listSupportedImageFormats();
 
+    void setImage(const gpu::TexturePointer& texture, int originalWidth, int originalHeight);
+
     QWeakPointer<Resource> _resource;
     QUrl _url;
     QByteArray _content;
@@ -367,9 +379,14 @@ void ImageReader::run() {
         QThread::currentThread()->setPriority(originalPriority);
     });
 
-    if (!_resource.data()) {
-        qCWarning(modelnetworking) << "Abandoning load of" << _url << "; could not get strong ref";
-        return;
+    NetworkTexture::Type type;
+    {
+        auto resource = _resource.toStrongRef();
+        if (!resource) {
+            qCWarning(modelnetworking) << "Abandoning load of" << _url << "; could not get strong ref";
+            return;
+        }
+        type = resource.dynamicCast<NetworkTexture>()->getTextureType();
     }
     listSupportedImageFormats();
 
@@ -377,6 +394,23 @@ void ImageReader::run() {
     // Some tga are not created properly without it.
     auto filename = _url.fileName().toStdString();
     auto filenameExtension = filename.substr(filename.find_last_of('.') + 1);
+
+    // Textures made by one of the stock loaders can be picked back up from disk as processed,
+    // skipping decoding and processing altogether
+    QByteArray processedKey;
+    auto textureCache = DependencyManager::get<TextureCache>();
+    if (textureCache && type != NetworkTexture::CUSTOM_TEXTURE) {
+        QByteArray params = QByteArray::number(_maxNumPixels) + " " + filenameExtension.c_str();
+        processedKey = model::ProcessedTextureCache::computeKey(_content, type, params);
+
+        QSize originalSize;
+        gpu::TexturePointer texture(textureCache->getProcessedTextureCache().load(processedKey, _url.toString().toStdString(), originalSize));
+        if (texture) {
+            setImage(texture, originalSize.width(), originalSize.height());
+            return;
+        }
+    }
+
     QImage image = QImage::fromData(_content, filenameExtension.c_str());
 
     // Note that QImage.format is the pixel format which is different from the "format" of the image file...
@@ -421,6 +455,15 @@ void ImageReader::run() {
         texture.reset(resource.dynamicCast<NetworkTexture>()->getTextureLoader()(image, url));
     }
 
+    // Store before handing the texture off, as its mips may be released once uploaded
+    if (texture && !processedKey.isEmpty()) {
+        textureCache->getProcessedTextureCache().store(processedKey, *texture, QSize(imageWidth, imageHeight));
+    }
+
+    setImage(texture, imageWidth, imageHeight);
+}
+
+void ImageReader::setImage(const gpu::TexturePointer& texture, int originalWidth, int originalHeight) {
     // Ensure the resource has not been deleted
     auto resource = _resource.toStrongRef();
     if (!resource) {
@@ -428,7 +471,7 @@ void ImageReader::run() {
     } else {
         QMetaObject::invokeMethod(resource.data(), "setImage",
             Q_ARG(gpu::TexturePointer, texture),
-            Q_ARG(int, imageWidth), Q_ARG(int, imageHeight));
+            Q_ARG(int, originalWidth), Q_ARG(int, originalHeight));
     }
 }
 
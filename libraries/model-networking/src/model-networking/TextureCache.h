@@ -21,6 +21,7 @@
 
 #include <DependencyManager.h>
 #include <ResourceCache.h>
+#include <model/ProcessedTextureCache.h>
 #include <model/TextureMap.h>
 
 const int ABSOLUTE_MAX_TEXTURE_NUM_PIXELS = 8192 * 8192;
@@ -134,6 +135,9 @@ public:
     NetworkTexturePointer getTexture(const QUrl& url, Type type = Type::DEFAULT_TEXTURE,
         const QByteArray& content = QByteArray(), int maxNumPixels = ABSOLUTE_MAX_TEXTURE_NUM_PIXELS);
 
+    /// Returns the on-disk cache of processed textures, created on first use.
+    model::ProcessedTextureCache& getProcessedTextureCache();
+
 protected:
     // Overload ResourceCache::prefetch to allow specifying texture type for loads
     Q_INVOKABLE ScriptableResource* prefetch(const QUrl& url, int type, int maxNumPixels = ABSOLUTE_MAX_TEXTURE_NUM_PIXELS);
@@ -152,6 +156,9 @@ private:
     gpu::TexturePointer _blueTexture;
     gpu::TexturePointer _blackTexture;
     gpu::TexturePointer _normalFittingTexture;
+
+    std::once_flag _processedTextureCacheOnce;
+    std::unique_ptr<model::ProcessedTextureCache> _processedTextureCache;
 };
 
 #endif // hifi_TextureCache_h
@@ -0,0 +1,348 @@
+//
+//  ProcessedTextureCache.cpp
+//  libraries/model/src/model
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "ProcessedTextureCache.h"
+
+#include <type_traits>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+#include <Profile.h>
+
+#include "ModelLogging.h"
+#include "TextureMap.h"
+
+using namespace model;
+
+static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+const qint64 ProcessedTextureCache::DEFAULT_MAX_SIZE = 2048 * BYTES_PER_MEGABYTE;
+
+static const char CONTAINER_MAGIC[4] = { 'H', 'F', 'T', 'X' };
+// Bump when the container layout changes; changes to the processing itself are covered by the key
+static const uint32_t CONTAINER_VERSION = 1;
+static const char* CONTAINER_EXTENSION = ".hftx";
+
+// mips start at offsets aligned for SIMD copies out of the mapped file
+static const quint64 MIP_ALIGNMENT = 64;
+
+enum ContainerFlags {
+    AUTOGENERATE_MIPS = 0x1,
+    IRRADIANCE = 0x2,
+};
+
+class PackedElement {
+public:
+    PackedElement() {}
+    PackedElement(const gpu::Element& element) :
+        dimension(element.getDimension()), type(element.getType()), semantic(element.getSemantic()) {}
+
+    gpu::Element toElement() const { return gpu::Element((gpu::Dimension)dimension, (gpu::Type)type, (gpu::Semantic)semantic); }
+
+    uint8_t dimension { 0 };
+    uint8_t type { 0 };
+    uint8_t semantic { 0 };
+    uint8_t spare { 0 };
+};
+
+class ContainerHeader {
+public:
+    char magic[4];
+    uint32_t version { CONTAINER_VERSION };
+    uint32_t type { 0 };
+    uint32_t usage { 0 };
+    uint16_t width { 0 };
+    uint16_t height { 0 };
+    uint16_t depth { 0 };
+    uint16_t numSlices { 0 };
+    PackedElement texelFormat;
+    uint32_t flags { 0 };
+    uint32_t originalWidth { 0 };
+    uint32_t originalHeight { 0 };
+    uint32_t numMips { 0 };
+    uint32_t spare { 0 };
+    gpu::Sampler::Desc sampler;
+    gpu::SphericalHarmonics irradiance {};
+};
+
+class MipEntry {
+public:
+    uint16_t level { 0 };
+    uint8_t face { 0 };
+    uint8_t spare { 0 };
+    PackedElement format;
+    quint64 offset { 0 };
+    quint64 size { 0 };
+};
+
+static_assert(std::is_trivially_copyable<gpu::SphericalHarmonics>::value, "irradiance is stored as is");
+static_assert(std::is_trivially_copyable<gpu::Sampler::Desc>::value, "sampler is stored as is");
+
+static quint64 alignOffset(quint64 offset) {
+    return (offset + MIP_ALIGNMENT - 1) & ~(MIP_ALIGNMENT - 1);
+}
+
+static gpu::Sampler::Desc getSamplerDesc(const gpu::Sampler& sampler) {
+    gpu::Sampler::Desc desc;
+    desc._borderColor = sampler.getBorderColor();
+    desc._maxAnisotropy = sampler.getMaxAnisotropy();
+    desc._filter = sampler.getFilter();
+    desc._comparisonFunc = sampler.getComparisonFunction();
+    desc._wrapModeU = sampler.getWrapModeU();
+    desc._wrapModeV = sampler.getWrapModeV();
+    desc._wrapModeW = sampler.getWrapModeW();
+    desc._mipOffset = sampler.getMipOffset();
+    desc._minMip = sampler.getMinMip();
+    desc._maxMip = sampler.getMaxMip();
+    return desc;
+}
+
+QByteArray ProcessedTextureCache::computeKey(const QByteArray& content, int usage, const QByteArray& params) {
+    PROFILE_RANGE(resource_parse, "ProcessedTextureCache::computeKey");
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData((const char*)&CONTAINER_VERSION, sizeof(CONTAINER_VERSION));
+    hash.addData((const char*)&usage, sizeof(usage));
+    hash.addData(params);
+    hash.addData(TextureUsage::getProcessingParams());
+    hash.addData(content);
+    return hash.result().toHex();
+}
+
+bool ProcessedTextureCache::write(const QString& path, const gpu::Texture& texture, const QSize& originalSize) {
+    PROFILE_RANGE(resource_parse, "ProcessedTextureCache::write");
+
+    // collect every stored mip, in the order they are to be assigned back
+    const uint8 numFaces = texture.getNumFaces();
+    std::vector<gpu::Texture::PixelsPointer> mips;
+    std::vector<MipEntry> entries;
+    for (uint16 level = 0; level < texture.evalNumMips(); ++level) {
+        for (uint8 face = 0; face < numFaces; ++face) {
+            if (!texture.isStoredMipFaceAvailable(level, face)) {
+                continue;
+            }
+            auto mip = texture.accessStoredMipFace(level, face);
+            MipEntry entry;
+            entry.level = level;
+            entry.face = face;
+            entry.format = PackedElement(mip->getFormat());
+            entry.size = mip->getSize();
+            entries.push_back(entry);
+            mips.push_back(mip);
+        }
+    }
+    if (entries.empty() || texture.getNumSlices() != 1) {
+        return false;
+    }
+
+    ContainerHeader header;
+    memcpy(header.magic, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC));
+    header.type = texture.getType();
+    header.usage = (uint32_t)texture.getUsage()._flags.to_ulong();
+    header.width = texture.getWidth();
+    header.height = texture.getHeight();
+    header.depth = texture.getDepth();
+    header.numSlices = texture.getNumSlices();
+    header.texelFormat = PackedElement(texture.getTexelFormat());
+    header.originalWidth = originalSize.width();
+    header.originalHeight = originalSize.height();
+    header.numMips = (uint32_t)entries.size();
+    header.sampler = getSamplerDesc(texture.getSampler());
+    if (texture.isAutogenerateMips()) {
+        header.flags |= AUTOGENERATE_MIPS;
+    }
+    if (texture.getIrradiance()) {
+        header.flags |= IRRADIANCE;
+        header.irradiance = *texture.getIrradiance();
+    }
+
+    quint64 offset = sizeof(ContainerHeader) + entries.size() * sizeof(MipEntry);
+    for (auto& entry : entries) {
+        entry.offset = alignOffset(offset);
+        offset = entry.offset + entry.size;
+    }
+
+    // written to the side and renamed into place, so readers never see a partial entry
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)entries.data(), entries.size() * sizeof(MipEntry));
+    static const char PADDING[MIP_ALIGNMENT] = {};
+    quint64 position = sizeof(ContainerHeader) + entries.size() * sizeof(MipEntry);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        file.write(PADDING, entries[i].offset - position);
+        file.write((const char*)mips[i]->readData(), entries[i].size);
+        position = entries[i].offset + entries[i].size;
+    }
+    return file.commit();
+}
+
+gpu::Texture* ProcessedTextureCache::read(const QString& path, const std::string& source, QSize& originalSize) {
+    PROFILE_RANGE(resource_parse, "ProcessedTextureCache::read");
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    const quint64 fileSize = file.size();
+    if (fileSize < sizeof(ContainerHeader)) {
+        return nullptr;
+    }
+    const uchar* data = file.map(0, fileSize);
+    if (!data) {
+        return nullptr;
+    }
+
+    ContainerHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC)) != 0 || header.version != CONTAINER_VERSION ||
+        header.type >= gpu::Texture::NUM_TYPES || header.numSlices != 1 || header.numMips == 0 ||
+        fileSize < sizeof(ContainerHeader) + (quint64)header.numMips * sizeof(MipEntry)) {
+        return nullptr;
+    }
+
+    gpu::Element texelFormat = header.texelFormat.toElement();
+    gpu::Sampler sampler(header.sampler);
+    gpu::Texture* texture = nullptr;
+    switch (header.type) {
+        case gpu::Texture::TEX_1D:
+            texture = gpu::Texture::create1D(texelFormat, header.width, sampler);
+            break;
+        case gpu::Texture::TEX_2D:
+            texture = gpu::Texture::create2D(texelFormat, header.width, header.height, sampler);
+            break;
+        case gpu::Texture::TEX_3D:
+            texture = gpu::Texture::create3D(texelFormat, header.width, header.height, header.depth, sampler);
+            break;
+        case gpu::Texture::TEX_CUBE:
+            texture = gpu::Texture::createCube(texelFormat, header.width, sampler);
+            break;
+    }
+    texture->setSource(source);
+    texture->setUsage(gpu::Texture::Usage(gpu::Texture::Usage::Flags(header.usage)));
+
+    const uint8 numFaces = texture->getNumFaces();
+    const MipEntry* entries = reinterpret_cast<const MipEntry*>(data + sizeof(ContainerHeader));
+    for (uint32_t i = 0; i < header.numMips; ++i) {
+        MipEntry entry;
+        memcpy(&entry, &entries[i], sizeof(entry));
+
+        bool assigned = false;
+        if (entry.offset <= fileSize && entry.size <= fileSize - entry.offset && entry.face < numFaces) {
+            gpu::Element format = entry.format.toElement();
+            const gpu::Byte* bytes = data + entry.offset;
+            // 2D textures track their max mip through assignStoredMip, as when processed
+            if (numFaces == 1) {
+                assigned = texture->assignStoredMip(entry.level, format, entry.size, bytes);
+            } else {
+                assigned = texture->assignStoredMipFace(entry.level, format, entry.size, bytes, entry.face);
+            }
+        }
+        if (!assigned) {
+            delete texture;
+            return nullptr;
+        }
+    }
+
+    if (header.flags & AUTOGENERATE_MIPS) {
+        texture->autoGenerateMips(-1);
+    }
+    if (header.flags & IRRADIANCE) {
+        texture->overrideIrradiance(std::make_shared<gpu::SphericalHarmonics>(header.irradiance));
+    }
+    originalSize = QSize(header.originalWidth, header.originalHeight);
+    return texture;
+}
+
+ProcessedTextureCache::ProcessedTextureCache(const QString& directory, qint64 maxSize) :
+    _directory(directory),
+    _maxSize(maxSize)
+{
+    QDir dir(_directory);
+    if (!dir.mkpath(".")) {
+        qCWarning(modelLog) << "Could not create the processed texture cache at" << _directory;
+    }
+
+    qint64 size = 0;
+    for (auto& info : dir.entryInfoList({ QString("*") + CONTAINER_EXTENSION }, QDir::Files)) {
+        size += info.size();
+    }
+    _size = size;
+    qCDebug(modelLog) << "Processed texture cache at" << _directory << "(size:" << size / BYTES_PER_MEGABYTE << "MB)";
+}
+
+QString ProcessedTextureCache::getPath(const QByteArray& key) const {
+    return _directory + "/" + key + CONTAINER_EXTENSION;
+}
+
+gpu::Texture* ProcessedTextureCache::load(const QByteArray& key, const std::string& source, QSize& originalSize) {
+    QString path = getPath(key);
+    if (!QFile::exists(path)) {
+        ++_numMisses;
+        return nullptr;
+    }
+
+    gpu::Texture* texture = read(path, source, originalSize);
+    if (!texture) {
+        // stale or damaged, let it be replaced
+        qCDebug(modelLog) << "Discarding unreadable processed texture" << path;
+        QFile::remove(path);
+        ++_numMisses;
+        return nullptr;
+    }
+    ++_numHits;
+    return texture;
+}
+
+bool ProcessedTextureCache::store(const QByteArray& key, const gpu::Texture& texture, const QSize& originalSize) {
+    QString path = getPath(key);
+    qint64 replacedSize = QFileInfo(path).size();
+    if (!write(path, texture, originalSize)) {
+        return false;
+    }
+    _size += QFileInfo(path).size() - replacedSize;
+    if (_size > _maxSize) {
+        trim();
+    }
+    return true;
+}
+
+void ProcessedTextureCache::clear() {
+    std::lock_guard<std::mutex> lock(_trimMutex);
+    QDir dir(_directory);
+    for (auto& info : dir.entryInfoList({ QString("*") + CONTAINER_EXTENSION }, QDir::Files)) {
+        QFile::remove(info.filePath());
+    }
+    _size = 0;
+}
+
+void ProcessedTextureCache::trim() {
+    std::lock_guard<std::mutex> lock(_trimMutex);
+    if (_size <= _maxSize) {
+        return;
+    }
+
+    // evict the oldest entries first, down to a margin under the limit so this does not run on every store
+    const qint64 targetSize = _maxSize - _maxSize / 4;
+    QDir dir(_directory);
+    qint64 size = 0;
+    auto entries = dir.entryInfoList({ QString("*") + CONTAINER_EXTENSION }, QDir::Files, QDir::Time);
+    for (auto& info : entries) {
+        if (size + info.size() <= targetSize) {
+            size += info.size();
+        } else {
+            QFile::remove(info.filePath());
+        }
+    }
+    _size = size;
+}
@@ -0,0 +1,70 @@
+//
+//  ProcessedTextureCache.h
+//  libraries/model/src/model
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#ifndef hifi_model_ProcessedTextureCache_h
+#define hifi_model_ProcessedTextureCache_h
+
+#include <atomic>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSize>
+#include <QtCore/QString>
+
+#include "gpu/Texture.h"
+
+namespace model {
+
+// An on-disk cache of textures as they come out of TextureUsage: the final texel format and every stored mip of
+// every face (and the irradiance of cube maps), so that loading a texture seen before skips decoding and processing.
+//
+// Each entry is one file, laid out to be mapped: a fixed header, a table of mips, then the mips themselves at
+// aligned offsets. Entries are keyed by computeKey(), so changing the source, the usage or the processing
+// parameters misses rather than loading a stale texture.
+class ProcessedTextureCache {
+public:
+    static const qint64 DEFAULT_MAX_SIZE;
+
+    // content is the encoded source image; usage and params are whatever else the processing depends on
+    static QByteArray computeKey(const QByteArray& content, int usage, const QByteArray& params);
+
+    // write and read the container directly, for callers managing their own files
+    static bool write(const QString& path, const gpu::Texture& texture, const QSize& originalSize);
+    static gpu::Texture* read(const QString& path, const std::string& source, QSize& originalSize);
+
+    ProcessedTextureCache(const QString& directory, qint64 maxSize = DEFAULT_MAX_SIZE);
+
+    const QString& getDirectory() const { return _directory; }
+
+    // returns nullptr on a miss; originalSize is the size of the source image the texture was processed from
+    gpu::Texture* load(const QByteArray& key, const std::string& source, QSize& originalSize);
+    bool store(const QByteArray& key, const gpu::Texture& texture, const QSize& originalSize);
+
+    void clear();
+
+    uint32_t getNumHits() const { return _numHits; }
+    uint32_t getNumMisses() const { return _numMisses; }
+    qint64 getSize() const { return _size; }
+
+private:
+    QString getPath(const QByteArray& key) const;
+    void trim();
+
+    const QString _directory;
+    const qint64 _maxSize;
+
+    std::mutex _trimMutex;
+    std::atomic<qint64> _size { 0 };
+    std::atomic<uint32_t> _numHits { 0 };
+    std::atomic<uint32_t> _numMisses { 0 };
+};
+
+};
+
+#endif // hifi_model_ProcessedTextureCache_h
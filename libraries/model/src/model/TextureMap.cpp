@@ -840,3 +840,19 @@ gpu::Texture* TextureUsage::createCubeTextureFromImage(const QImage& srcImage, c
 gpu::Texture* TextureUsage::createCubeTextureFromImageWithoutIrradiance(const QImage& srcImage, const std::string& srcImageName) {
     return processCubeTextureColorFromImage(srcImage, srcImageName, false, true, true, false);
 }
+
+QByteArray TextureUsage::getProcessingParams() {
+    // bump when the output of any of the processing above changes
+    static const int PROCESSING_VERSION = 1;
+#ifdef COMPRESS_TEXTURES
+    const bool compress = true;
+#else
+    const bool compress = false;
+#endif
+    return QString("v%1 max %2x%3 page %4x%5 cpumips %6 compress %7 decimate %8")
+        .arg(PROCESSING_VERSION)
+        .arg(MAX_TEXTURE_SIZE.x).arg(MAX_TEXTURE_SIZE.y)
+        .arg(SPARSE_PAGE_SIZE.x).arg(SPARSE_PAGE_SIZE.y)
+        .arg(CPU_MIPMAPS).arg((int)compress).arg((int)DEV_DECIMATE_TEXTURES)
+        .toLatin1();
+}
@@ -18,6 +18,7 @@
 
 #include <qurl.h>
 
+class QByteArray;
 class QImage;
 
 namespace model {
@@ -50,6 +51,10 @@ public:
     static gpu::Texture* process2DTextureColorFromImage(const QImage& srcImage, const std::string& srcImageName, bool isLinear, bool doCompress, bool generateMips);
     static gpu::Texture* processCubeTextureColorFromImage(const QImage& srcImage, const std::string& srcImageName, bool isLinear, bool doCompress, bool generateMips, bool generateIrradiance);
 
+    // Describes the build-time and developer settings that the processing above depends on,
+    // so that processed textures cached on disk can be told apart when any of them change
+    static QByteArray getProcessingParams();
+
 };
 
 
@@ -112,7 +112,8 @@ public:
         ReloadEntityServerScript,
         EntityPhysics,
         EntityServerScriptLog,
-        LAST_PACKET_TYPE = EntityServerScriptLog
+        InjectAudioAsset,
+        LAST_PACKET_TYPE = InjectAudioAsset
     };
 };
 
@@ -224,7 +225,9 @@ enum class AvatarMixerPacketVersion : PacketVersion {
     SessionDisplayName,
     Unignore,
     ImmediateSessionDisplayNameUpdates,
-    VariableAvatarData
+    VariableAvatarData,
+    QuantizedJointData,
+    SessionLocalIDs
 };
 
 enum class DomainConnectRequestVersion : PacketVersion {
@@ -203,19 +203,7 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, QByteArray&
     // If we don't have jurisdictions, then we will simply queue up all of these packets and wait till we have
     // jurisdictions for processing
     if (!serversExist()) {
-        if (_maxPendingMessages > 0) {
-            EditMessagePair messagePair { type, QByteArray(editMessage) };
-
-            _pendingPacketsLock.lock();
-            _preServerEdits.push_back(messagePair);
-
-            // if we've saved MORE than out max, then clear out the oldest packet...
-            int allPendingMessages = (int)(_preServerSingleMessagePackets.size() + _preServerEdits.size());
-            if (allPendingMessages > _maxPendingMessages) {
-                _preServerEdits.pop_front();
-            }
-            _pendingPacketsLock.unlock();
-        }
+        queuePreServerEditMessage(type, editMessage);
         return; // bail early
     }
 
@@ -228,58 +216,107 @@ void OctreeEditPacketSender::queueOctreeEditMessage(PacketType type, QByteArray&
     DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& node){
         // only send to the NodeTypes that are getMyNodeType()
         if (node->getActiveSocket() && node->getType() == getMyNodeType()) {
-            QUuid nodeUUID = node->getUUID();
-            bool isMyJurisdiction = true;
+            queueOctreeEditMessageToNode(node, type, editMessage);
+        }
+    });
 
-            if (type == PacketType::EntityErase) {
-                isMyJurisdiction = true; // send erase messages to all servers
-            } else if (_serverJurisdictions) {
-                // we need to get the jurisdiction for this
-                // here we need to get the "pending packet" for this server
-                _serverJurisdictions->withReadLock([&] {
-                    if ((*_serverJurisdictions).find(nodeUUID) != (*_serverJurisdictions).end()) {
-                        const JurisdictionMap& map = (*_serverJurisdictions)[nodeUUID];
-                        isMyJurisdiction = (map.isMyJurisdiction(reinterpret_cast<const unsigned char*>(editMessage.data()),
-                            CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
-                    } else {
-                        isMyJurisdiction = false;
-                    }
-                });
-            }
-            if (isMyJurisdiction) {
-                std::unique_ptr<NLPacket>& bufferedPacket = _pendingEditPackets[nodeUUID];
+    _packetsQueueLock.unlock();
 
-                if (!bufferedPacket) {
-                    bufferedPacket = initializePacket(type, node->getClockSkewUsec());
-                } else {
-                    // If we're switching type, then we send the last one and start over
-                    if ((type != bufferedPacket->getType() && bufferedPacket->getPayloadSize() > 0) ||
-                        (editMessage.size() >= bufferedPacket->bytesAvailableForWrite())) {
+}
 
-                        // create the new packet and swap it with the packet in _pendingEditPackets
-                        auto packetToRelease = initializePacket(type, node->getClockSkewUsec());
-                        bufferedPacket.swap(packetToRelease);
+void OctreeEditPacketSender::queueOctreeEditMessages(PacketType type, std::vector<QByteArray>& editMessages) {
 
-                        // release the previously buffered packet
-                        releaseQueuedPacket(nodeUUID, std::move(packetToRelease));
-                    }
-                }
+    if (!_shouldSend || editMessages.empty()) {
+        return; // bail early
+    }
 
-                // This is really the first time we know which server/node this particular edit message
-                // is going to, so we couldn't adjust for clock skew till now. But here's our chance.
-                // We call this virtual function that allows our specific type of EditPacketSender to
-                // fixup the buffer for any clock skew
-                if (node->getClockSkewUsec() != 0) {
-                    adjustEditPacketForClockSkew(type, editMessage, node->getClockSkewUsec());
-                }
+    if (!serversExist()) {
+        for (auto& editMessage : editMessages) {
+            queuePreServerEditMessage(type, editMessage);
+        }
+        return; // bail early
+    }
+
+    // same as queueOctreeEditMessage, but the queue lock and node list are only visited once for the whole batch,
+    // and consecutive messages for a node are packed into its pending packet back to back
+    _packetsQueueLock.lock();
 
-                bufferedPacket->write(editMessage);
+    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& node){
+        if (node->getActiveSocket() && node->getType() == getMyNodeType()) {
+            for (auto& editMessage : editMessages) {
+                queueOctreeEditMessageToNode(node, type, editMessage);
             }
         }
     });
 
     _packetsQueueLock.unlock();
+}
+
+void OctreeEditPacketSender::queuePreServerEditMessage(PacketType type, const QByteArray& editMessage) {
+    if (_maxPendingMessages > 0) {
+        EditMessagePair messagePair { type, QByteArray(editMessage) };
+
+        _pendingPacketsLock.lock();
+        _preServerEdits.push_back(messagePair);
+
+        // if we've saved MORE than out max, then clear out the oldest packet...
+        int allPendingMessages = (int)(_preServerSingleMessagePackets.size() + _preServerEdits.size());
+        if (allPendingMessages > _maxPendingMessages) {
+            _preServerEdits.pop_front();
+        }
+        _pendingPacketsLock.unlock();
+    }
+}
+
+// NOTE: must be called with _packetsQueueLock held
+void OctreeEditPacketSender::queueOctreeEditMessageToNode(const SharedNodePointer& node, PacketType type, QByteArray& editMessage) {
+    QUuid nodeUUID = node->getUUID();
+    bool isMyJurisdiction = true;
+
+    if (type == PacketType::EntityErase) {
+        isMyJurisdiction = true; // send erase messages to all servers
+    } else if (_serverJurisdictions) {
+        // we need to get the jurisdiction for this
+        // here we need to get the "pending packet" for this server
+        _serverJurisdictions->withReadLock([&] {
+            if ((*_serverJurisdictions).find(nodeUUID) != (*_serverJurisdictions).end()) {
+                const JurisdictionMap& map = (*_serverJurisdictions)[nodeUUID];
+                isMyJurisdiction = (map.isMyJurisdiction(reinterpret_cast<const unsigned char*>(editMessage.data()),
+                    CHECK_NODE_ONLY) == JurisdictionMap::WITHIN);
+            } else {
+                isMyJurisdiction = false;
+            }
+        });
+    }
+    if (isMyJurisdiction) {
+        std::unique_ptr<NLPacket>& bufferedPacket = _pendingEditPackets[nodeUUID];
+
+        if (!bufferedPacket) {
+            bufferedPacket = initializePacket(type, node->getClockSkewUsec());
+        } else {
+            // If we're switching type, then we send the last one and start over
+            if ((type != bufferedPacket->getType() && bufferedPacket->getPayloadSize() > 0) ||
+                (editMessage.size() >= bufferedPacket->bytesAvailableForWrite())) {
+
+                // create the new packet and swap it with the packet in _pendingEditPackets
+                auto packetToRelease = initializePacket(type, node->getClockSkewUsec());
+                bufferedPacket.swap(packetToRelease);
 
+                // release the previously buffered packet
+                releaseQueuedPacket(nodeUUID, std::move(packetToRelease));
+            }
+        }
+
+        // This is really the first time we know which server/node this particular edit message
+        // is going to, so we couldn't adjust for clock skew till now. But here's our chance.
+        // We call this virtual function that allows our specific type of EditPacketSender to
+        // fixup the buffer for any clock skew
+        if (node->getClockSkewUsec() != 0) {
+            adjustEditPacketForClockSkew(type, editMessage, node->getClockSkewUsec());
+        }
+
+        bufferedPacket->write(editMessage);
+    }
 }
 
 void OctreeEditPacketSender::releaseQueuedMessages() {
@@ -13,6 +13,7 @@
 #define hifi_OctreeEditPacketSender_h
 
 #include <unordered_map>
+#include <vector>
 
 #include <PacketSender.h>
 #include <udt/PacketHeaders.h>
@@ -32,6 +33,9 @@ public:
     /// MaxPendingMessages will be buffered and processed when servers are known.
     void queueOctreeEditMessage(PacketType type, QByteArray& editMessage);
 
+    /// Queues several edit messages of the same type at once, packing them into as few packets as possible.
+    void queueOctreeEditMessages(PacketType type, std::vector<QByteArray>& editMessages);
+
     /// Releases all queued messages even if those messages haven't filled an MTU packet. This will move the packed message
     /// packets onto the send queue. If running in threaded mode, the caller does not need to do any further processing to
     /// have these packets get sent. If running in non-threaded mode, the caller must still call process() on a regular
@@ -93,6 +97,8 @@ protected:
     void releaseQueuedPacket(const QUuid& nodeUUID, std::unique_ptr<NLPacket> packetBuffer); // releases specific queued packet
 
     void processPreServerExistsPackets();
+    void queuePreServerEditMessage(PacketType type, const QByteArray& editMessage);
+    void queueOctreeEditMessageToNode(const SharedNodePointer& node, PacketType type, QByteArray& editMessage);
 
     // These are packets which are destined from know servers but haven't been released because they're still too small
     std::unordered_map<QUuid, std::unique_ptr<NLPacket>> _pendingEditPackets;
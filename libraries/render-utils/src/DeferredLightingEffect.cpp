@@ -188,7 +188,7 @@ void DeferredLightingEffect::addSpotLight(const glm::vec3& position, float radiu
 }
 
 void DeferredLightingEffect::setupKeyLightBatch(gpu::Batch& batch, int lightBufferUnit, int ambientBufferUnit, int skyboxCubemapUnit) {
-    PerformanceTimer perfTimer("DLE->setupBatch()");
+    PERFORMANCE_TIMER("DLE->setupBatch()");
     auto keyLight = _allocatedLights[_globalLights.front()];
 
     if (lightBufferUnit >= 0) {
@@ -14,6 +14,9 @@
 #include <algorithm>
 #include <assert.h>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <OctreeUtils.h>
 #include <PerfStat.h>
 #include <ViewFrustum.h>
@@ -21,6 +24,74 @@
 
 using namespace render;
 
+// Partial selections are culled in chunks of this many items,
+// and on the worker pool once they reach the threshold
+static const size_t CULL_CHUNK_SIZE = 1024;
+static const size_t PARALLEL_CULL_THRESHOLD = 4 * CULL_CHUNK_SIZE;
+
+// Filter, frustum cull and optionally solid angle cull the partial items of a spatial selection.
+// The frustum tests use the selection's bound arrays, several bounds at a time, and the solid angle test
+// and the output use the same bounds, those the spatial tree was last given, rather than item.getBound().
+// Chunk outputs are concatenated in order, so the result is the same whether or not the chunks ran in parallel.
+static void cullPartialItems(const Scene& scene, RenderArgs* args, const ItemFilter& filter, const CullFunctor& cullFunctor,
+                             bool testSolidAngle, const ItemIDs& items, const ItemBoundArrays& bounds,
+                             RenderDetails::Item& details, ItemBounds& outItems) {
+    assert(items.size() == bounds.size());
+    const ViewFrustum& frustum = args->getViewFrustum();
+
+    auto cullChunk = [&](size_t begin, size_t end, ItemBounds& chunkItems, int& outOfView, int& tooSmall) {
+        uint8_t inView[CULL_CHUNK_SIZE];
+        bounds.intersectFrustum(frustum, begin, end, inView);
+
+        for (size_t i = begin; i < end; i++) {
+            auto& item = scene.getItem(items[i]);
+            if (!filter.test(item.getKey())) {
+                continue;
+            }
+            if (!inView[i - begin]) {
+                outOfView++;
+                continue;
+            }
+            ItemBound itemBound(items[i], bounds.get(i));
+            if (testSolidAngle && !cullFunctor(args, itemBound.bound)) {
+                tooSmall++;
+                continue;
+            }
+            chunkItems.emplace_back(itemBound);
+        }
+    };
+
+    size_t numChunks = (items.size() + CULL_CHUNK_SIZE - 1) / CULL_CHUNK_SIZE;
+    auto chunkEnd = [&](size_t chunk) { return std::min((chunk + 1) * CULL_CHUNK_SIZE, items.size()); };
+
+    if (items.size() < PARALLEL_CULL_THRESHOLD) {
+        for (size_t chunk = 0; chunk < numChunks; chunk++) {
+            cullChunk(chunk * CULL_CHUNK_SIZE, chunkEnd(chunk), outItems, details._outOfView, details._tooSmall);
+        }
+        return;
+    }
+
+    struct ChunkResult {
+        ItemBounds items;
+        int outOfView { 0 };
+        int tooSmall { 0 };
+    };
+    std::vector<ChunkResult> results(numChunks);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numChunks), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t chunk = range.begin(); chunk != range.end(); chunk++) {
+            auto& result = results[chunk];
+            cullChunk(chunk * CULL_CHUNK_SIZE, chunkEnd(chunk), result.items, result.outOfView, result.tooSmall);
+        }
+    });
+
+    for (auto& result : results) {
+        outItems.insert(outItems.end(), result.items.begin(), result.items.end());
+        details._outOfView += result.outOfView;
+        details._tooSmall += result.tooSmall;
+    }
+}
+
 void render::cullItems(const RenderContextPointer& renderContext, const CullFunctor& cullFunctor, RenderDetails::Item& details,
                        const ItemBounds& inItems, ItemBounds& outItems) {
     assert(renderContext->args);
@@ -42,13 +113,13 @@ void render::cullItems(const RenderContextPointer& renderContext, const CullFunc
         // when they are outside of the view frustum...
         bool inView;
         {
-            PerformanceTimer perfTimer("boxIntersectsFrustum");
+            PERFORMANCE_TIMER("boxIntersectsFrustum");
             inView = frustum.boxIntersectsFrustum(item.bound);
         }
         if (inView) {
             bool bigEnoughToRender;
             {
-                PerformanceTimer perfTimer("shouldRender");
+                PERFORMANCE_TIMER("shouldRender");
                 bigEnoughToRender = cullFunctor(args, item.bound);
             }
             if (bigEnoughToRender) {
@@ -156,14 +227,6 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
             */
         }
 
-        bool frustumTest(const AABox& bound) {
-            if (!_args->getViewFrustum().boxIntersectsFrustum(bound)) {
-                _renderDetails._outOfView++;
-                return false;
-            }
-            return true;
-        }
-
         bool solidAngleTest(const AABox& bound) {
             // FIXME: Keep this code here even though we don't use it yet
             //auto eyeToPoint = bound.calcCenter() - _eyePos;
@@ -191,7 +254,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
     if (_skipCulling) {
         // inside & fit items: filter only, culling is disabled
         {
-            PerformanceTimer perfTimer("insideFitItems");
+            PERFORMANCE_TIMER("insideFitItems");
             for (auto id : inSelection.insideItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -203,7 +266,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // inside & subcell items: filter only, culling is disabled
         {
-            PerformanceTimer perfTimer("insideSmallItems");
+            PERFORMANCE_TIMER("insideSmallItems");
             for (auto id : inSelection.insideSubcellItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -215,7 +278,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // partial & fit items: filter only, culling is disabled
         {
-            PerformanceTimer perfTimer("partialFitItems");
+            PERFORMANCE_TIMER("partialFitItems");
             for (auto id : inSelection.partialItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -227,7 +290,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // partial & subcell items: filter only, culling is disabled
         {
-            PerformanceTimer perfTimer("partialSmallItems");
+            PERFORMANCE_TIMER("partialSmallItems");
             for (auto id : inSelection.partialSubcellItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -241,7 +304,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // inside & fit items: easy, just filter
         {
-            PerformanceTimer perfTimer("insideFitItems");
+            PERFORMANCE_TIMER("insideFitItems");
             for (auto id : inSelection.insideItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -253,7 +316,7 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // inside & subcell items: filter & distance cull
         {
-            PerformanceTimer perfTimer("insideSmallItems");
+            PERFORMANCE_TIMER("insideSmallItems");
             for (auto id : inSelection.insideSubcellItems) {
                 auto& item = scene->getItem(id);
                 if (_filter.test(item.getKey())) {
@@ -267,32 +330,16 @@ void CullSpatialSelection::run(const SceneContextPointer& sceneContext, const Re
 
         // partial & fit items: filter & frustum cull
         {
-            PerformanceTimer perfTimer("partialFitItems");
-            for (auto id : inSelection.partialItems) {
-                auto& item = scene->getItem(id);
-                if (_filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    if (test.frustumTest(itemBound.bound)) {
-                        outItems.emplace_back(itemBound);
-                    }
-                }
-            }
+            PERFORMANCE_TIMER("partialFitItems");
+            cullPartialItems(*scene, args, _filter, _cullFunctor, false,
+                inSelection.partialItems, inSelection.partialItemBounds, details, outItems);
         }
 
         // partial & subcell items:: filter & frutum cull & solidangle cull
         {
-            PerformanceTimer perfTimer("partialSmallItems");
-            for (auto id : inSelection.partialSubcellItems) {
-                auto& item = scene->getItem(id);
-                if (_filter.test(item.getKey())) {
-                    ItemBound itemBound(id, item.getBound());
-                    if (test.frustumTest(itemBound.bound)) {
-                        if (test.solidAngleTest(itemBound.bound)) {
-                            outItems.emplace_back(itemBound);
-                        }
-                    }
-                }
-            }
+            PERFORMANCE_TIMER("partialSmallItems");
+            cullPartialItems(*scene, args, _filter, _cullFunctor, true,
+                inSelection.partialSubcellItems, inSelection.partialSubcellItemBounds, details, outItems);
         }
     }
 
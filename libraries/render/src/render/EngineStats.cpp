@@ -51,5 +51,11 @@ void EngineStats::run(const SceneContextPointer& sceneContext, const RenderConte
     config->frameSetPipelineCount = _gpuStats._PSNumSetPipelines;
     config->frameSetInputFormatCount = _gpuStats._ISNumFormatChanges;
 
+    auto batchStats = gpu::Batch::getStorageStats();
+    config->frameBatchCount = batchStats.numBatches - _batchStats.numBatches;
+    config->frameBatchAllocationCount = batchStats.numAllocated - _batchStats.numAllocated;
+    config->batchPoolCount = batchStats.numPooled;
+    _batchStats = batchStats;
+
     config->emitDirty();
 }
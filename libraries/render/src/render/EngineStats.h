@@ -50,6 +50,10 @@ namespace render {
         Q_PROPERTY(quint32 frameSetPipelineCount MEMBER frameSetPipelineCount NOTIFY dirty)
         Q_PROPERTY(quint32 frameSetInputFormatCount MEMBER frameSetInputFormatCount NOTIFY dirty)
 
+        Q_PROPERTY(quint32 frameBatchCount MEMBER frameBatchCount NOTIFY dirty)
+        Q_PROPERTY(quint32 frameBatchAllocationCount MEMBER frameBatchAllocationCount NOTIFY dirty)
+        Q_PROPERTY(quint32 batchPoolCount MEMBER batchPoolCount NOTIFY dirty)
+
 
     public:
         EngineStatsConfig() : Job::Config(true) {}
@@ -81,6 +85,9 @@ namespace render {
 
         quint32 frameSetInputFormatCount{ 0 };
 
+        quint32 frameBatchCount{ 0 };
+        quint32 frameBatchAllocationCount{ 0 };
+        quint32 batchPoolCount{ 0 };
 
 
         void emitDirty() { emit dirty(); }
@@ -91,6 +98,7 @@ namespace render {
 
     class EngineStats {
         gpu::ContextStats _gpuStats;
+        gpu::Batch::StorageStats _batchStats;
         QElapsedTimer _frameTimer;
     public:
         using Config = EngineStatsConfig;
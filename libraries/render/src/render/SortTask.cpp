@@ -44,7 +44,6 @@ void render::depthSortItems(const SceneContextPointer& sceneContext, const Rende
     assert(renderContext->args);
     assert(renderContext->args->hasViewFrustum());
 
-    auto& scene = sceneContext->_scene;
     RenderArgs* args = renderContext->args;
 
 
@@ -58,7 +57,6 @@ void render::depthSortItems(const SceneContextPointer& sceneContext, const Rende
     itemBoundSorts.reserve(outItems.size());
 
     for (auto itemDetails : inItems) {
-        auto item = scene->getItem(itemDetails.id);
         auto bound = itemDetails.bound; // item.getBound();
         float distance = args->getViewFrustum().distanceToCamera(bound.calcCenter());
 
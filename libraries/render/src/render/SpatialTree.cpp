@@ -15,6 +15,120 @@
 
 using namespace render;
 
+void ItemBoundArrays::clear() {
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+}
+
+void ItemBoundArrays::push_back(const AABox& bound) {
+    // the max corner is evaluated as AABox::getFarthestVertex() does, so culling matches it exactly
+    const glm::vec3& corner = bound.getCorner();
+    const glm::vec3& scale = bound.getScale();
+    minX.push_back(corner.x);
+    minY.push_back(corner.y);
+    minZ.push_back(corner.z);
+    maxX.push_back(corner.x + scale.x);
+    maxY.push_back(corner.y + scale.y);
+    maxZ.push_back(corner.z + scale.z);
+}
+
+void ItemBoundArrays::set(size_t index, const AABox& bound) {
+    const glm::vec3& corner = bound.getCorner();
+    const glm::vec3& scale = bound.getScale();
+    minX[index] = corner.x;
+    minY[index] = corner.y;
+    minZ[index] = corner.z;
+    maxX[index] = corner.x + scale.x;
+    maxY[index] = corner.y + scale.y;
+    maxZ[index] = corner.z + scale.z;
+}
+
+AABox ItemBoundArrays::get(size_t index) const {
+    glm::vec3 corner(minX[index], minY[index], minZ[index]);
+    glm::vec3 farthest(maxX[index], maxY[index], maxZ[index]);
+    return AABox(corner, farthest - corner);
+}
+
+void ItemBoundArrays::erase(size_t index) {
+    minX.erase(minX.begin() + index);
+    minY.erase(minY.begin() + index);
+    minZ.erase(minZ.begin() + index);
+    maxX.erase(maxX.begin() + index);
+    maxY.erase(maxY.begin() + index);
+    maxZ.erase(maxZ.begin() + index);
+}
+
+void ItemBoundArrays::append(const ItemBoundArrays& other) {
+    minX.insert(minX.end(), other.minX.begin(), other.minX.end());
+    minY.insert(minY.end(), other.minY.begin(), other.minY.end());
+    minZ.insert(minZ.end(), other.minZ.begin(), other.minZ.end());
+    maxX.insert(maxX.end(), other.maxX.begin(), other.maxX.end());
+    maxY.insert(maxY.end(), other.maxY.begin(), other.maxY.end());
+    maxZ.insert(maxZ.end(), other.maxZ.begin(), other.maxZ.end());
+}
+
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define ITEM_BOUNDS_SSE2
+#endif
+
+void ItemBoundArrays::intersectFrustum(const ViewFrustum& frustum, size_t begin, size_t end, uint8_t* inView) const {
+    const ::Plane* planes = frustum.getPlanes();
+
+    // for each plane, the farthest vertex along its normal comes from the same arrays for every bound
+    const float* farthest[NUM_FRUSTUM_PLANES][3];
+    for (int p = 0; p < NUM_FRUSTUM_PLANES; p++) {
+        const glm::vec3& normal = planes[p].getNormal();
+        farthest[p][0] = (normal.x > 0.0f) ? maxX.data() : minX.data();
+        farthest[p][1] = (normal.y > 0.0f) ? maxY.data() : minY.data();
+        farthest[p][2] = (normal.z > 0.0f) ? maxZ.data() : minZ.data();
+    }
+
+    size_t i = begin;
+
+#ifdef ITEM_BOUNDS_SSE2
+    // 4 bounds at a time, against every plane
+    for (; i + 4 <= end; i += 4) {
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < NUM_FRUSTUM_PLANES; p++) {
+            const glm::vec3& normal = planes[p].getNormal();
+            __m128 x = _mm_loadu_ps(&farthest[p][0][i]);
+            __m128 y = _mm_loadu_ps(&farthest[p][1][i]);
+            __m128 z = _mm_loadu_ps(&farthest[p][2][i]);
+
+            // same evaluation order as Plane::distance(), so the results are bit-identical
+            __m128 dot = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(normal.x), x), _mm_mul_ps(_mm_set1_ps(normal.y), y));
+            dot = _mm_add_ps(dot, _mm_mul_ps(_mm_set1_ps(normal.z), z));
+            __m128 distance = _mm_add_ps(_mm_set1_ps(planes[p].getDCoefficient()), dot);
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+        }
+
+        int mask = _mm_movemask_ps(outside);
+        inView[i - begin + 0] = !(mask & 1);
+        inView[i - begin + 1] = !(mask & 2);
+        inView[i - begin + 2] = !(mask & 4);
+        inView[i - begin + 3] = !(mask & 8);
+    }
+#endif
+
+    for (; i < end; i++) {
+        bool isInView = true;
+        for (int p = 0; p < NUM_FRUSTUM_PLANES && isInView; p++) {
+            glm::vec3 vertex(farthest[p][0][i], farthest[p][1][i], farthest[p][2][i]);
+            isInView = !(planes[p].distance(vertex) < 0.0f);
+        }
+        inView[i - begin] = isInView;
+    }
+}
+
 
 const float Octree::INV_DEPTH_DIM[] = {
     1.0f,
@@ -298,12 +412,11 @@ Octree::Locations ItemSpatialTree::evalLocations(const ItemBounds& bounds) const
     return locations;
 }
 
-ItemSpatialTree::Index ItemSpatialTree::insertItem(Index cellIdx, const ItemKey& key, const ItemID& item) {
+ItemSpatialTree::Index ItemSpatialTree::insertItem(Index cellIdx, const ItemKey& key, const ItemID& item, const AABox& bound) {
     // Add the item to the brick (and a brick if needed)
     accessCellBrick(cellIdx, [&](Cell& cell, Brick& brick, Octree::Index cellID) {
-        auto& itemIn = (key.isSmall() ? brick.subcellItems : brick.items);
-
-        itemIn.push_back(item);
+        brick.itemList(key.isSmall()).push_back(item);
+        brick.boundList(key.isSmall()).push_back(bound);
 
         cell.setBrickFilled();
     }, true);
@@ -311,7 +424,7 @@ ItemSpatialTree::Index ItemSpatialTree::insertItem(Index cellIdx, const ItemKey&
     return cellIdx;
 }
 
-bool ItemSpatialTree::updateItem(Index cellIdx, const ItemKey& oldKey, const ItemKey& key, const ItemID& item) {
+bool ItemSpatialTree::updateItem(Index cellIdx, const ItemKey& oldKey, const ItemKey& key, const ItemID& item, const AABox& bound) {
     // In case we missed that one, nothing to do
     if (cellIdx == INVALID_CELL) {
         return true;
@@ -323,11 +436,33 @@ bool ItemSpatialTree::updateItem(Index cellIdx, const ItemKey& oldKey, const Ite
 
     // Get to the brick where the item is and update where it s stored
     accessCellBrick(cellIdx, [&](Cell& cell, Brick& brick, Octree::Index cellID) {
-        auto& itemIn = (key.isSmall() ? brick.subcellItems : brick.items);
-        auto& itemOut = (oldKey.isSmall() ? brick.subcellItems : brick.items);
+        auto& itemOut = brick.itemList(oldKey.isSmall());
+        auto found = std::find(itemOut.begin(), itemOut.end(), item);
+        brick.boundList(oldKey.isSmall()).erase(found - itemOut.begin());
+        itemOut.erase(found);
+
+        brick.itemList(key.isSmall()).push_back(item);
+        brick.boundList(key.isSmall()).push_back(bound);
+    }, false); // do not create brick!
+
+    return success;
+}
 
-        itemIn.push_back(item);
-        itemOut.erase(std::find(itemOut.begin(), itemOut.end(), item));
+bool ItemSpatialTree::updateItemBound(Index cellIdx, const ItemKey& key, const ItemID& item, const AABox& bound) {
+    // In case we missed that one, nothing to do
+    if (cellIdx == INVALID_CELL) {
+        return true;
+    }
+    auto success = false;
+
+    // The item stays where it is, only refresh its bound
+    accessCellBrick(cellIdx, [&](Cell& cell, Brick& brick, Octree::Index cellID) {
+        auto& itemList = brick.itemList(key.isSmall());
+        auto found = std::find(itemList.begin(), itemList.end(), item);
+        if (found != itemList.end()) {
+            brick.boundList(key.isSmall()).set(found - itemList.begin(), bound);
+            success = true;
+        }
     }, false); // do not create brick!
 
     return success;
@@ -343,9 +478,10 @@ bool ItemSpatialTree::removeItem(Index cellIdx, const ItemKey& key, const ItemID
     // Remove the item from the brick
     bool emptyCell = false;
     accessCellBrick(cellIdx, [&](Cell& cell, Brick& brick, Octree::Index brickID) {
-        auto& itemList = (key.isSmall() ? brick.subcellItems : brick.items);
-
-        itemList.erase(std::find(itemList.begin(), itemList.end(), item));
+        auto& itemList = brick.itemList(key.isSmall());
+        auto found = std::find(itemList.begin(), itemList.end(), item);
+        brick.boundList(key.isSmall()).erase(found - itemList.begin());
+        itemList.erase(found);
 
         if (brick.items.empty() && brick.subcellItems.empty()) {
             cell.setBrickEmpty();
@@ -396,20 +532,22 @@ ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey&
     else if (newCell == oldCell) {
         // Did the key changed, if yes update
         if (newKey._flags != oldKey._flags) {
-            updateItem(newCell, oldKey, newKey, item);
+            updateItem(newCell, oldKey, newKey, item, bound);
             return newCell;
         }
+        // Else the bound may still have moved within the cell
+        updateItemBound(newCell, newKey, item, bound);
         return newCell;
     }
     // do we know about this item ?
     else if (oldCell == INVALID_CELL) {
-        insertItem(newCell, newKey, item);
+        insertItem(newCell, newKey, item, bound);
         return newCell;
     }
     // A true update of cell is required
     else {
         // Add the item to the brick (and a brick if needed)
-        insertItem(newCell, newKey, item);
+        insertItem(newCell, newKey, item, bound);
 
         // And remove it from the previous one
         removeItem(oldCell, oldKey, item);
@@ -608,12 +746,15 @@ int ItemSpatialTree::selectCellItems(ItemSelection& selection, const ItemFilter&
         selection.insideSubcellItems.insert(selection.insideSubcellItems.end(), brickSubcellItems.begin(), brickSubcellItems.end());
     }
 
+    // Partial items also bring their bounds along, to be culled individually
     for (auto brickId : selection.cellSelection.partialBricks) {
         auto& brickItems = getConcreteBrick(brickId).items;
         selection.partialItems.insert(selection.partialItems.end(), brickItems.begin(), brickItems.end());
+        selection.partialItemBounds.append(getConcreteBrick(brickId).itemBounds);
 
         auto& brickSubcellItems = getConcreteBrick(brickId).subcellItems;
         selection.partialSubcellItems.insert(selection.partialSubcellItems.end(), brickSubcellItems.begin(), brickSubcellItems.end());
+        selection.partialSubcellItemBounds.append(getConcreteBrick(brickId).subcellItemBounds);
     }
 
     return (int) selection.numItems();
@@ -27,11 +27,41 @@
 
 namespace render {
 
+    // Structure-of-arrays copy of item bounds, kept in the same order as a list of ItemIDs,
+    // so that culling can test several bounds at once without touching the items themselves
+    class ItemBoundArrays {
+    public:
+        std::vector<float> minX, minY, minZ;
+        std::vector<float> maxX, maxY, maxZ;
+
+        size_t size() const { return minX.size(); }
+
+        // The bound at index, as the frustum test sees it
+        AABox get(size_t index) const;
+
+        void clear();
+        void push_back(const AABox& bound);
+        void set(size_t index, const AABox& bound);
+        void erase(size_t index);
+        void append(const ItemBoundArrays& other);
+
+        // For each bound in [begin, end), set inView[i - begin] to 1 if it intersects the frustum, else 0
+        // Gives the same result as ViewFrustum::boxIntersectsFrustum, several bounds at a time
+        void intersectFrustum(const ViewFrustum& frustum, size_t begin, size_t end, uint8_t* inView) const;
+    };
+
     class Brick {
     public:
         std::vector<ItemID> items;
         std::vector<ItemID> subcellItems;
 
+        // the bounds of items and subcellItems, in the same order, as of their last reset
+        ItemBoundArrays itemBounds;
+        ItemBoundArrays subcellItemBounds;
+
+        std::vector<ItemID>& itemList(bool subcell) { return (subcell ? subcellItems : items); }
+        ItemBoundArrays& boundList(bool subcell) { return (subcell ? subcellItemBounds : itemBounds); }
+
         void free() {};
     };
 
@@ -436,8 +466,9 @@ namespace render {
 
         // Managing itemsInserting items in cells
         // Cells need to have been allocated first calling indexCell
-        Index insertItem(Index cellIdx, const ItemKey& key, const ItemID& item);
-        bool updateItem(Index cellIdx, const ItemKey& oldKey, const ItemKey& key, const ItemID& item);
+        Index insertItem(Index cellIdx, const ItemKey& key, const ItemID& item, const AABox& bound);
+        bool updateItem(Index cellIdx, const ItemKey& oldKey, const ItemKey& key, const ItemID& item, const AABox& bound);
+        bool updateItemBound(Index cellIdx, const ItemKey& key, const ItemID& item, const AABox& bound);
         bool removeItem(Index cellIdx, const ItemKey& key, const ItemID& item);
 
         Index resetItem(Index oldCell, const ItemKey& oldKey, const AABox& bound, const ItemID& item, ItemKey& newKey);
@@ -453,6 +484,10 @@ namespace render {
             ItemIDs partialItems;
             ItemIDs partialSubcellItems;
 
+            // bounds of the partial items, in the same order, for culling
+            ItemBoundArrays partialItemBounds;
+            ItemBoundArrays partialSubcellItemBounds;
+
             ItemIDs& items(bool inside) { return (inside ? insideItems : partialItems); }
             ItemIDs& subcellItems(bool inside) { return (inside ? insideSubcellItems : partialSubcellItems); }
 
@@ -466,6 +501,8 @@ namespace render {
                 insideSubcellItems.clear();
                 partialItems.clear();
                 partialSubcellItems.clear();
+                partialItemBounds.clear();
+                partialSubcellItemBounds.clear();
             }
         };
 
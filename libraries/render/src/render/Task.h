@@ -562,7 +562,8 @@ public:
     template <class T, class O, class C = Config> using ModelO = Model<T, C, None, O>;
     template <class T, class I, class O, class C = Config> using ModelIO = Model<T, C, I, O>;
 
-    Job(std::string name, ConceptPointer concept) : _concept(concept), _name(name) {}
+    Job(std::string name, ConceptPointer concept) :
+        _concept(concept), _name(name), _timerID(PerformanceTimer::registerTimer(QString::fromStdString(name))) {}
 
     const Varying getInput() const { return _concept->getInput(); }
     const Varying getOutput() const { return _concept->getOutput(); }
@@ -576,7 +577,7 @@ public:
     }
 
     void run(const SceneContextPointer& sceneContext, const RenderContextPointer& renderContext) {
-        PerformanceTimer perfTimer(_name.c_str());
+        PerformanceTimer perfTimer(_timerID);
         PROFILE_RANGE(render, _name.c_str());
         auto start = usecTimestampNow();
 
@@ -588,6 +589,7 @@ public:
     protected:
     ConceptPointer _concept;
     std::string _name = "";
+    PerformanceTimer::ID _timerID;
 };
 
 // A task is a specialized job to run a collection of other jobs
@@ -11,9 +11,24 @@
 
 #include "AudioScriptingInterface.h"
 
+#include <AudioAssetInjection.h>
+#include <NodeList.h>
+
 #include "ScriptAudioInjector.h"
 #include "ScriptEngineLogging.h"
 
+static bool sendToAudioMixer(const AudioAssetInjection& injection) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+    if (!audioMixer || !audioMixer->getActiveSocket()) {
+        qCDebug(scriptengine) << "No audio mixer to play" << injection.url << "on";
+        return false;
+    }
+
+    nodeList->sendPacket(injection.toPacket(), *audioMixer);
+    return true;
+}
+
 void registerAudioMetaTypes(QScriptEngine* engine) {
     qScriptRegisterMetaType(engine, injectorOptionsToScriptValue, injectorOptionsFromScriptValue);
     qScriptRegisterMetaType(engine, soundSharedPointerToScriptValue, soundSharedPointerFromScriptValue);
@@ -60,6 +75,32 @@ ScriptAudioInjector* AudioScriptingInterface::playSound(SharedSoundPointer sound
     }
 }
 
+QUuid AudioScriptingInterface::playSoundOnMixer(const QString& soundURL, const AudioInjectorOptions& injectorOptions) {
+    QUrl url = AudioAssetInjection::urlForSound(soundURL);
+    if (url.isEmpty()) {
+        qCWarning(scriptengine) << "Audio.playSoundOnMixer() only plays asset hashes, not" << soundURL;
+        return QUuid();
+    }
+
+    QUuid injectorID = QUuid::createUuid();
+    AudioAssetInjection injection(injectorID, url, injectorOptions);
+    return sendToAudioMixer(injection) ? injectorID : QUuid();
+}
+
+void AudioScriptingInterface::updateSoundOnMixer(const QUuid& injectorID, const QString& soundURL,
+                                                 const AudioInjectorOptions& injectorOptions) {
+    QUrl url = AudioAssetInjection::urlForSound(soundURL);
+    if (url.isEmpty()) {
+        qCWarning(scriptengine) << "Audio.updateSoundOnMixer() only plays asset hashes, not" << soundURL;
+        return;
+    }
+    sendToAudioMixer(AudioAssetInjection(injectorID, url, injectorOptions));
+}
+
+void AudioScriptingInterface::stopSoundOnMixer(const QUuid& injectorID) {
+    sendToAudioMixer(AudioAssetInjection::stop(injectorID));
+}
+
 void AudioScriptingInterface::setStereoInput(bool stereo) {
     if (_localAudioInterface) {
         _localAudioInterface->setIsStereoInput(stereo);
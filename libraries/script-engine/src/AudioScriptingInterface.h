@@ -29,6 +29,14 @@ protected:
     // this method is protected to stop C++ callers from calling, but invokable from script
     Q_INVOKABLE ScriptAudioInjector* playSound(SharedSoundPointer sound, const AudioInjectorOptions& injectorOptions = AudioInjectorOptions());
 
+    // play an asset hash, or an atp: URL of one, on the audio mixer, which fetches it itself rather than having this client
+    // stream it. the mixer only accepts this from nodes that can rez temporary entities.
+    // returns an id to pass to updateSoundOnMixer/stopSoundOnMixer, or a null id if there is no audio mixer or the sound
+    // is not an asset hash
+    Q_INVOKABLE QUuid playSoundOnMixer(const QString& soundURL, const AudioInjectorOptions& injectorOptions = AudioInjectorOptions());
+    Q_INVOKABLE void updateSoundOnMixer(const QUuid& injectorID, const QString& soundURL, const AudioInjectorOptions& injectorOptions);
+    Q_INVOKABLE void stopSoundOnMixer(const QUuid& injectorID);
+
     Q_INVOKABLE void setStereoInput(bool stereo);
 
 signals:
@@ -14,10 +14,12 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QEventLoop>
+#include <QtCore/QDir>
 #include <QtCore/QFileInfo>
 #include <QtCore/QTimer>
 #include <QtCore/QThread>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QStandardPaths>
 
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QApplication>
@@ -38,6 +40,7 @@
 #include <MessagesClient.h>
 #include <NetworkAccessManager.h>
 #include <PathUtils.h>
+#include <shared/GlobalAppProperties.h>
 #include <ResourceScriptingInterface.h>
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
@@ -185,6 +188,8 @@ ScriptEngine::ScriptEngine(Context context, const QString& scriptContents, const
     });
     
     setProcessEventsInterval(MSECS_PER_SECOND);
+
+    _timerClock.start();
 }
 
 QString ScriptEngine::getContext() const {
@@ -291,6 +296,8 @@ void ScriptEngine::runDebuggable() {
             return;
         }
 
+        processTimers();
+
         qint64 now = usecTimestampNow();
         // we check for 'now' in the past in case people set their clock back
         if (_lastUpdate < now) {
@@ -537,6 +544,7 @@ void ScriptEngine::init() {
     qScriptRegisterMetaType(this, RayToAvatarIntersectionResultToScriptValue, RayToAvatarIntersectionResultFromScriptValue);
     qScriptRegisterSequenceMetaType<QVector<QUuid>>(this);
     qScriptRegisterSequenceMetaType<QVector<EntityItemID>>(this);
+    qScriptRegisterSequenceMetaType<QVector<EntityItemProperties>>(this);
 
     qScriptRegisterSequenceMetaType<QVector<glm::vec2> >(this);
     qScriptRegisterSequenceMetaType<QVector<glm::quat> >(this);
@@ -927,11 +935,14 @@ void ScriptEngine::run() {
         // on shutdown and stop... so we want to loop and sleep until we've spent our time in 
         // purgatory, constantly checking to see if our script was asked to end
         bool processedEvents = false;
+        std::chrono::microseconds frameBusy(0);
         while (!_isFinished && clock::now() < sleepUntil) {
 
             {
                 PROFILE_RANGE(script, "processEvents-sleep");
+                auto beforeEvents = clock::now();
                 QCoreApplication::processEvents(); // before we sleep again, give events a chance to process
+                frameBusy += std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - beforeEvents);
             }
             processedEvents = true;
 
@@ -970,6 +981,8 @@ void ScriptEngine::run() {
             break;
         }
 
+        auto beforeWork = clock::now();
+
         // Only call this if we didn't processEvents as part of waiting for next frame
         if (!processedEvents) {
             PROFILE_RANGE(script, "processEvents");
@@ -980,6 +993,15 @@ void ScriptEngine::run() {
             break;
         }
 
+        {
+            PROFILE_RANGE(script, "ScriptTimers");
+            processTimers();
+        }
+
+        if (_isFinished) {
+            break;
+        }
+
         if (!_isFinished && entityScriptingInterface->getEntityPacketSender()->serversExist()) {
             // release the queue of edit entity messages.
             entityScriptingInterface->getEntityPacketSender()->releaseQueuedMessages();
@@ -999,6 +1021,8 @@ void ScriptEngine::run() {
                 auto preUpdate = clock::now();
                 {
                     PROFILE_RANGE(script, "ScriptUpdate");
+                    static const QString UPDATE_PROFILE_NAME = "Script.update";
+                    ScriptProfiler::Scope profile(_profiler, ScriptProfiler::UPDATE, EntityItemID(), UPDATE_PROFILE_NAME);
                     emit update(deltaTime);
                 }
                 auto postUpdate = clock::now();
@@ -1010,6 +1034,10 @@ void ScriptEngine::run() {
 
         // Debug and clear exceptions
         hadUncaughtExceptions(*this, _fileNameString, this);
+
+        frameBusy += std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - beforeWork);
+        _busyUsecsTotal += frameBusy.count();
+        _numBusyFrames++;
     }
 
     scriptInfoMessage("Script Engine stopping:" + getFilename());
@@ -1043,24 +1071,25 @@ void ScriptEngine::run() {
 // NOTE: This is private because it must be called on the same thread that created the timers, which is why
 // we want to only call it in our own run "shutdown" processing.
 void ScriptEngine::stopAllTimers() {
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
+    QMutableHashIterator<ScriptTimer*, CallbackData> i(_timerFunctionMap);
     while (i.hasNext()) {
         i.next();
-        QTimer* timer = i.key();
+        ScriptTimer* timer = i.key();
         stopTimer(timer);
     }
+    _timerWheel.clear();
 }
 
 void ScriptEngine::stopAllTimersForEntityScript(const EntityItemID& entityID) {
-     // We could maintain a separate map of entityID => QTimer, but someone will have to prove to me that it's worth the complexity. -HRS
-    QVector<QTimer*> toDelete;
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
+     // We could maintain a separate map of entityID => ScriptTimer, but someone will have to prove to me that it's worth the complexity. -HRS
+    QVector<ScriptTimer*> toDelete;
+    QMutableHashIterator<ScriptTimer*, CallbackData> i(_timerFunctionMap);
     while (i.hasNext()) {
         i.next();
         if (i.value().definingEntityIdentifier != entityID) {
             continue;
         }
-        QTimer* timer = i.key();
+        ScriptTimer* timer = i.key();
         toDelete << timer; // don't delete while we're iterating. save it.
     }
     for (auto timer:toDelete) { // now reap 'em
@@ -1116,7 +1145,14 @@ void ScriptEngine::updateMemoryCost(const qint64& deltaSize) {
     }
 }
 
-void ScriptEngine::timerFired() {
+// Timers are serviced once per engine frame from run(), rather than each owning a QTimer on the event loop.
+// Everything due this frame fires in deadline order, and timers due in the same wheel tick fire in the
+// order they were scheduled.
+void ScriptEngine::processTimers() {
+    if (_timerFunctionMap.isEmpty()) {
+        return;
+    }
+
     {
         auto engine = DependencyManager::get<ScriptEngines>();
         if (!engine || engine->isStopped()) {
@@ -1125,48 +1161,125 @@ void ScriptEngine::timerFired() {
         }
     }
 
-    QTimer* callingTimer = reinterpret_cast<QTimer*>(sender());
-    CallbackData timerData = _timerFunctionMap.value(callingTimer);
+    quint64 now = _timerClock.elapsed();
+    _dueTimers.clear();
+    _timerWheel.advance(now, _dueTimers);
 
-    if (!callingTimer->isActive()) {
-        // this timer is done, we can kill it
-        _timerFunctionMap.remove(callingTimer);
-        delete callingTimer;
-    }
+    for (auto& entry : _dueTimers) {
+        // skip entries for timers that were stopped, or rescheduled, since they were added to the wheel
+        auto it = _timerFunctionMap.find(entry.timer);
+        if (it == _timerFunctionMap.end() || entry.timer->_scheduleID != entry.id) {
+            continue;
+        }
+
+        ScriptTimer* timer = entry.timer;
+        CallbackData timerData = it.value();
 
-    // call the associated JS function, if it exists
-    if (timerData.function.isValid()) {
-        auto preTimer = p_high_resolution_clock::now();
-        callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
-        auto postTimer = p_high_resolution_clock::now();
-        auto elapsed = (postTimer - preTimer);
-        _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+        if (timer->isSingleShot()) {
+            // this timer is done, we can kill it
+            _timerFunctionMap.erase(it);
+            delete timer;
+        } else {
+            // reschedule before calling, so the callback can clear it. A timer that fell more than an
+            // interval behind skips the missed ticks instead of firing repeatedly to catch up.
+            quint64 interval = (quint64)std::max(timer->getInterval(), 0);
+            quint64 deadline = timer->_deadlineMsecs + interval;
+            if (deadline <= now) {
+                deadline = now + interval;
+            }
+            timer->_deadlineMsecs = deadline;
+            timer->_scheduleID = _timerWheel.schedule(timer, deadline);
+        }
 
+        // call the associated JS function, if it exists
+        if (timerData.function.isValid()) {
+            auto preTimer = p_high_resolution_clock::now();
+            ScriptProfiler::Scope profile(_profiler, ScriptProfiler::TIMER, timerData.definingEntityIdentifier, timerData.profileName);
+            callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
+            auto postTimer = p_high_resolution_clock::now();
+            auto elapsed = (postTimer - preTimer);
+            _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+        }
     }
+    _dueTimers.clear();
 }
 
 
 QObject* ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
-    // create the timer, add it to the map, and start it
-    QTimer* newTimer = new QTimer(this);
-    newTimer->setSingleShot(isSingleShot);
+    // create the timer handle, add it to the map, and schedule it on the wheel
+    ScriptTimer* newTimer = new ScriptTimer(this, intervalMS, isSingleShot);
+
+    // name the call site once here, rather than on every tick
+    auto functionName = function.property("name").toString();
+    auto profileName = QString("%1(%2) %3").arg(isSingleShot ? "setTimeout" : "setInterval").arg(intervalMS)
+        .arg(functionName.isEmpty() ? "<anonymous>" : functionName);
+
+    CallbackData timerData = { function, currentEntityIdentifier, currentSandboxURL, profileName };
+    _timerFunctionMap.insert(newTimer, timerData);
+
+    newTimer->_deadlineMsecs = _timerClock.elapsed() + (quint64)std::max(intervalMS, 0);
+    newTimer->_scheduleID = _timerWheel.schedule(newTimer, newTimer->_deadlineMsecs);
+    return newTimer;
+}
+
+std::atomic<bool> ScriptEngine::_profileTimelinesAllowed { false };
+
+// like Test.startTracing, the timeline is available to the test script of a --testScript run, and on servers
+// that allow it, such as the entity script server with allow_profile_timelines set
+static bool isProfileTimelineAvailable(bool allowed) {
+    auto app = QCoreApplication::instance();
+    return app && (allowed || app->property(hifi::properties::TEST).isValid()) &&
+        DependencyManager::isSet<tracing::Tracer>();
+}
+
+bool ScriptEngine::startProfileTimeline() {
+    if (!isProfileTimelineAvailable(_profileTimelinesAllowed)) {
+        scriptWarningMessage("Script.startProfileTimeline() is only available to test scripts and servers that allow it");
+        return false;
+    }
+
+    // script callbacks are traced in trace.script.entities, see ScriptProfiler::Scope
+    QLoggingCategory::setFilterRules("trace.script=true\ntrace.script.entities=true");
+    DependencyManager::get<tracing::Tracer>()->startTracing();
+    return true;
+}
 
-    // The default timer type is not very accurate below about 200ms http://doc.qt.io/qt-5/qt.html#TimerType-enum
-    static const int MIN_TIMEOUT_FOR_COARSE_TIMER = 200;
-    if (intervalMS < MIN_TIMEOUT_FOR_COARSE_TIMER) {
-        newTimer->setTimerType(Qt::PreciseTimer);
+bool ScriptEngine::stopProfileTimeline(const QString& filename) {
+    if (!isProfileTimelineAvailable(_profileTimelinesAllowed)) {
+        scriptWarningMessage("Script.stopProfileTimeline() is only available to test scripts and servers that allow it");
+        return false;
     }
 
-    connect(newTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
+    // only a plain file name is kept, the timeline is always written to the profile timelines directory
+    static const QString PROFILE_TIMELINES_DIRECTORY = "profileTimelines";
+    static const QString DEFAULT_TIMELINE_NAME = "timeline";
+    static const QString TIMELINE_EXTENSION = ".json";
+    static const QRegularExpression UNSAFE_CHARACTERS("[^A-Za-z0-9_.-]");
 
-    // make sure the timer stops when the script does
-    connect(this, &ScriptEngine::scriptEnding, newTimer, &QTimer::stop);
+    QString name = QFileInfo(filename).fileName();
+    name.replace(UNSAFE_CHARACTERS, "_");
+    while (name.startsWith('.')) {
+        name.remove(0, 1);
+    }
+    if (name.isEmpty()) {
+        name = DEFAULT_TIMELINE_NAME;
+    }
+    if (!name.endsWith(TIMELINE_EXTENSION) && !name.endsWith(TIMELINE_EXTENSION + ".gz")) {
+        name += TIMELINE_EXTENSION;
+    }
 
-    CallbackData timerData = {function, currentEntityIdentifier, currentSandboxURL };
-    _timerFunctionMap.insert(newTimer, timerData);
+    QDir directory(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+    if (!directory.mkpath(PROFILE_TIMELINES_DIRECTORY)) {
+        scriptWarningMessage("Script.stopProfileTimeline() could not create " + directory.filePath(PROFILE_TIMELINES_DIRECTORY));
+        return false;
+    }
+    QString path = directory.filePath(PROFILE_TIMELINES_DIRECTORY + "/" + name);
 
-    newTimer->start(intervalMS);
-    return newTimer;
+    auto tracer = DependencyManager::get<tracing::Tracer>();
+    tracer->stopTracing();
+    tracer->serialize(path);
+    scriptInfoMessage("Script profile timeline written to " + path);
+    return true;
 }
 
 QObject* ScriptEngine::setInterval(const QScriptValue& function, int intervalMS) {
@@ -1187,9 +1300,9 @@ QObject* ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
     return setupTimerWithInterval(function, timeoutMS, true);
 }
 
-void ScriptEngine::stopTimer(QTimer *timer) {
-    if (_timerFunctionMap.contains(timer)) {
-        timer->stop();
+void ScriptEngine::stopTimer(ScriptTimer* timer) {
+    if (timer && _timerFunctionMap.contains(timer)) {
+        // its wheel entry is dropped lazily when its tick comes around
         _timerFunctionMap.remove(timer);
         delete timer;
     }
@@ -1403,11 +1516,17 @@ void ScriptEngine::forwardHandlerCall(const EntityItemID& entityID, const QStrin
             // and the entity scripts may be for entities other than the one this is a handler for.
             // Fortunately, the definingEntityIdentifier captured the entity script id (if any) when the handler was added.
             CallbackData& handler = handlersForEvent[i];
+            ScriptProfiler::Scope profile(_profiler, ScriptProfiler::EVENT_HANDLER, handler.definingEntityIdentifier, eventName);
             callWithEnvironment(handler.definingEntityIdentifier, handler.definingSandboxURL, handler.function, QScriptValue(), eventHandlerArgs);
         }
     }
 }
 
+void ScriptEngine::takeBusyTime(int& numFrames, quint64& busyUsecs) {
+    numFrames = _numBusyFrames.exchange(0);
+    busyUsecs = _busyUsecsTotal.exchange(0);
+}
+
 int ScriptEngine::getNumRunningEntityScripts() const {
     int sum = 0;
     for (auto& st : _entityScripts) {
@@ -1730,6 +1849,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             QScriptValueList args;
             args << entityID.toScriptValue(this);
             args << qScriptValueFromSequence(this, params);
+            ScriptProfiler::Scope profile(_profiler, ScriptProfiler::ENTITY_METHOD, entityID, methodName);
             callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args);
         }
 
@@ -1762,6 +1882,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             QScriptValueList args;
             args << entityID.toScriptValue(this);
             args << event.toScriptValue(this);
+            ScriptProfiler::Scope profile(_profiler, ScriptProfiler::ENTITY_METHOD, entityID, methodName);
             callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args);
         }
     }
@@ -1796,6 +1917,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             args << entityID.toScriptValue(this);
             args << otherID.toScriptValue(this);
             args << collisionToScriptValue(this, collision);
+            ScriptProfiler::Scope profile(_profiler, ScriptProfiler::ENTITY_METHOD, entityID, methodName);
             callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args);
         }
     }
@@ -14,6 +14,7 @@
 
 #include <vector>
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 #include <QtCore/QSet>
@@ -38,6 +39,8 @@
 #include "Quat.h"
 #include "Mat4.h"
 #include "ScriptCache.h"
+#include "ScriptProfiler.h"
+#include "ScriptTimerWheel.h"
 #include "ScriptUUID.h"
 #include "Vec3.h"
 
@@ -52,6 +55,7 @@ public:
     QScriptValue function;
     EntityItemID definingEntityIdentifier;
     QUrl definingSandboxURL;
+    QString profileName;
 };
 
 typedef QList<CallbackData> CallbackList;
@@ -150,8 +154,8 @@ public:
 
     Q_INVOKABLE QObject* setInterval(const QScriptValue& function, int intervalMS);
     Q_INVOKABLE QObject* setTimeout(const QScriptValue& function, int timeoutMS);
-    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
-    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(qobject_cast<ScriptTimer*>(timer)); }
+    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(qobject_cast<ScriptTimer*>(timer)); }
     Q_INVOKABLE void print(const QString& message);
     Q_INVOKABLE QUrl resolvePath(const QString& path) const;
     Q_INVOKABLE QUrl resourcesPath() const;
@@ -169,6 +173,27 @@ public:
 
     Q_INVOKABLE QUuid generateUUID() { return QUuid::createUuid(); }
 
+    // wall time spent in entity methods, timers, event handlers and update, see ScriptProfiler
+    Q_INVOKABLE QVariantMap getProfile() const { return _profiler.toVariantMap(); }
+    Q_INVOKABLE void resetProfile() { _profiler.reset(); }
+
+    // capture a Chrome trace timeline (chrome://tracing) of script callbacks, using the process-wide Tracer.
+    // only available to the test script of a --testScript run, or where setProfileTimelinesAllowed was
+    // called, as the entity script server does per its settings. the timeline is written as filename,
+    // stripped of any directory, in the profileTimelines directory of the application's local data.
+    Q_INVOKABLE bool startProfileTimeline();
+    Q_INVOKABLE bool stopProfileTimeline(const QString& filename);
+    static void setProfileTimelinesAllowed(bool allowed) { _profileTimelinesAllowed = allowed; }
+
+    const ScriptProfiler& getProfiler() const { return _profiler; }
+
+    // time the run loop spent processing events, timers, edit packets and update since the last call, not
+    // counting the SCRIPT_FPS sleep. safe to call from any thread.
+    void takeBusyTime(int& numFrames, quint64& busyUsecs);
+
+    // time spent in the callbacks of each entity script since the last call. safe to call from any thread.
+    QHash<EntityItemID, quint64> takeEntityScriptBusyTime() { return _profiler.takeEntityUsecs(); }
+
     bool isFinished() const { return _isFinished; } // used by Application and ScriptWidget
     bool isRunning() const { return _isRunning; } // used by ScriptWidget
 
@@ -231,7 +256,7 @@ protected:
     void init();
 
     bool evaluatePending() const { return _evaluatesPending > 0; }
-    void timerFired();
+    void processTimers();
     void stopAllTimers();
     void stopAllTimersForEntityScript(const EntityItemID& entityID);
     void refreshFileScript(const EntityItemID& entityID);
@@ -239,7 +264,7 @@ protected:
     void setParentURL(const QString& parentURL) { _parentURL = parentURL; }
 
     QObject* setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
-    void stopTimer(QTimer* timer);
+    void stopTimer(ScriptTimer* timer);
 
     QHash<EntityItemID, RegisteredEventHandlers> _registeredHandlers;
     void forwardHandlerCall(const EntityItemID& entityID, const QString& eventName, QScriptValueList eventHanderArgs);
@@ -259,7 +284,10 @@ protected:
     std::atomic<bool> _isStopping { false };
     int _evaluatesPending { 0 };
     bool _isInitialized { false };
-    QHash<QTimer*, CallbackData> _timerFunctionMap;
+    QHash<ScriptTimer*, CallbackData> _timerFunctionMap;
+    ScriptTimerWheel _timerWheel;
+    QElapsedTimer _timerClock;
+    std::vector<ScriptTimerWheel::Entry> _dueTimers;
     QSet<QUrl> _includedURLs;
     QHash<EntityItemID, EntityScriptDetails> _entityScripts;
     bool _isThreaded { false };
@@ -284,6 +312,12 @@ protected:
     std::recursive_mutex _lock;
 
     std::chrono::microseconds _totalTimerExecution { 0 };
+
+    std::atomic<int> _numBusyFrames { 0 };
+    std::atomic<quint64> _busyUsecsTotal { 0 };
+
+    ScriptProfiler _profiler;
+    static std::atomic<bool> _profileTimelinesAllowed;
 };
 
 #endif // hifi_ScriptEngine_h
@@ -0,0 +1,66 @@
+//
+//  ScriptEngineLoadBalancer.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptEngineLoadBalancer.h"
+
+const int ScriptEngineLoadBalancer::MIN_WINDOWS_OVER_BUDGET = 2;
+const float ScriptEngineLoadBalancer::HEADROOM_RATIO = 0.5f;
+
+ScriptEngineLoadBalancer::ScriptEngineLoadBalancer(int numShards, float frameBudgetMsecs) :
+    _shards(numShards),
+    _frameBudgetMsecs(frameBudgetMsecs)
+{
+}
+
+void ScriptEngineLoadBalancer::updateShard(int index, float averageBusyMsecs, int numScripts) {
+    auto& shard = _shards[index];
+    shard.averageBusyMsecs = averageBusyMsecs;
+    shard.numScripts = numScripts;
+
+    if (averageBusyMsecs > _frameBudgetMsecs) {
+        shard.numWindowsOverBudget++;
+    } else {
+        shard.numWindowsOverBudget = 0;
+    }
+}
+
+bool ScriptEngineLoadBalancer::pickMove(int& fromIndex, int& toIndex) {
+    if (_shards.size() < 2) {
+        return false;
+    }
+
+    int slowest = 0;
+    int fastest = 0;
+    for (int i = 1; i < (int)_shards.size(); ++i) {
+        if (_shards[i].averageBusyMsecs > _shards[slowest].averageBusyMsecs) {
+            slowest = i;
+        }
+        if (_shards[i].averageBusyMsecs < _shards[fastest].averageBusyMsecs) {
+            fastest = i;
+        }
+    }
+
+    auto& from = _shards[slowest];
+    auto& to = _shards[fastest];
+    if (slowest == fastest || from.numScripts <= 1 ||
+        from.numWindowsOverBudget < MIN_WINDOWS_OVER_BUDGET ||
+        to.averageBusyMsecs > HEADROOM_RATIO * _frameBudgetMsecs) {
+        return false;
+    }
+
+    from.numWindowsOverBudget = 0;
+    fromIndex = slowest;
+    toIndex = fastest;
+    return true;
+}
+
+bool ScriptEngineLoadBalancer::hasHeadroomFor(int index, float scriptBusyMsecs) const {
+    return _shards[index].averageBusyMsecs + scriptBusyMsecs <= _frameBudgetMsecs;
+}
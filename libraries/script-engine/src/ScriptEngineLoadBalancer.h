@@ -0,0 +1,54 @@
+//
+//  ScriptEngineLoadBalancer.h
+//  libraries/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptEngineLoadBalancer_h
+#define hifi_ScriptEngineLoadBalancer_h
+
+#include <vector>
+
+// Decides when a script should move between script engines that each run on their own thread.
+//
+// Once per rebalance window each engine reports the average time per frame it spent busy, that is without the
+// SCRIPT_FPS sleep. An engine that stays over the frame budget for MIN_WINDOWS_OVER_BUDGET windows gives up one
+// script to the least busy engine, if that one is under HEADROOM_RATIO of the budget.
+class ScriptEngineLoadBalancer {
+public:
+    static const int MIN_WINDOWS_OVER_BUDGET;
+    static const float HEADROOM_RATIO;
+
+    struct Shard {
+        float averageBusyMsecs { 0.0f };
+        int numScripts { 0 };
+        int numWindowsOverBudget { 0 };
+    };
+
+    ScriptEngineLoadBalancer(int numShards, float frameBudgetMsecs);
+
+    int getNumShards() const { return (int)_shards.size(); }
+    float getFrameBudgetMsecs() const { return _frameBudgetMsecs; }
+    void setFrameBudgetMsecs(float frameBudgetMsecs) { _frameBudgetMsecs = frameBudgetMsecs; }
+    const Shard& getShard(int index) const { return _shards[index]; }
+
+    // record the measurements of one shard for the window that just ended
+    void updateShard(int index, float averageBusyMsecs, int numScripts);
+
+    // once every shard was updated for the window, pick the shards a script should move between.
+    // returns false if no move is needed, the over budget count of the source shard restarts otherwise.
+    bool pickMove(int& fromIndex, int& toIndex);
+
+    // whether a script that keeps its engine busy scriptBusyMsecs per frame fits within the budget of a shard
+    bool hasHeadroomFor(int index, float scriptBusyMsecs) const;
+
+private:
+    std::vector<Shard> _shards;
+    float _frameBudgetMsecs;
+};
+
+#endif // hifi_ScriptEngineLoadBalancer_h
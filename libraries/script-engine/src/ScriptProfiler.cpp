@@ -0,0 +1,195 @@
+//
+//  ScriptProfiler.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptProfiler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QJsonArray>
+
+#include <Profile.h>
+
+uint qHash(const ScriptProfiler::Key& key, uint seed) {
+    return qHash(key.entityID, seed) ^ qHash(key.name, seed) ^ (uint)key.type;
+}
+
+static const QString OTHER_CALL_SITES = "<other>";
+
+const char* ScriptProfiler::typeName(CallType type) {
+    switch (type) {
+        case ENTITY_METHOD:
+            return "entity_method";
+        case TIMER:
+            return "timer";
+        case EVENT_HANDLER:
+            return "event_handler";
+        case UPDATE:
+            return "update";
+        default:
+            return "unknown";
+    }
+}
+
+void ScriptProfiler::Record::add(quint64 usecs) {
+    ++count;
+    totalUsecs += usecs;
+    maxUsecs = std::max(maxUsecs, usecs);
+
+    int bucket = 0;
+    while (usecs > 0 && bucket < NUM_HISTOGRAM_BUCKETS - 1) {
+        usecs >>= 1;
+        ++bucket;
+    }
+    ++histogram[bucket];
+}
+
+QVariantMap ScriptProfiler::Record::toVariantMap() const {
+    QVariantList buckets;
+    for (auto bucketCount : histogram) {
+        buckets.push_back(bucketCount);
+    }
+    return {
+        { "count", count },
+        { "totalUsecs", totalUsecs },
+        { "averageUsecs", count > 0 ? (double)totalUsecs / count : 0.0 },
+        { "maxUsecs", maxUsecs },
+        { "histogram", buckets }
+    };
+}
+
+ScriptProfiler::Scope::Scope(ScriptProfiler& profiler, CallType type, const EntityItemID& entityID, const QString& name) :
+    _profiler(profiler),
+    _type(type),
+    _entityID(entityID),
+    _name(name),
+    _start(p_high_resolution_clock::now())
+{
+    // only build the trace event while a timeline is being captured
+    if (DependencyManager::isSet<tracing::Tracer>() && tracing::enabled() && trace_script_entities().isDebugEnabled()) {
+        _traced = true;
+        tracing::traceEvent(trace_script_entities(), _name, tracing::DurationBegin, "",
+            { { "type", typeName(_type) }, { "entity", _entityID.toString() } });
+    }
+}
+
+ScriptProfiler::Scope::~Scope() {
+    auto elapsed = p_high_resolution_clock::now() - _start;
+    _profiler.record(_type, _entityID, _name, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    if (_traced) {
+        tracing::traceEvent(trace_script_entities(), _name, tracing::DurationEnd);
+    }
+}
+
+void ScriptProfiler::record(CallType type, const EntityItemID& entityID, const QString& name, quint64 usecs) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _totals[type].add(usecs);
+    if (!entityID.isNull()) {
+        _entityUsecs[entityID] += usecs;
+    }
+
+    Key key { type, entityID, name };
+    auto it = _records.find(key);
+    if (it == _records.end()) {
+        // past the limit new call sites share one record per type, which may already exist
+        if (_records.size() >= MAX_CALL_SITES) {
+            key = { type, EntityItemID(), OTHER_CALL_SITES };
+            it = _records.find(key);
+        }
+        if (it == _records.end()) {
+            it = _records.insert(key, Record());
+        }
+    }
+    it->add(usecs);
+}
+
+void ScriptProfiler::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _records.clear();
+    _totals = {};
+    _entityUsecs.clear();
+}
+
+QHash<EntityItemID, quint64> ScriptProfiler::takeEntityUsecs() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    QHash<EntityItemID, quint64> entityUsecs;
+    entityUsecs.swap(_entityUsecs);
+    return entityUsecs;
+}
+
+QVariantMap ScriptProfiler::toVariantMap() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    QVariantMap totals;
+    for (int i = 0; i < NUM_CALL_TYPES; ++i) {
+        totals[typeName((CallType)i)] = _totals[i].toVariantMap();
+    }
+
+    QVariantMap entities;
+    for (auto it = _records.constBegin(); it != _records.constEnd(); ++it) {
+        const Key& key = it.key();
+        QString entityKey = key.entityID.isNull() ? "" : key.entityID.toString();
+
+        QVariantMap entity = entities[entityKey].toMap();
+        QVariantMap callSites = entity[typeName(key.type)].toMap();
+        callSites[key.name] = it.value().toVariantMap();
+        entity[typeName(key.type)] = callSites;
+        entities[entityKey] = entity;
+    }
+
+    return {
+        { "totals", totals },
+        { "entities", entities }
+    };
+}
+
+QJsonObject ScriptProfiler::toJson(int maxCallSites) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    QJsonObject result;
+    for (int i = 0; i < NUM_CALL_TYPES; ++i) {
+        auto& total = _totals[i];
+        QString prefix = typeName((CallType)i);
+        result[prefix + "_calls"] = (qint64)total.count;
+        result[prefix + "_total_usecs"] = (qint64)total.totalUsecs;
+        result[prefix + "_max_usecs"] = (qint64)total.maxUsecs;
+    }
+
+    // the most expensive call sites
+    std::vector<QHash<Key, Record>::const_iterator> sorted;
+    sorted.reserve(_records.size());
+    for (auto it = _records.constBegin(); it != _records.constEnd(); ++it) {
+        sorted.push_back(it);
+    }
+    auto numCallSites = std::min((size_t)std::max(maxCallSites, 0), sorted.size());
+    std::partial_sort(sorted.begin(), sorted.begin() + numCallSites, sorted.end(), [](const QHash<Key, Record>::const_iterator& a,
+                                                                                      const QHash<Key, Record>::const_iterator& b) {
+        return a.value().totalUsecs > b.value().totalUsecs;
+    });
+
+    QJsonArray topCallSites;
+    for (size_t i = 0; i < numCallSites; ++i) {
+        auto& key = sorted[i].key();
+        auto& record = sorted[i].value();
+        topCallSites.push_back(QJsonObject {
+            { "type", typeName(key.type) },
+            { "entity", key.entityID.isNull() ? QString() : key.entityID.toString() },
+            { "name", key.name },
+            { "calls", (qint64)record.count },
+            { "total_usecs", (qint64)record.totalUsecs },
+            { "max_usecs", (qint64)record.maxUsecs }
+        });
+    }
+    result["top_call_sites"] = topCallSites;
+
+    return result;
+}
@@ -0,0 +1,103 @@
+//
+//  ScriptProfiler.h
+//  libraries/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptProfiler_h
+#define hifi_ScriptProfiler_h
+
+#include <array>
+#include <mutex>
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+#include <EntityItemID.h>
+#include <PortableHighResolutionClock.h>
+
+// Always-on wall time accounting for the JS callbacks a ScriptEngine runs: entity script methods,
+// timers, entity event handlers and the per-frame update signal. Call sites are keyed by
+// (type, defining entity, name) and each keeps totals and a log2 histogram of durations.
+// Recording happens on the engine thread, readers (stats, scripts) may be on any thread.
+class ScriptProfiler {
+public:
+    enum CallType {
+        ENTITY_METHOD,
+        TIMER,
+        EVENT_HANDLER,
+        UPDATE,
+        NUM_CALL_TYPES
+    };
+
+    // bucket i counts calls of [2^(i-1), 2^i) usecs, the last bucket is open ended (>= ~32ms)
+    static const int NUM_HISTOGRAM_BUCKETS = 16;
+
+    // call sites beyond this are folded into a per-type "other" record, to bound memory
+    static const int MAX_CALL_SITES = 512;
+
+    class Record {
+    public:
+        quint64 count { 0 };
+        quint64 totalUsecs { 0 };
+        quint64 maxUsecs { 0 };
+        std::array<quint32, NUM_HISTOGRAM_BUCKETS> histogram {};
+
+        void add(quint64 usecs);
+        QVariantMap toVariantMap() const;
+    };
+
+    // times the enclosing scope and, while tracing, brackets it with trace events for the Chrome timeline
+    class Scope {
+    public:
+        Scope(ScriptProfiler& profiler, CallType type, const EntityItemID& entityID, const QString& name);
+        ~Scope();
+
+    private:
+        ScriptProfiler& _profiler;
+        CallType _type;
+        EntityItemID _entityID;
+        QString _name;
+        p_high_resolution_clock::time_point _start;
+        bool _traced { false };
+    };
+
+    void record(CallType type, const EntityItemID& entityID, const QString& name, quint64 usecs);
+    void reset();
+
+    // time recorded for each entity since the last call, which the entity script server balances engines by
+    QHash<EntityItemID, quint64> takeEntityUsecs();
+
+    // per call site records, grouped by defining entity ("" for non-entity scripts)
+    QVariantMap toVariantMap() const;
+
+    // the most expensive call sites and per-type totals, for assignment stats
+    QJsonObject toJson(int maxCallSites = 10) const;
+
+    static const char* typeName(CallType type);
+
+private:
+    struct Key {
+        CallType type;
+        EntityItemID entityID;
+        QString name;
+
+        bool operator==(const Key& other) const {
+            return type == other.type && entityID == other.entityID && name == other.name;
+        }
+    };
+    friend uint qHash(const Key& key, uint seed);
+
+    mutable std::mutex _mutex;
+    QHash<Key, Record> _records;
+    std::array<Record, NUM_CALL_TYPES> _totals;
+    QHash<EntityItemID, quint64> _entityUsecs;
+};
+
+#endif // hifi_ScriptProfiler_h
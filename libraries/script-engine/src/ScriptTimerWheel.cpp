@@ -0,0 +1,67 @@
+//
+//  ScriptTimerWheel.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptTimerWheel.h"
+
+#include <algorithm>
+
+#include "ScriptEngine.h"
+
+void ScriptTimer::stop() {
+    auto engine = qobject_cast<ScriptEngine*>(parent());
+    if (engine) {
+        engine->clearInterval(this);
+    }
+}
+
+quint64 ScriptTimerWheel::schedule(ScriptTimer* timer, quint64 deadlineMsecs) {
+    // round up, and never into a tick that has already been visited
+    quint64 tick = (deadlineMsecs + TICK_MSECS - 1) / TICK_MSECS;
+    tick = std::max(tick, _currentTick + 1);
+
+    quint64 id = _nextID++;
+    _slots[tick % NUM_SLOTS].push_back({ timer, tick, id });
+    ++_size;
+    return id;
+}
+
+void ScriptTimerWheel::advance(quint64 nowMsecs, std::vector<Entry>& due) {
+    quint64 nowTick = nowMsecs / TICK_MSECS;
+    if (nowTick <= _currentTick) {
+        return;
+    }
+
+    size_t firstDue = due.size();
+
+    // after a long stall every slot may hold due entries, so visit each one once
+    quint64 numTicks = std::min<quint64>(nowTick - _currentTick, NUM_SLOTS);
+    for (quint64 i = 1; i <= numTicks; ++i) {
+        auto& slot = _slots[(_currentTick + i) % NUM_SLOTS];
+        auto kept = std::partition(slot.begin(), slot.end(), [nowTick](const Entry& entry) {
+            return entry.tick > nowTick;
+        });
+        due.insert(due.end(), kept, slot.end());
+        _size -= std::distance(kept, slot.end());
+        slot.erase(kept, slot.end());
+    }
+    _currentTick = nowTick;
+
+    // ids increase with every schedule() call, which makes the order deterministic
+    std::sort(due.begin() + firstDue, due.end(), [](const Entry& a, const Entry& b) {
+        return a.tick < b.tick || (a.tick == b.tick && a.id < b.id);
+    });
+}
+
+void ScriptTimerWheel::clear() {
+    for (auto& slot : _slots) {
+        slot.clear();
+    }
+    _size = 0;
+}
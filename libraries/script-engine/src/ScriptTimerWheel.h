@@ -0,0 +1,82 @@
+//
+//  ScriptTimerWheel.h
+//  libraries/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptTimerWheel_h
+#define hifi_ScriptTimerWheel_h
+
+#include <array>
+#include <vector>
+
+#include <QtCore/QObject>
+
+// The object returned to JS by Script.setInterval()/setTimeout(). It is only a handle: the callback
+// lives in the owning ScriptEngine and scheduling is done by its ScriptTimerWheel. The properties
+// mirror the QTimer ones scripts could previously read.
+class ScriptTimer : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int interval READ getInterval)
+    Q_PROPERTY(bool singleShot READ isSingleShot)
+    Q_PROPERTY(bool active READ isActive)
+
+public:
+    ScriptTimer(QObject* parent, int intervalMS, bool isSingleShot) :
+        QObject(parent), _interval(intervalMS), _isSingleShot(isSingleShot) {}
+
+    int getInterval() const { return _interval; }
+    bool isSingleShot() const { return _isSingleShot; }
+    bool isActive() const { return _scheduleID != 0; }
+
+public slots:
+    void stop();
+
+private:
+    friend class ScriptEngine;
+
+    int _interval;
+    bool _isSingleShot;
+
+    quint64 _deadlineMsecs { 0 };
+    quint64 _scheduleID { 0 };  // id of the live wheel entry, 0 when not scheduled
+};
+
+// Hashed timing wheel. Deadlines are rounded up to TICK_MSECS, so timers due in the same tick are
+// coalesced and dispatched together. Cancellation is lazy: an entry only fires if its id is still
+// the timer's current schedule id.
+class ScriptTimerWheel {
+public:
+    static const int TICK_MSECS = 4;
+    static const int NUM_SLOTS = 512;  // ~2s per revolution, longer timers wait for later rounds
+
+    struct Entry {
+        ScriptTimer* timer;
+        quint64 tick;
+        quint64 id;
+    };
+
+    ScriptTimerWheel(quint64 nowMsecs = 0) : _currentTick(nowMsecs / TICK_MSECS) {}
+
+    // returns the schedule id to store on the timer
+    quint64 schedule(ScriptTimer* timer, quint64 deadlineMsecs);
+
+    // collects every entry due at nowMsecs, ordered by deadline tick then schedule order; the caller
+    // must drop entries whose id no longer matches their timer before touching the timer
+    void advance(quint64 nowMsecs, std::vector<Entry>& due);
+
+    void clear();
+    size_t size() const { return _size; }
+
+private:
+    std::array<std::vector<Entry>, NUM_SLOTS> _slots;
+    quint64 _currentTick;
+    quint64 _nextID { 1 };
+    size_t _size { 0 };
+};
+
+#endif // hifi_ScriptTimerWheel_h
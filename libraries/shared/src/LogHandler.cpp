@@ -12,16 +12,89 @@
 
 #include "LogHandler.h"
 
+#include <chrono>
 #include <mutex>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QDebug>
 #include <QtCore/QMutexLocker>
-#include <QtCore/QRegExp>
+#include <QtCore/QStringList>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
+static const size_t LOG_QUEUE_SIZE = 1 << 14; // must be a power of 2
+static const std::chrono::milliseconds LOG_WRITE_INTERVAL { 100 };
+static const int MAX_LOG_BATCH_SIZE = 256;
+// the writer otherwise wakes up every LOG_WRITE_INTERVAL, rather than on every message
+static const size_t LOG_PUSHES_PER_WAKE = LOG_QUEUE_SIZE / 4;
+
+class LogEntry {
+public:
+    LogMsgType type;
+    const char* category; // the names of logging categories are static
+    QString message;
+    qint64 timestamp;
+    size_t threadID;
+};
+
+// Bounded queue of messages that any thread can push to without locking, popped by one thread at a time.
+// Each cell carries a sequence number that tells pushes and pops whose turn it is.
+class LogQueue {
+public:
+    LogQueue(size_t size) : _cells(new Cell[size]), _mask(size - 1) {
+        for (size_t i = 0; i < size; ++i) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // position is set to the number of pushes before this one
+    bool push(LogEntry&& entry, size_t& position) {
+        Cell* cell;
+        position = _pushPosition.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &_cells[position & _mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+            if (difference == 0) {
+                if (_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // full
+                return false;
+            } else {
+                position = _pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+        cell->entry = std::move(entry);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(LogEntry& entry) {
+        Cell* cell = &_cells[_popPosition & _mask];
+        if (cell->sequence.load(std::memory_order_acquire) != _popPosition + 1) {
+            return false;
+        }
+        entry = std::move(cell->entry);
+        cell->sequence.store(_popPosition + _mask + 1, std::memory_order_release);
+        ++_popPosition;
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        LogEntry entry;
+    };
+
+    std::unique_ptr<Cell[]> _cells;
+    const size_t _mask;
+    std::atomic<size_t> _pushPosition { 0 };
+    size_t _popPosition { 0 };
+};
+
 QMutex LogHandler::_mutex;
 
 LogHandler& LogHandler::getInstance() {
@@ -29,13 +102,14 @@ LogHandler& LogHandler::getInstance() {
     return staticInstance;
 }
 
-LogHandler::LogHandler() {
+LogHandler::LogHandler() : _queue(new LogQueue(LOG_QUEUE_SIZE)) {
     // when the log handler is first setup we should print our timezone
     QString timezoneString = "Time zone: " + QDateTime::currentDateTime().toString("t");
     printMessage(LogMsgType::LogInfo, QMessageLogContext(), timezoneString);
 }
 
 LogHandler::~LogHandler() {
+    setAsyncOutput(false);
     flushRepeatedMessages();
     printMessage(LogMsgType::LogDebug, QMessageLogContext(), "LogHandler shutdown.");
 }
@@ -85,74 +159,153 @@ void LogHandler::setShouldDisplayMilliseconds(bool shouldDisplayMilliseconds) {
     _shouldDisplayMilliseconds = shouldDisplayMilliseconds;
 }
 
-
-void LogHandler::flushRepeatedMessages() {
+void LogHandler::setOutputFile(FILE* outputFile) {
     QMutexLocker lock(&_mutex);
-    QHash<QString, int>::iterator message = _repeatMessageCountHash.begin();
-    while (message != _repeatMessageCountHash.end()) {
+    _outputFile = outputFile;
+}
+
 
-        if (message.value() > 0) {
-            QString repeatMessage = QString("%1 repeated log entries matching \"%2\" - Last entry: \"%3\"")
-            .arg(message.value()).arg(message.key()).arg(_lastRepeatedMessage.value(message.key()));
+void LogHandler::setAsyncOutput(bool asyncOutput) {
+    if (asyncOutput == _asyncOutput) {
+        return;
+    }
 
-            QMessageLogContext emptyContext;
-            lock.unlock();
-            printMessage(LogSuppressed, emptyContext, repeatMessage);
-            lock.relock();
+    if (asyncOutput) {
+        {
+            std::lock_guard<std::mutex> guard(_writerMutex);
+            _stopWriter = false;
+        }
+        _writer = std::thread([this] { runWriter(); });
+        _asyncOutput = true;
+    } else {
+        _asyncOutput = false;
+        {
+            std::lock_guard<std::mutex> guard(_writerMutex);
+            _stopWriter = true;
         }
+        _writerCondition.notify_all();
+        _writer.join();
+        writeQueuedMessages();
+    }
+}
 
-        _lastRepeatedMessage.remove(message.key());
-        message = _repeatMessageCountHash.erase(message);
+void LogHandler::runWriter() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    while (!_stopWriter) {
+        _writerCondition.wait_for(lock, LOG_WRITE_INTERVAL);
+        lock.unlock();
+        writeQueuedMessages();
+        lock.lock();
     }
 }
 
-QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
-    QMutexLocker lock(&_mutex);
-    if (message.isEmpty()) {
-        return QString();
+void LogHandler::writeQueuedMessages() {
+    std::lock_guard<std::mutex> writeGuard(_writeMutex);
+
+    bool isQueueEmpty = false;
+    while (!isQueueEmpty) {
+        QByteArray batch;
+        FILE* outputFile;
+        {
+            QMutexLocker lock(&_mutex);
+            LogEntry entry;
+            for (int i = 0; i < MAX_LOG_BATCH_SIZE; ++i) {
+                if (!_queue->pop(entry)) {
+                    isQueueEmpty = true;
+                    break;
+                }
+                // suppressed messages were filtered out before being queued
+                batch.append(formatMessage(entry.type, entry.category, entry.message, entry.timestamp,
+                    entry.threadID).toLocal8Bit());
+                batch.append('\n');
+            }
+
+            quint64 numDroppedMessages = _numDroppedMessages;
+            if (numDroppedMessages != _numReportedDroppedMessages) {
+                QString droppedMessage = QString("%1 log entries dropped, logged faster than they could be written")
+                    .arg(numDroppedMessages - _numReportedDroppedMessages);
+                batch.append(formatMessage(LogWarning, nullptr, droppedMessage, QDateTime::currentMSecsSinceEpoch(),
+                    (size_t)QThread::currentThreadId()).toLocal8Bit());
+                batch.append('\n');
+                _numReportedDroppedMessages = numDroppedMessages;
+            }
+            outputFile = _outputFile;
+        }
+
+        if (!batch.isEmpty()) {
+            fwrite(batch.constData(), 1, batch.size(), outputFile);
+            fflush(outputFile);
+        }
     }
+}
 
-    if (type == LogDebug) {
-        // for debug messages, check if this matches any of our regexes for repeated log messages
-        foreach(const QString& regexString, getInstance()._repeatedMessageRegexes) {
-            QRegExp repeatRegex(regexString);
-            if (repeatRegex.indexIn(message) != -1) {
+void LogHandler::flushRepeatedMessages() {
+    QStringList repeatMessages;
+    int numRepeatedMessagePatterns = _numRepeatedMessagePatterns.load(std::memory_order_acquire);
+    for (int i = 0; i < numRepeatedMessagePatterns; ++i) {
+        auto& repeated = *_repeatedMessagePatterns[i];
+        // the next matching message is output again
+        int numRepeats = repeated.numRepeats.exchange(-1);
+        if (numRepeats > 0) {
+            std::lock_guard<std::mutex> guard(repeated.lastRepeatMutex);
+            repeatMessages << QString("%1 repeated log entries matching \"%2\" - Last entry: \"%3\"")
+                .arg(numRepeats).arg(repeated.pattern).arg(repeated.lastRepeat);
+        }
+    }
 
-                if (!_repeatMessageCountHash.contains(regexString)) {
-                    // we have a match but didn't have this yet - output the first one
-                    _repeatMessageCountHash[regexString] = 0;
+    QMessageLogContext emptyContext;
+    for (const auto& repeatMessage : repeatMessages) {
+        outputMessage(LogSuppressed, emptyContext, repeatMessage);
+    }
+}
 
-                    // break the foreach so we output the first match
-                    break;
-                } else {
-                    // we have a match - add 1 to the count of repeats for this message and set this as the last repeated message
-                    _repeatMessageCountHash[regexString] += 1;
-                    _lastRepeatedMessage[regexString] = message;
+bool LogHandler::isSuppressed(LogMsgType type, const QString& message) {
+    if (type != LogDebug) {
+        return false;
+    }
 
-                    // return out, we're not printing this one
-                    return QString();
-                }
+    // for debug messages, check if this matches any of our regexes for repeated log messages
+    int numRepeatedMessagePatterns = _numRepeatedMessagePatterns.load(std::memory_order_acquire);
+    for (int i = 0; i < numRepeatedMessagePatterns; ++i) {
+        auto& repeated = *_repeatedMessagePatterns[i];
+        if (repeated.regex.match(message).hasMatch()) {
+            if (repeated.numRepeats.fetch_add(1) == -1) {
+                // we have a match but didn't have this yet - output the first one
+                break;
+            }
+
+            // we have a match - set this as the last repeated message, unless another thread is doing so right now
+            std::unique_lock<std::mutex> lock(repeated.lastRepeatMutex, std::try_to_lock);
+            if (lock.owns_lock()) {
+                repeated.lastRepeat = message;
             }
+
+            // we're not printing this one
+            return true;
         }
     }
-    if (type == LogDebug) {
-        // see if this message is one we should only print once
-        foreach(const QString& regexString, getInstance()._onlyOnceMessageRegexes) {
-            QRegExp onlyOnceRegex(regexString);
-            if (onlyOnceRegex.indexIn(message) != -1) {
-                if (!_onlyOnceMessageCountHash.contains(message)) {
-                    // we have a match and haven't yet printed this message.
-                    _onlyOnceMessageCountHash[message] = 1;
-                    // break the foreach so we output the first match
-                    break;
-                } else {
-                    // We've already printed this message, don't print it again.
-                    return QString();
-                }
+
+    // see if this message is one we should only print once
+    int numOnlyOnceMessagePatterns = _numOnlyOnceMessagePatterns.load(std::memory_order_acquire);
+    for (int i = 0; i < numOnlyOnceMessagePatterns; ++i) {
+        auto& onlyOnce = *_onlyOnceMessagePatterns[i];
+        if (onlyOnce.regex.match(message).hasMatch()) {
+            std::lock_guard<std::mutex> guard(onlyOnce.outputMessagesMutex);
+            if (!onlyOnce.outputMessages.contains(message)) {
+                // we have a match and haven't yet printed this message.
+                onlyOnce.outputMessages.insert(message);
+                break;
+            } else {
+                // We've already printed this message, don't print it again.
+                return true;
             }
         }
     }
+    return false;
+}
 
+QString LogHandler::formatMessage(LogMsgType type, const char* category, const QString& message, qint64 timestamp,
+        size_t threadID) const {
     // log prefix is in the following format
     // [TIMESTAMP] [DEBUG] [PID] [TID] [TARGET] logged string
 
@@ -161,15 +314,14 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
         dateFormatPtr = &DATE_STRING_FORMAT_WITH_MILLISECONDS;
     }
 
-    QString prefixString = QString("[%1] [%2] [%3]").arg(QDateTime::currentDateTime().toString(*dateFormatPtr),
-        stringForLogType(type), context.category);
+    QString prefixString = QString("[%1] [%2] [%3]").arg(QDateTime::fromMSecsSinceEpoch(timestamp).toString(*dateFormatPtr),
+        stringForLogType(type), category);
 
     if (_shouldOutputProcessID) {
         prefixString.append(QString(" [%1]").arg(QCoreApplication::applicationPid()));
     }
 
     if (_shouldOutputThreadID) {
-        size_t threadID = (size_t)QThread::currentThreadId();
         prefixString.append(QString(" [%1]").arg(threadID));
     }
 
@@ -177,13 +329,56 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
         prefixString.append(QString(" [%1]").arg(_targetName));
     }
 
-    QString logMessage = QString("%1 %2").arg(prefixString, message.split('\n').join('\n' + prefixString + " "));
-    fprintf(stdout, "%s\n", qPrintable(logMessage));
+    return QString("%1 %2").arg(prefixString, message.split('\n').join('\n' + prefixString + " "));
+}
+
+QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
+    if (message.isEmpty() || isSuppressed(type, message)) {
+        return QString();
+    }
+
+    QMutexLocker lock(&_mutex);
+    QString logMessage = formatMessage(type, context.category, message, QDateTime::currentMSecsSinceEpoch(),
+        (size_t)QThread::currentThreadId());
+    fprintf(_outputFile, "%s\n", qPrintable(logMessage));
     return logMessage;
 }
 
+void LogHandler::outputMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
+    if (!_asyncOutput || type == LogFatal) {
+        if (_asyncOutput) {
+            // what was logged before a fatal message is written out before it
+            writeQueuedMessages();
+        }
+        printMessage(type, context, message);
+        return;
+    }
+
+    if (message.isEmpty() || isSuppressed(type, message)) {
+        return;
+    }
+
+    LogEntry entry { type, context.category, message, QDateTime::currentMSecsSinceEpoch(),
+        (size_t)QThread::currentThreadId() };
+    size_t position;
+    if (!_queue->push(std::move(entry), position)) {
+        ++_numDroppedMessages;
+        return;
+    }
+
+    if (_asyncOutput) {
+        if ((position + 1) % LOG_PUSHES_PER_WAKE == 0) {
+            // the queue may be filling up before the writer's next interval
+            _writerCondition.notify_one();
+        }
+    } else {
+        // async output was turned off since, write the message out ourselves
+        writeQueuedMessages();
+    }
+}
+
 void LogHandler::verboseMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message) {
-    getInstance().printMessage((LogMsgType) type, context, message);
+    getInstance().outputMessage((LogMsgType) type, context, message);
 }
 
 void LogHandler::setupRepeatedMessageFlusher() {
@@ -201,10 +396,30 @@ const QString& LogHandler::addRepeatedMessageRegex(const QString& regexString) {
     QMetaObject::invokeMethod(this, "setupRepeatedMessageFlusher");
 
     QMutexLocker lock(&_mutex);
+    if (!_repeatedMessageRegexes.contains(regexString)) {
+        int numPatterns = _numRepeatedMessagePatterns.load(std::memory_order_relaxed);
+        if (numPatterns < MAX_MESSAGE_PATTERNS) {
+            _repeatedMessagePatterns[numPatterns].reset(new RepeatedMessagePattern(regexString));
+            _numRepeatedMessagePatterns.store(numPatterns + 1, std::memory_order_release);
+        } else {
+            fprintf(_outputFile, "Too many repeated log message patterns, not suppressing \"%s\"\n",
+                qPrintable(regexString));
+        }
+    }
     return *_repeatedMessageRegexes.insert(regexString);
 }
 
 const QString& LogHandler::addOnlyOnceMessageRegex(const QString& regexString) {
     QMutexLocker lock(&_mutex);
+    if (!_onlyOnceMessageRegexes.contains(regexString)) {
+        int numPatterns = _numOnlyOnceMessagePatterns.load(std::memory_order_relaxed);
+        if (numPatterns < MAX_MESSAGE_PATTERNS) {
+            _onlyOnceMessagePatterns[numPatterns].reset(new OnlyOnceMessagePattern(regexString));
+            _numOnlyOnceMessagePatterns.store(numPatterns + 1, std::memory_order_release);
+        } else {
+            fprintf(_outputFile, "Too many only once log message patterns, not suppressing \"%s\"\n",
+                qPrintable(regexString));
+        }
+    }
     return *_onlyOnceMessageRegexes.insert(regexString);
 }
@@ -13,8 +13,16 @@
 #ifndef hifi_LogHandler_h
 #define hifi_LogHandler_h
 
+#include <atomic>
+#include <cstdio>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include <QHash>
 #include <QObject>
+#include <QRegularExpression>
 #include <QSet>
 #include <QString>
 #include <QMutex>
@@ -30,6 +38,8 @@ enum LogMsgType {
     LogSuppressed = 100
 };
 
+class LogQueue;
+
 /// Handles custom message handling and sending of stats/logs to Logstash instance
 class LogHandler : public QObject {
     Q_OBJECT
@@ -44,6 +54,15 @@ public:
     void setShouldOutputThreadID(bool shouldOutputThreadID);
     void setShouldDisplayMilliseconds(bool shouldDisplayMilliseconds);
 
+    /// has the messages of verboseMessageHandler filtered, formatted and written by a background thread, so that
+    /// logging threads only queue them. Messages are dropped, and counted, while the queue is full.
+    void setAsyncOutput(bool asyncOutput);
+    bool isAsyncOutput() const { return _asyncOutput; }
+    quint64 getNumDroppedMessages() const { return _numDroppedMessages; }
+
+    /// where messages are written, stdout by default
+    void setOutputFile(FILE* outputFile);
+
     QString printMessage(LogMsgType type, const QMessageLogContext& context, const QString &message);
 
     /// a qtMessageHandler that can be hooked up to a target that links to Qt
@@ -60,20 +79,75 @@ private:
     LogHandler();
     ~LogHandler();
 
+    // Patterns are matched by the logging threads without taking _mutex, so that suppressed messages
+    // cost a match and never take a slot in the queue.
+    class MessagePattern {
+    public:
+        MessagePattern(const QString& pattern) : pattern(pattern), regex(pattern) { regex.optimize(); }
+
+        const QString pattern;
+        QRegularExpression regex; // unlike QRegExp, safe to match from several threads at once
+    };
+
+    class RepeatedMessagePattern : public MessagePattern {
+    public:
+        using MessagePattern::MessagePattern;
+
+        // -1 until a message matches and is output, then the number of matching messages suppressed since
+        std::atomic<int> numRepeats { -1 };
+        std::mutex lastRepeatMutex; // only tried by the logging threads, a storm doesn't queue up on it
+        QString lastRepeat;
+    };
+
+    class OnlyOnceMessagePattern : public MessagePattern {
+    public:
+        using MessagePattern::MessagePattern;
+
+        std::mutex outputMessagesMutex;
+        QSet<QString> outputMessages;
+    };
+
+    // patterns are only ever appended, under _mutex, and counted once they are set up
+    static const int MAX_MESSAGE_PATTERNS = 256;
+
     void flushRepeatedMessages();
 
+    // queues the message in async mode, prints it otherwise
+    void outputMessage(LogMsgType type, const QMessageLogContext& context, const QString& message);
+
+    bool isSuppressed(LogMsgType type, const QString& message);
+    QString formatMessage(LogMsgType type, const char* category, const QString& message, qint64 timestamp,
+        size_t threadID) const;
+
+    void runWriter();
+    void writeQueuedMessages();
+
     QString _targetName;
     bool _shouldOutputProcessID { false };
     bool _shouldOutputThreadID { false };
     bool _shouldDisplayMilliseconds { false };
     QSet<QString> _repeatedMessageRegexes;
-    QHash<QString, int> _repeatMessageCountHash;
-    QHash<QString, QString> _lastRepeatedMessage;
+    std::unique_ptr<RepeatedMessagePattern> _repeatedMessagePatterns[MAX_MESSAGE_PATTERNS];
+    std::atomic<int> _numRepeatedMessagePatterns { 0 };
 
     QSet<QString> _onlyOnceMessageRegexes;
-    QHash<QString, int> _onlyOnceMessageCountHash;
+    std::unique_ptr<OnlyOnceMessagePattern> _onlyOnceMessagePatterns[MAX_MESSAGE_PATTERNS];
+    std::atomic<int> _numOnlyOnceMessagePatterns { 0 };
+
+    FILE* _outputFile { stdout }; // guarded by _mutex
 
     static QMutex _mutex;
+
+    std::unique_ptr<LogQueue> _queue;
+    std::atomic<bool> _asyncOutput { false };
+    std::atomic<quint64> _numDroppedMessages { 0 };
+    quint64 _numReportedDroppedMessages { 0 }; // guarded by _writeMutex
+    std::mutex _writeMutex; // held by whoever writes out the queue
+
+    std::thread _writer;
+    bool _stopWriter { false }; // guarded by _writerMutex
+    std::mutex _writerMutex;
+    std::condition_variable _writerCondition;
 };
 
 #endif // hifi_LogHandler_h
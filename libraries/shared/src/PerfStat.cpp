@@ -9,9 +9,15 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+#include <array>
 #include <cstdio>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <QDebug>
 #include <QThread>
@@ -79,28 +85,229 @@ void PerformanceTimerRecord::tallyResult(const quint64& now) {
 // PerformanceTimer
 // ----------------------------------------------------------------------------
 
+namespace {
+
+// Nodes are the paths of timer names that scopes were entered through, node 0 being the path of no scope.
+const uint32_t ROOT_NODE = 0;
+const uint32_t SLOTS_PER_CHUNK = 256;
+const uint32_t MAX_SLOT_CHUNKS = 256;
+
+struct TimerSlot {
+    std::atomic<quint64> total { 0 };
+    std::atomic<quint64> count { 0 };
+};
+
+// Timing state of a thread. Slots are written by the thread only, and emptied by whoever merges them.
+class ThreadTimers {
+public:
+    ThreadTimers() {
+        for (auto& chunk : _chunks) {
+            chunk.store(nullptr);
+        }
+    }
+    ~ThreadTimers() {
+        for (auto& chunk : _chunks) {
+            delete[] chunk.load();
+        }
+    }
+
+    // for the thread itself, null past the maximum number of nodes
+    TimerSlot* getSlot(uint32_t node) {
+        uint32_t chunkIndex = node / SLOTS_PER_CHUNK;
+        if (chunkIndex >= MAX_SLOT_CHUNKS) {
+            return nullptr;
+        }
+        TimerSlot* chunk = _chunks[chunkIndex].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new TimerSlot[SLOTS_PER_CHUNK];
+            _chunks[chunkIndex].store(chunk, std::memory_order_release);
+        }
+        return &chunk[node % SLOTS_PER_CHUNK];
+    }
+
+    // for any thread, null if the thread never recorded the node
+    TimerSlot* findSlot(uint32_t node) const {
+        uint32_t chunkIndex = node / SLOTS_PER_CHUNK;
+        if (chunkIndex >= MAX_SLOT_CHUNKS) {
+            return nullptr;
+        }
+        TimerSlot* chunk = _chunks[chunkIndex].load(std::memory_order_acquire);
+        return chunk ? &chunk[node % SLOTS_PER_CHUNK] : nullptr;
+    }
+
+    std::atomic<bool> orphaned { false }; // set once the thread has exited
+
+    // only used by the thread
+    uint32_t currentNode { ROOT_NODE };
+    std::unordered_map<uint64_t, uint32_t> childNodes; // by parent node and timer
+
+private:
+    std::array<std::atomic<TimerSlot*>, MAX_SLOT_CHUNKS> _chunks;
+};
+
+class LocalThreadTimers {
+public:
+    ~LocalThreadTimers() {
+        if (timers) {
+            timers->orphaned = true;
+        }
+    }
+
+    std::shared_ptr<ThreadTimers> timers;
+};
+
+struct TimerNode {
+    uint32_t parent;
+    PerformanceTimer::ID timer;
+    QString fullName;
+};
+
+class TimerRegistry {
+public:
+    TimerRegistry() {
+        nodes.push_back({ ROOT_NODE, 0, QString() });
+    }
+
+    std::mutex mutex;
+    QHash<QString, PerformanceTimer::ID> ids; // guarded by mutex
+    QVector<QString> names; // guarded by mutex
+    std::vector<TimerNode> nodes; // guarded by mutex
+    QHash<quint64, uint32_t> nodeIndices; // by parent node and timer, guarded by mutex
+    std::vector<std::shared_ptr<ThreadTimers>> threads; // guarded by mutex
+    QMap<QString, PerformanceTimerRecord> records; // guarded by mutex
+};
+
+}
+
+static thread_local LocalThreadTimers localThreadTimers;
+
+static TimerRegistry& getRegistry() {
+    static TimerRegistry registry;
+    return registry;
+}
+
+static uint64_t getChildKey(uint32_t parent, PerformanceTimer::ID timer) {
+    return ((uint64_t)parent << 32) | timer;
+}
+
+static ThreadTimers& getThreadTimers() {
+    if (!localThreadTimers.timers) {
+        localThreadTimers.timers = std::make_shared<ThreadTimers>();
+        auto& registry = getRegistry();
+        std::lock_guard<std::mutex> guard(registry.mutex);
+        registry.threads.push_back(localThreadTimers.timers);
+    }
+    return *localThreadTimers.timers;
+}
+
+static uint32_t getChildNode(ThreadTimers& timers, uint32_t parent, PerformanceTimer::ID timer) {
+    auto key = getChildKey(parent, timer);
+    auto it = timers.childNodes.find(key);
+    if (it != timers.childNodes.end()) {
+        return it->second;
+    }
+
+    // first time this thread enters the path, the full name is only built the first time any thread does
+    uint32_t node;
+    {
+        auto& registry = getRegistry();
+        std::lock_guard<std::mutex> guard(registry.mutex);
+        auto nodeIt = registry.nodeIndices.constFind(key);
+        if (nodeIt != registry.nodeIndices.constEnd()) {
+            node = nodeIt.value();
+        } else {
+            node = (uint32_t)registry.nodes.size();
+            QString fullName = registry.nodes[parent].fullName + "/" + registry.names[timer];
+            registry.nodes.push_back({ parent, timer, fullName });
+            registry.nodeIndices.insert(key, node);
+        }
+    }
+    timers.childNodes.emplace(key, node);
+    return node;
+}
+
+// merges the slots of all threads into the records, with the registry locked
+static void mergeThreadTimers(TimerRegistry& registry, bool keepResults) {
+    const uint32_t numNodes = (uint32_t)registry.nodes.size();
+    std::vector<ThreadTimers*> exited;
+    for (auto& timers : registry.threads) {
+        // checked before merging, so that nothing is left behind in the slots of a thread that is let go of
+        if (timers->orphaned) {
+            exited.push_back(timers.get());
+        }
+
+        for (uint32_t node = ROOT_NODE + 1; node < numNodes; ++node) {
+            TimerSlot* slot = timers->findSlot(node);
+            if (!slot) {
+                // skip to the next chunk
+                node += SLOTS_PER_CHUNK - 1 - (node % SLOTS_PER_CHUNK);
+                continue;
+            }
+            // the count is taken first, a total it doesn't account for yet is left for the next merge
+            quint64 count = slot->count.exchange(0, std::memory_order_relaxed);
+            if (count > 0) {
+                quint64 total = slot->total.exchange(0, std::memory_order_relaxed);
+                if (keepResults) {
+                    registry.records[registry.nodes[node].fullName].accumulateResult(total);
+                }
+            }
+        }
+    }
+
+    registry.threads.erase(std::remove_if(registry.threads.begin(), registry.threads.end(),
+        [&](const std::shared_ptr<ThreadTimers>& timers) {
+            return std::find(exited.begin(), exited.end(), timers.get()) != exited.end();
+        }), registry.threads.end());
+}
+
 std::atomic<bool> PerformanceTimer::_isActive(false);
-QHash<QThread*, QString> PerformanceTimer::_fullNames;
-QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 
+// static
+PerformanceTimer::ID PerformanceTimer::registerTimer(const QString& name) {
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    auto it = registry.ids.constFind(name);
+    if (it != registry.ids.constEnd()) {
+        return it.value();
+    }
+    ID id = (ID)registry.names.size();
+    registry.names.push_back(name);
+    registry.ids.insert(name, id);
+    return id;
+}
+
+PerformanceTimer::PerformanceTimer(ID id) {
+    if (_isActive) {
+        start(id);
+    }
+}
 
 PerformanceTimer::PerformanceTimer(const QString& name) {
     if (_isActive) {
-        _name = name;
-        QString& fullName = _fullNames[QThread::currentThread()];
-        fullName.append("/");
-        fullName.append(_name);
-        _start = usecTimestampNow();
+        start(registerTimer(name));
     }
 }
 
+void PerformanceTimer::start(ID id) {
+    auto& timers = getThreadTimers();
+    _parentNode = timers.currentNode;
+    _node = getChildNode(timers, _parentNode, id);
+    timers.currentNode = _node;
+    _start = usecTimestampNow();
+}
+
 PerformanceTimer::~PerformanceTimer() {
-    if (_isActive && _start != 0) {
+    if (_start != 0) {
         quint64 elapsedUsec = (usecTimestampNow() - _start);
-        QString& fullName = _fullNames[QThread::currentThread()];
-        PerformanceTimerRecord& namedRecord = _records[fullName];
-        namedRecord.accumulateResult(elapsedUsec);
-        fullName.resize(fullName.size() - (_name.size() + 1));
+        ThreadTimers& timers = *localThreadTimers.timers;
+        timers.currentNode = _parentNode;
+        if (_isActive) {
+            TimerSlot* slot = timers.getSlot(_node);
+            if (slot) {
+                slot->total.fetch_add(elapsedUsec, std::memory_order_relaxed);
+                slot->count.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
     }
 }
 
@@ -111,22 +318,45 @@ bool PerformanceTimer::isActive() {
 
 // static
 QString PerformanceTimer::getContextName() {
-    return _fullNames[QThread::currentThread()];
+    if (!localThreadTimers.timers) {
+        return QString();
+    }
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    return registry.nodes[localThreadTimers.timers->currentNode].fullName;
 }
 
 // static
 void PerformanceTimer::addTimerRecord(const QString& fullName, quint64 elapsedUsec) {
-    PerformanceTimerRecord& namedRecord = _records[fullName];
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    PerformanceTimerRecord& namedRecord = registry.records[fullName];
     namedRecord.accumulateResult(elapsedUsec);
 }
 
+// static
+PerformanceTimerRecord PerformanceTimer::getTimerRecord(const QString& name) {
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    return registry.records.value(name);
+}
+
+// static
+QMap<QString, PerformanceTimerRecord> PerformanceTimer::getAllTimerRecords() {
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    return registry.records;
+}
+
 // static
 void PerformanceTimer::setActive(bool active) {
     if (active != _isActive) {
         _isActive.store(active);
         if (!active) {
-            _fullNames.clear();
-            _records.clear();
+            auto& registry = getRegistry();
+            std::lock_guard<std::mutex> guard(registry.mutex);
+            mergeThreadTimers(registry, false);
+            registry.records.clear();
         }
 
         qCDebug(shared) << "PerformanceTimer has been turned" << ((active) ? "on" : "off");
@@ -135,14 +365,18 @@ void PerformanceTimer::setActive(bool active) {
 
 // static
 void PerformanceTimer::tallyAllTimerRecords() {
-    QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
-    QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    mergeThreadTimers(registry, true);
+
+    QMap<QString, PerformanceTimerRecord>::iterator recordsItr = registry.records.begin();
+    QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = registry.records.end();
     quint64 now = usecTimestampNow();
     while (recordsItr != recordsEnd) {
         recordsItr.value().tallyResult(now);
         if (recordsItr.value().isStale(now)) {
             // purge stale records
-            recordsItr = _records.erase(recordsItr);
+            recordsItr = registry.records.erase(recordsItr);
         } else {
             ++recordsItr;
         }
@@ -150,7 +384,7 @@ void PerformanceTimer::tallyAllTimerRecords() {
 }
 
 void PerformanceTimer::dumpAllTimerRecords() {
-    QMapIterator<QString, PerformanceTimerRecord> i(_records);
+    QMapIterator<QString, PerformanceTimerRecord> i(getAllTimerRecords());
     while (i.hasNext()) {
         i.next();
         qCDebug(shared) << i.key() << ": average " << i.value().getAverage()
@@ -73,9 +73,18 @@ private:
     SimpleMovingAverage _movingAverage;
 };
 
+// Times nested scopes, recording them under the path of timer names they were entered through, e.g. "/idle/update".
+// Timer names are registered once, see PERFORMANCE_TIMER. Each thread accumulates into slots of its own, which
+// tallyAllTimerRecords() merges into the records, so that timing a scope takes no lock and builds no string.
 class PerformanceTimer {
 public:
+    using ID = uint32_t;
 
+    // returns the same ID for the same name
+    static ID registerTimer(const QString& name);
+
+    PerformanceTimer(ID id);
+    // registers the name on every use, prefer PERFORMANCE_TIMER
     PerformanceTimer(const QString& name);
     ~PerformanceTimer();
 
@@ -84,18 +93,24 @@ public:
 
     static QString getContextName();
     static void addTimerRecord(const QString& fullName, quint64 elapsedUsec);
-    static const PerformanceTimerRecord& getTimerRecord(const QString& name) { return _records[name]; };
-    static const QMap<QString, PerformanceTimerRecord>& getAllTimerRecords() { return _records; };
+    static PerformanceTimerRecord getTimerRecord(const QString& name);
+    static QMap<QString, PerformanceTimerRecord> getAllTimerRecords();
     static void tallyAllTimerRecords();
     static void dumpAllTimerRecords();
 
 private:
+    void start(ID id);
+
     quint64 _start = 0;
-    QString _name;
+    uint32_t _node = 0;
+    uint32_t _parentNode = 0;
     static std::atomic<bool> _isActive;
-    static QHash<QThread*, QString> _fullNames;
-    static QMap<QString, PerformanceTimerRecord> _records;
 };
 
+// Times the enclosing scope, with its name registered the first time the scope is reached
+#define PERFORMANCE_TIMER(name) PerformanceTimer perfTimer([] { \
+    static const PerformanceTimer::ID id = PerformanceTimer::registerTimer(name); \
+    return id; \
+}())
 
 #endif // hifi_PerfStat_h
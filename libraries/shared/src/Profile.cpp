@@ -39,9 +39,14 @@ static bool tracingEnabled() {
 
 Duration::Duration(const QLoggingCategory& category, const QString& name, uint32_t argbColor, uint64_t payload, const QVariantMap& baseArgs) : _name(name), _category(category) {
     if (tracingEnabled() && category.isDebugEnabled()) {
-        QVariantMap args = baseArgs;
-        args["nv_payload"] = QVariant::fromValue(payload);
-        tracing::traceEvent(_category, _name, tracing::DurationBegin, "", args);
+        static const QString PAYLOAD_ARG = "nv_payload";
+        if (baseArgs.empty()) {
+            tracing::traceEvent(_category, _name, tracing::DurationBegin, PAYLOAD_ARG, (double)payload);
+        } else {
+            QVariantMap args = baseArgs;
+            args[PAYLOAD_ARG] = QVariant::fromValue(payload);
+            tracing::traceEvent(_category, _name, tracing::DurationBegin, "", args);
+        }
 
 #if defined(NSIGHT_TRACING)
         nvtxEventAttributes_t eventAttrib { 0 };
@@ -10,6 +10,7 @@
 //
 
 #include <QQueue>
+#include <QVector>
 
 #include "DependencyManager.h"
 #include "SharedUtil.h"
@@ -33,6 +34,7 @@ SpatiallyNestable::SpatiallyNestable(NestableType nestableType, QUuid id) :
 
 SpatiallyNestable::~SpatiallyNestable() {
     forEachChild([&](SpatiallyNestablePointer object) {
+        object->invalidateWorldTransforms();
         object->parentDeleted();
     });
 }
@@ -64,12 +66,17 @@ const QUuid SpatiallyNestable::getParentID() const {
 }
 
 void SpatiallyNestable::setParentID(const QUuid& parentID) {
+    bool changed = false;
     _idLock.withWriteLock([&] {
         if (_parentID != parentID) {
             _parentID = parentID;
             _parentKnowsMe = false;
+            changed = true;
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
 }
 
 Transform SpatiallyNestable::getParentTransform(bool& success, int depth) const {
@@ -146,7 +153,10 @@ void SpatiallyNestable::forgetChild(SpatiallyNestablePointer newChild) const {
 }
 
 void SpatiallyNestable::setParentJointIndex(quint16 parentJointIndex) {
-    _parentJointIndex = parentJointIndex;
+    if (_parentJointIndex != parentJointIndex) {
+        _parentJointIndex = parentJointIndex;
+        invalidateWorldTransforms();
+    }
 }
 
 glm::vec3 SpatiallyNestable::worldToLocal(const glm::vec3& position,
@@ -405,6 +415,9 @@ void SpatiallyNestable::setPosition(const glm::vec3& position, bool& success, bo
             _translationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -458,6 +471,9 @@ void SpatiallyNestable::setOrientation(const glm::quat& orientation, bool& succe
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -593,14 +609,80 @@ glm::vec3 SpatiallyNestable::getParentAngularVelocity(bool& success) const {
 
 const Transform SpatiallyNestable::getTransform(bool& success, int depth) const {
     Transform result;
+    if (getCachedWorldTransform(result)) {
+        success = true;
+        return result;
+    }
+
+    // read before computing, so that a change made meanwhile leaves the result uncached
+    quint64 generation = _worldTransformGeneration;
+
     // return a world-space transform for this object's location
     Transform parentTransform = getParentTransform(success, depth);
     _transformLock.withReadLock([&] {
         Transform::mult(result, parentTransform, _transform);
     });
+
+    // joints move without telling their children, so only transforms relative to the parent itself are kept, and
+    // only once the parent's own is
+    bool cacheable = success && _parentJointIndex == INVALID_JOINT_INDEX;
+    if (cacheable) {
+        SpatiallyNestablePointer parent = _parent.lock();
+        cacheable = !parent || parent->hasWorldTransformCached();
+    }
+    if (cacheable) {
+        _worldTransformCacheLock.withWriteLock([&] {
+            _worldTransformCache = result;
+            _worldTransformCacheGeneration = generation;
+        });
+    }
     return result;
 }
 
+bool SpatiallyNestable::getCachedWorldTransform(Transform& result) const {
+    // a parent replaced by another object with the same ID doesn't invalidate its children's transforms
+    if (_parent.expired() && !getParentID().isNull()) {
+        return false;
+    }
+
+    bool cached = false;
+    _worldTransformCacheLock.withReadLock([&] {
+        if (_worldTransformCacheGeneration == _worldTransformGeneration) {
+            result = _worldTransformCache;
+            cached = true;
+        }
+    });
+    return cached;
+}
+
+bool SpatiallyNestable::hasWorldTransformCached() const {
+    bool cached = false;
+    _worldTransformCacheLock.withReadLock([&] {
+        cached = _worldTransformCacheGeneration == _worldTransformGeneration;
+    });
+    return cached;
+}
+
+void SpatiallyNestable::invalidateWorldTransforms(int depth) const {
+    ++_worldTransformGeneration;
+
+    if (depth > maxParentingChain) {
+        return;
+    }
+    QVector<SpatiallyNestablePointer> children;
+    _childrenLock.withReadLock([&] {
+        children.reserve(_children.size());
+        foreach(SpatiallyNestableWeakPointer childWP, _children) {
+            if (SpatiallyNestablePointer child = childWP.lock()) {
+                children << child;
+            }
+        }
+    });
+    for (auto& child : children) {
+        child->invalidateWorldTransforms(depth + 1);
+    }
+}
+
 const Transform SpatiallyNestable::getTransform() const {
     bool success;
     Transform result = getTransform(success);
@@ -658,6 +740,9 @@ void SpatiallyNestable::setTransform(const Transform& transform, bool& success)
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
     if (success && changed) {
         locationChanged();
     }
@@ -699,6 +784,9 @@ void SpatiallyNestable::setScale(const glm::vec3& scale) {
             _scaleChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
     if (changed) {
         dimensionsChanged();
     }
@@ -721,6 +809,9 @@ void SpatiallyNestable::setScale(float value) {
             _scaleChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
 
     if (changed) {
         dimensionsChanged();
@@ -752,6 +843,9 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
 
     if (changed) {
         locationChanged();
@@ -780,6 +874,9 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
             _translationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
     if (changed) {
         locationChanged(tellPhysics);
     }
@@ -807,6 +904,9 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
     if (changed) {
         locationChanged();
     }
@@ -865,6 +965,9 @@ void SpatiallyNestable::setLocalScale(const glm::vec3& scale) {
             _scaleChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
     if (changed) {
         dimensionsChanged();
     }
@@ -1110,6 +1213,9 @@ void SpatiallyNestable::setLocalTransformAndVelocities(
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransforms();
+    }
     // linear velocity
     _velocityLock.withWriteLock([&] {
         _velocity = localVelocity;
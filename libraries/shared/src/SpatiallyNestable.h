@@ -12,6 +12,8 @@
 #ifndef hifi_SpatiallyNestable_h
 #define hifi_SpatiallyNestable_h
 
+#include <atomic>
+
 #include <QUuid>
 
 #include "Transform.h"
@@ -179,6 +181,9 @@ public:
             const glm::vec3& localVelocity,
             const glm::vec3& localAngularVelocity);
 
+    // changes whenever the world transform may have changed, whether through this object or one of its ancestors
+    quint64 getWorldTransformGeneration() const { return _worldTransformGeneration; }
+
     bool scaleChangedSince(quint64 time) { return _scaleChanged > time; }
     bool tranlationChangedSince(quint64 time) { return _translationChanged > time; }
     bool rotationChangedSince(quint64 time) { return _rotationChanged > time; }
@@ -211,6 +216,10 @@ protected:
     quint64 _rotationChanged { 0 };
 
 private:
+    bool getCachedWorldTransform(Transform& result) const;
+    bool hasWorldTransformCached() const;
+    void invalidateWorldTransforms(int depth = 0) const;
+
     mutable ReadWriteLockable _transformLock;
     mutable ReadWriteLockable _idLock;
     mutable ReadWriteLockable _velocityLock;
@@ -220,6 +229,12 @@ private:
     glm::vec3 _angularVelocity;
     mutable bool _parentKnowsMe { false };
     bool _isDead { false };
+
+    // the last world transform computed by getTransform(), valid while its generation is current
+    mutable ReadWriteLockable _worldTransformCacheLock;
+    mutable Transform _worldTransformCache;
+    mutable quint64 _worldTransformCacheGeneration { 0 };
+    mutable std::atomic<quint64> _worldTransformGeneration { 1 };
 };
 
 
@@ -8,7 +8,9 @@
 
 #include "Trace.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 
 #include <QtCore/QDebug>
 #include <QtCore/QCoreApplication>
@@ -24,84 +26,572 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QTextStream>
 
-#include <QtCore/QJsonObject>
-#include <QtCore/QJsonDocument>
-
-#include <BuildInfo.h>
-
 #include "Gzip.h"
 #include "PortableHighResolutionClock.h"
 #include "shared/GlobalAppProperties.h"
 
 using namespace tracing;
 
+static const uint64_t TRACE_RING_SIZE = 1 << 14; // records per thread
+static const std::chrono::milliseconds TRACE_FLUSH_INTERVAL { 50 };
+
+static const quint32 BINARY_TRACE_MAGIC = 0x52544648; // "HFTR"
+static const quint32 BINARY_TRACE_VERSION = 2;
+
+static_assert(sizeof(TraceRecord) == 80, "TraceRecord is written as is to binary traces");
+
+namespace tracing {
+
+// Records of one thread, with a single producer, the thread itself, and a single consumer, whoever holds the
+// drain mutex of the tracer.
+class TraceRing {
+public:
+    TraceRing(qint64 threadID) : threadID(threadID), _records(TRACE_RING_SIZE) {}
+
+    bool push(const TraceRecord& record) {
+        auto head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= TRACE_RING_SIZE) {
+            return false;
+        }
+        _records[head % TRACE_RING_SIZE] = record;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // moves the records out of the ring, discarding them if out is null
+    void drain(std::vector<TraceRecord>* out) {
+        auto tail = _tail.load(std::memory_order_relaxed);
+        auto head = _head.load(std::memory_order_acquire);
+        while (out && tail != head) {
+            auto begin = tail % TRACE_RING_SIZE;
+            auto count = std::min(head - tail, TRACE_RING_SIZE - begin);
+            out->insert(out->end(), _records.data() + begin, _records.data() + begin + count);
+            tail += count;
+        }
+        _tail.store(head, std::memory_order_release);
+    }
+
+    const qint64 threadID;
+    std::atomic<bool> orphaned { false }; // set once the thread is done with the ring
+
+    // indices of the names and categories already interned by the thread, only used by it,
+    // valid for the generation of the string table they were interned in
+    QHash<QString, uint32_t> strings;
+    QHash<const QLoggingCategory*, uint32_t> categories;
+    uint32_t stringsGeneration { 0 };
+
+private:
+    std::vector<TraceRecord> _records;
+    std::atomic<uint64_t> _head { 0 };
+    std::atomic<uint64_t> _tail { 0 };
+};
+
+}
+
+// The ring of the current thread, for the tracer it was created by
+class LocalTraceRing {
+public:
+    ~LocalTraceRing() {
+        if (ring) {
+            ring->orphaned = true;
+        }
+    }
+
+    uint64_t tracerSerial { 0 };
+    std::shared_ptr<TraceRing> ring;
+};
+
+static thread_local LocalTraceRing localTraceRing;
+static std::atomic<uint64_t> nextTracerSerial { 1 };
+
+struct TraceThread {
+    qint64 threadID;
+    std::vector<TraceRecord> records;
+};
+
+struct TraceData {
+    qint64 processID { 0 };
+    QVector<QString> strings;
+    std::vector<TraceThread> threads;
+};
+
+static TraceTimestamp getTimestamp() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+}
+
+static bool isNumber(const QVariant& value) {
+    switch (value.userType()) {
+        case QMetaType::Bool:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::Long:
+        case QMetaType::ULong:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Float:
+        case QMetaType::Double:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ids that are plain decimal numbers, as most are, are stored as is rather than interned
+static bool parseNumericID(const QString& id, uint64_t& value) {
+    static const int MAX_DIGITS = 19; // always fits in 64 bits
+    if (id.isEmpty() || id.size() > MAX_DIGITS || (id.size() > 1 && id[0] == '0')) {
+        return false;
+    }
+    value = 0;
+    for (QChar c : id) {
+        auto digit = c.unicode();
+        if (digit < '0' || digit > '9') {
+            return false;
+        }
+        value = value * 10 + (digit - '0');
+    }
+    return true;
+}
+
+template <typename Intern>
+static void setID(TraceRecord& record, const QString& id, Intern intern) {
+    uint64_t value = 0;
+    if (parseNumericID(id, value)) {
+        record.id = value;
+        record.numericID = 1;
+    } else {
+        record.id = intern(id);
+    }
+}
+
+// args past TraceRecord::MAX_ARGS are dropped, non-numeric values are interned as strings
+template <typename InternName, typename InternValue>
+static void setArgs(TraceRecord& record, const QVariantMap& args, const QVariantMap& extra,
+        InternName internName, InternValue internValue) {
+    auto addArg = [&](const QString& name, const QVariant& value, bool isExtra) {
+        if (record.numArgs == TraceRecord::MAX_ARGS) {
+            return;
+        }
+        int i = record.numArgs++;
+        record.argNames[i] = internName(name);
+        if (isNumber(value)) {
+            record.argValues[i] = value.toDouble();
+        } else {
+            record.argValues[i] = internValue(value.toString());
+            record.stringArgs |= (uint8_t)(1 << i);
+        }
+        if (isExtra) {
+            record.extraArgs |= (uint8_t)(1 << i);
+        }
+    };
+
+    for (auto it = args.begin(); it != args.end(); ++it) {
+        addArg(it.key(), it.value(), false);
+    }
+    for (auto it = extra.begin(); it != extra.end(); ++it) {
+        addArg(it.key(), it.value(), true);
+    }
+}
+
+static QByteArray toJsonString(const QString& string) {
+    QByteArray utf8 = string.toUtf8();
+    QByteArray json;
+    json.reserve(utf8.size() + 2);
+    json.append('"');
+    for (char c : utf8) {
+        switch (c) {
+            case '"': json.append("\\\""); break;
+            case '\\': json.append("\\\\"); break;
+            case '\n': json.append("\\n"); break;
+            case '\r': json.append("\\r"); break;
+            case '\t': json.append("\\t"); break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    json.append(QString().sprintf("\\u%04x", (int)c).toLatin1());
+                } else {
+                    json.append(c);
+                }
+                break;
+        }
+    }
+    json.append('"');
+    return json;
+}
+
+static QByteArray toJsonNumber(double value) {
+    static const double MAX_EXACT_INTEGER = 9007199254740992.0; // 2^53
+    if (!std::isfinite(value)) {
+        return "null";
+    }
+    if (value == std::floor(value) && std::abs(value) < MAX_EXACT_INTEGER) {
+        return QByteArray::number((qint64)value);
+    }
+    return QByteArray::number(value, 'g', 15);
+}
+
+// Chrome tracing format, written by hand as QJsonObject serialization is very slow
+static void writeJsonTrace(const TraceData& data, QByteArray& out) {
+    QVector<QByteArray> strings;
+    strings.reserve(data.strings.size());
+    for (const auto& string : data.strings) {
+        strings.push_back(toJsonString(string));
+    }
+    const QByteArray processID = QByteArray::number(data.processID);
+
+    auto appendArg = [&](const TraceRecord& record, int i) {
+        out.append(strings[record.argNames[i]]).append(':');
+        if (record.stringArgs & (1 << i)) {
+            out.append(strings[(uint32_t)record.argValues[i]]);
+        } else {
+            out.append(toJsonNumber(record.argValues[i]));
+        }
+    };
+
+    out.append("[\n");
+    bool first = true;
+    for (const auto& thread : data.threads) {
+        const QByteArray threadID = QByteArray::number(thread.threadID);
+        for (const auto& record : thread.records) {
+            if (first) {
+                first = false;
+            } else {
+                out.append(",\n");
+            }
+            out.append("{\"name\":").append(strings[record.name]);
+            out.append(",\"cat\":").append(strings[record.category]);
+            out.append(",\"ph\":\"").append((char)record.type).append('"');
+            out.append(",\"ts\":").append(QByteArray::number((qulonglong)record.timestamp));
+            out.append(",\"pid\":").append(processID);
+            out.append(",\"tid\":").append(threadID);
+            if (record.numericID) {
+                out.append(",\"id\":\"").append(QByteArray::number((qulonglong)record.id)).append('"');
+            } else if (record.id) {
+                out.append(",\"id\":").append(strings[record.id]);
+            }
+
+            bool hasArgs = false;
+            for (int i = 0; i < record.numArgs; ++i) {
+                if (!(record.extraArgs & (1 << i))) {
+                    out.append(hasArgs ? "," : ",\"args\":{");
+                    hasArgs = true;
+                    appendArg(record, i);
+                }
+            }
+            if (hasArgs) {
+                out.append('}');
+            }
+            for (int i = 0; i < record.numArgs; ++i) {
+                if (record.extraArgs & (1 << i)) {
+                    out.append(',');
+                    appendArg(record, i);
+                }
+            }
+            out.append('}');
+        }
+    }
+    out.append("\n]");
+}
+
+// Records are written as they are in memory, in the byte order of the host, which is little endian on all our
+// platforms, as is the rest of the file
+static void writeBinaryTrace(const TraceData& data, QByteArray& out) {
+    QDataStream stream(&out, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << BINARY_TRACE_MAGIC << BINARY_TRACE_VERSION << data.processID;
+
+    stream << (quint32)data.strings.size();
+    for (const auto& string : data.strings) {
+        stream << string;
+    }
+
+    stream << (quint32)data.threads.size();
+    for (const auto& thread : data.threads) {
+        stream << thread.threadID << (quint32)thread.records.size();
+        stream.writeRawData((const char*)thread.records.data(), (int)(thread.records.size() * sizeof(TraceRecord)));
+    }
+}
+
+static bool isValidRecord(const TraceRecord& record, uint32_t numStrings) {
+    if (record.name >= numStrings || record.category >= numStrings || record.numArgs > TraceRecord::MAX_ARGS ||
+            (!record.numericID && record.id >= numStrings)) {
+        return false;
+    }
+    for (int i = 0; i < record.numArgs; ++i) {
+        if (record.argNames[i] >= numStrings ||
+                ((record.stringArgs & (1 << i)) && !(record.argValues[i] >= 0 && record.argValues[i] < numStrings))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool readBinaryTrace(const QByteArray& bytes, TraceData& data) {
+    QDataStream stream(bytes);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != BINARY_TRACE_MAGIC || version != BINARY_TRACE_VERSION) {
+        return false;
+    }
+    stream >> data.processID;
+
+    quint32 numStrings = 0;
+    stream >> numStrings;
+    for (quint32 i = 0; i < numStrings && stream.status() == QDataStream::Ok; ++i) {
+        QString string;
+        stream >> string;
+        data.strings.push_back(string);
+    }
+
+    quint32 numThreads = 0;
+    stream >> numThreads;
+    for (quint32 i = 0; i < numThreads && stream.status() == QDataStream::Ok; ++i) {
+        TraceThread thread;
+        quint32 numRecords = 0;
+        stream >> thread.threadID >> numRecords;
+        if ((quint64)numRecords * sizeof(TraceRecord) > (quint64)bytes.size()) {
+            return false;
+        }
+        thread.records.resize(numRecords);
+        int length = (int)(numRecords * sizeof(TraceRecord));
+        if (stream.readRawData((char*)thread.records.data(), length) != length) {
+            return false;
+        }
+        data.threads.push_back(std::move(thread));
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // don't trust the string indices of the file
+    const uint32_t numValidStrings = (uint32_t)data.strings.size();
+    for (const auto& thread : data.threads) {
+        for (const auto& record : thread.records) {
+            if (!isValidRecord(record, numValidStrings)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool writeTraceFile(const QString& path, QByteArray data) {
+    // If the file exists and we can't remove it, fail early
+    if (QFileInfo(path).exists() && !QFile::remove(path)) {
+        return false;
+    }
+
+    if (path.endsWith(".gz")) {
+        QByteArray compressed;
+        gzip(data, compressed);
+        data = compressed;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(data);
+    file.close();
+    return true;
+}
+
 bool tracing::enabled() {
     return DependencyManager::get<Tracer>()->isEnabled();
 }
 
+bool tracing::convertTrace(const QString& binaryPath, const QString& jsonPath) {
+    QFile file(binaryPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open trace" << binaryPath;
+        return false;
+    }
+
+    TraceData data;
+    if (!readBinaryTrace(file.readAll(), data)) {
+        qWarning() << binaryPath << "is not a binary trace of a supported version";
+        return false;
+    }
+
+    QByteArray json;
+    writeJsonTrace(data, json);
+    return writeTraceFile(jsonPath, json);
+}
+
+Tracer::Tracer() : _serial(nextTracerSerial++) {
+    resetStrings();
+}
+
+Tracer::~Tracer() {
+    stopFlusher();
+}
+
 void Tracer::startTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
+    std::lock_guard<std::mutex> guard(_stateMutex);
     if (_enabled) {
         qWarning() << "Tried to enable tracer, but already enabled";
         return;
     }
 
-    _events.clear();
+    // discard events recorded since tracing was last stopped and not serialized
+    drainRings(false);
+    {
+        std::lock_guard<std::mutex> drainGuard(_drainMutex);
+        _records.clear();
+    }
+    _numDroppedEvents = 0;
+    resetStrings();
+
     _enabled = true;
+    startFlusher();
 }
 
 void Tracer::stopTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
+    std::lock_guard<std::mutex> guard(_stateMutex);
     if (!_enabled) {
         qWarning() << "Cannot stop tracing, already disabled";
         return;
     }
     _enabled = false;
+    stopFlusher();
+    drainRings();
 }
 
-void TraceEvent::writeJson(QTextStream& out) const {
-#if 0
-    // FIXME QJsonObject serialization is very slow, so we should be using manual JSON serialization
-    out << "{";
-    out << "\"name\":\"" << name << "\",";
-    out << "\"cat\":\"" << category.categoryName() << "\",";
-    out << "\"ph\":\"" << QString(type) << "\",";
-    out << "\"ts\":\"" << timestamp << "\",";
-    out << "\"pid\":\"" << processID << "\",";
-    out << "\"tid\":\"" << threadID << "\"";
-    //if (!extra.empty()) {
-    //    auto it = extra.begin();
-    //    for (; it != extra.end(); it++) {
-    //        ev[it.key()] = QJsonValue::fromVariant(it.value());
-    //    }
-    //}
-    //if (!args.empty()) {
-    //    out << ",\"args\":'
-    //}
-    out << '}';
-#else
-    QJsonObject ev {
-        { "name", QJsonValue(name) },
-        { "cat", category.categoryName() },
-        { "ph", QString(type) },
-        { "ts", timestamp },
-        { "pid", processID },
-        { "tid", threadID }
-    };
-    if (!id.isEmpty()) {
-        ev["id"] = id;
+void Tracer::startFlusher() {
+    {
+        std::lock_guard<std::mutex> guard(_flusherMutex);
+        _stopFlusher = false;
+    }
+    _flusher = std::thread([this] {
+        std::unique_lock<std::mutex> lock(_flusherMutex);
+        while (!_stopFlusher) {
+            _flusherCondition.wait_for(lock, TRACE_FLUSH_INTERVAL);
+            lock.unlock();
+            drainRings();
+            lock.lock();
+        }
+    });
+}
+
+void Tracer::stopFlusher() {
+    if (!_flusher.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(_flusherMutex);
+        _stopFlusher = true;
+    }
+    _flusherCondition.notify_all();
+    _flusher.join();
+}
+
+void Tracer::drainRings(bool keepRecords) {
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    {
+        std::lock_guard<std::mutex> guard(_ringsMutex);
+        rings = _rings;
+    }
+
+    std::vector<TraceRing*> done;
+    {
+        std::lock_guard<std::mutex> guard(_drainMutex);
+        for (auto& ring : rings) {
+            // checked before draining, so that nothing is left behind in a ring that is let go of
+            bool orphaned = ring->orphaned;
+            ring->drain(keepRecords ? &_records[ring->threadID] : nullptr);
+            if (orphaned) {
+                done.push_back(ring.get());
+            }
+        }
     }
-    if (!args.empty()) {
-        ev["args"] = QJsonObject::fromVariantMap(args);
+
+    if (!done.empty()) {
+        std::lock_guard<std::mutex> guard(_ringsMutex);
+        _rings.erase(std::remove_if(_rings.begin(), _rings.end(), [&](const std::shared_ptr<TraceRing>& ring) {
+            return std::find(done.begin(), done.end(), ring.get()) != done.end();
+        }), _rings.end());
     }
-    if (!extra.empty()) {
-        auto it = extra.begin();
-        for (; it != extra.end(); it++) {
-            ev[it.key()] = QJsonValue::fromVariant(it.value());
+}
+
+TraceRing& Tracer::getRing() {
+    if (localTraceRing.tracerSerial != _serial) {
+        if (localTraceRing.ring) {
+            localTraceRing.ring->orphaned = true;
         }
+        localTraceRing.ring = std::make_shared<TraceRing>(int64_t(QThread::currentThreadId()));
+        localTraceRing.tracerSerial = _serial;
+
+        std::lock_guard<std::mutex> guard(_ringsMutex);
+        _rings.push_back(localTraceRing.ring);
+    }
+
+    auto& ring = *localTraceRing.ring;
+    auto generation = _stringsGeneration.load(std::memory_order_acquire);
+    if (ring.stringsGeneration != generation) {
+        ring.strings.clear();
+        ring.categories.clear();
+        ring.stringsGeneration = generation;
+    }
+    return ring;
+}
+
+void Tracer::resetStrings() {
+    std::lock_guard<std::mutex> guard(_stringsMutex);
+    _stringIndices.clear();
+    _strings.clear();
+    // index 0 is the empty string
+    _strings.push_back(QString());
+    ++_stringsGeneration;
+}
+
+uint32_t Tracer::intern(const QString& string) {
+    if (string.isEmpty()) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> guard(_stringsMutex);
+    auto it = _stringIndices.constFind(string);
+    if (it != _stringIndices.constEnd()) {
+        return it.value();
+    }
+    uint32_t index = (uint32_t)_strings.size();
+    _strings.push_back(string);
+    _stringIndices.insert(string, index);
+    return index;
+}
+
+uint32_t Tracer::intern(TraceRing& ring, const QString& string) {
+    if (string.isEmpty()) {
+        return 0;
+    }
+
+    auto it = ring.strings.constFind(string);
+    if (it != ring.strings.constEnd()) {
+        return it.value();
+    }
+    uint32_t index = intern(string);
+    ring.strings.insert(string, index);
+    return index;
+}
+
+uint32_t Tracer::intern(TraceRing& ring, const QLoggingCategory& category) {
+    auto it = ring.categories.constFind(&category);
+    if (it != ring.categories.constEnd()) {
+        return it.value();
+    }
+    uint32_t index = intern(QString::fromLatin1(category.categoryName()));
+    ring.categories.insert(&category, index);
+    return index;
+}
+
+void Tracer::push(TraceRing& ring, const TraceRecord& record) {
+    if (!ring.push(record)) {
+        ++_numDroppedEvents;
     }
-    out << QJsonDocument(ev).toJson(QJsonDocument::Compact);
-#endif
 }
 
 void Tracer::serialize(const QString& originalPath) {
@@ -126,75 +616,66 @@ void Tracer::serialize(const QString& originalPath) {
         }
     }
 
-
-
-    std::list<TraceEvent> currentEvents;
-    {
-        std::lock_guard<std::mutex> guard(_eventsMutex);
-        currentEvents.swap(_events);
-        for (auto& event : _metadataEvents) {
-            currentEvents.push_back(event);
-        }
+    if (_numDroppedEvents > 0) {
+        qWarning() << "Tracer dropped" << _numDroppedEvents << "events recorded faster than they were flushed";
     }
 
-    // If the file exists and we can't remove it, fail early
-    if (QFileInfo(path).exists() && !QFile::remove(path)) {
-        return;
-    }
+    TraceData data;
+    data.processID = QCoreApplication::applicationPid();
 
-    // If we can't open a temp file for writing, fail early
-    QByteArray data;
+    drainRings();
     {
-        QTextStream out(&data);
-        out << "[\n";
-        bool first = true;
-        for (const auto& event : currentEvents) {
-            if (first) {
-                first = false;
-            } else {
-                out << ",\n";
-            }
-            event.writeJson(out);
+        std::lock_guard<std::mutex> guard(_drainMutex);
+        for (auto& entry : _records) {
+            data.threads.push_back({ entry.first, std::move(entry.second) });
         }
-        out << "\n]";
+        _records.clear();
     }
 
-    if (path.endsWith(".gz")) {
-        QByteArray compressed;
-        gzip(data, compressed);
-        data = compressed;
-    } 
-    
+    std::list<TraceEvent> metadataEvents;
     {
-        QFile file(path);
-        if (!file.open(QIODevice::WriteOnly)) {
-            return;
+        std::lock_guard<std::mutex> guard(_metadataMutex);
+        metadataEvents.insert(metadataEvents.end(), _metadataEvents.begin(), _metadataEvents.end());
+    }
+    for (const auto& event : metadataEvents) {
+        TraceRecord record = {};
+        record.timestamp = event.timestamp;
+        record.type = event.type;
+        record.name = intern(event.name);
+        record.category = intern(QString::fromLatin1(event.category.categoryName()));
+        auto internString = [this](const QString& string) { return intern(string); };
+        setID(record, event.id, internString);
+        setArgs(record, event.args, event.extra, internString, internString);
+
+        auto thread = std::find_if(data.threads.begin(), data.threads.end(), [&](const TraceThread& thread) {
+            return thread.threadID == event.threadID;
+        });
+        if (thread == data.threads.end()) {
+            thread = data.threads.insert(data.threads.end(), TraceThread { event.threadID, {} });
         }
-        file.write(data);
-        file.close();
+        thread->records.push_back(record);
     }
 
-#if 0
-    QByteArray data;
     {
+        std::lock_guard<std::mutex> guard(_stringsMutex);
+        data.strings = _strings;
+    }
 
-        // "traceEvents":[
-        // {"args":{"nv_payload":0},"cat":"hifi.render","name":"render::Scene::processPendingChangesQueue","ph":"B","pid":14796,"tid":21636,"ts":68795933487}
-
-        QJsonArray traceEvents;
+    // drop the odd event whose strings were interned by a thread into the table of a previous trace
+    const uint32_t numStrings = (uint32_t)data.strings.size();
+    for (auto& thread : data.threads) {
+        thread.records.erase(std::remove_if(thread.records.begin(), thread.records.end(), [&](const TraceRecord& record) {
+            return !isValidRecord(record, numStrings);
+        }), thread.records.end());
+    }
 
-        QJsonDocument document {
-            QJsonObject {
-                { "traceEvents", traceEvents },
-                { "otherData", QJsonObject {
-                    { "version", QString { "High Fidelity Interface v1.0" } +BuildInfo::VERSION }
-                } }
-            }
-        };
-        
-        data = document.toJson(QJsonDocument::Compact);
+    QByteArray bytes;
+    if (path.endsWith(BINARY_TRACE_EXTENSION)) {
+        writeBinaryTrace(data, bytes);
+    } else {
+        writeJsonTrace(data, bytes);
     }
-#endif
+    writeTraceFile(path, bytes);
 }
 
 void Tracer::traceEvent(const QLoggingCategory& category,
@@ -202,54 +683,66 @@ void Tracer::traceEvent(const QLoggingCategory& category,
     qint64 timestamp, qint64 processID, qint64 threadID,
     const QString& id,
     const QVariantMap& args, const QVariantMap& extra) {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
 
     // We always want to store metadata events even if tracing is not enabled so that when
     // tracing is enabled we will be able to associate that metadata with that trace.
     // Metadata events should be used sparingly - as of 12/30/16 the Chrome Tracing
     // spec only supports thread+process metadata, so we should only expect to see metadata
     // events created when a new thread or process is created.
-    if (!_enabled && type != Metadata) {
-        return;
-    }
-
-    if (type == Metadata) {
-        _metadataEvents.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
-    } else {
-        _events.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
-    }
+    std::lock_guard<std::mutex> guard(_metadataMutex);
+    _metadataEvents.push_back({
+        id,
+        name,
+        type,
+        timestamp,
+        processID,
+        threadID,
+        category,
+        args,
+        extra
+    });
 }
 
 void Tracer::traceEvent(const QLoggingCategory& category, 
     const QString& name, EventType type, const QString& id, 
     const QVariantMap& args, const QVariantMap& extra) {
-    if (!_enabled && type != Metadata) {
+    if (type == Metadata) {
+        auto processID = QCoreApplication::applicationPid();
+        auto threadID = int64_t(QThread::currentThreadId());
+        traceEvent(category, name, type, getTimestamp(), processID, threadID, id, args, extra);
         return;
     }
+    if (!_enabled) {
+        return;
+    }
+
+    auto& ring = getRing();
+    TraceRecord record = {};
+    record.timestamp = getTimestamp();
+    record.type = type;
+    record.name = intern(ring, name);
+    record.category = intern(ring, category);
+    // ids and string values are mostly unique, so they are interned without filling the cache of the ring
+    auto internString = [this](const QString& string) { return intern(string); };
+    setID(record, id, internString);
+    setArgs(record, args, extra, [&](const QString& string) { return intern(ring, string); }, internString);
+    push(ring, record);
+}
 
-    auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
-    auto processID = QCoreApplication::applicationPid();
-    auto threadID = int64_t(QThread::currentThreadId());
+void Tracer::traceEvent(const QLoggingCategory& category, const QString& name, EventType type,
+    const QString& argName, double argValue) {
+    if (!_enabled) {
+        return;
+    }
 
-    traceEvent(category, name, type, timestamp, processID, threadID, id, args, extra);
+    auto& ring = getRing();
+    TraceRecord record = {};
+    record.timestamp = getTimestamp();
+    record.type = type;
+    record.name = intern(ring, name);
+    record.category = intern(ring, category);
+    record.numArgs = 1;
+    record.argNames[0] = intern(ring, argName);
+    record.argValues[0] = argValue;
+    push(ring, record);
 }
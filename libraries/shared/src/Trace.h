@@ -10,13 +10,21 @@
 #ifndef hifi_Trace_h
 #define hifi_Trace_h
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <QtCore/QString>
 #include <QtCore/QVariantMap>
 #include <QtCore/QHash>
 #include <QtCore/QSet>
+#include <QtCore/QVector>
 #include <QtCore/QLoggingCategory>
 
 #include "DependencyManager.h"
@@ -62,6 +70,9 @@ enum EventType : char {
     ContextLeave = ')'
 };
 
+// Binary traces are written by Tracer::serialize() for paths with this extension, JSON traces otherwise
+const QString BINARY_TRACE_EXTENSION = ".hftrace";
+
 struct TraceEvent {
     QString id;
     QString name;
@@ -72,21 +83,52 @@ struct TraceEvent {
     const QLoggingCategory& category;
     QVariantMap args;
     QVariantMap extra;
+};
+
+// A fixed-size event, as recorded and as written to binary traces.
+// Strings are indices into the string table of the tracer, 0 being the empty string.
+struct TraceRecord {
+    static const int MAX_ARGS = 4;
 
-    void writeJson(QTextStream& out) const;
+    TraceTimestamp timestamp;
+    uint64_t id; // the id itself if numericID is set, a string index otherwise
+    uint32_t name;
+    uint32_t category;
+    EventType type;
+    uint8_t numericID;
+    uint8_t numArgs;
+    uint8_t stringArgs; // bit per arg, set if its value is a string index rather than a number
+    uint8_t extraArgs; // bit per arg, set if it belongs at the top level of the event rather than in its args
+    uint32_t argNames[MAX_ARGS];
+    double argValues[MAX_ARGS];
 };
 
+class TraceRing;
+
+// Events are recorded without locks into a ring buffer per thread, and moved out of the rings by a flusher thread
+// while tracing. Names, categories and arg names are interned and cached by each thread, so only their first use by
+// a thread takes a lock. Numeric ids are stored as is, other ids and string arg values are interned without being
+// cached. The string table only holds the strings of the current trace, it is reset by startTracing().
+// Events are dropped, and counted, if a thread outpaces the flusher.
 class Tracer : public Dependency {
 public:
+    Tracer();
+    ~Tracer();
+
     void traceEvent(const QLoggingCategory& category, 
         const QString& name, EventType type,
         const QString& id = "", 
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
+    // records an event with a single numeric arg, without building a QVariantMap
+    void traceEvent(const QLoggingCategory& category, const QString& name, EventType type,
+        const QString& argName, double argValue);
+
     void startTracing();
     void stopTracing();
     void serialize(const QString& file);
     bool isEnabled() const { return _enabled; }
+    uint64_t getNumDroppedEvents() const { return _numDroppedEvents; }
 
 private:
     void traceEvent(const QLoggingCategory& category, 
@@ -95,12 +137,45 @@ private:
         const QString& id = "",
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
-    bool _enabled { false };
-    std::list<TraceEvent> _events;
+    TraceRing& getRing();
+    void resetStrings();
+    uint32_t intern(const QString& string);
+    uint32_t intern(TraceRing& ring, const QString& string);
+    uint32_t intern(TraceRing& ring, const QLoggingCategory& category);
+    void push(TraceRing& ring, const TraceRecord& record);
+
+    void startFlusher();
+    void stopFlusher();
+    void drainRings(bool keepRecords = true);
+
+    const uint64_t _serial;
+    std::atomic<bool> _enabled { false };
+    std::atomic<uint64_t> _numDroppedEvents { 0 };
+    std::mutex _stateMutex;
+
     std::list<TraceEvent> _metadataEvents;
-    std::mutex _eventsMutex;
+    std::mutex _metadataMutex;
+
+    QHash<QString, uint32_t> _stringIndices; // guarded by _stringsMutex
+    QVector<QString> _strings; // guarded by _stringsMutex
+    std::mutex _stringsMutex;
+    std::atomic<uint32_t> _stringsGeneration { 0 }; // bumped on reset, to invalidate the string caches of the rings
+
+    std::vector<std::shared_ptr<TraceRing>> _rings; // guarded by _ringsMutex
+    std::mutex _ringsMutex;
+
+    std::unordered_map<qint64, std::vector<TraceRecord>> _records; // by thread, guarded by _drainMutex
+    std::mutex _drainMutex;
+
+    std::thread _flusher;
+    bool _stopFlusher { false }; // guarded by _flusherMutex
+    std::mutex _flusherMutex;
+    std::condition_variable _flusherCondition;
 };
 
+// Converts a binary trace to the Chrome JSON format, gzipped if the output path ends in .gz
+bool convertTrace(const QString& binaryPath, const QString& jsonPath);
+
 inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, const QString& id = "", const QVariantMap& args = {}, const QVariantMap& extra = {}) {
     const auto& tracer = DependencyManager::get<Tracer>();
     if (tracer) {
@@ -112,6 +187,13 @@ inline void traceEvent(const QLoggingCategory& category, const QString& name, Ev
     traceEvent(category, name, type, QString::number(id), args, extra);
 }
 
+inline void traceEvent(const QLoggingCategory& category, const QString& name, EventType type, const QString& argName, double argValue) {
+    const auto& tracer = DependencyManager::get<Tracer>();
+    if (tracer) {
+        tracer->traceEvent(category, name, type, argName, argValue);
+    }
+}
+
 }
 
 #endif // hifi_Trace_h
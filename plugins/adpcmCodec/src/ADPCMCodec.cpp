@@ -0,0 +1,100 @@
+//
+//  ADPCMCodec.cpp
+//  plugins/adpcmCodec/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <AudioADPCM.h>
+#include <AudioConstants.h>
+
+#include "ADPCMCodec.h"
+
+const char* ADPCMCodec::NAME { "adpcm" };
+
+void ADPCMCodec::init() {
+}
+
+void ADPCMCodec::deinit() {
+}
+
+bool ADPCMCodec::activate() {
+    CodecPlugin::activate();
+    return true;
+}
+
+void ADPCMCodec::deactivate() {
+    CodecPlugin::deactivate();
+}
+
+bool ADPCMCodec::isSupported() const {
+    return true;
+}
+
+class ADPCMEncoder : public Encoder, public AudioADPCMEncoder {
+public:
+    ADPCMEncoder(int numChannels) : AudioADPCMEncoder(numChannels) {
+        _encodedSize = AudioADPCM::getEncodedSize(numChannels, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+
+    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
+        encodedBuffer.resize(_encodedSize);
+        AudioADPCMEncoder::encode((const int16_t*)decodedBuffer.constData(), (uint8_t*)encodedBuffer.data(),
+                                  AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+private:
+    int _encodedSize;
+};
+
+class ADPCMDecoder : public Decoder, public AudioADPCMDecoder {
+public:
+    ADPCMDecoder(int numChannels) : AudioADPCMDecoder(numChannels) {
+        _encodedSize = AudioADPCM::getEncodedSize(numChannels, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        _decodedSize = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * sizeof(int16_t) * numChannels;
+    }
+
+    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
+        if (encodedBuffer.size() != _encodedSize) {
+            // truncated or foreign payload, treat it as lost
+            lostFrame(decodedBuffer);
+            return;
+        }
+        decodedBuffer.resize(_decodedSize);
+        AudioADPCMDecoder::decode((const uint8_t*)encodedBuffer.constData(), (int16_t*)decodedBuffer.data(),
+                                  AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+
+    virtual void lostFrame(QByteArray& decodedBuffer) override {
+        // frames are coded independently, so there is no decoder state to conceal
+        decodedBuffer.resize(_decodedSize);
+        memset(decodedBuffer.data(), 0, decodedBuffer.size());
+    }
+private:
+    int _encodedSize;
+    int _decodedSize;
+};
+
+Encoder* ADPCMCodec::createEncoder(int sampleRate, int numChannels) {
+    if (!AudioADPCM::isValidChannelCount(numChannels)) {
+        return nullptr;
+    }
+    return new ADPCMEncoder(numChannels);
+}
+
+Decoder* ADPCMCodec::createDecoder(int sampleRate, int numChannels) {
+    if (!AudioADPCM::isValidChannelCount(numChannels)) {
+        return nullptr;
+    }
+    return new ADPCMDecoder(numChannels);
+}
+
+void ADPCMCodec::releaseEncoder(Encoder* encoder) {
+    delete encoder;
+}
+
+void ADPCMCodec::releaseDecoder(Decoder* decoder) {
+    delete decoder;
+}
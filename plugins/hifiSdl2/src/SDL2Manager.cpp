@@ -128,7 +128,7 @@ void SDL2Manager::pluginUpdate(float deltaTime, const controller::InputCalibrati
             joystick->update(deltaTime, inputCalibrationData);
         }
         
-        PerformanceTimer perfTimer("SDL2Manager::update");
+        PERFORMANCE_TIMER("SDL2Manager::update");
         SDL_GameControllerUpdate();
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
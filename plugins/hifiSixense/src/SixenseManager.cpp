@@ -180,7 +180,7 @@ void SixenseManager::InputDevice::update(float deltaTime, const controller::Inpu
         disconnectedInterval = 0.0f;
     }
 
-    PerformanceTimer perfTimer("sixense");
+    PERFORMANCE_TIMER("sixense");
     // FIXME send this message once when we've positively identified hydra hardware
     //UserActivityLogger::getInstance().connectedDevice("spatial_controller", "hydra");
 
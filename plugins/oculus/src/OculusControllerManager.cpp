@@ -83,7 +83,7 @@ void OculusControllerManager::deactivate() {
 }
 
 void OculusControllerManager::pluginUpdate(float deltaTime, const controller::InputCalibrationData& inputCalibrationData) {
-    PerformanceTimer perfTimer("OculusControllerManager::TouchDevice::update");
+    PERFORMANCE_TIMER("OculusControllerManager::TouchDevice::update");
 
     if (_touch) {
         if (OVR_SUCCESS(ovr_GetInputState(_session, ovrControllerType_Touch, &_inputState))) {
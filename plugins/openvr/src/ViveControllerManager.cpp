@@ -146,7 +146,7 @@ void ViveControllerManager::deactivate() {
 }
 
 void ViveControllerManager::updateRendering(RenderArgs* args, render::ScenePointer scene, render::PendingChanges pendingChanges) {
-    PerformanceTimer perfTimer("ViveControllerManager::updateRendering");
+    PERFORMANCE_TIMER("ViveControllerManager::updateRendering");
 
     /*
     if (_modelLoaded) {
@@ -249,7 +249,7 @@ void ViveControllerManager::InputDevice::update(float deltaTime, const controlle
         return;
     }
 
-    PerformanceTimer perfTimer("ViveControllerManager::update");
+    PERFORMANCE_TIMER("ViveControllerManager::update");
 
     auto leftHandDeviceIndex = _system->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_LeftHand);
     auto rightHandDeviceIndex = _system->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_RightHand);
@@ -182,6 +182,29 @@ Item {
             ]
         }  
 
+        PlotPerf {
+            title: "Batch Storage"
+            height: parent.evalEvenHeight()
+            object: stats.config
+            plots: [
+                {
+                    prop: "frameBatchCount",
+                    label: "Batches",
+                    color: "#00B4EF"
+                },
+                {
+                    prop: "frameBatchAllocationCount",
+                    label: "Allocated",
+                    color: "#E2334D"
+                },
+                {
+                    prop: "batchPoolCount",
+                    label: "Pooled",
+                    color: "#1AC567"
+                }
+            ]
+        }
+
         property var drawOpaqueConfig: Render.getConfig("DrawOpaqueDeferred")
         property var drawTransparentConfig: Render.getConfig("DrawTransparentDeferred")
         property var drawLightConfig: Render.getConfig("DrawLight")
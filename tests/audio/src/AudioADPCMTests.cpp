@@ -0,0 +1,173 @@
+//
+//  AudioADPCMTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioADPCMTests.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include <AudioADPCM.h>
+#include <AudioConstants.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioADPCMTests)
+
+static const int FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+static const int NUM_TEST_FRAMES = 100;
+
+// tone plus noise, with a different pitch per channel
+static void generateFrame(int16_t* output, int numChannels, int frameIndex, float noise) {
+    for (int i = 0; i < FRAMES; i++) {
+        float t = (float)(frameIndex * FRAMES + i) / AudioConstants::SAMPLE_RATE;
+        for (int c = 0; c < numChannels; c++) {
+            float x = 0.4f * sinf(TWO_PI * (440.0f + 110.0f * c) * t);
+            x += noise * ((float)rand() / RAND_MAX - 0.5f);
+            output[i * numChannels + c] = (int16_t)(x * AudioConstants::MAX_SAMPLE_VALUE);
+        }
+    }
+}
+
+// signal-to-noise ratio of a full encode/decode round trip, in dB
+static float measureSNR(int numChannels, float noise) {
+    AudioADPCMEncoder encoder(numChannels);
+    AudioADPCMDecoder decoder(numChannels);
+
+    std::vector<int16_t> input(FRAMES * numChannels);
+    std::vector<int16_t> output(FRAMES * numChannels);
+    std::vector<uint8_t> encoded(AudioADPCM::getEncodedSize(numChannels, FRAMES));
+
+    double signalPower = 0.0;
+    double noisePower = 0.0;
+    for (int f = 0; f < NUM_TEST_FRAMES; f++) {
+        generateFrame(input.data(), numChannels, f, noise);
+        encoder.encode(input.data(), encoded.data(), FRAMES);
+        decoder.decode(encoded.data(), output.data(), FRAMES);
+
+        for (size_t i = 0; i < input.size(); i++) {
+            double error = input[i] - output[i];
+            signalPower += (double)input[i] * input[i];
+            noisePower += error * error;
+        }
+    }
+    return (float)(10.0 * log10(signalPower / std::max(noisePower, 1.0)));
+}
+
+void AudioADPCMTests::testEncodedSize() {
+    // 4 bits per sample, plus a fixed per-frame header
+    int pcmSize = FRAMES * AudioConstants::STEREO * sizeof(int16_t);
+    int encodedSize = AudioADPCM::getEncodedSize(AudioConstants::STEREO, FRAMES);
+    qDebug() << "stereo frame:" << pcmSize << "bytes PCM," << encodedSize << "bytes ADPCM, ratio" << (float)pcmSize / encodedSize;
+    QVERIFY(encodedSize * 4 >= pcmSize);
+    QVERIFY(encodedSize * 3 < pcmSize);
+
+    QVERIFY(AudioADPCM::isValidChannelCount(AudioConstants::MONO));
+    QVERIFY(AudioADPCM::isValidChannelCount(AudioConstants::STEREO));
+    QVERIFY(AudioADPCM::isValidChannelCount(AudioConstants::AMBISONIC));
+    QVERIFY(!AudioADPCM::isValidChannelCount(3));
+}
+
+void AudioADPCMTests::testSilence() {
+    AudioADPCMEncoder encoder(AudioConstants::STEREO);
+    AudioADPCMDecoder decoder(AudioConstants::STEREO);
+
+    int16_t input[FRAMES * AudioConstants::STEREO] {};
+    int16_t output[FRAMES * AudioConstants::STEREO];
+    std::vector<uint8_t> encoded(AudioADPCM::getEncodedSize(AudioConstants::STEREO, FRAMES));
+
+    // silence must stay silent (no limit cycles), even after a loud frame has raised the step size
+    generateFrame(input, AudioConstants::STEREO, 0, 1.0f);
+    encoder.encode(input, encoded.data(), FRAMES);
+    memset(input, 0, sizeof(input));
+    for (int f = 0; f < 4; f++) {
+        encoder.encode(input, encoded.data(), FRAMES);
+    }
+    decoder.decode(encoded.data(), output, FRAMES);
+    for (int i = 0; i < FRAMES * AudioConstants::STEREO; i++) {
+        QVERIFY(abs(output[i]) <= 1);
+    }
+}
+
+void AudioADPCMTests::testQuality() {
+    float toneSNR = measureSNR(AudioConstants::STEREO, 0.0f);
+    float noisySNR = measureSNR(AudioConstants::STEREO, 0.2f);
+    float monoSNR = measureSNR(AudioConstants::MONO, 0.0f);
+    qDebug() << "SNR: tone" << toneSNR << "dB, tone+noise" << noisySNR << "dB, mono" << monoSNR << "dB";
+
+    // IMA-style ADPCM is good for ~30dB on narrowband material
+    QVERIFY(toneSNR > 25.0f);
+    QVERIFY(noisySNR > 20.0f);
+    QVERIFY(monoSNR > 25.0f);
+}
+
+void AudioADPCMTests::testIndependentFrames() {
+    // a frame must decode identically regardless of what the decoder saw before (packet loss)
+    AudioADPCMEncoder encoder(AudioConstants::STEREO);
+    AudioADPCMDecoder decoder0(AudioConstants::STEREO);
+    AudioADPCMDecoder decoder1(AudioConstants::STEREO);
+
+    int16_t input[FRAMES * AudioConstants::STEREO];
+    int16_t output0[FRAMES * AudioConstants::STEREO];
+    int16_t output1[FRAMES * AudioConstants::STEREO];
+    std::vector<uint8_t> encoded(AudioADPCM::getEncodedSize(AudioConstants::STEREO, FRAMES));
+
+    for (int f = 0; f < 10; f++) {
+        generateFrame(input, AudioConstants::STEREO, f, 0.1f);
+        encoder.encode(input, encoded.data(), FRAMES);
+        if (f % 3 != 0) {
+            decoder0.decode(encoded.data(), output0, FRAMES);
+        }
+    }
+    decoder0.decode(encoded.data(), output0, FRAMES);
+    decoder1.decode(encoded.data(), output1, FRAMES);
+    QVERIFY(memcmp(output0, output1, sizeof(output0)) == 0);
+}
+
+void AudioADPCMTests::testThroughput() {
+    const int LOOPS = 100000;
+
+    AudioADPCMEncoder encoder(AudioConstants::STEREO);
+    AudioADPCMDecoder decoder(AudioConstants::STEREO);
+
+    int16_t input[FRAMES * AudioConstants::STEREO];
+    int16_t output[FRAMES * AudioConstants::STEREO];
+    std::vector<uint8_t> encoded(AudioADPCM::getEncodedSize(AudioConstants::STEREO, FRAMES));
+    generateFrame(input, AudioConstants::STEREO, 0, 0.1f);
+
+    {
+        // baseline, the "pcm" codec is a copy in each direction
+        std::vector<uint8_t> pcm(sizeof(input));
+        auto start = usecTimestampNow();
+        for (int i = 0; i < LOOPS; i++) {
+            memcpy(pcm.data(), input, sizeof(input));
+            memcpy(output, pcm.data(), sizeof(output));
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "PCM:" << (float)duration / LOOPS << "usecs per stereo frame";
+    }
+    {
+        auto start = usecTimestampNow();
+        for (int i = 0; i < LOOPS; i++) {
+            encoder.encode(input, encoded.data(), FRAMES);
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "ADPCM encode:" << (float)duration / LOOPS << "usecs per stereo frame";
+    }
+    {
+        auto start = usecTimestampNow();
+        for (int i = 0; i < LOOPS; i++) {
+            decoder.decode(encoded.data(), output, FRAMES);
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "ADPCM decode:" << (float)duration / LOOPS << "usecs per stereo frame";
+    }
+}
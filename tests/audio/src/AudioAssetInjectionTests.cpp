@@ -0,0 +1,77 @@
+//
+//  AudioAssetInjectionTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioAssetInjectionTests.h"
+
+#include <AudioAssetInjection.h>
+
+QTEST_MAIN(AudioAssetInjectionTests)
+
+static const QString HASH = "b1ca3b2d4f1e2bd8e4c4ee7cc3fbcb76b7ac2d3a65eaa4b5d63d4c8f05a1a2c3";
+
+void AudioAssetInjectionTests::testUrlForSound() {
+    QCOMPARE(AudioAssetInjection::urlForSound(HASH), QUrl("atp:" + HASH + ".wav"));
+    QCOMPARE(AudioAssetInjection::urlForSound("atp:" + HASH + ".mp3"), QUrl("atp:" + HASH + ".mp3"));
+
+    // anything else is dropped on the client already
+    QVERIFY(AudioAssetInjection::urlForSound("http://example.com/sound.wav").isEmpty());
+    QVERIFY(AudioAssetInjection::urlForSound("not a hash").isEmpty());
+    QVERIFY(AudioAssetInjection::urlForSound("").isEmpty());
+}
+
+void AudioAssetInjectionTests::testRejectedURLs() {
+    QVERIFY(AudioAssetInjection::isPermittedURL(QUrl("atp:" + HASH)));
+    QVERIFY(AudioAssetInjection::isPermittedURL(QUrl("atp:" + HASH + ".wav")));
+
+    const QStringList REJECTED {
+        "file:///etc/passwd",
+        "file:" + HASH + ".wav",
+        "http://127.0.0.1:40100/status",
+        "https://example.com/" + HASH + ".wav",
+        "ftp://example.com/" + HASH,
+        "data:audio/wav;base64,UklGRg==",
+        "qrc:/sounds/" + HASH + ".wav",
+        "atp:/sounds/doorbell.wav",
+        "atp://localhost/" + HASH + ".wav",
+        "atp:" + HASH + ".wav?x=1",
+        "atp:" + HASH + ".wav#fragment",
+        "atp:" + HASH + "./../secret",
+        "atp:" + HASH.left(63),
+        "atp:",
+        ""
+    };
+    for (auto& url : REJECTED) {
+        if (AudioAssetInjection::isPermittedURL(QUrl(url))) {
+            QFAIL(qPrintable("permitted " + url));
+        }
+    }
+}
+
+void AudioAssetInjectionTests::testPermissions() {
+    NodePermissions canRezTmp;
+    canRezTmp.set(NodePermissions::Permission::canRezTemporaryEntities);
+
+    NodePermissions canRez;
+    canRez.set(NodePermissions::Permission::canConnectToDomain);
+    canRez.set(NodePermissions::Permission::canRezPermanentEntities);
+
+    AudioAssetInjection play(QUuid::createUuid(), QUrl("atp:" + HASH + ".wav"), AudioInjectorOptions());
+    QVERIFY(play.isPermittedFor(canRezTmp));
+    QVERIFY(!play.isPermittedFor(canRez));
+    QVERIFY(!play.isPermittedFor(NodePermissions()));
+
+    // the permission does not open up other URLs
+    AudioAssetInjection local(QUuid::createUuid(), QUrl("file:///etc/passwd"), AudioInjectorOptions());
+    QVERIFY(!local.isPermittedFor(canRezTmp));
+
+    // anyone can stop their own sounds
+    auto stop = AudioAssetInjection::stop(play.injectorID);
+    QVERIFY(stop.isPermittedFor(NodePermissions()));
+}
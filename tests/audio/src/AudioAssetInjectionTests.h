@@ -0,0 +1,24 @@
+//
+//  AudioAssetInjectionTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioAssetInjectionTests_h
+#define hifi_AudioAssetInjectionTests_h
+
+#include <QtTest/QtTest>
+
+class AudioAssetInjectionTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testUrlForSound();
+    void testRejectedURLs();
+    void testPermissions();
+};
+
+#endif // hifi_AudioAssetInjectionTests_h
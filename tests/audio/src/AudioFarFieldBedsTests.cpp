@@ -0,0 +1,68 @@
+//
+//  AudioFarFieldBedsTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioFarFieldBedsTests.h"
+
+#include <random>
+
+#include <AudioFarFieldBeds.h>
+
+QTEST_MAIN(AudioFarFieldBedsTests)
+
+void AudioFarFieldBedsTests::testCells() {
+    const float CELL_SIZE = 10.0f;
+    AudioFarFieldBeds beds;
+    beds.setCellSize(CELL_SIZE);
+
+    QCOMPARE(beds.getCell(glm::vec3(0.0f)), glm::ivec3(0));
+    QCOMPARE(beds.getCell(glm::vec3(9.99f, 0.0f, 0.0f)), glm::ivec3(0));
+    QCOMPARE(beds.getCell(glm::vec3(10.0f, -0.01f, -10.0f)), glm::ivec3(1, -1, -1));
+    QCOMPARE(beds.getCellCenter(glm::ivec3(1, -1, 0)), glm::vec3(15.0f, -5.0f, 5.0f));
+}
+
+void AudioFarFieldBedsTests::testMinFarFieldDistance() {
+    const float CELL_SIZE = 10.0f;
+    const float MIN_DISTANCE = AudioFarFieldBeds::getMinFarFieldDistance(CELL_SIZE);
+    QVERIFY(fabsf(MIN_DISTANCE - 18.660254f) < 0.0001f);
+
+    AudioFarFieldBeds beds;
+    beds.setCellSize(CELL_SIZE);
+    beds.setFarFieldDistance(MIN_DISTANCE);
+
+    const glm::ivec3 CELL(2, 0, -3);
+    const glm::vec3 CENTER = beds.getCellCenter(CELL);
+    const float HALF_CELL = CELL_SIZE / 2.0f;
+
+    // the worst case: a listener in a corner of the cell, and a source just past the far-field distance
+    // in the direction of that corner
+    glm::vec3 corner = CENTER + glm::vec3(HALF_CELL);
+    glm::vec3 direction = glm::normalize(corner - CENTER);
+    glm::vec3 source = CENTER + direction * (MIN_DISTANCE + 0.001f);
+    QVERIFY(beds.isFarField(CENTER, source));
+    QVERIFY(glm::distance(corner, source) >= CELL_SIZE);
+
+    // with the previous clamp to one cell size the same source would be within a cell of the listener
+    glm::vec3 closeSource = CENTER + direction * (CELL_SIZE + 0.001f);
+    QVERIFY(glm::distance(corner, closeSource) < CELL_SIZE);
+
+    // any listener in the cell is at least a cell away from any far-field source
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> inCell(-0.999f * HALF_CELL, 0.999f * HALF_CELL);
+    std::normal_distribution<float> gaussian;
+    for (int i = 0; i < 10000; ++i) {
+        glm::vec3 listener = CENTER + glm::vec3(inCell(generator), inCell(generator), inCell(generator));
+        QCOMPARE(beds.getCell(listener), CELL);
+
+        glm::vec3 randomDirection = glm::normalize(glm::vec3(gaussian(generator), gaussian(generator), gaussian(generator)));
+        glm::vec3 farSource = CENTER + randomDirection * (MIN_DISTANCE + 0.001f);
+        QVERIFY(beds.isFarField(CENTER, farSource));
+        QVERIFY(glm::distance(listener, farSource) >= CELL_SIZE);
+    }
+}
@@ -0,0 +1,23 @@
+//
+//  AudioFarFieldBedsTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioFarFieldBedsTests_h
+#define hifi_AudioFarFieldBedsTests_h
+
+#include <QtTest/QtTest>
+
+class AudioFarFieldBedsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testCells();
+    void testMinFarFieldDistance();
+};
+
+#endif // hifi_AudioFarFieldBedsTests_h
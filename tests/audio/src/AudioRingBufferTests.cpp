@@ -125,3 +125,56 @@ void AudioRingBufferTests::runAllTests() {
         assertBufferSize(ringBuffer, 0);
     }
 }
+
+void AudioRingBufferTests::testWrappedCopies() {
+
+    const int FRAME_SAMPLES = 10;
+    int16_t writeData[100];
+    for (int i = 0; i < 100; i++) { writeData[i] = (i % 2) ? -100 * i : 100 * i; }
+
+    // moves the (empty) buffer's read and write positions forward
+    auto advance = [](AudioRingBuffer& buffer, int numSamples) {
+        while (numSamples > 0) {
+            int n = std::min(numSamples, 20);
+            buffer.addSilentSamples(n);
+            buffer.skipSamples(n);
+            numSamples -= n;
+        }
+    };
+
+    // every offset of the source and destination against the wrap, including none
+    for (int sourceOffset = 0; sourceOffset < 40; sourceOffset++) {
+        for (int destOffset = 0; destOffset < 40; destOffset++) {
+            AudioRingBuffer source(FRAME_SAMPLES, 3); // buffer of 40 samples, holds 30
+            AudioRingBuffer dest(FRAME_SAMPLES, 3);
+            advance(source, sourceOffset);
+            advance(dest, destOffset);
+
+            source.writeSamples(writeData, 25);
+
+            // loudness of the next frame, which may wrap
+            float loudness = 0.0f;
+            for (int i = 0; i < FRAME_SAMPLES; i++) {
+                loudness += (float)std::abs(writeData[i]);
+            }
+            loudness /= FRAME_SAMPLES * AudioConstants::MAX_SAMPLE_VALUE;
+            QCOMPARE(source.getNextOutputFrameLoudness(), loudness);
+
+            // plain copy
+            int16_t readData[30];
+            QCOMPARE(dest.writeSamples(source.nextOutput(), 25), 25);
+            QCOMPARE(dest.readSamples(readData, 30), 25);
+            for (int i = 0; i < 25; i++) {
+                QCOMPARE(readData[i], writeData[i]);
+            }
+
+            // faded copy, truncated as a cast
+            const float FADE = 0.3f;
+            QCOMPARE(dest.writeSamplesWithFade(source.nextOutput(), 25, FADE), 25);
+            QCOMPARE(dest.readSamples(readData, 30), 25);
+            for (int i = 0; i < 25; i++) {
+                QCOMPARE(readData[i], (int16_t)((float)writeData[i] * FADE));
+            }
+        }
+    }
+}
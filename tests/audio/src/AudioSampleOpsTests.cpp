@@ -0,0 +1,208 @@
+//
+//  AudioSampleOpsTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSampleOpsTests.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <AudioConstants.h>
+#include <AudioSampleOps.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioSampleOpsTests)
+
+// lengths and offsets that cover every SIMD tail, and unaligned buffers
+static const int MAX_TEST_SAMPLES = 67;
+static const int MAX_TEST_OFFSET = 3;
+
+static std::vector<int16_t> randomSamples(int numSamples) {
+    std::vector<int16_t> samples(numSamples);
+    for (auto& sample : samples) {
+        sample = (int16_t)(rand() % 65536 - 32768);
+    }
+    // always include the extremes
+    samples[0] = -32768;
+    samples[numSamples - 1] = 32767;
+    return samples;
+}
+
+static std::vector<float> randomFloats(int numSamples, float range) {
+    std::vector<float> samples(numSamples);
+    for (auto& sample : samples) {
+        sample = range * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    return samples;
+}
+
+void AudioSampleOpsTests::testConvertInt16ToFloat() {
+    const float SCALE = 1.0f / AudioConstants::MAX_SAMPLE_VALUE;
+    for (int n = 0; n <= MAX_TEST_SAMPLES; n++) {
+        for (int offset = 0; offset <= MAX_TEST_OFFSET; offset++) {
+            auto input = randomSamples(n + offset + 1);
+            std::vector<float> output(n + 1, -1.0f);
+
+            convertInt16ToFloat(&input[offset], output.data(), n, SCALE);
+            for (int i = 0; i < n; i++) {
+                QCOMPARE(output[i], (float)input[offset + i] * SCALE);
+            }
+            QCOMPARE(output[n], -1.0f); // no overrun
+        }
+    }
+}
+
+void AudioSampleOpsTests::testConvertFloatToInt16() {
+    const float SCALE = (float)AudioConstants::MAX_SAMPLE_VALUE;
+    for (int n = 0; n <= MAX_TEST_SAMPLES; n++) {
+        for (int offset = 0; offset <= MAX_TEST_OFFSET; offset++) {
+            // out of range, to exercise clipping
+            auto input = randomFloats(n + offset + 1, 3.0f);
+            std::vector<int16_t> output(n + 1, 12345);
+
+            convertFloatToInt16(&input[offset], output.data(), n, SCALE);
+            for (int i = 0; i < n; i++) {
+                float x = input[offset + i] * SCALE;
+                x = std::min(std::max(x, -32768.0f), 32767.0f);
+                QCOMPARE(output[i], (int16_t)lrintf(x));
+            }
+            QCOMPARE(output[n], (int16_t)12345);
+        }
+    }
+}
+
+void AudioSampleOpsTests::testAccumulate() {
+    const float GAIN = 0.7f / AudioConstants::MAX_SAMPLE_VALUE;
+    const float EPSILON = 1.0e-6f;
+    for (int n = 0; n <= MAX_TEST_SAMPLES; n++) {
+        for (int offset = 0; offset <= MAX_TEST_OFFSET; offset++) {
+            auto input = randomSamples(n + offset + 1);
+            auto mix = randomFloats(2 * n + 1, 1.0f);
+
+            // mono into mono
+            auto output = mix;
+            accumulateInt16ToFloat(&input[offset], output.data(), n, GAIN);
+            for (int i = 0; i < n; i++) {
+                QVERIFY(fabsf(output[i] - (mix[i] + (float)input[offset + i] * GAIN)) < EPSILON);
+            }
+            QCOMPARE(output[n], mix[n]);
+
+            // mono into both channels of stereo
+            output = mix;
+            accumulateMonoInt16ToStereoFloat(&input[offset], output.data(), n, GAIN);
+            for (int i = 0; i < n; i++) {
+                float sample = (float)input[offset + i] * GAIN;
+                QVERIFY(fabsf(output[2 * i + 0] - (mix[2 * i + 0] + sample)) < EPSILON);
+                QVERIFY(fabsf(output[2 * i + 1] - (mix[2 * i + 1] + sample)) < EPSILON);
+            }
+            QCOMPARE(output[2 * n], mix[2 * n]);
+        }
+    }
+}
+
+void AudioSampleOpsTests::testScale() {
+    const float GAINS[] = { 0.0f, 0.3f, 0.999f, 1.0f };
+    for (float gain : GAINS) {
+        for (int n = 0; n <= MAX_TEST_SAMPLES; n++) {
+            for (int offset = 0; offset <= MAX_TEST_OFFSET; offset++) {
+                auto input = randomSamples(n + offset + 1);
+                std::vector<int16_t> output(n + 1, 12345);
+
+                scaleInt16(&input[offset], output.data(), n, gain);
+                for (int i = 0; i < n; i++) {
+                    QCOMPARE(output[i], (int16_t)((float)input[offset + i] * gain));
+                }
+                QCOMPARE(output[n], (int16_t)12345);
+            }
+        }
+    }
+}
+
+void AudioSampleOpsTests::testSumAbs() {
+    for (int n = 0; n <= MAX_TEST_SAMPLES; n++) {
+        for (int offset = 0; offset <= MAX_TEST_OFFSET; offset++) {
+            auto input = randomSamples(n + offset + 1);
+            int64_t sum = 0;
+            for (int i = 0; i < n; i++) {
+                sum += std::abs((int)input[offset + i]);
+            }
+            QCOMPARE(sumAbsInt16(&input[offset], n), sum);
+        }
+    }
+
+    // full-scale input, long enough to overflow 32 bits
+    std::vector<int16_t> loud(100000, -32768);
+    QCOMPARE(sumAbsInt16(loud.data(), (int)loud.size()), (int64_t)loud.size() * 32768);
+}
+
+void AudioSampleOpsTests::testThroughput() {
+    const int LOOPS = 1000000;
+    const int SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+
+    auto input = randomSamples(SAMPLES);
+    auto floats = randomFloats(SAMPLES, 2.0f);
+    std::vector<float> mix(SAMPLES);
+    std::vector<int16_t> output(SAMPLES);
+
+    {
+        // baseline, the scalar loop that the mixers used
+        auto start = usecTimestampNow();
+        for (int i = 0; i < LOOPS; i++) {
+            for (int j = 0; j < SAMPLES; j++) {
+                mix[j] += float(input[j] * 0.5f / AudioConstants::MAX_SAMPLE_VALUE);
+            }
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "scalar accumulate:" << (float)duration * 1000 / LOOPS << "nsecs per stereo frame";
+    }
+    {
+        auto start = usecTimestampNow();
+        for (int i = 0; i < LOOPS; i++) {
+            accumulateInt16ToFloat(input.data(), mix.data(), SAMPLES, 0.5f / AudioConstants::MAX_SAMPLE_VALUE);
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "accumulateInt16ToFloat:" << (float)duration * 1000 / LOOPS << "nsecs per stereo frame";
+    }
+    {
+        auto start = usecTimestampNow();
+        for (int i = 0; i < LOOPS; i++) {
+            convertInt16ToFloat(input.data(), mix.data(), SAMPLES, 1.0f / AudioConstants::MAX_SAMPLE_VALUE);
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "convertInt16ToFloat:" << (float)duration * 1000 / LOOPS << "nsecs per stereo frame";
+    }
+    {
+        auto start = usecTimestampNow();
+        for (int i = 0; i < LOOPS; i++) {
+            convertFloatToInt16(floats.data(), output.data(), SAMPLES, (float)AudioConstants::MAX_SAMPLE_VALUE);
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "convertFloatToInt16:" << (float)duration * 1000 / LOOPS << "nsecs per stereo frame";
+    }
+    {
+        auto start = usecTimestampNow();
+        for (int i = 0; i < LOOPS; i++) {
+            scaleInt16(input.data(), output.data(), SAMPLES, 0.5f);
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "scaleInt16:" << (float)duration * 1000 / LOOPS << "nsecs per stereo frame";
+    }
+    {
+        int64_t sum = 0;
+        auto start = usecTimestampNow();
+        for (int i = 0; i < LOOPS; i++) {
+            sum += sumAbsInt16(input.data(), SAMPLES);
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "sumAbsInt16:" << (float)duration * 1000 / LOOPS << "nsecs per stereo frame";
+        QVERIFY(sum > 0);
+    }
+}
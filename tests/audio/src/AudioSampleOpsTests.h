@@ -0,0 +1,27 @@
+//
+//  AudioSampleOpsTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSampleOpsTests_h
+#define hifi_AudioSampleOpsTests_h
+
+#include <QtTest/QtTest>
+
+class AudioSampleOpsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testConvertInt16ToFloat();
+    void testConvertFloatToInt16();
+    void testAccumulate();
+    void testScale();
+    void testSumAbs();
+    void testThroughput();
+};
+
+#endif // hifi_AudioSampleOpsTests_h
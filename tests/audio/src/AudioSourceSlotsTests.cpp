@@ -0,0 +1,140 @@
+//
+//  AudioSourceSlotsTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSourceSlotsTests.h"
+
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QUuid>
+
+#include <AudioSourceSlots.h>
+#include <SharedUtil.h>
+#include <UUIDHasher.h>
+
+QTEST_MAIN(AudioSourceSlotsTests)
+
+void AudioSourceSlotsTests::testAllocate() {
+    AudioSourceSlotAllocator allocator;
+
+    for (uint32_t i = 0; i < 10; i++) {
+        AudioSourceSlot slot = allocator.allocate();
+        QCOMPARE(slot.index, i);
+        QVERIFY(slot.isValid());
+    }
+    QCOMPARE(allocator.getCapacity(), (uint32_t)10);
+}
+
+void AudioSourceSlotsTests::testReuse() {
+    AudioSourceSlotAllocator allocator;
+
+    std::vector<AudioSourceSlot> slots;
+    for (int i = 0; i < 8; i++) {
+        slots.push_back(allocator.allocate());
+    }
+
+    // the lowest free index is reused first, with a new generation
+    allocator.release(slots[5]);
+    allocator.release(slots[2]);
+
+    AudioSourceSlot reused = allocator.allocate();
+    QCOMPARE(reused.index, slots[2].index);
+    QVERIFY(reused.generation != slots[2].generation);
+
+    reused = allocator.allocate();
+    QCOMPARE(reused.index, slots[5].index);
+
+    // releasing a stale handle is ignored
+    allocator.release(slots[5]);
+    QCOMPARE(allocator.allocate().index, (uint32_t)8);
+    QCOMPARE(allocator.getCapacity(), (uint32_t)9);
+}
+
+void AudioSourceSlotsTests::testHRTFReset() {
+    AudioSourceSlotAllocator allocator;
+    AudioHRTFSlots hrtfs;
+
+    AudioSourceSlot slot = allocator.allocate();
+    QVERIFY(hrtfs.find(slot) == nullptr);
+
+    bool isNew;
+    hrtfs.get(slot, isNew).setGainAdjustment(0.5f);
+    QVERIFY(isNew);
+    QCOMPARE(hrtfs.get(slot, isNew).getGainAdjustment(), 0.5f);
+    QVERIFY(!isNew);
+    QVERIFY(hrtfs.find(slot) != nullptr);
+
+    // a new owner of the index must not inherit the previous source's state
+    allocator.release(slot);
+    AudioSourceSlot reused = allocator.allocate();
+    QCOMPARE(reused.index, slot.index);
+    QVERIFY(hrtfs.find(reused) == nullptr);
+    QCOMPARE(hrtfs.get(reused, isNew).getGainAdjustment(), HRTF_GAIN);
+    QVERIFY(isNew);
+
+    // entries past the first chunk
+    AudioSourceSlot far { AudioHRTFSlots::CHUNK_SIZE * 3 + 1, 1 };
+    hrtfs.get(far).setGainAdjustment(2.0f);
+    QCOMPARE(hrtfs.getNumChunks(), (size_t)4);
+    QCOMPARE(hrtfs.find(far)->getGainAdjustment(), 2.0f);
+}
+
+// Per-listener HRTF lookups as done by AudioMixerSlave::addStream for every (listener, source) pair each frame,
+// comparing the nested UUID maps the mixer used to keep against slot-indexed storage.
+void AudioSourceSlotsTests::testMixerLookupBenchmark() {
+    const int NUM_LISTENERS = 200;
+    const int NUM_SOURCES = 200;
+    const int NUM_FRAMES = 50;
+
+    std::vector<QUuid> sourceIDs;
+    AudioSourceSlotAllocator allocator;
+    std::vector<AudioSourceSlot> sourceSlots;
+    for (int i = 0; i < NUM_SOURCES; i++) {
+        sourceIDs.push_back(QUuid::createUuid());
+        sourceSlots.push_back(allocator.allocate());
+    }
+    const QUuid micStreamID;
+
+    float sum = 0.0f;
+    {
+        using HRTFMap = std::unordered_map<QUuid, AudioHRTF>;
+        using NodeSourcesHRTFMap = std::unordered_map<QUuid, HRTFMap>;
+        std::vector<NodeSourcesHRTFMap> listeners(NUM_LISTENERS);
+
+        auto start = usecTimestampNow();
+        for (int f = 0; f < NUM_FRAMES; f++) {
+            for (auto& listener : listeners) {
+                for (auto& sourceID : sourceIDs) {
+                    sum += listener[sourceID][micStreamID].getGainAdjustment();
+                }
+            }
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "UUID maps:" << (float)duration / NUM_FRAMES << "usecs per mixer frame for"
+            << NUM_LISTENERS << "listeners x" << NUM_SOURCES << "sources";
+    }
+    {
+        std::vector<AudioHRTFSlots> listeners(NUM_LISTENERS);
+
+        auto start = usecTimestampNow();
+        for (int f = 0; f < NUM_FRAMES; f++) {
+            for (auto& listener : listeners) {
+                for (auto& sourceSlot : sourceSlots) {
+                    sum += listener.get(sourceSlot).getGainAdjustment();
+                }
+            }
+        }
+        auto duration = usecTimestampNow() - start;
+        qDebug() << "Slots:" << (float)duration / NUM_FRAMES << "usecs per mixer frame for"
+            << NUM_LISTENERS << "listeners x" << NUM_SOURCES << "sources";
+    }
+
+    QCOMPARE(sum, 2.0f * NUM_FRAMES * NUM_LISTENERS * NUM_SOURCES * HRTF_GAIN);
+}
@@ -0,0 +1,25 @@
+//
+//  AudioSourceSlotsTests.h
+//  tests/audio/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSourceSlotsTests_h
+#define hifi_AudioSourceSlotsTests_h
+
+#include <QtTest/QtTest>
+
+class AudioSourceSlotsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testAllocate();
+    void testReuse();
+    void testHRTFReset();
+    void testMixerLookupBenchmark();
+};
+
+#endif // hifi_AudioSourceSlotsTests_h
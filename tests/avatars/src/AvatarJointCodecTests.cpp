@@ -0,0 +1,322 @@
+//
+//  AvatarJointCodecTests.cpp
+//  tests/avatars/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarJointCodecTests.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AvatarJointCodec.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AvatarJointCodecTests)
+
+static const int NUM_JOINTS = 60;
+
+static float randomFloat() {
+    return 2.0f * (float)rand() / RAND_MAX - 1.0f;
+}
+
+static QVector<JointData> randomJoints(int numJoints) {
+    QVector<JointData> joints(numJoints);
+    for (auto& joint : joints) {
+        joint.rotation = glm::normalize(glm::quat(randomFloat(), randomFloat(), randomFloat(), randomFloat()));
+        joint.rotationSet = true;
+        joint.translation = 0.4f * glm::vec3(randomFloat(), randomFloat(), randomFloat());
+        joint.translationSet = true;
+    }
+    return joints;
+}
+
+// angle between two rotations, in radians. |a - b| = 2 sin(angle / 4), which keeps precision for small angles
+static float angleBetween(const glm::quat& a, const glm::quat& b) {
+    glm::quat c = glm::dot(a, b) < 0.0f ? -b : b;
+    float sumOfSquares = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        sumOfSquares += (a[i] - c[i]) * (a[i] - c[i]);
+    }
+    return 4.0f * asinf(glm::min(1.0f, sqrtf(sumOfSquares) / 2.0f));
+}
+
+static int encode(const AvatarJointCodec& codec, const QVector<JointData>& joints, const QVector<bool>& sendRotations,
+        const QVector<bool>& sendTranslations, std::vector<unsigned char>& buffer) {
+    buffer.resize(AvatarJointCodec::getMaxEncodedSize(joints.size()));
+    int scaleExponent = AvatarJointCodec::computeTranslationScaleExponent(joints);
+    int size = codec.encode(buffer.data(), joints, sendRotations, sendTranslations, scaleExponent);
+    buffer.resize(size);
+    return size;
+}
+
+void AvatarJointCodecTests::testRoundTrip() {
+    AvatarJointCodec codec;
+    QVector<JointData> joints = randomJoints(NUM_JOINTS);
+    QVector<bool> sendAll(NUM_JOINTS);
+    sendAll.fill(true);
+
+    std::vector<unsigned char> buffer;
+    int size = encode(codec, joints, sendAll, sendAll, buffer);
+
+    QVector<JointData> decoded;
+    int numRotations = 0;
+    int numTranslations = 0;
+    QCOMPARE(AvatarJointCodec::decode(buffer.data(), size, decoded, &numRotations, &numTranslations), size);
+    QCOMPARE(decoded.size(), NUM_JOINTS);
+    QCOMPARE(numRotations, NUM_JOINTS);
+    QCOMPARE(numTranslations, NUM_JOINTS);
+
+    int scaleExponent = AvatarJointCodec::computeTranslationScaleExponent(joints);
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        QVERIFY(decoded[i].rotationSet);
+        QVERIFY(decoded[i].translationSet);
+
+        // what the sender compares against is exactly what the receiver gets
+        QCOMPARE(decoded[i].rotation, codec.dequantizeRotation(codec.quantizeRotation(joints[i].rotation)));
+        QCOMPARE(decoded[i].translation,
+            codec.dequantizeTranslation(codec.quantizeTranslation(joints[i].translation, scaleExponent), scaleExponent));
+    }
+}
+
+void AvatarJointCodecTests::testValidityMasks() {
+    AvatarJointCodec codec;
+    QVector<JointData> joints = randomJoints(NUM_JOINTS);
+    QVector<bool> sendRotations(NUM_JOINTS);
+    QVector<bool> sendTranslations(NUM_JOINTS);
+    int expectedRotations = 0;
+    int expectedTranslations = 0;
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        sendRotations[i] = (i % 3) != 0;
+        sendTranslations[i] = (i % 4) == 0;
+        expectedRotations += sendRotations[i] ? 1 : 0;
+        expectedTranslations += sendTranslations[i] ? 1 : 0;
+    }
+
+    std::vector<unsigned char> buffer;
+    int size = encode(codec, joints, sendRotations, sendTranslations, buffer);
+
+    // one bit per joint and mask, no padding but the last byte's
+    const int HEADER_SIZE = 3;
+    int numBits = 2 * NUM_JOINTS + expectedRotations * (2 + 3 * codec.getRotationBits()) +
+        expectedTranslations * 3 * codec.getTranslationBits();
+    QCOMPARE(size, HEADER_SIZE + (numBits + BITS_IN_BYTE - 1) / BITS_IN_BYTE);
+
+    // joints that were not sent are left as they were
+    QVector<JointData> decoded(NUM_JOINTS);
+    glm::quat previousRotation(0.0f, 1.0f, 0.0f, 0.0f);
+    glm::vec3 previousTranslation(1.0f, 2.0f, 3.0f);
+    for (auto& joint : decoded) {
+        joint.rotation = previousRotation;
+        joint.translation = previousTranslation;
+    }
+
+    int numRotations = 0;
+    int numTranslations = 0;
+    QCOMPARE(AvatarJointCodec::decode(buffer.data(), size, decoded, &numRotations, &numTranslations), size);
+    QCOMPARE(numRotations, expectedRotations);
+    QCOMPARE(numTranslations, expectedTranslations);
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        QCOMPARE(decoded[i].rotationSet, (bool)sendRotations[i]);
+        QCOMPARE(decoded[i].translationSet, (bool)sendTranslations[i]);
+        if (!sendRotations[i]) {
+            QCOMPARE(decoded[i].rotation, previousRotation);
+        }
+        if (!sendTranslations[i]) {
+            QCOMPARE(decoded[i].translation, previousTranslation);
+        }
+    }
+}
+
+void AvatarJointCodecTests::testTruncated() {
+    AvatarJointCodec codec;
+    QVector<JointData> joints = randomJoints(NUM_JOINTS);
+    QVector<bool> sendAll(NUM_JOINTS);
+    sendAll.fill(true);
+
+    std::vector<unsigned char> buffer;
+    int size = encode(codec, joints, sendAll, sendAll, buffer);
+
+    for (int truncatedSize = 0; truncatedSize < size; truncatedSize++) {
+        QVector<JointData> decoded(2);
+        QCOMPARE(AvatarJointCodec::decode(buffer.data(), truncatedSize, decoded), -1);
+        QCOMPARE(decoded.size(), 2);
+        QVERIFY(!decoded[0].rotationSet && !decoded[1].translationSet);
+    }
+}
+
+void AvatarJointCodecTests::testReconstructionError() {
+    const float SMALLEST_THREE_RANGE = 2.0f / sqrtf(2.0f);
+    const int NUM_SAMPLES = 100;
+
+    float previousRotationError = FLT_MAX;
+    float previousTranslationError = FLT_MAX;
+    for (int bits = AvatarJointCodec::MIN_BITS; bits <= AvatarJointCodec::MAX_BITS; bits++) {
+        AvatarJointCodec codec(bits, bits);
+        QVector<bool> sendAll(NUM_JOINTS);
+        sendAll.fill(true);
+
+        float maxRotationError = 0.0f;
+        float maxTranslationError = 0.0f;
+        float maxTranslationStep = 0.0f;
+        std::vector<unsigned char> buffer;
+        for (int sample = 0; sample < NUM_SAMPLES; sample++) {
+            QVector<JointData> joints = randomJoints(NUM_JOINTS);
+            int scaleExponent = AvatarJointCodec::computeTranslationScaleExponent(joints);
+            maxTranslationStep = glm::max(maxTranslationStep, ldexpf(1.0f, scaleExponent) / ((1 << (bits - 1)) - 1));
+            int size = encode(codec, joints, sendAll, sendAll, buffer);
+
+            QVector<JointData> decoded;
+            QCOMPARE(AvatarJointCodec::decode(buffer.data(), size, decoded), size);
+            for (int i = 0; i < NUM_JOINTS; i++) {
+                maxRotationError = glm::max(maxRotationError, angleBetween(joints[i].rotation, decoded[i].rotation));
+                maxTranslationError = glm::max(maxTranslationError,
+                    glm::distance(joints[i].translation, decoded[i].translation));
+            }
+        }
+
+        // within a quantization step on every component
+        float rotationStep = SMALLEST_THREE_RANGE / ((1 << bits) - 1);
+        QVERIFY(maxRotationError < 4.0f * rotationStep);
+        QVERIFY(maxTranslationError < maxTranslationStep);
+
+        // allow for the noise of the random samples
+        QVERIFY(maxRotationError < previousRotationError * 1.1f);
+        QVERIFY(maxTranslationError < previousTranslationError * 1.1f);
+        previousRotationError = maxRotationError;
+        previousTranslationError = maxTranslationError;
+
+        qDebug() << bits << "bits: max rotation error" << maxRotationError * DEGREES_PER_RADIAN << "degrees,"
+            << "max translation error" << maxTranslationError * MILLIMETERS_PER_METER << "mm";
+    }
+}
+
+// an animated skeleton: some joints idle, the others swinging at their own pace, only the hips translating
+static void animate(QVector<JointData>& joints, float time) {
+    for (int i = 0; i < joints.size(); i++) {
+        JointData& joint = joints[i];
+        float amplitude = (i % 3 == 0) ? 0.0f : 0.2f + 0.5f * (float)(i % 5) / 5.0f;
+        float frequency = 0.5f + 0.1f * (float)(i % 7);
+        glm::vec3 axis = glm::normalize(glm::vec3(1.0f, (float)(i % 2), (float)(i % 3)));
+        joint.rotation = glm::angleAxis(amplitude * sinf(TWO_PI * frequency * time), axis);
+        joint.rotationSet = true;
+        joint.translation = glm::vec3(0.0f, 0.1f + 0.01f * (float)i, 0.0f);
+        if (i == 0) {
+            joint.translation += glm::vec3(0.05f * sinf(TWO_PI * time), 0.9f, 0.0f);
+        }
+        joint.translationSet = true;
+    }
+}
+
+// size of the joints in the encoding before AvatarJointCodec, a byte per eight joints and mask and six bytes a value
+static int legacyEncodedSize(int numJoints, int numRotations, int numTranslations) {
+    const int BYTES_PER_VALUE = 6;
+    int bytesOfValidity = (numJoints + BITS_IN_BYTE - 1) / BITS_IN_BYTE;
+    return 1 + 2 * bytesOfValidity + BYTES_PER_VALUE * (numRotations + numTranslations);
+}
+
+void AvatarJointCodecTests::testBytesPerAvatar() {
+    const int FRAMES_PER_SECOND = 45;
+    const int NUM_FRAMES = 10 * FRAMES_PER_SECOND;
+    const int FRAMES_PER_SEND_ALL = 50; // as AVATAR_UPDATES_PER_FULL_UPDATE
+    // a second receiver loses every tenth packet, never a full update, and the skeleton stops on a lost one
+    const int LOSS_PERIOD = 10;
+    const int FREEZE_FRAME = 7 * FRAMES_PER_SEND_ALL + LOSS_PERIOD / 2;
+
+    const int BIT_DEPTHS[] = { 8, 10, AvatarJointCodec::DEFAULT_ROTATION_BITS, AvatarJointCodec::MAX_BITS };
+    for (int bits : BIT_DEPTHS) {
+        AvatarJointCodec codec(bits, bits);
+        QVector<JointData> joints(NUM_JOINTS);
+        QVector<JointData> lastSent(NUM_JOINTS);
+        QVector<JointData> legacyLastSent(NUM_JOINTS);
+        QVector<JointData> received;
+        QVector<JointData> lossyReceived;
+        QVector<bool> sendRotations(NUM_JOINTS);
+        QVector<bool> sendTranslations(NUM_JOINTS);
+        std::vector<unsigned char> buffer;
+
+        int totalSize = 0;
+        int totalLegacySize = 0;
+        float maxRotationError = 0.0f;
+        const float maxQuantizationError = 4.0f * (2.0f / sqrtf(2.0f)) / ((1 << bits) - 1);
+        int framesStale = 0;
+        int maxFramesStale = 0;
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            animate(joints, (float)std::min(frame, FREEZE_FRAME) / FRAMES_PER_SECOND);
+            bool sendAll = (frame % FRAMES_PER_SEND_ALL) == 0;
+            int scaleExponent = AvatarJointCodec::computeTranslationScaleExponent(joints);
+
+            // as AvatarData::toByteArray does without culling, sending what changed since the receiver's last update
+            int numRotations = 0;
+            int numTranslations = 0;
+            int numLegacyRotations = 0;
+            int numLegacyTranslations = 0;
+            for (int i = 0; i < NUM_JOINTS; i++) {
+                sendRotations[i] = sendAll ||
+                    codec.quantizeRotation(joints[i].rotation) != codec.quantizeRotation(lastSent[i].rotation);
+                sendTranslations[i] = sendAll || codec.quantizeTranslation(joints[i].translation, scaleExponent) !=
+                    codec.quantizeTranslation(lastSent[i].translation, scaleExponent);
+                numRotations += sendRotations[i] ? 1 : 0;
+                numTranslations += sendTranslations[i] ? 1 : 0;
+                numLegacyRotations += (sendAll || joints[i].rotation != legacyLastSent[i].rotation) ? 1 : 0;
+                numLegacyTranslations += (sendAll || joints[i].translation != legacyLastSent[i].translation) ? 1 : 0;
+                if (sendRotations[i]) {
+                    lastSent[i].rotation = joints[i].rotation;
+                }
+                if (sendTranslations[i]) {
+                    lastSent[i].translation = joints[i].translation;
+                }
+            }
+            legacyLastSent = joints;
+
+            int size = encode(codec, joints, sendRotations, sendTranslations, buffer);
+            QCOMPARE(AvatarJointCodec::decode(buffer.data(), size, received), size);
+            for (int i = 0; i < NUM_JOINTS; i++) {
+                maxRotationError = glm::max(maxRotationError, angleBetween(joints[i].rotation, received[i].rotation));
+            }
+
+            bool lost = (frame % LOSS_PERIOD) == LOSS_PERIOD / 2;
+            if (!lost) {
+                QCOMPARE(AvatarJointCodec::decode(buffer.data(), size, lossyReceived), size);
+            }
+            bool stale = false;
+            for (int i = 0; i < NUM_JOINTS; i++) {
+                stale = stale || angleBetween(joints[i].rotation, lossyReceived[i].rotation) > maxQuantizationError;
+            }
+            framesStale = stale ? framesStale + 1 : 0;
+            maxFramesStale = std::max(maxFramesStale, framesStale);
+
+            totalSize += size;
+            totalLegacySize += legacyEncodedSize(NUM_JOINTS, numLegacyRotations, numLegacyTranslations);
+        }
+
+        // skipping what didn't survive quantization never lets the receiver drift
+        QVERIFY(maxRotationError < maxQuantizationError);
+
+        // the change lost as the skeleton stopped is only made up for by the next full update
+        QVERIFY(maxFramesStale > 1);
+        QVERIFY(maxFramesStale < FRAMES_PER_SEND_ALL);
+        QCOMPARE(framesStale, 0);
+
+        float bytesPerFrame = (float)totalSize / NUM_FRAMES;
+        float legacyBytesPerFrame = (float)totalLegacySize / NUM_FRAMES;
+        if (bits == AvatarJointCodec::DEFAULT_ROTATION_BITS) {
+            QVERIFY(bytesPerFrame < legacyBytesPerFrame);
+        }
+
+        qDebug() << bits << "bits:" << bytesPerFrame << "bytes per avatar per frame, was" << legacyBytesPerFrame
+            << "-" << (bytesPerFrame * FRAMES_PER_SECOND) / BYTES_PER_KILOBIT << "kbps, was"
+            << (legacyBytesPerFrame * FRAMES_PER_SECOND) / BYTES_PER_KILOBIT << "kbps,"
+            << "max rotation error" << maxRotationError * DEGREES_PER_RADIAN << "degrees,"
+            << "stale for up to" << maxFramesStale << "frames with" << (100 / LOSS_PERIOD) << "% loss";
+    }
+}
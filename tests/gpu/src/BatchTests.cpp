@@ -0,0 +1,279 @@
+//
+//  BatchTests.cpp
+//  tests/gpu/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BatchTests.h"
+
+#include <string.h>
+#include <thread>
+
+#include <gpu/Batch.h>
+#include <gpu/Context.h>
+#include <gpu/Frame.h>
+#include <gpu/null/NullBackend.h>
+
+QTEST_MAIN(BatchTests)
+
+static const int NUM_BUCKETS = 8;
+static const int NUM_ITEMS_PER_BUCKET = 50;
+static const char* INSTANCE_NAME = "BatchTests::instance";
+
+// shared resources, standing in for meshes and per-pipeline state
+class Resources {
+public:
+    Resources() {
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            glm::vec4 value(i, i + 1, i + 2, i + 3);
+            uniformBuffers.push_back(std::make_shared<gpu::Buffer>(sizeof(value), (const gpu::Byte*)&value));
+        }
+        for (int i = 0; i < 3; i++) {
+            vertexBuffers.push_back(std::make_shared<gpu::Buffer>());
+            indexBuffers.push_back(std::make_shared<gpu::Buffer>());
+        }
+    }
+
+    std::vector<gpu::BufferPointer> uniformBuffers;
+    std::vector<gpu::BufferPointer> vertexBuffers;
+    std::vector<gpu::BufferPointer> indexBuffers;
+};
+
+static void drawInstances(gpu::Batch& batch, gpu::Batch::NamedBatchData& data) {
+    batch.setInputBuffer(1, data.buffers[0], 0, sizeof(glm::vec4));
+    batch.drawInstanced((gpu::uint32)data.count(), gpu::TRIANGLES, 36);
+}
+
+static void setupFrame(gpu::Batch& batch) {
+    batch.setViewportTransform(glm::ivec4(0, 0, 1920, 1080));
+    batch.setStateScissorRect(glm::ivec4(0, 0, 1920, 1080));
+    batch.setProjectionTransform(glm::mat4(2.0f));
+    batch.setViewTransform(Transform());
+}
+
+// records one bucket the way a pipeline bucket of shapes is: pipeline state, then each item
+static void recordBucket(gpu::Batch& batch, const Resources& resources, int bucket) {
+    batch.setUniformBuffer(0, resources.uniformBuffers[bucket], 0, sizeof(glm::vec4));
+
+    for (int i = 0; i < NUM_ITEMS_PER_BUCKET; i++) {
+        int item = bucket * NUM_ITEMS_PER_BUCKET + i;
+
+        Transform model;
+        model.setTranslation(glm::vec3(item, 0.0f, 0.0f));
+        batch.setModelTransform(model);
+
+        if (item % 5 == 0) {
+            // instanced through a named call
+            batch.setupNamedCalls(INSTANCE_NAME, drawInstances);
+            batch.getNamedBuffer(INSTANCE_NAME)->append(glm::vec4(item));
+            continue;
+        }
+
+        batch.setInputBuffer(0, resources.vertexBuffers[item % 3], 0, sizeof(glm::vec3));
+        batch.setIndexBuffer(gpu::UINT16, resources.indexBuffers[item % 3], 0);
+        glm::vec4 color(item, 0.5f, 0.25f, 1.0f);
+        batch._glUniform4fv(2, 1, (const float*)&color);
+        if (item % 7 == 0) {
+            batch.setViewTransform(Transform(), false);
+        }
+        batch.drawIndexed(gpu::TRIANGLES, 36, 0);
+    }
+}
+
+static void compareBatches(const gpu::Batch& actual, const gpu::Batch& expected) {
+    QCOMPARE(actual.getCommands().size(), expected.getCommands().size());
+    QVERIFY(actual.getCommands() == expected.getCommands());
+    QVERIFY(actual.getCommandOffsets() == expected.getCommandOffsets());
+
+    QCOMPARE(actual.getParams().size(), expected.getParams().size());
+    for (size_t i = 0; i < actual.getParams().size(); i++) {
+        QCOMPARE(actual.getParams()[i]._uint, expected.getParams()[i]._uint);
+    }
+    QVERIFY(actual._data == expected._data);
+
+    QCOMPARE(actual._objects.size(), expected._objects.size());
+    QVERIFY(memcmp(actual._objects.data(), expected._objects.data(), actual._objects.size() * sizeof(gpu::Batch::TransformObject)) == 0);
+    QCOMPARE(actual._drawCallInfos.size(), expected._drawCallInfos.size());
+    for (size_t i = 0; i < actual._drawCallInfos.size(); i++) {
+        QCOMPARE(actual._drawCallInfos[i].index, expected._drawCallInfos[i].index);
+    }
+
+    QCOMPARE(actual._buffers.size(), expected._buffers.size());
+    for (size_t i = 0; i < actual._buffers.size(); i++) {
+        QVERIFY(actual._buffers._items[i]._data == expected._buffers._items[i]._data);
+    }
+    QCOMPARE(actual._transforms.size(), expected._transforms.size());
+    QCOMPARE(actual._pipelines.size(), expected._pipelines.size());
+
+    QCOMPARE(actual._namedData.size(), expected._namedData.size());
+    for (auto& namedCall : expected._namedData) {
+        auto found = actual._namedData.find(namedCall.first);
+        QVERIFY(found != actual._namedData.end());
+        auto& actualData = found->second;
+        auto& expectedData = namedCall.second;
+
+        QCOMPARE(actualData.count(), expectedData.count());
+        for (size_t i = 0; i < expectedData.count(); i++) {
+            QCOMPARE(actualData.drawCallInfos[i].index, expectedData.drawCallInfos[i].index);
+        }
+        QCOMPARE(actualData.buffers.size(), expectedData.buffers.size());
+        for (size_t i = 0; i < expectedData.buffers.size(); i++) {
+            QCOMPARE(actualData.buffers[i]->getSize(), expectedData.buffers[i]->getSize());
+            QVERIFY(memcmp(actualData.buffers[i]->getData(), expectedData.buffers[i]->getData(), expectedData.buffers[i]->getSize()) == 0);
+        }
+    }
+}
+
+void BatchTests::testAppend() {
+    Resources resources;
+
+    gpu::Batch expected;
+    setupFrame(expected);
+    for (int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+        recordBucket(expected, resources, bucket);
+    }
+
+    gpu::Batch stitched;
+    setupFrame(stitched);
+    for (int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+        gpu::Batch subBatch;
+        recordBucket(subBatch, resources, bucket);
+        stitched.append(subBatch);
+    }
+
+    compareBatches(stitched, expected);
+
+    // drawing after an append uses the model transform the appended commands left off with
+    // (captured again, where recording in place would have reused the last one)
+    expected.drawIndexed(gpu::TRIANGLES, 36, 0);
+    stitched.drawIndexed(gpu::TRIANGLES, 36, 0);
+    QCOMPARE(stitched._objects.size(), expected._objects.size() + 1);
+    QVERIFY(memcmp(&stitched._objects.back(), &expected._objects.back(), sizeof(gpu::Batch::TransformObject)) == 0);
+}
+
+void BatchTests::testParallelRecording() {
+    Resources resources;
+
+    gpu::Batch expected;
+    setupFrame(expected);
+    for (int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+        recordBucket(expected, resources, bucket);
+    }
+
+    // record each bucket on its own thread, then stitch in bucket order
+    for (int run = 0; run < 10; run++) {
+        std::vector<gpu::Batch> subBatches(NUM_BUCKETS);
+        std::vector<std::thread> threads;
+        for (int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+            threads.emplace_back([&, bucket] {
+                recordBucket(subBatches[bucket], resources, bucket);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        gpu::Batch stitched;
+        setupFrame(stitched);
+        for (auto& subBatch : subBatches) {
+            stitched.append(subBatch);
+        }
+        compareBatches(stitched, expected);
+    }
+}
+
+void BatchTests::testNullBackendFrame() {
+    gpu::Context::init<gpu::null::Backend>();
+    auto context = std::make_shared<gpu::Context>();
+    Resources resources;
+
+    for (int frameIndex = 0; frameIndex < 3; frameIndex++) {
+        context->beginFrame();
+
+        gpu::Batch batch;
+        setupFrame(batch);
+        for (int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+            gpu::Batch subBatch;
+            recordBucket(subBatch, resources, bucket);
+            batch.append(subBatch);
+        }
+        size_t numCommands = batch.getCommands().size();
+        context->appendFrameBatch(batch);
+
+        auto frame = context->endFrame();
+        QCOMPARE(frame->batches.size(), (size_t)1);
+
+        // finishing the frame runs the stitched named calls at the end of the batch
+        auto& commands = frame->batches[0].getCommands();
+        QCOMPARE(commands.size(), numCommands + 4);
+        QCOMPARE((int)commands[numCommands], (int)gpu::Batch::COMMAND_startNamedCall);
+        QCOMPARE((int)commands[numCommands + 2], (int)gpu::Batch::COMMAND_drawInstanced);
+        QCOMPARE(frame->batches[0]._namedData[INSTANCE_NAME].count(), (size_t)(NUM_BUCKETS * NUM_ITEMS_PER_BUCKET / 5));
+
+        context->executeFrame(frame);
+    }
+}
+
+void BatchTests::testStorageRecycling() {
+    Resources resources;
+
+    // consecutive uses of a resource share a cache entry
+    {
+        gpu::Batch batch;
+        batch.setUniformBuffer(0, resources.uniformBuffers[0], 0, sizeof(glm::vec4));
+        batch.setUniformBuffer(1, resources.uniformBuffers[0], 0, sizeof(glm::vec4));
+        batch.setUniformBuffer(2, resources.uniformBuffers[1], 0, sizeof(glm::vec4));
+        QCOMPARE(batch._buffers.size(), (size_t)2);
+        QCOMPARE(resources.uniformBuffers[0].use_count(), (long)2);
+    }
+
+    // a recycled batch's storage, with its capacity, goes to the next batch constructed
+    size_t numCommands;
+    size_t commandsCapacity;
+    {
+        gpu::Batch batch;
+        for (int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+            recordBucket(batch, resources, bucket);
+        }
+        numCommands = batch.getCommands().size();
+        commandsCapacity = batch.getCommands().capacity();
+        gpu::Batch::recycle(batch);
+        QVERIFY(batch.getCommands().empty());
+    }
+    QCOMPARE(resources.uniformBuffers[NUM_BUCKETS - 1].use_count(), (long)1);
+
+    auto before = gpu::Batch::getStorageStats();
+    QVERIFY(before.numPooled > 0);
+    {
+        gpu::Batch batch;
+        QVERIFY(batch.getCommands().empty());
+        QVERIFY(batch._namedData.empty());
+        QCOMPARE(batch.getCommands().capacity(), commandsCapacity);
+        QVERIFY(batch.getCommands().capacity() >= numCommands);
+    }
+    auto after = gpu::Batch::getStorageStats();
+    QCOMPARE(after.numBatches, before.numBatches + 1);
+    QCOMPARE(after.numAllocated, before.numAllocated);
+    QCOMPARE(after.numPooled, before.numPooled - 1);
+
+    // a retiring frame recycles its batches
+    gpu::Context::init<gpu::null::Backend>();
+    auto context = std::make_shared<gpu::Context>();
+    context->beginFrame();
+    for (int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+        gpu::doInBatch(context, [&](gpu::Batch& batch) {
+            recordBucket(batch, resources, bucket);
+        });
+    }
+    auto frame = context->endFrame();
+    context->executeFrame(frame);
+
+    before = gpu::Batch::getStorageStats();
+    frame.reset();
+    after = gpu::Batch::getStorageStats();
+    QCOMPARE(after.numPooled, before.numPooled + NUM_BUCKETS);
+}
@@ -0,0 +1,25 @@
+//
+//  BatchTests.h
+//  tests/gpu/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BatchTests_h
+#define hifi_BatchTests_h
+
+#include <QtTest/QtTest>
+
+class BatchTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testAppend();
+    void testParallelRecording();
+    void testNullBackendFrame();
+    void testStorageRecycling();
+};
+
+#endif // hifi_BatchTests_h
@@ -0,0 +1,257 @@
+//
+//  ProcessedTextureCacheTests.cpp
+//  tests/model/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ProcessedTextureCacheTests.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+
+#include <SharedUtil.h>
+
+#include <model/ProcessedTextureCache.h>
+#include <model/TextureMap.h>
+
+QTEST_MAIN(ProcessedTextureCacheTests)
+
+using namespace model;
+
+// a gradient with some noise, so that it neither compresses to nothing nor is all opaque
+static QImage makeImage(int width, int height, bool alpha, int seed = 0) {
+    QImage image(width, height, alpha ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+    uint32_t random = 1 + seed;
+    for (int y = 0; y < height; y++) {
+        QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; x++) {
+            random = random * 1664525 + 1013904223;
+            int noise = (random >> 24) & 0x1f;
+            int a = alpha ? ((x * 255 / width) | 0x3) : 255;
+            line[x] = qRgba((x * 255 / width + noise) & 0xff, (y * 255 / height + noise) & 0xff, (seed * 37 + noise) & 0xff, a);
+        }
+    }
+    return image;
+}
+
+static QByteArray encode(const QImage& image, const char* format) {
+    QByteArray content;
+    QBuffer buffer(&content);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, format);
+    return content;
+}
+
+static void compareTextures(const gpu::Texture& actual, const gpu::Texture& expected) {
+    QCOMPARE((int)actual.getType(), (int)expected.getType());
+    QVERIFY(actual.getTexelFormat() == expected.getTexelFormat());
+    QCOMPARE(actual.getWidth(), expected.getWidth());
+    QCOMPARE(actual.getHeight(), expected.getHeight());
+    QCOMPARE(actual.getDepth(), expected.getDepth());
+    QVERIFY(actual.getUsage() == expected.getUsage());
+    QCOMPARE((int)actual.getSampler().getFilter(), (int)expected.getSampler().getFilter());
+    QCOMPARE((int)actual.getSampler().getWrapModeU(), (int)expected.getSampler().getWrapModeU());
+    QCOMPARE(actual.isAutogenerateMips(), expected.isAutogenerateMips());
+    QCOMPARE(actual.source(), expected.source());
+    QCOMPARE(actual.mipLevels(), expected.mipLevels());
+
+    for (uint16 level = 0; level < expected.evalNumMips(); level++) {
+        QCOMPARE(actual.getStoredMipWidth(level), expected.getStoredMipWidth(level));
+        for (uint8 face = 0; face < expected.getNumFaces(); face++) {
+            QCOMPARE(actual.isStoredMipFaceAvailable(level, face), expected.isStoredMipFaceAvailable(level, face));
+            if (!expected.isStoredMipFaceAvailable(level, face)) {
+                continue;
+            }
+            auto actualMip = actual.accessStoredMipFace(level, face);
+            auto expectedMip = expected.accessStoredMipFace(level, face);
+            QVERIFY(actualMip->getFormat() == expectedMip->getFormat());
+            QCOMPARE(actualMip->getSize(), expectedMip->getSize());
+            QVERIFY(memcmp(actualMip->readData(), expectedMip->readData(), expectedMip->getSize()) == 0);
+        }
+    }
+
+    QCOMPARE((bool)actual.getIrradiance(), (bool)expected.getIrradiance());
+    if (expected.getIrradiance()) {
+        QVERIFY(memcmp(actual.getIrradiance().get(), expected.getIrradiance().get(), sizeof(gpu::SphericalHarmonics)) == 0);
+    }
+}
+
+void ProcessedTextureCacheTests::testKeys() {
+    QByteArray content = encode(makeImage(64, 64, false), "PNG");
+    QByteArray key = ProcessedTextureCache::computeKey(content, 1, "params");
+
+    QCOMPARE(ProcessedTextureCache::computeKey(content, 1, "params"), key);
+    QVERIFY(ProcessedTextureCache::computeKey(content, 2, "params") != key);
+    QVERIFY(ProcessedTextureCache::computeKey(content, 1, "other params") != key);
+    QVERIFY(ProcessedTextureCache::computeKey(encode(makeImage(64, 64, false, 1), "PNG"), 1, "params") != key);
+
+    // keys name files
+    for (char c : key) {
+        QVERIFY(isxdigit(c));
+    }
+}
+
+void ProcessedTextureCacheTests::testRoundTrip() {
+    QTemporaryDir directory;
+    ProcessedTextureCache cache(directory.path());
+
+    using Loader = gpu::Texture* (*)(const QImage&, const std::string&);
+    struct Case {
+        const char* name;
+        Loader loader;
+        QImage image;
+    };
+    std::vector<Case> cases = {
+        // rectified to the sparse page size, with a full CPU mip chain
+        { "albedo", TextureUsage::createAlbedoTextureFromImage, makeImage(300, 200, true) },
+        { "opaque", TextureUsage::create2DTextureFromImage, makeImage(256, 256, false) },
+        { "normal", TextureUsage::createNormalTextureFromNormalImage, makeImage(128, 64, false) },
+        { "roughness", TextureUsage::createRoughnessTextureFromImage, makeImage(100, 100, false) },
+        // CPU face mips, autogenerated mips and irradiance
+        { "cube", TextureUsage::createCubeTextureFromImage, makeImage(512, 256, false) },
+    };
+
+    int usage = 0;
+    for (auto& testCase : cases) {
+        std::string source = std::string("test://") + testCase.name;
+        std::unique_ptr<gpu::Texture> processed(testCase.loader(testCase.image, source));
+        QVERIFY(processed);
+
+        QByteArray key = ProcessedTextureCache::computeKey(encode(testCase.image, "PNG"), usage++, QByteArray());
+        QSize originalSize;
+        QVERIFY(!cache.load(key, source, originalSize));
+        QVERIFY(cache.store(key, *processed, testCase.image.size()));
+
+        std::unique_ptr<gpu::Texture> loaded(cache.load(key, source, originalSize));
+        QVERIFY(loaded);
+        QCOMPARE(originalSize, testCase.image.size());
+        compareTextures(*loaded, *processed);
+    }
+    QCOMPARE(cache.getNumHits(), (uint32_t)cases.size());
+    QCOMPARE(cache.getNumMisses(), (uint32_t)cases.size());
+    QVERIFY(cache.getSize() > 0);
+
+    // entries written by one cache are picked up by the next over the same directory
+    ProcessedTextureCache reopened(directory.path());
+    QCOMPARE(reopened.getSize(), cache.getSize());
+}
+
+void ProcessedTextureCacheTests::testDamagedEntry() {
+    QTemporaryDir directory;
+    ProcessedTextureCache cache(directory.path());
+
+    QImage image = makeImage(256, 128, true);
+    std::unique_ptr<gpu::Texture> processed(TextureUsage::createAlbedoTextureFromImage(image, "damaged"));
+    QByteArray key = ProcessedTextureCache::computeKey(encode(image, "PNG"), 0, QByteArray());
+    QVERIFY(cache.store(key, *processed, image.size()));
+
+    auto files = QDir(directory.path()).entryInfoList(QDir::Files);
+    QCOMPARE(files.size(), 1);
+    QString path = files[0].filePath();
+
+    // truncated into the mips
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() / 2));
+    }
+    QSize originalSize;
+    QVERIFY(!cache.load(key, "damaged", originalSize));
+    QVERIFY(!QFile::exists(path));
+    QCOMPARE(cache.getNumMisses(), (uint32_t)1);
+
+    // from another version of the container
+    QVERIFY(cache.store(key, *processed, image.size()));
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        file.seek(4);
+        uint32_t version = 0xffff;
+        file.write((const char*)&version, sizeof(version));
+    }
+    QVERIFY(!cache.load(key, "damaged", originalSize));
+
+    // replaced by the next store
+    QVERIFY(cache.store(key, *processed, image.size()));
+    std::unique_ptr<gpu::Texture> loaded(cache.load(key, "damaged", originalSize));
+    QVERIFY(loaded);
+    compareTextures(*loaded, *processed);
+}
+
+void ProcessedTextureCacheTests::testEviction() {
+    QTemporaryDir directory;
+
+    QImage image = makeImage(128, 128, false);
+    std::unique_ptr<gpu::Texture> processed(TextureUsage::create2DTextureFromImage(image, "evicted"));
+    QString path = directory.path() + "/entry";
+    QVERIFY(ProcessedTextureCache::write(path, *processed, image.size()));
+    qint64 entrySize = QFileInfo(path).size();
+    QFile::remove(path);
+
+    // room for a few entries
+    const qint64 MAX_SIZE = 4 * entrySize + entrySize / 2;
+    ProcessedTextureCache cache(directory.path(), MAX_SIZE);
+    for (int i = 0; i < 20; i++) {
+        QByteArray key = ProcessedTextureCache::computeKey(QByteArray::number(i), 0, QByteArray());
+        QVERIFY(cache.store(key, *processed, image.size()));
+        QVERIFY(cache.getSize() <= MAX_SIZE);
+    }
+
+    qint64 size = 0;
+    for (auto& info : QDir(directory.path()).entryInfoList(QDir::Files)) {
+        size += info.size();
+    }
+    QCOMPARE(size, cache.getSize());
+
+    cache.clear();
+    QCOMPARE(cache.getSize(), (qint64)0);
+    QVERIFY(QDir(directory.path()).entryInfoList(QDir::Files).isEmpty());
+}
+
+void ProcessedTextureCacheTests::testColdVsWarm() {
+    QTemporaryDir directory;
+    ProcessedTextureCache cache(directory.path());
+
+    // as ImageReader does it: decode and process on a miss, map and assign on a hit
+    const int NUM_RUNS = 5;
+    for (int size : { 512, 1024, 2048 }) {
+        QByteArray content = encode(makeImage(size, size, true, size), "PNG");
+        std::string source = "benchmark";
+
+        quint64 coldTime = 0;
+        quint64 warmTime = 0;
+        for (int run = 0; run < NUM_RUNS; run++) {
+            cache.clear();
+
+            auto t0 = usecTimestampNow();
+            QByteArray key = ProcessedTextureCache::computeKey(content, 0, QByteArray());
+            QSize originalSize;
+            std::unique_ptr<gpu::Texture> cold(cache.load(key, source, originalSize));
+            QVERIFY(!cold);
+            QImage image = QImage::fromData(content, "PNG");
+            cold.reset(TextureUsage::createAlbedoTextureFromImage(image, source));
+            QVERIFY(cache.store(key, *cold, image.size()));
+            auto t1 = usecTimestampNow();
+
+            std::unique_ptr<gpu::Texture> warm(cache.load(ProcessedTextureCache::computeKey(content, 0, QByteArray()), source, originalSize));
+            auto t2 = usecTimestampNow();
+            QVERIFY(warm);
+
+            coldTime += t1 - t0;
+            warmTime += t2 - t1;
+            if (run == 0) {
+                compareTextures(*warm, *cold);
+            }
+        }
+
+        qDebug() << size << "x" << size << "albedo:"
+                 << "cold" << (double)coldTime / NUM_RUNS / 1000.0 << "ms"
+                 << "warm" << (double)warmTime / NUM_RUNS / 1000.0 << "ms"
+                 << "(" << (double)coldTime / std::max(warmTime, (quint64)1) << "x )";
+    }
+}
@@ -0,0 +1,26 @@
+//
+//  ProcessedTextureCacheTests.h
+//  tests/model/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ProcessedTextureCacheTests_h
+#define hifi_ProcessedTextureCacheTests_h
+
+#include <QtTest/QtTest>
+
+class ProcessedTextureCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testKeys();
+    void testRoundTrip();
+    void testDamagedEntry();
+    void testEviction();
+    void testColdVsWarm();
+};
+
+#endif // hifi_ProcessedTextureCacheTests_h
@@ -0,0 +1,100 @@
+//
+//  EncodedEntityCacheTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <EncodedEntityCache.h>
+
+#include "EncodedEntityCacheTests.h"
+
+QTEST_MAIN(EncodedEntityCacheTests)
+
+static EncodedEntityCache::Stamp makeStamp(quint64 time) {
+    EncodedEntityCache::Stamp stamp;
+    stamp.changedOnServer = time;
+    stamp.lastEdited = time;
+    stamp.lastUpdated = time;
+    stamp.lastSimulated = time;
+    return stamp;
+}
+
+void EncodedEntityCacheTests::hitsOnlyCurrentEntries() {
+    EncodedEntityCache cache;
+    EntityItemID id(QUuid::createUuid());
+    EntityPropertyFlags properties;
+    properties += PROP_POSITION;
+    properties += PROP_NAME;
+    QByteArray encoded("an encoded entity");
+
+    OctreePacketData packetData;
+    QVERIFY(!cache.append(id, makeStamp(1), properties, &packetData));
+    QCOMPARE(cache.getNumMisses(), (quint64)1);
+
+    cache.insert(id, makeStamp(1), properties, (const unsigned char*)encoded.constData(), encoded.size());
+    QVERIFY(cache.append(id, makeStamp(1), properties, &packetData));
+    QCOMPARE(packetData.getUncompressedSize(), encoded.size());
+    QVERIFY(memcmp(packetData.getUncompressedData(), encoded.constData(), encoded.size()) == 0);
+    QCOMPARE(cache.getNumHits(), (quint64)1);
+    QCOMPARE(cache.getBytesSaved(), (quint64)encoded.size());
+
+    // changed since, or asked for other properties
+    EncodedEntityCache::Stamp simulated = makeStamp(1);
+    simulated.lastSimulated = 2;
+    QVERIFY(!cache.append(id, simulated, properties, &packetData));
+    EntityPropertyFlags fewerProperties;
+    fewerProperties += PROP_POSITION;
+    QVERIFY(!cache.append(id, makeStamp(1), fewerProperties, &packetData));
+    QCOMPARE(cache.getNumMisses(), (quint64)3);
+
+    // replaced in place
+    cache.insert(id, simulated, properties, (const unsigned char*)encoded.constData(), encoded.size());
+    QCOMPARE(cache.getNumEntries(), 1);
+    QCOMPARE(cache.getSize(), encoded.size());
+    QVERIFY(cache.append(id, simulated, properties, &packetData));
+
+    cache.remove(id);
+    QCOMPARE(cache.getNumEntries(), 0);
+    QCOMPARE(cache.getSize(), 0);
+    QVERIFY(!cache.append(id, simulated, properties, &packetData));
+}
+
+void EncodedEntityCacheTests::doesNotSpliceWhatDoesNotFit() {
+    EncodedEntityCache cache;
+    EntityItemID id(QUuid::createUuid());
+    EntityPropertyFlags properties;
+    properties += PROP_POSITION;
+    QByteArray encoded(200, 'x');
+    cache.insert(id, makeStamp(1), properties, (const unsigned char*)encoded.constData(), encoded.size());
+
+    OctreePacketData packetData(false, 100);
+    QVERIFY(!cache.append(id, makeStamp(1), properties, &packetData));
+    QCOMPARE(packetData.getUncompressedSize(), 0);
+    QCOMPARE(cache.getNumHits(), (quint64)0);
+    QCOMPARE(cache.getNumMisses(), (quint64)0);
+}
+
+void EncodedEntityCacheTests::staysWithinMaxSize() {
+    const int MAX_SIZE = 1000;
+    EncodedEntityCache cache(MAX_SIZE);
+    EntityPropertyFlags properties;
+    properties += PROP_POSITION;
+    QByteArray encoded(150, 'x');
+
+    for (int i = 0; i < 20; i++) {
+        cache.insert(EntityItemID(QUuid::createUuid()), makeStamp(1), properties,
+            (const unsigned char*)encoded.constData(), encoded.size());
+        QVERIFY(cache.getSize() <= MAX_SIZE);
+        QCOMPARE(cache.getSize(), cache.getNumEntries() * encoded.size());
+    }
+
+    QByteArray tooLarge(MAX_SIZE + 1, 'x');
+    int size = cache.getSize();
+    cache.insert(EntityItemID(QUuid::createUuid()), makeStamp(1), properties,
+        (const unsigned char*)tooLarge.constData(), tooLarge.size());
+    QCOMPARE(cache.getSize(), size);
+}
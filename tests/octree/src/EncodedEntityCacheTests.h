@@ -0,0 +1,25 @@
+//
+//  EncodedEntityCacheTests.h
+//  tests/octree/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EncodedEntityCacheTests_h
+#define hifi_EncodedEntityCacheTests_h
+
+#include <QtTest/QtTest>
+
+class EncodedEntityCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void hitsOnlyCurrentEntries();
+    void doesNotSpliceWhatDoesNotFit();
+    void staysWithinMaxSize();
+};
+
+#endif // hifi_EncodedEntityCacheTests_h
@@ -412,7 +412,7 @@ namespace render {
             case model::SunSkyStage::SKY_BOX: {
                 auto skybox = skyStage->getSkybox();
                 if (skybox) {
-                    PerformanceTimer perfTimer("skybox");
+                    PERFORMANCE_TIMER("skybox");
                     skybox->render(batch, args->getViewFrustum());
                     break;
                 }
@@ -898,7 +898,7 @@ private:
         }
 
         {
-            PerformanceTimer perfTimer("SceneProcessPendingChanges");
+            PERFORMANCE_TIMER("SceneProcessPendingChanges");
             _main3DScene->enqueuePendingChanges(pendingChanges);
 
             _main3DScene->processPendingChangesQueue();
@@ -913,20 +913,20 @@ private:
             batch.resetStages();
         });
         PROFILE_RANGE(render, __FUNCTION__);
-        PerformanceTimer perfTimer("draw");
+        PERFORMANCE_TIMER("draw");
         // The pending changes collecting the changes here
         render::PendingChanges pendingChanges;
         // Setup the current Zone Entity lighting
         DependencyManager::get<DeferredLightingEffect>()->setGlobalLight(_sunSkyStage.getSunLight());
         {
-            PerformanceTimer perfTimer("SceneProcessPendingChanges");
+            PERFORMANCE_TIMER("SceneProcessPendingChanges");
             _main3DScene->enqueuePendingChanges(pendingChanges);
             _main3DScene->processPendingChangesQueue();
         }
 
         // For now every frame pass the renderContext
         {
-            PerformanceTimer perfTimer("EngineRun");
+            PERFORMANCE_TIMER("EngineRun");
             _renderEngine->getRenderContext()->args = renderArgs;
             // Before the deferred pass, let's try to use the render engine
             _renderEngine->run();
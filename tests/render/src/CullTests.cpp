@@ -0,0 +1,300 @@
+//
+//  CullTests.cpp
+//  tests/render/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CullTests.h"
+
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+#include <render/CullTask.h>
+#include <render/Scene.h>
+#include <render/SortTask.h>
+
+QTEST_MAIN(CullTests)
+
+using namespace render;
+
+// a render item that is nothing but a bound, standing in for an entity
+class BoundData {
+public:
+    using Pointer = std::shared_ptr<BoundData>;
+    BoundData(const AABox& bound) : bound(bound) {}
+    AABox bound;
+};
+using BoundPayload = Payload<BoundData>;
+
+namespace render {
+    template <> const ItemKey payloadGetKey(const BoundData::Pointer& data) { return ItemKey::Builder::opaqueShape(); }
+    template <> const Item::Bound payloadGetBound(const BoundData::Pointer& data) { return data->bound; }
+}
+
+static const float WORLD_SIZE = 1000.0f;
+
+static AABox randomBox(std::mt19937& generator, float worldSize, float maxSize) {
+    std::uniform_real_distribution<float> position(-0.5f * worldSize, 0.5f * worldSize);
+    std::uniform_real_distribution<float> size(0.0f, maxSize);
+    glm::vec3 corner(position(generator), position(generator), position(generator));
+    return AABox(corner, glm::vec3(size(generator), size(generator), size(generator)));
+}
+
+static ScenePointer makeScene(int numItems, std::mt19937& generator, std::vector<ItemID>* ids = nullptr) {
+    auto scene = std::make_shared<Scene>(glm::vec3(-16384.0f), 32768.0f);
+
+    PendingChanges changes;
+    for (int i = 0; i < numItems; i++) {
+        auto id = scene->allocateID();
+        auto data = std::make_shared<BoundData>(randomBox(generator, WORLD_SIZE, 4.0f));
+        changes.resetItem(id, std::make_shared<BoundPayload>(data));
+        if (ids) {
+            ids->push_back(id);
+        }
+    }
+    scene->enqueuePendingChanges(changes);
+    scene->processPendingChangesQueue();
+    return scene;
+}
+
+static ViewFrustum makeFrustum(float yaw) {
+    ViewFrustum frustum;
+    frustum.setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 0.5f * WORLD_SIZE));
+    frustum.setPosition(glm::vec3(0.0f, 1.8f, 0.0f));
+    frustum.setOrientation(glm::angleAxis(yaw, glm::vec3(0.0f, 1.0f, 0.0f)));
+    frustum.calculate();
+    return frustum;
+}
+
+// the usual LOD functor: cull items that subtend too small an angle
+static bool isBigEnough(const RenderArgs* args, const AABox& bound) {
+    float distance = glm::distance(args->getViewFrustum().getPosition(), bound.calcCenter());
+    return glm::length(bound.getDimensions()) > 0.01f * distance;
+}
+
+// runs FetchSpatialTree then CullSpatialSelection, as the render task does
+class CullHarness {
+public:
+    CullHarness(const ScenePointer& scene) :
+        _cull(isBigEnough, RenderDetails::ITEM, ItemFilter::Builder::opaqueShape().withoutLayered()) {
+        _sceneContext = std::make_shared<SceneContext>();
+        _sceneContext->_scene = scene;
+        _renderContext = std::make_shared<RenderContext>();
+        _renderContext->jobConfig = std::make_shared<CullSpatialSelection::Config>();
+
+        _fetch.configure(FetchSpatialTree::Config());
+        _cull.configure(CullSpatialSelection::Config());
+    }
+
+    void fetch(RenderArgs& args, ItemSpatialTree::ItemSelection& selection) {
+        _renderContext->args = &args;
+        _fetch.run(_sceneContext, _renderContext, selection);
+    }
+
+    void cull(RenderArgs& args, const ItemSpatialTree::ItemSelection& selection, ItemBounds& outItems) {
+        _renderContext->args = &args;
+        _cull.run(_sceneContext, _renderContext, selection, outItems);
+    }
+
+    void sort(RenderArgs& args, const ItemBounds& inItems, ItemBounds& outItems) {
+        _renderContext->args = &args;
+        depthSortItems(_sceneContext, _renderContext, true, inItems, outItems);
+    }
+
+private:
+    SceneContextPointer _sceneContext;
+    RenderContextPointer _renderContext;
+    FetchSpatialTree _fetch;
+    CullSpatialSelection _cull;
+};
+
+static bool boundArrayMatches(const ItemBoundArrays& bounds, size_t index, const AABox& bound) {
+    glm::vec3 minimum = bound.getCorner();
+    glm::vec3 maximum = bound.getCorner() + bound.getScale();
+    return bounds.minX[index] == minimum.x && bounds.minY[index] == minimum.y && bounds.minZ[index] == minimum.z &&
+           bounds.maxX[index] == maximum.x && bounds.maxY[index] == maximum.y && bounds.maxZ[index] == maximum.z;
+}
+
+void CullTests::testIntersectFrustum() {
+    std::mt19937 generator(1);
+
+    // an odd count, to exercise the scalar tail
+    const int NUM_BOXES = 1003;
+    std::vector<AABox> boxes;
+    ItemBoundArrays bounds;
+    for (int i = 0; i < NUM_BOXES; i++) {
+        // mix in some degenerate boxes
+        AABox box = (i % 17 == 0) ? AABox(randomBox(generator, 200.0f, 0.0f).getCorner(), 0.0f)
+                                  : randomBox(generator, 200.0f, 20.0f);
+        boxes.push_back(box);
+        bounds.push_back(box);
+    }
+    QCOMPARE(bounds.size(), (size_t)NUM_BOXES);
+
+    std::vector<uint8_t> inView(NUM_BOXES);
+    for (float yaw = 0.0f; yaw < TWO_PI; yaw += 0.5f) {
+        ViewFrustum frustum = makeFrustum(yaw);
+
+        for (size_t begin : { 0, 1, 3, 6 }) {
+            size_t end = NUM_BOXES - begin;
+            bounds.intersectFrustum(frustum, begin, end, inView.data());
+
+            for (size_t i = begin; i < end; i++) {
+                QCOMPARE((bool)inView[i - begin], frustum.boxIntersectsFrustum(boxes[i]));
+            }
+        }
+    }
+}
+
+void CullTests::testBoundArrays() {
+    std::mt19937 generator(2);
+    std::vector<ItemID> ids;
+    auto scene = makeScene(5000, generator, &ids);
+
+    // move some items a little (staying in their cell), move some far, and remove some
+    PendingChanges changes;
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (i % 3 == 0) {
+            AABox moved = scene->getItem(ids[i]).getBound();
+            moved.translate(glm::vec3(0.001f));
+            changes.updateItem<BoundData>(ids[i], [moved](BoundData& data) { data.bound = moved; });
+        } else if (i % 5 == 0) {
+            AABox moved = randomBox(generator, WORLD_SIZE, 50.0f);
+            changes.updateItem<BoundData>(ids[i], [moved](BoundData& data) { data.bound = moved; });
+        } else if (i % 7 == 0) {
+            changes.removeItem(ids[i]);
+        }
+    }
+    scene->enqueuePendingChanges(changes);
+    scene->processPendingChangesQueue();
+
+    // the bounds carried along with partial items must be those of the items, in the same order
+    ItemFilter filter = ItemFilter::Builder::visibleWorldItems().withoutLayered();
+    for (float yaw = 0.0f; yaw < TWO_PI; yaw += 1.0f) {
+        ItemSpatialTree::ItemSelection selection;
+        scene->getSpatialTree().selectCellItems(selection, filter, makeFrustum(yaw), 0.1f);
+
+        QCOMPARE(selection.partialItemBounds.size(), selection.partialItems.size());
+        QCOMPARE(selection.partialSubcellItemBounds.size(), selection.partialSubcellItems.size());
+        for (size_t i = 0; i < selection.partialItems.size(); i++) {
+            QVERIFY(boundArrayMatches(selection.partialItemBounds, i, scene->getItem(selection.partialItems[i]).getBound()));
+        }
+        for (size_t i = 0; i < selection.partialSubcellItems.size(); i++) {
+            QVERIFY(boundArrayMatches(selection.partialSubcellItemBounds, i, scene->getItem(selection.partialSubcellItems[i]).getBound()));
+        }
+    }
+}
+
+void CullTests::testCullSpatialSelection() {
+    std::mt19937 generator(3);
+
+    // enough items that the partial lists take the parallel path
+    auto scene = makeScene(100000, generator);
+    CullHarness harness(scene);
+    ItemFilter filter = ItemFilter::Builder::opaqueShape().withoutLayered();
+
+    for (float yaw = 0.0f; yaw < TWO_PI; yaw += 0.7f) {
+        RenderArgs args;
+        args.pushViewFrustum(makeFrustum(yaw));
+        const ViewFrustum& frustum = args.getViewFrustum();
+
+        ItemSpatialTree::ItemSelection selection;
+        ItemBounds culled;
+        harness.fetch(args, selection);
+        harness.cull(args, selection, culled);
+
+        // the one-item-at-a-time reference, as culled before the bounds were cached. partial items are
+        // tested, and output, with the bounds the selection carries
+        ItemBounds expected;
+        int outOfView = 0;
+        int tooSmall = 0;
+        auto cullList = [&](const ItemIDs& items, const ItemBoundArrays* bounds, bool testSolidAngle) {
+            for (size_t i = 0; i < items.size(); i++) {
+                auto id = items[i];
+                auto& item = scene->getItem(id);
+                if (!filter.test(item.getKey())) {
+                    continue;
+                }
+                bool testFrustum = (bounds != nullptr);
+                AABox bound = testFrustum ? bounds->get(i) : item.getBound();
+                if (testFrustum && !frustum.boxIntersectsFrustum(bound)) {
+                    outOfView++;
+                    continue;
+                }
+                if (testSolidAngle && !isBigEnough(&args, bound)) {
+                    tooSmall++;
+                    continue;
+                }
+                expected.emplace_back(ItemBound(id, bound));
+            }
+        };
+        cullList(selection.insideItems, nullptr, false);
+        cullList(selection.insideSubcellItems, nullptr, true);
+        cullList(selection.partialItems, &selection.partialItemBounds, false);
+        cullList(selection.partialSubcellItems, &selection.partialSubcellItemBounds, true);
+
+        QCOMPARE(culled.size(), expected.size());
+        for (size_t i = 0; i < culled.size(); i++) {
+            QCOMPARE(culled[i].id, expected[i].id);
+            QVERIFY(culled[i].bound.getCorner() == expected[i].bound.getCorner());
+            QVERIFY(culled[i].bound.getScale() == expected[i].bound.getScale());
+        }
+        QCOMPARE(args._details._item._outOfView, outOfView);
+        QCOMPARE(args._details._item._tooSmall, tooSmall);
+        QCOMPARE(args._details._item._rendered, (int)expected.size());
+    }
+}
+
+void CullTests::testThroughput() {
+    std::mt19937 generator(4);
+
+    const int NUM_FRAMES = 100;
+    for (int numItems : { 10000, 100000, 300000 }) {
+        auto scene = makeScene(numItems, generator);
+        CullHarness harness(scene);
+
+        quint64 fetchTime = 0;
+        quint64 cullTime = 0;
+        quint64 sortTime = 0;
+        size_t numPartial = 0;
+        size_t numRendered = 0;
+
+        for (int i = 0; i < NUM_FRAMES; i++) {
+            RenderArgs args;
+            args.pushViewFrustum(makeFrustum(TWO_PI * i / NUM_FRAMES));
+
+            ItemSpatialTree::ItemSelection selection;
+            ItemBounds culled;
+            ItemBounds sorted;
+
+            auto t0 = usecTimestampNow();
+            harness.fetch(args, selection);
+            auto t1 = usecTimestampNow();
+            harness.cull(args, selection, culled);
+            auto t2 = usecTimestampNow();
+            harness.sort(args, culled, sorted);
+            auto t3 = usecTimestampNow();
+
+            fetchTime += t1 - t0;
+            cullTime += t2 - t1;
+            sortTime += t3 - t2;
+            numPartial += selection.partialNumItems();
+            numRendered += sorted.size();
+        }
+
+        qDebug() << numItems << "items:"
+                 << "partial" << numPartial / NUM_FRAMES << "rendered" << numRendered / NUM_FRAMES
+                 << "| fetch" << (double)fetchTime / NUM_FRAMES / 1000.0 << "ms"
+                 << "cull" << (double)cullTime / NUM_FRAMES / 1000.0 << "ms"
+                 << "sort" << (double)sortTime / NUM_FRAMES / 1000.0 << "ms";
+    }
+}
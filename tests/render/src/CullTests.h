@@ -0,0 +1,25 @@
+//
+//  CullTests.h
+//  tests/render/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CullTests_h
+#define hifi_CullTests_h
+
+#include <QtTest/QtTest>
+
+class CullTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testIntersectFrustum();
+    void testBoundArrays();
+    void testCullSpatialSelection();
+    void testThroughput();
+};
+
+#endif // hifi_CullTests_h
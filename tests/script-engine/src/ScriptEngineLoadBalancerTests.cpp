@@ -0,0 +1,113 @@
+//
+//  ScriptEngineLoadBalancerTests.cpp
+//  tests/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptEngineLoadBalancerTests.h"
+
+#include <vector>
+
+#include <ScriptEngineLoadBalancer.h>
+
+QTEST_MAIN(ScriptEngineLoadBalancerTests)
+
+// one frame at SCRIPT_FPS, what a shard reports if it measured the whole frame including its sleep
+static const float FRAME_MSECS = 1000.0f / 60.0f;
+static const float BUDGET_MSECS = FRAME_MSECS;
+
+// shards whose scripts each cost a fixed busy time per frame
+static void updateShards(ScriptEngineLoadBalancer& balancer, const std::vector<int>& numScripts, float msecsPerScript) {
+    for (int i = 0; i < (int)numScripts.size(); ++i) {
+        balancer.updateShard(i, numScripts[i] * msecsPerScript, numScripts[i]);
+    }
+}
+
+void ScriptEngineLoadBalancerTests::testIdleShardsStayPut() {
+    ScriptEngineLoadBalancer balancer(3, BUDGET_MSECS);
+    std::vector<int> numScripts { 10, 2, 2 };
+
+    for (int window = 0; window < 10; ++window) {
+        updateShards(balancer, numScripts, 0.5f);
+        int from, to;
+        QVERIFY(!balancer.pickMove(from, to));
+    }
+    QCOMPARE(balancer.getShard(0).numWindowsOverBudget, 0);
+}
+
+void ScriptEngineLoadBalancerTests::testOverloadedShardMovesScript() {
+    ScriptEngineLoadBalancer balancer(3, BUDGET_MSECS);
+    std::vector<int> numScripts { 12, 1, 2 };
+    const float MSECS_PER_SCRIPT = 2.0f;
+
+    // the first window over budget is not enough
+    updateShards(balancer, numScripts, MSECS_PER_SCRIPT);
+    int from = -1, to = -1;
+    QVERIFY(!balancer.pickMove(from, to));
+    QCOMPARE(balancer.getShard(0).numWindowsOverBudget, 1);
+
+    // the second one moves a script from the overloaded shard to the least busy one
+    updateShards(balancer, numScripts, MSECS_PER_SCRIPT);
+    QVERIFY(balancer.pickMove(from, to));
+    QCOMPARE(from, 0);
+    QCOMPARE(to, 1);
+    QCOMPARE(balancer.getShard(0).numWindowsOverBudget, 0);
+
+    // keep moving scripts as the server would, until the overloaded shard is back under budget
+    numScripts[from]--;
+    numScripts[to]++;
+    int numMoves = 1;
+    for (int window = 0; window < 100; ++window) {
+        updateShards(balancer, numScripts, MSECS_PER_SCRIPT);
+        if (balancer.pickMove(from, to)) {
+            numScripts[from]--;
+            numScripts[to]++;
+            numMoves++;
+        }
+    }
+
+    QVERIFY(numMoves > 1);
+    for (int i = 0; i < (int)numScripts.size(); ++i) {
+        QVERIFY(numScripts[i] * MSECS_PER_SCRIPT <= BUDGET_MSECS);
+    }
+    QCOMPARE(numScripts[0] + numScripts[1] + numScripts[2], 15);
+}
+
+void ScriptEngineLoadBalancerTests::testNoHeadroom() {
+    // a shard reporting a whole frame, as if its sleep were counted, never receives scripts
+    ScriptEngineLoadBalancer balancer(2, BUDGET_MSECS);
+    for (int window = 0; window < 4; ++window) {
+        balancer.updateShard(0, 2.0f * BUDGET_MSECS, 10);
+        balancer.updateShard(1, FRAME_MSECS, 1);
+        int from, to;
+        QVERIFY(!balancer.pickMove(from, to));
+    }
+    QVERIFY(balancer.getShard(0).numWindowsOverBudget >= ScriptEngineLoadBalancer::MIN_WINDOWS_OVER_BUDGET);
+}
+
+void ScriptEngineLoadBalancerTests::testSingleScript() {
+    // moving the only script of a shard would just move the problem
+    ScriptEngineLoadBalancer balancer(2, BUDGET_MSECS);
+    for (int window = 0; window < 4; ++window) {
+        balancer.updateShard(0, 2.0f * BUDGET_MSECS, 1);
+        balancer.updateShard(1, 0.0f, 0);
+        int from, to;
+        QVERIFY(!balancer.pickMove(from, to));
+    }
+}
+
+void ScriptEngineLoadBalancerTests::testHeadroomForScript() {
+    ScriptEngineLoadBalancer balancer(2, BUDGET_MSECS);
+    balancer.updateShard(0, 2.0f * BUDGET_MSECS, 10);
+    balancer.updateShard(1, 0.25f * BUDGET_MSECS, 2);
+
+    // the least busy shard has headroom, but not for a script that is over budget on its own
+    QVERIFY(balancer.hasHeadroomFor(1, 0.5f * BUDGET_MSECS));
+    QVERIFY(balancer.hasHeadroomFor(1, 0.7f * BUDGET_MSECS));
+    QVERIFY(!balancer.hasHeadroomFor(1, 0.8f * BUDGET_MSECS));
+    QVERIFY(!balancer.hasHeadroomFor(0, 0.0f));
+}
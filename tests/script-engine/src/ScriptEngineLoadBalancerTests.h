@@ -0,0 +1,27 @@
+//
+//  ScriptEngineLoadBalancerTests.h
+//  tests/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptEngineLoadBalancerTests_h
+#define hifi_ScriptEngineLoadBalancerTests_h
+
+#include <QtTest/QtTest>
+
+class ScriptEngineLoadBalancerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testIdleShardsStayPut();
+    void testOverloadedShardMovesScript();
+    void testNoHeadroom();
+    void testSingleScript();
+    void testHeadroomForScript();
+};
+
+#endif // hifi_ScriptEngineLoadBalancerTests_h
@@ -0,0 +1,153 @@
+//
+//  ScriptProfilerTests.cpp
+//  tests/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptProfilerTests.h"
+
+#include <ScriptProfiler.h>
+
+QTEST_MAIN(ScriptProfilerTests)
+
+static QVariantMap callSite(const QVariantMap& profile, const EntityItemID& entityID, ScriptProfiler::CallType type,
+                            const QString& name) {
+    QString entityKey = entityID.isNull() ? "" : entityID.toString();
+    return profile["entities"].toMap()[entityKey].toMap()[ScriptProfiler::typeName(type)].toMap()[name].toMap();
+}
+
+static QVariantMap total(const QVariantMap& profile, ScriptProfiler::CallType type) {
+    return profile["totals"].toMap()[ScriptProfiler::typeName(type)].toMap();
+}
+
+void ScriptProfilerTests::testAggregation() {
+    ScriptProfiler profiler;
+    EntityItemID entityA(QUuid::createUuid());
+    EntityItemID entityB(QUuid::createUuid());
+
+    profiler.record(ScriptProfiler::ENTITY_METHOD, entityA, "clickDownOnEntity", 100);
+    profiler.record(ScriptProfiler::ENTITY_METHOD, entityA, "clickDownOnEntity", 300);
+    profiler.record(ScriptProfiler::ENTITY_METHOD, entityB, "clickDownOnEntity", 50);
+    profiler.record(ScriptProfiler::TIMER, EntityItemID(), "tick", 20);
+
+    auto profile = profiler.toVariantMap();
+
+    // the same method of two entities are two call sites
+    auto siteA = callSite(profile, entityA, ScriptProfiler::ENTITY_METHOD, "clickDownOnEntity");
+    QCOMPARE(siteA["count"].toULongLong(), 2ULL);
+    QCOMPARE(siteA["totalUsecs"].toULongLong(), 400ULL);
+    QCOMPARE(siteA["maxUsecs"].toULongLong(), 300ULL);
+    QCOMPARE(siteA["averageUsecs"].toDouble(), 200.0);
+
+    auto siteB = callSite(profile, entityB, ScriptProfiler::ENTITY_METHOD, "clickDownOnEntity");
+    QCOMPARE(siteB["count"].toULongLong(), 1ULL);
+    QCOMPARE(siteB["totalUsecs"].toULongLong(), 50ULL);
+
+    // per type totals cover every call site
+    QCOMPARE(total(profile, ScriptProfiler::ENTITY_METHOD)["count"].toULongLong(), 3ULL);
+    QCOMPARE(total(profile, ScriptProfiler::ENTITY_METHOD)["totalUsecs"].toULongLong(), 450ULL);
+    QCOMPARE(total(profile, ScriptProfiler::TIMER)["count"].toULongLong(), 1ULL);
+    QCOMPARE(total(profile, ScriptProfiler::UPDATE)["count"].toULongLong(), 0ULL);
+
+    auto json = profiler.toJson(1);
+    QCOMPARE(json["entity_method_calls"].toInt(), 3);
+    auto top = json["top_call_sites"].toArray();
+    QCOMPARE(top.size(), 1);
+    QCOMPARE(top[0].toObject()["entity"].toString(), entityA.toString());
+    QCOMPARE(top[0].toObject()["total_usecs"].toInt(), 400);
+}
+
+void ScriptProfilerTests::testHistogram() {
+    ScriptProfiler::Record record;
+    record.add(0);
+    record.add(1);
+    record.add(3);
+    record.add(1000);
+    record.add(1ULL << 40);
+
+    QCOMPARE(record.histogram[0], 1u);
+    QCOMPARE(record.histogram[1], 1u);
+    QCOMPARE(record.histogram[2], 1u);
+    QCOMPARE(record.histogram[10], 1u);
+    QCOMPARE(record.histogram[ScriptProfiler::NUM_HISTOGRAM_BUCKETS - 1], 1u);
+    QCOMPARE(record.count, 5ULL);
+}
+
+void ScriptProfilerTests::testOverflow() {
+    ScriptProfiler profiler;
+    for (int i = 0; i < ScriptProfiler::MAX_CALL_SITES; ++i) {
+        profiler.record(ScriptProfiler::TIMER, EntityItemID(), QString("timer%1").arg(i), 1);
+    }
+
+    // new call sites beyond the limit share one record, which keeps accumulating
+    profiler.record(ScriptProfiler::TIMER, EntityItemID(), "late1", 10);
+    profiler.record(ScriptProfiler::TIMER, EntityItemID(), "late2", 20);
+    profiler.record(ScriptProfiler::TIMER, EntityItemID(), "late3", 30);
+
+    // known call sites are still recorded on their own
+    profiler.record(ScriptProfiler::TIMER, EntityItemID(), "timer0", 5);
+
+    auto profile = profiler.toVariantMap();
+    auto other = callSite(profile, EntityItemID(), ScriptProfiler::TIMER, "<other>");
+    QCOMPARE(other["count"].toULongLong(), 3ULL);
+    QCOMPARE(other["totalUsecs"].toULongLong(), 60ULL);
+    QCOMPARE(other["maxUsecs"].toULongLong(), 30ULL);
+    QVERIFY(callSite(profile, EntityItemID(), ScriptProfiler::TIMER, "late1").isEmpty());
+
+    auto timer0 = callSite(profile, EntityItemID(), ScriptProfiler::TIMER, "timer0");
+    QCOMPARE(timer0["count"].toULongLong(), 2ULL);
+
+    // overflow is per type
+    EntityItemID entity(QUuid::createUuid());
+    profiler.record(ScriptProfiler::ENTITY_METHOD, entity, "late4", 40);
+    profile = profiler.toVariantMap();
+    auto otherMethods = callSite(profile, EntityItemID(), ScriptProfiler::ENTITY_METHOD, "<other>");
+    QCOMPARE(otherMethods["count"].toULongLong(), 1ULL);
+    QCOMPARE(callSite(profile, EntityItemID(), ScriptProfiler::TIMER, "<other>")["count"].toULongLong(), 3ULL);
+
+    QCOMPARE(total(profile, ScriptProfiler::TIMER)["count"].toULongLong(), (unsigned long long)ScriptProfiler::MAX_CALL_SITES + 4);
+}
+
+void ScriptProfilerTests::testReset() {
+    ScriptProfiler profiler;
+    profiler.record(ScriptProfiler::UPDATE, EntityItemID(), "Script.update", 100);
+    profiler.reset();
+
+    auto profile = profiler.toVariantMap();
+    QVERIFY(profile["entities"].toMap().isEmpty());
+    QCOMPARE(total(profile, ScriptProfiler::UPDATE)["count"].toULongLong(), 0ULL);
+
+    // recording works again after a reset, from zero
+    profiler.record(ScriptProfiler::UPDATE, EntityItemID(), "Script.update", 7);
+    profile = profiler.toVariantMap();
+    QCOMPARE(callSite(profile, EntityItemID(), ScriptProfiler::UPDATE, "Script.update")["totalUsecs"].toULongLong(), 7ULL);
+}
+
+void ScriptProfilerTests::testEntityUsecs() {
+    ScriptProfiler profiler;
+    EntityItemID entityA(QUuid::createUuid());
+    EntityItemID entityB(QUuid::createUuid());
+
+    // every call type counts toward its entity, calls of non-entity scripts toward none
+    profiler.record(ScriptProfiler::ENTITY_METHOD, entityA, "preload", 100);
+    profiler.record(ScriptProfiler::TIMER, entityA, "tick", 20);
+    profiler.record(ScriptProfiler::EVENT_HANDLER, entityB, "onClick", 5);
+    profiler.record(ScriptProfiler::UPDATE, EntityItemID(), "Script.update", 1000);
+
+    auto entityUsecs = profiler.takeEntityUsecs();
+    QCOMPARE(entityUsecs.size(), 2);
+    QCOMPARE(entityUsecs[entityA], 120ULL);
+    QCOMPARE(entityUsecs[entityB], 5ULL);
+
+    // each call only returns what was recorded since the previous one, the call site records keep accumulating
+    profiler.record(ScriptProfiler::TIMER, entityA, "tick", 7);
+    entityUsecs = profiler.takeEntityUsecs();
+    QCOMPARE(entityUsecs.size(), 1);
+    QCOMPARE(entityUsecs[entityA], 7ULL);
+    QCOMPARE(callSite(profiler.toVariantMap(), entityA, ScriptProfiler::TIMER, "tick")["totalUsecs"].toULongLong(), 27ULL);
+    QVERIFY(profiler.takeEntityUsecs().isEmpty());
+}
@@ -0,0 +1,27 @@
+//
+//  ScriptProfilerTests.h
+//  tests/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptProfilerTests_h
+#define hifi_ScriptProfilerTests_h
+
+#include <QtTest/QtTest>
+
+class ScriptProfilerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testAggregation();
+    void testHistogram();
+    void testOverflow();
+    void testReset();
+    void testEntityUsecs();
+};
+
+#endif // hifi_ScriptProfilerTests_h
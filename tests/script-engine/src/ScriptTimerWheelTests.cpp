@@ -0,0 +1,168 @@
+//
+//  ScriptTimerWheelTests.cpp
+//  tests/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptTimerWheelTests.h"
+
+#include <functional>
+#include <map>
+#include <vector>
+
+#include <ScriptTimerWheel.h>
+
+QTEST_MAIN(ScriptTimerWheelTests)
+
+const quint64 REVOLUTION_MSECS = ScriptTimerWheel::NUM_SLOTS * ScriptTimerWheel::TICK_MSECS;
+
+// Dispatches due entries the way ScriptEngine::timerFired() does: an entry only fires while its id is the
+// timer's current schedule id, and a repeating timer is rescheduled before its callback runs.
+class TimerDispatcher {
+public:
+    void start(ScriptTimer* timer, quint64 deadlineMsecs, std::function<void()> callback = nullptr) {
+        _callbacks[timer] = callback;
+        _scheduleIDs[timer] = wheel.schedule(timer, deadlineMsecs);
+    }
+
+    void stop(ScriptTimer* timer) { _scheduleIDs[timer] = 0; }
+
+    void advance(quint64 nowMsecs) {
+        std::vector<ScriptTimerWheel::Entry> due;
+        wheel.advance(nowMsecs, due);
+        for (auto& entry : due) {
+            if (_scheduleIDs[entry.timer] != entry.id) {
+                continue;
+            }
+            if (entry.timer->isSingleShot()) {
+                _scheduleIDs[entry.timer] = 0;
+            } else {
+                _scheduleIDs[entry.timer] = wheel.schedule(entry.timer, nowMsecs + entry.timer->getInterval());
+            }
+            fired.push_back(entry.timer);
+            if (_callbacks[entry.timer]) {
+                _callbacks[entry.timer]();
+            }
+        }
+    }
+
+    ScriptTimerWheel wheel;
+    std::vector<ScriptTimer*> fired;
+
+private:
+    std::map<ScriptTimer*, quint64> _scheduleIDs;
+    std::map<ScriptTimer*, std::function<void()>> _callbacks;
+};
+
+void ScriptTimerWheelTests::testFiringOrder() {
+    ScriptTimer late(nullptr, 40, true);
+    ScriptTimer early(nullptr, 8, true);
+    ScriptTimer nextRevolution(nullptr, (int)REVOLUTION_MSECS + 8, true);
+    ScriptTimer middle(nullptr, 20, true);
+
+    // scheduled out of order, and nextRevolution shares a slot with early
+    TimerDispatcher dispatcher;
+    for (auto timer : { &late, &early, &nextRevolution, &middle }) {
+        dispatcher.start(timer, timer->getInterval());
+    }
+    QCOMPARE(dispatcher.wheel.size(), (size_t)4);
+
+    dispatcher.advance(100);
+    QCOMPARE(dispatcher.fired, std::vector<ScriptTimer*>({ &early, &middle, &late }));
+
+    // a slot only gives up the entries of the current revolution
+    QCOMPARE(dispatcher.wheel.size(), (size_t)1);
+    dispatcher.advance(REVOLUTION_MSECS);
+    QCOMPARE(dispatcher.fired.size(), (size_t)3);
+
+    dispatcher.advance(REVOLUTION_MSECS + 8);
+    QCOMPARE(dispatcher.fired, std::vector<ScriptTimer*>({ &early, &middle, &late, &nextRevolution }));
+    QCOMPARE(dispatcher.wheel.size(), (size_t)0);
+}
+
+void ScriptTimerWheelTests::testCoalescing() {
+    const int TICK = ScriptTimerWheel::TICK_MSECS;
+    ScriptTimer first(nullptr, 2 * TICK - 1, true);
+    ScriptTimer second(nullptr, 2 * TICK, true);
+    ScriptTimer third(nullptr, TICK + 1, true);
+    ScriptTimer nextTick(nullptr, 2 * TICK + 1, true);
+
+    // deadlines are rounded up to the tick, so the first three are due together, in the order they were scheduled
+    TimerDispatcher dispatcher;
+    for (auto timer : { &first, &second, &third, &nextTick }) {
+        dispatcher.start(timer, timer->getInterval());
+    }
+
+    dispatcher.advance(2 * TICK - 1);
+    QVERIFY(dispatcher.fired.empty());
+
+    dispatcher.advance(2 * TICK);
+    QCOMPARE(dispatcher.fired, std::vector<ScriptTimer*>({ &first, &second, &third }));
+
+    dispatcher.advance(3 * TICK);
+    QCOMPARE(dispatcher.fired, std::vector<ScriptTimer*>({ &first, &second, &third, &nextTick }));
+}
+
+void ScriptTimerWheelTests::testCancelFromCallback() {
+    const int INTERVAL = 3 * ScriptTimerWheel::TICK_MSECS;
+    ScriptTimer stopsOther(nullptr, INTERVAL, false);
+    ScriptTimer stopped(nullptr, INTERVAL, false);
+    ScriptTimer stopsItself(nullptr, INTERVAL, false);
+
+    TimerDispatcher dispatcher;
+    dispatcher.start(&stopsOther, INTERVAL, [&] { dispatcher.stop(&stopped); });
+    dispatcher.start(&stopped, INTERVAL);
+    dispatcher.start(&stopsItself, INTERVAL, [&] { dispatcher.stop(&stopsItself); });
+
+    // stopped is due in the same batch, but its entry is no longer live by the time it is reached
+    dispatcher.advance(INTERVAL);
+    QCOMPARE(dispatcher.fired, std::vector<ScriptTimer*>({ &stopsOther, &stopsItself }));
+
+    // stopsItself was rescheduled before its callback ran, which stopping it from the callback undoes
+    dispatcher.advance(2 * INTERVAL);
+    dispatcher.advance(3 * INTERVAL);
+    QCOMPARE(dispatcher.fired, std::vector<ScriptTimer*>({ &stopsOther, &stopsItself, &stopsOther, &stopsOther }));
+
+    // cancelled entries stay in the wheel until their tick comes
+    dispatcher.stop(&stopsOther);
+    QCOMPARE(dispatcher.wheel.size(), (size_t)1);
+    dispatcher.advance(4 * INTERVAL);
+    QCOMPARE(dispatcher.fired.size(), (size_t)4);
+    QCOMPARE(dispatcher.wheel.size(), (size_t)0);
+}
+
+void ScriptTimerWheelTests::testCatchUpAfterStall() {
+    ScriptTimer first(nullptr, 8, true);
+    ScriptTimer second(nullptr, 1000, true);
+    ScriptTimer third(nullptr, (int)REVOLUTION_MSECS + 4, true);
+    ScriptTimer fourth(nullptr, (int)(3 * REVOLUTION_MSECS) + 12, true);
+    ScriptTimer repeating(nullptr, 100, false);
+
+    TimerDispatcher dispatcher;
+    for (auto timer : { &fourth, &third, &second, &first, &repeating }) {
+        dispatcher.start(timer, timer->getInterval());
+    }
+
+    // several revolutions pass in one advance: every slot is visited once and everything due fires, in order,
+    // with the repeating timer firing once rather than once for each interval it missed
+    const quint64 STALL_END = 4 * REVOLUTION_MSECS;
+    dispatcher.advance(STALL_END);
+    QCOMPARE(dispatcher.fired, std::vector<ScriptTimer*>({ &first, &repeating, &second, &third, &fourth }));
+    QCOMPARE(dispatcher.wheel.size(), (size_t)1);
+
+    // a deadline that is already past goes into the next tick, not into one that was skipped over
+    ScriptTimer past(nullptr, 0, true);
+    dispatcher.start(&past, 0);
+    dispatcher.advance(STALL_END + ScriptTimerWheel::TICK_MSECS - 1);
+    QCOMPARE(dispatcher.fired.size(), (size_t)5);
+    dispatcher.advance(STALL_END + ScriptTimerWheel::TICK_MSECS);
+    QCOMPARE(dispatcher.fired.back(), &past);
+
+    dispatcher.advance(STALL_END + 100);
+    QCOMPARE(dispatcher.fired.back(), &repeating);
+    QCOMPARE(dispatcher.fired.size(), (size_t)7);
+}
@@ -0,0 +1,26 @@
+//
+//  ScriptTimerWheelTests.h
+//  tests/script-engine/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptTimerWheelTests_h
+#define hifi_ScriptTimerWheelTests_h
+
+#include <QtTest/QtTest>
+
+class ScriptTimerWheelTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testFiringOrder();
+    void testCoalescing();
+    void testCancelFromCallback();
+    void testCatchUpAfterStall();
+};
+
+#endif // hifi_ScriptTimerWheelTests_h
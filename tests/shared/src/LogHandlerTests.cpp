@@ -0,0 +1,129 @@
+//
+//  LogHandlerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LogHandlerTests.h"
+
+#include <thread>
+#include <vector>
+
+#include <LogHandler.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(LogHandlerTests)
+
+void LogHandlerTests::initTestCase() {
+    qInstallMessageHandler(LogHandler::verboseMessageHandler);
+}
+
+void LogHandlerTests::testRepeatedMessages() {
+    auto& logHandler = LogHandler::getInstance();
+    logHandler.addRepeatedMessageRegex("^Repeated message \\d+");
+
+    QMessageLogContext context;
+    QVERIFY(!logHandler.printMessage(LogDebug, context, "Repeated message 1").isEmpty());
+    QVERIFY(logHandler.printMessage(LogDebug, context, "Repeated message 2").isEmpty());
+    QVERIFY(logHandler.printMessage(LogDebug, context, "Repeated message 3").isEmpty());
+
+    // only debug messages are suppressed
+    QVERIFY(!logHandler.printMessage(LogWarning, context, "Repeated message 4").isEmpty());
+    QVERIFY(!logHandler.printMessage(LogDebug, context, "Unrelated message").isEmpty());
+}
+
+void LogHandlerTests::testOnlyOnceMessages() {
+    auto& logHandler = LogHandler::getInstance();
+    logHandler.addOnlyOnceMessageRegex("^Once message");
+
+    QMessageLogContext context;
+    QVERIFY(!logHandler.printMessage(LogDebug, context, "Once message A").isEmpty());
+    QVERIFY(logHandler.printMessage(LogDebug, context, "Once message A").isEmpty());
+    QVERIFY(!logHandler.printMessage(LogDebug, context, "Once message B").isEmpty());
+}
+
+void LogHandlerTests::testAsyncOutput() {
+    const int NUM_MESSAGES = 100;
+    // more than the queue holds, which is fine as long as they are suppressed before taking a place in it
+    const int NUM_SUPPRESSED_MESSAGES = 1 << 15;
+
+    auto& logHandler = LogHandler::getInstance();
+    logHandler.addRepeatedMessageRegex("^Async storm message \\d+");
+
+    FILE* outputFile = tmpfile();
+    QVERIFY(outputFile);
+    logHandler.setOutputFile(outputFile);
+    auto numDroppedBefore = logHandler.getNumDroppedMessages();
+
+    logHandler.setAsyncOutput(true);
+    QVERIFY(logHandler.isAsyncOutput());
+    for (int i = 0; i < NUM_SUPPRESSED_MESSAGES; ++i) {
+        qDebug() << "Async storm message" << i;
+    }
+    for (int i = 0; i < NUM_MESSAGES; ++i) {
+        qDebug() << "Async message" << i;
+    }
+    logHandler.setAsyncOutput(false);
+    QVERIFY(!logHandler.isAsyncOutput());
+    logHandler.setOutputFile(stdout);
+
+    QCOMPARE(logHandler.getNumDroppedMessages(), numDroppedBefore);
+
+    rewind(outputFile);
+    QFile output;
+    QVERIFY(output.open(outputFile, QIODevice::ReadOnly));
+    QStringList lines = QString::fromLocal8Bit(output.readAll()).split('\n', QString::SkipEmptyParts);
+    output.close();
+    fclose(outputFile);
+
+    // the first message of the storm, then every other message in the order they were logged
+    QCOMPARE(lines.size(), NUM_MESSAGES + 1);
+    QVERIFY(lines[0].endsWith("Async storm message 0"));
+    for (int i = 0; i < NUM_MESSAGES; ++i) {
+        QVERIFY(lines[i + 1].endsWith(QString("Async message %1").arg(i)));
+    }
+}
+
+// log storms, as in the suppressed packet mismatch messages of LimitedNodeList
+void LogHandlerTests::benchmarkContention() {
+    const int NUM_THREADS = 8;
+    const int NUM_MESSAGES = 20000;
+
+    auto& logHandler = LogHandler::getInstance();
+    logHandler.addRepeatedMessageRegex("^Storm message from thread \\d+");
+
+    auto logStorm = [&] {
+        std::vector<std::thread> threads;
+        auto start = usecTimestampNow();
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            threads.emplace_back([i] {
+                for (int j = 0; j < NUM_MESSAGES; ++j) {
+                    qDebug() << "Storm message from thread" << i << "number" << j;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return usecTimestampNow() - start;
+    };
+
+    auto syncDuration = logStorm();
+
+    logHandler.setAsyncOutput(true);
+    auto numDroppedBefore = logHandler.getNumDroppedMessages();
+    auto asyncDuration = logStorm();
+    auto numDropped = logHandler.getNumDroppedMessages() - numDroppedBefore;
+    logHandler.setAsyncOutput(false);
+
+    const double numCalls = NUM_THREADS * NUM_MESSAGES;
+    qDebug() << "Log calls per second on" << NUM_THREADS << "threads, synchronous:"
+        << (quint64)(numCalls * USECS_PER_SECOND / syncDuration)
+        << "asynchronous:" << (quint64)(numCalls * USECS_PER_SECOND / asyncDuration)
+        << "with" << numDropped << "dropped";
+}
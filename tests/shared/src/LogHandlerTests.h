@@ -0,0 +1,27 @@
+//
+//  LogHandlerTests.h
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LogHandlerTests_h
+#define hifi_LogHandlerTests_h
+
+#include <QtTest/QtTest>
+
+class LogHandlerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testRepeatedMessages();
+    void testOnlyOnceMessages();
+    void testAsyncOutput();
+    void benchmarkContention();
+};
+
+#endif // hifi_LogHandlerTests_h
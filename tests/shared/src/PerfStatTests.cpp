@@ -0,0 +1,111 @@
+//
+//  PerfStatTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PerfStatTests.h"
+
+#include <thread>
+#include <vector>
+
+#include <PerfStat.h>
+
+QTEST_MAIN(PerfStatTests)
+
+static void timeInner() {
+    PERFORMANCE_TIMER("inner");
+}
+
+static void timeOuter() {
+    PERFORMANCE_TIMER("outer");
+    timeInner();
+    timeInner();
+}
+
+void PerfStatTests::cleanup() {
+    PerformanceTimer::setActive(false);
+}
+
+void PerfStatTests::testNestedTimers() {
+    // nothing is recorded while inactive
+    timeOuter();
+    PerformanceTimer::setActive(true);
+    PerformanceTimer::tallyAllTimerRecords();
+    QVERIFY(PerformanceTimer::getAllTimerRecords().isEmpty());
+
+    timeOuter();
+    timeInner();
+    QCOMPARE(PerformanceTimer::getContextName(), QString());
+    PerformanceTimer::tallyAllTimerRecords();
+
+    auto records = PerformanceTimer::getAllTimerRecords();
+    QCOMPARE(records.size(), 3);
+    QVERIFY(records.contains("/outer"));
+    QVERIFY(records.contains("/outer/inner"));
+    QVERIFY(records.contains("/inner"));
+    QCOMPARE(records["/outer/inner"].getCount(), (quint64)1);
+
+    {
+        PERFORMANCE_TIMER("outer");
+        QCOMPARE(PerformanceTimer::getContextName(), QString("/outer"));
+    }
+    QCOMPARE(PerformanceTimer::getContextName(), QString());
+}
+
+void PerfStatTests::testThreadedTimers() {
+    const int NUM_THREADS = 4;
+    const int NUM_CALLS = 1000;
+
+    PerformanceTimer::setActive(true);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([] {
+            for (int j = 0; j < NUM_CALLS; ++j) {
+                timeOuter();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    PerformanceTimer::tallyAllTimerRecords();
+
+    // the threads of a path are tallied together
+    auto records = PerformanceTimer::getAllTimerRecords();
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(records["/outer"].getCount(), (quint64)1);
+    QVERIFY(records["/outer"].getAverage() >= records["/outer/inner"].getAverage());
+}
+
+void PerfStatTests::testTimerRecords() {
+    PerformanceTimer::setActive(true);
+    PerformanceTimer::addTimerRecord("/physics/step", 100);
+    PerformanceTimer::addTimerRecord("/physics/step", 200);
+    PerformanceTimer::tallyAllTimerRecords();
+
+    auto record = PerformanceTimer::getTimerRecord("/physics/step");
+    QCOMPARE(record.getCount(), (quint64)1);
+    QCOMPARE(record.getAverage(), (quint64)300);
+    QCOMPARE(PerformanceTimer::registerTimer("step"), PerformanceTimer::registerTimer("step"));
+
+    PerformanceTimer::setActive(false);
+    QVERIFY(PerformanceTimer::getAllTimerRecords().isEmpty());
+}
+
+void PerfStatTests::benchmarkTimers() {
+    const int NUM_CALLS = 1000000;
+
+    PerformanceTimer::setActive(true);
+    auto start = usecTimestampNow();
+    for (int i = 0; i < NUM_CALLS; ++i) {
+        timeInner();
+    }
+    auto duration = usecTimestampNow() - start;
+    PerformanceTimer::tallyAllTimerRecords();
+    qDebug() << NUM_CALLS << "timed scopes took" << duration << "usecs";
+}
@@ -0,0 +1,27 @@
+//
+//  PerfStatTests.h
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PerfStatTests_h
+#define hifi_PerfStatTests_h
+
+#include <QtTest/QtTest>
+
+class PerfStatTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void testNestedTimers();
+    void testThreadedTimers();
+    void testTimerRecords();
+    void benchmarkTimers();
+};
+
+#endif // hifi_PerfStatTests_h
@@ -0,0 +1,233 @@
+//
+//  SpatiallyNestableTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatiallyNestableTests.h"
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <SpatiallyNestable.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(SpatiallyNestableTests)
+
+const float EPSILON = 0.0001f;
+
+class TestNestable : public SpatiallyNestable {
+public:
+    TestNestable() : SpatiallyNestable(NestableType::Entity, QUuid::createUuid()) {}
+};
+using TestNestablePointer = std::shared_ptr<TestNestable>;
+
+class TestParentFinder : public SpatialParentFinder {
+public:
+    SpatiallyNestableWeakPointer find(QUuid parentID, bool& success, SpatialParentTree* entityTree = nullptr) const override {
+        auto it = _objects.find(parentID);
+        success = it != _objects.end();
+        return success ? *it : SpatiallyNestableWeakPointer();
+    }
+
+    TestNestablePointer create(const QUuid& parentID = QUuid()) {
+        auto object = std::make_shared<TestNestable>();
+        _objects[object->getID()] = object;
+        object->setParentID(parentID);
+        return object;
+    }
+
+    void destroy(TestNestablePointer& object) {
+        _objects.remove(object->getID());
+        object.reset();
+    }
+
+private:
+    QHash<QUuid, SpatiallyNestableWeakPointer> _objects;
+};
+
+static QSharedPointer<TestParentFinder> finder() {
+    return DependencyManager::get<TestParentFinder>();
+}
+
+// a chain of objects each a unit further along x than its parent
+static std::vector<TestNestablePointer> makeChain(int length) {
+    std::vector<TestNestablePointer> chain;
+    QUuid parentID;
+    for (int i = 0; i < length; i++) {
+        auto object = finder()->create(parentID);
+        object->setLocalPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+        parentID = object->getID();
+        chain.push_back(object);
+    }
+    return chain;
+}
+
+void SpatiallyNestableTests::initTestCase() {
+    DependencyManager::registerInheritance<SpatialParentFinder, TestParentFinder>();
+    DependencyManager::set<TestParentFinder>();
+}
+
+void SpatiallyNestableTests::testWorldTransformFollowsAncestors() {
+    const int LENGTH = 8;
+    auto chain = makeChain(LENGTH);
+    auto& root = chain.front();
+    auto& leaf = chain.back();
+
+    bool success;
+    QCOMPARE_WITH_ABS_ERROR(leaf->getPosition(success), glm::vec3((float)LENGTH, 0.0f, 0.0f), EPSILON);
+    QVERIFY(success);
+
+    // a second read is served from the cache
+    quint64 generation = leaf->getWorldTransformGeneration();
+    QCOMPARE_WITH_ABS_ERROR(leaf->getPosition(success), glm::vec3((float)LENGTH, 0.0f, 0.0f), EPSILON);
+    QCOMPARE(leaf->getWorldTransformGeneration(), generation);
+
+    // moving and turning an ancestor reaches every descendant
+    root->setLocalPosition(glm::vec3(0.0f, 10.0f, 0.0f));
+    QVERIFY(leaf->getWorldTransformGeneration() != generation);
+    QCOMPARE_WITH_ABS_ERROR(leaf->getPosition(success), glm::vec3((float)(LENGTH - 1), 10.0f, 0.0f), EPSILON);
+
+    chain[LENGTH / 2]->setLocalOrientation(glm::angleAxis(PI / 2.0f, glm::vec3(0.0f, 1.0f, 0.0f)));
+    glm::vec3 expected((float)(LENGTH / 2), 10.0f, -(float)(LENGTH - 1 - LENGTH / 2));
+    QCOMPARE_WITH_ABS_ERROR(leaf->getPosition(success), expected, EPSILON);
+    QCOMPARE_QUATS(leaf->getOrientation(), glm::angleAxis(PI / 2.0f, glm::vec3(0.0f, 1.0f, 0.0f)), EPSILON);
+
+    // world-frame setters on a descendant still land where asked
+    leaf->setPosition(glm::vec3(3.0f, 4.0f, 5.0f));
+    QCOMPARE_WITH_ABS_ERROR(leaf->getPosition(success), glm::vec3(3.0f, 4.0f, 5.0f), EPSILON);
+
+    for (auto& object : chain) {
+        finder()->destroy(object);
+    }
+}
+
+void SpatiallyNestableTests::testReparenting() {
+    auto first = finder()->create();
+    first->setLocalPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+    auto second = finder()->create();
+    second->setLocalPosition(glm::vec3(0.0f, 2.0f, 0.0f));
+    auto child = finder()->create(first->getID());
+    child->setLocalPosition(glm::vec3(0.0f, 0.0f, 3.0f));
+    auto grandchild = finder()->create(child->getID());
+
+    bool success;
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(success), glm::vec3(1.0f, 0.0f, 3.0f), EPSILON);
+
+    child->setParentID(second->getID());
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(success), glm::vec3(0.0f, 2.0f, 3.0f), EPSILON);
+    QVERIFY(success);
+
+    // the old parent no longer moves it
+    first->setLocalPosition(glm::vec3(100.0f, 0.0f, 0.0f));
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(success), glm::vec3(0.0f, 2.0f, 3.0f), EPSILON);
+    second->setLocalPosition(glm::vec3(0.0f, 20.0f, 0.0f));
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(success), glm::vec3(0.0f, 20.0f, 3.0f), EPSILON);
+
+    // joints of a plain nestable are at its origin, but their transforms are never kept
+    child->setParentJointIndex(0);
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(success), glm::vec3(0.0f, 20.0f, 3.0f), EPSILON);
+    child->setParentJointIndex(INVALID_JOINT_INDEX);
+
+    child->setParentID(QUuid());
+    QCOMPARE_WITH_ABS_ERROR(grandchild->getPosition(success), glm::vec3(0.0f, 0.0f, 3.0f), EPSILON);
+
+    finder()->destroy(grandchild);
+    finder()->destroy(child);
+    finder()->destroy(second);
+    finder()->destroy(first);
+}
+
+void SpatiallyNestableTests::testDeletedParent() {
+    auto parent = finder()->create();
+    parent->setLocalPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    auto child = finder()->create(parent->getID());
+
+    bool success;
+    QCOMPARE_WITH_ABS_ERROR(child->getPosition(success), glm::vec3(1.0f, 2.0f, 3.0f), EPSILON);
+    QVERIFY(success);
+
+    finder()->destroy(parent);
+    child->getPosition(success);
+    QVERIFY(!success);
+
+    finder()->destroy(child);
+}
+
+// every query of the leaf walks the whole chain when something up it has moved, and none of it otherwise
+void SpatiallyNestableTests::benchmarkDeepHierarchy() {
+    const int NUM_QUERIES = 100000;
+    for (int length : { 2, 8, 16, 28 }) {
+        auto chain = makeChain(length);
+        auto& root = chain.front();
+        auto& leaf = chain.back();
+
+        glm::vec3 sum;
+        quint64 start = usecTimestampNow();
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            root->setLocalPosition(glm::vec3((float)(i & 1), 0.0f, 0.0f));
+            sum += leaf->getPosition();
+        }
+        quint64 moving = usecTimestampNow() - start;
+
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            sum += leaf->getPosition();
+        }
+        quint64 still = usecTimestampNow() - start;
+        QVERIFY(!isNaN(sum));
+
+        qDebug() << "depth" << length << ": moving" << (double)moving * 1000.0 / NUM_QUERIES << "nsecs/query,"
+                 << "still" << (double)still * 1000.0 / NUM_QUERIES << "nsecs/query";
+
+        for (auto& object : chain) {
+            finder()->destroy(object);
+        }
+    }
+}
+
+// children of one parent, as with many entities attached to an avatar
+void SpatiallyNestableTests::benchmarkWideHierarchy() {
+    const int NUM_FRAMES = 100;
+    for (int width : { 10, 100, 1000 }) {
+        auto root = finder()->create();
+        std::vector<TestNestablePointer> children;
+        for (int i = 0; i < width; i++) {
+            auto child = finder()->create(root->getID());
+            child->setLocalPosition(glm::vec3((float)i, 0.0f, 0.0f));
+            children.push_back(child);
+        }
+
+        // each frame the root moves once and every child is queried a few times, as by physics, rendering and scripts
+        const int QUERIES_PER_FRAME = 4;
+        glm::vec3 sum;
+        quint64 start = usecTimestampNow();
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            root->setLocalPosition(glm::vec3(0.0f, (float)frame, 0.0f));
+            for (int query = 0; query < QUERIES_PER_FRAME; query++) {
+                for (auto& child : children) {
+                    sum += child->getPosition();
+                }
+            }
+        }
+        quint64 elapsed = usecTimestampNow() - start;
+        QVERIFY(!isNaN(sum));
+
+        bool success;
+        QCOMPARE_WITH_ABS_ERROR(children.back()->getPosition(success),
+                                glm::vec3((float)(width - 1), (float)(NUM_FRAMES - 1), 0.0f), EPSILON);
+
+        qDebug() << "width" << width << ":" << (double)elapsed / NUM_FRAMES << "usecs/frame";
+
+        for (auto& child : children) {
+            finder()->destroy(child);
+        }
+        finder()->destroy(root);
+    }
+}
@@ -8,8 +8,15 @@
 
 #include "TraceTests.h"
 
+#include <thread>
+#include <vector>
+
 #include <QtTest/QtTest>
 #include <QtGui/QDesktopServices>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
 
 #include <Profile.h>
 
@@ -45,3 +52,157 @@ void TraceTests::testTraceSerialization() {
     qDebug() << "Done";
 }
 
+
+static QJsonArray readJsonTrace(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJsonArray();
+    }
+    return QJsonDocument::fromJson(file.readAll()).array();
+}
+
+void TraceTests::testBinaryTraceConversion() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString binaryPath = dir.path() + "/trace" + tracing::BINARY_TRACE_EXTENSION;
+    const QString jsonPath = dir.path() + "/trace.json";
+
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    PROFILE_SET_THREAD_NAME("Trace Test Thread");
+    tracer->startTracing();
+    {
+        PROFILE_RANGE(test, "TestRange")
+        PROFILE_COUNTER(test, "TestCounter", { { "value", 1.5 } })
+        PROFILE_INSTANT(test, "TestInstant", "g")
+        PROFILE_ASYNC_BEGIN(test, "TestAsync", "42", { { "label", "\"quoted\"" } })
+        PROFILE_ASYNC_END(test, "TestAsync", "42")
+    }
+    tracer->stopTracing();
+    tracer->serialize(binaryPath);
+
+    QVERIFY(tracing::convertTrace(binaryPath, jsonPath));
+    QJsonArray events = readJsonTrace(jsonPath);
+    QCOMPARE(events.size(), 7);
+
+    QMap<QString, QJsonObject> eventsByPhase;
+    for (const auto& value : events) {
+        QJsonObject event = value.toObject();
+        QCOMPARE(event["pid"].toVariant().toLongLong(), (qint64)QCoreApplication::applicationPid());
+        eventsByPhase.insert(event["ph"].toString(), event);
+    }
+
+    QCOMPARE(eventsByPhase["B"]["name"].toString(), QString("TestRange"));
+    QCOMPARE(eventsByPhase["B"]["cat"].toString(), QString("trace.test"));
+    QCOMPARE(eventsByPhase["B"]["args"].toObject()["nv_payload"].toInt(), 0);
+    QVERIFY(eventsByPhase["E"]["ts"].toDouble() >= eventsByPhase["B"]["ts"].toDouble());
+    QCOMPARE(eventsByPhase["C"]["args"].toObject()["value"].toDouble(), 1.5);
+    QCOMPARE(eventsByPhase["i"]["s"].toString(), QString("g"));
+    QCOMPARE(eventsByPhase["b"]["id"].toString(), QString("42"));
+    QCOMPARE(eventsByPhase["b"]["args"].toObject()["label"].toString(), QString("\"quoted\""));
+    QCOMPARE(eventsByPhase["M"]["args"].toObject()["name"].toString(), QString("Trace Test Thread"));
+
+    // a new trace starts out empty, but for the metadata
+    const QString directJsonPath = dir.path() + "/direct.json";
+    tracer->startTracing();
+    tracer->stopTracing();
+    tracer->serialize(directJsonPath);
+    QCOMPARE(readJsonTrace(directJsonPath).size(), 1); // only the metadata outlives a trace
+}
+
+void TraceTests::testThreadedTracing() {
+    const int NUM_THREADS = 4;
+    const int NUM_RANGES = 2000;
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString jsonPath = dir.path() + "/threaded.json";
+
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    auto start = usecTimestampNow();
+    {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < NUM_THREADS; ++i) {
+            threads.emplace_back([] {
+                for (int j = 0; j < NUM_RANGES; ++j) {
+                    PROFILE_RANGE(test, "ThreadedRange")
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    auto duration = usecTimestampNow() - start;
+    tracer->stopTracing();
+    qDebug() << "Recording" << NUM_THREADS * NUM_RANGES << "ranges on" << NUM_THREADS << "threads took"
+        << duration << "usecs";
+
+    QCOMPARE(tracer->getNumDroppedEvents(), (uint64_t)0);
+    tracer->serialize(jsonPath);
+
+    QJsonArray events = readJsonTrace(jsonPath);
+    QCOMPARE(events.size(), 2 * NUM_THREADS * NUM_RANGES);
+
+    QMap<qint64, int> depthByThread;
+    for (const auto& value : events) {
+        QJsonObject event = value.toObject();
+        auto threadID = event["tid"].toVariant().toLongLong();
+        // events of a thread are in order, so that ranges are balanced
+        depthByThread[threadID] += event["ph"].toString() == "B" ? 1 : -1;
+        QVERIFY(depthByThread[threadID] >= 0);
+    }
+    for (auto depth : depthByThread) {
+        QCOMPARE(depth, 0);
+    }
+}
+
+void TraceTests::testIDsAndStringReset() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString firstPath = dir.path() + "/first.json";
+    const QString secondPath = dir.path() + "/second" + tracing::BINARY_TRACE_EXTENSION;
+    const QString secondJsonPath = dir.path() + "/second.json";
+    const QString URL_ID = "atp:/models/chair.fbx";
+
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    {
+        PROFILE_RANGE(test, "FirstRange")
+        PROFILE_ASYNC_BEGIN(test, "TestAsync", "7")
+        PROFILE_ASYNC_END(test, "TestAsync", "007")
+    }
+    tracer->stopTracing();
+    tracer->serialize(firstPath);
+
+    QMap<QString, QString> idsByPhase;
+    for (const auto& value : readJsonTrace(firstPath)) {
+        QJsonObject event = value.toObject();
+        idsByPhase.insert(event["ph"].toString(), event["id"].toString());
+    }
+    QCOMPARE(idsByPhase["b"], QString("7"));
+    QCOMPARE(idsByPhase["e"], QString("007"));
+
+    // the string table of the first trace is gone, names cached by this thread must be interned again
+    tracer->startTracing();
+    {
+        PROFILE_RANGE(test, "SecondRange")
+        PROFILE_ASYNC_BEGIN(test, "TestAsync", URL_ID, { { "url", URL_ID } })
+        PROFILE_ASYNC_END(test, "TestAsync", URL_ID)
+    }
+    tracer->stopTracing();
+    tracer->serialize(secondPath);
+
+    QVERIFY(tracing::convertTrace(secondPath, secondJsonPath));
+    QMap<QString, QJsonObject> eventsByPhase;
+    for (const auto& value : readJsonTrace(secondJsonPath)) {
+        QJsonObject event = value.toObject();
+        eventsByPhase.insert(event["ph"].toString(), event);
+    }
+    QCOMPARE(eventsByPhase["B"]["name"].toString(), QString("SecondRange"));
+    QCOMPARE(eventsByPhase["B"]["cat"].toString(), QString("trace.test"));
+    QCOMPARE(eventsByPhase["b"]["name"].toString(), QString("TestAsync"));
+    QCOMPARE(eventsByPhase["b"]["id"].toString(), URL_ID);
+    QCOMPARE(eventsByPhase["b"]["args"].toObject()["url"].toString(), URL_ID);
+    QCOMPARE(eventsByPhase["e"]["id"].toString(), URL_ID);
+}
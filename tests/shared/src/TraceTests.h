@@ -15,6 +15,9 @@ class TraceTests : public QObject {
     Q_OBJECT
 private slots:
     void testTraceSerialization();
+    void testBinaryTraceConversion();
+    void testThreadedTracing();
+    void testIDsAndStringReset();
 };
 
 #endif // hifi_TraceTests_h
@@ -0,0 +1,349 @@
+//
+//  AudioMixerBenchApp.cpp
+//  tools/audio-mixer-bench/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerBenchApp.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QThread>
+
+#include <AudioHelpers.h>
+#include <NLPacket.h>
+#include <NumericalConstants.h>
+#include <PortableHighResolutionClock.h>
+#include <ReceivedMessage.h>
+
+#include "AudioFarFieldBeds.h"
+#include "AudioMixerClientData.h"
+#include "AudioMixerSlavePool.h"
+#include "AudioMixerStats.h"
+
+static const float TWO_PI = 2.0f * 3.14159265f;
+
+// talkers alternate between talking and silence over this many frames, on average
+static const int MEAN_TALK_CYCLE_FRAMES = 200;
+
+// frames queued on each stream before the first mix, so they start unstarved
+static const int PREFILL_FRAMES = 2;
+
+static QList<int> parseIntList(const QString& value) {
+    QList<int> list;
+    for (auto& item : value.split(',', QString::SkipEmptyParts)) {
+        list.push_back(item.toInt());
+    }
+    return list;
+}
+
+AudioMixerBenchApp::AudioMixerBenchApp(int argc, char* argv[]) : QCoreApplication(argc, argv) {
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity Audio Mixer Benchmark");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption listenersOption("listeners", "comma-separated numbers of listeners, who also talk (default 25,50,100)",
+        "counts", "25,50,100");
+    parser.addOption(listenersOption);
+
+    const QCommandLineOption injectorsOption("injectors", "comma-separated numbers of injected streams (default 0)",
+        "counts", "0");
+    parser.addOption(injectorsOption);
+
+    const QCommandLineOption budgetOption("budget", "comma-separated full renders per listener, -1 for unlimited (default -1)",
+        "renders", "-1");
+    parser.addOption(budgetOption);
+
+    const QCommandLineOption framesOption("frames", "measured frames per run (default 1000)", "frames");
+    parser.addOption(framesOption);
+
+    const QCommandLineOption warmupOption("warmup", "unmeasured frames before each run (default 100)", "frames");
+    parser.addOption(warmupOption);
+
+    const QCommandLineOption threadsOption("threads", "mixer slave threads (default is the ideal thread count)", "threads");
+    parser.addOption(threadsOption);
+
+    const QCommandLineOption worldSizeOption("world-size", "edge of the cube sources are placed in (default 50m)", "meters");
+    parser.addOption(worldSizeOption);
+
+    const QCommandLineOption talkRatioOption("talk-ratio", "fraction of the time each listener talks (default 0.5)", "ratio");
+    parser.addOption(talkRatioOption);
+
+    const QCommandLineOption farFieldOption("far-field-distance", "distance at which far-field beds take over (default off)",
+        "meters");
+    parser.addOption(farFieldOption);
+
+    const QCommandLineOption cellSizeOption("far-field-cell-size", "far-field bed cell size (default 10m)", "meters");
+    parser.addOption(cellSizeOption);
+
+    const QCommandLineOption seedOption("seed", "seed for source placement and audio (default 1)", "seed");
+    parser.addOption(seedOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        _returnCode = 1;
+        return;
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        return;
+    }
+
+    if (parser.isSet(framesOption)) {
+        _numFrames = std::max(1, parser.value(framesOption).toInt());
+    }
+    if (parser.isSet(warmupOption)) {
+        _numWarmupFrames = std::max(0, parser.value(warmupOption).toInt());
+    }
+    _numThreads = parser.isSet(threadsOption) ? parser.value(threadsOption).toInt() : QThread::idealThreadCount();
+    if (parser.isSet(worldSizeOption)) {
+        _worldSize = parser.value(worldSizeOption).toFloat();
+    }
+    if (parser.isSet(talkRatioOption)) {
+        _talkRatio = glm::clamp(parser.value(talkRatioOption).toFloat(), 0.0f, 1.0f);
+    }
+    if (parser.isSet(farFieldOption)) {
+        _farFieldDistance = parser.value(farFieldOption).toFloat();
+    }
+    if (parser.isSet(cellSizeOption)) {
+        _farFieldCellSize = parser.value(cellSizeOption).toFloat();
+    }
+    _generator.seed(parser.isSet(seedOption) ? parser.value(seedOption).toUInt() : 1);
+
+    printf("%9s %9s %8s | %8s %8s %8s %8s %7s | %9s %9s %9s %9s %10s | %8s %8s\n",
+        "listeners", "injectors", "budget",
+        "p50 ms", "p90 ms", "p99 ms", "max ms", "frame",
+        "hrtf/f", "silent/f", "downmix/f", "culled/f", "hrtf/s", "decodes/f", "sent KB/f");
+
+    for (int numListeners : parseIntList(parser.value(listenersOption))) {
+        for (int numInjectors : parseIntList(parser.value(injectorsOption))) {
+            for (int rendersPerListener : parseIntList(parser.value(budgetOption))) {
+                runScenario({ numListeners, numInjectors, std::max(rendersPerListener, AudioMixerSlave::UNLIMITED_RENDERS) });
+            }
+        }
+    }
+}
+
+void AudioMixerBenchApp::runScenario(const Scenario& scenario) {
+    // the slaves run the whole mix, mute and environment checks and encode included, and send into this sink
+    std::atomic<uint64_t> sentBytes { 0 };
+    AudioMixerSlavePool slavePool(_numThreads, [&](std::unique_ptr<NLPacket> packet, const Node&) {
+        sentBytes += packet->getDataSize();
+    });
+
+    AudioFarFieldBeds farFieldBeds;
+    farFieldBeds.setFarFieldDistance(_farFieldDistance);
+    farFieldBeds.setCellSize(_farFieldCellSize);
+
+    // listeners need an active socket to be mixed for, though nothing is sent to it
+    quint16 port = 0;
+    auto createNode = [&] {
+        HifiSockAddr socket(QHostAddress::LocalHost, ++port);
+        SharedNodePointer node { new Node(QUuid::createUuid(), NodeType::Agent, socket, socket, NodePermissions()) };
+        node->activatePublicSocket();
+        node->setLinkedData(std::unique_ptr<NodeData> { new AudioMixerClientData(node->getUUID()) });
+        return node;
+    };
+
+    // every listener talks through its microphone stream
+    std::vector<SharedNodePointer> nodes;
+    std::vector<Source> talkers;
+    for (int i = 0; i < scenario.numListeners; ++i) {
+        nodes.push_back(createNode());
+        addSource(talkers, true);
+    }
+
+    // injectors all belong to one node without a microphone, like a script server
+    std::vector<Source> injectors;
+    SharedNodePointer injectorNode;
+    if (scenario.numInjectors > 0) {
+        injectorNode = createNode();
+        nodes.push_back(injectorNode);
+        for (int i = 0; i < scenario.numInjectors; ++i) {
+            addSource(injectors, false);
+        }
+    }
+
+    std::vector<uint64_t> frameTimes;
+    frameTimes.reserve(_numFrames);
+    uint64_t totalMixTime = 0;
+    AudioMixerStats totalStats;
+    uint64_t totalSentBytes = 0;
+
+    for (int frame = 0; frame < _numWarmupFrames + _numFrames; ++frame) {
+        int numPackets = (frame == 0) ? 1 + PREFILL_FRAMES : 1;
+        for (int packet = 0; packet < numPackets; ++packet) {
+            for (int i = 0; i < scenario.numListeners; ++i) {
+                sendMicrophoneFrame(nodes[i], talkers[i]);
+            }
+            for (auto& injector : injectors) {
+                sendInjectorFrame(injectorNode, injector);
+            }
+        }
+
+        // as in AudioMixer::start
+        auto frameStart = p_high_resolution_clock::now();
+
+        AudioMixerStats frameStats;
+        for (auto& node : nodes) {
+            frameStats.sumStreams += static_cast<AudioMixerClientData*>(node->getLinkedData())->checkBuffersBeforeFrameSend();
+        }
+        farFieldBeds.prepare(nodes.cbegin(), nodes.cend());
+        frameStats.farFieldBeds += farFieldBeds.getNumBeds();
+        frameStats.farFieldEncodes += farFieldBeds.getNumEncodes();
+
+        uint64_t sentBytesBefore = sentBytes;
+        auto mixStart = p_high_resolution_clock::now();
+        slavePool.mix(nodes.cbegin(), nodes.cend(), frame + 1, scenario.rendersPerListener, &farFieldBeds);
+        auto frameEnd = p_high_resolution_clock::now();
+
+        slavePool.each([&](AudioMixerSlave& slave) {
+            frameStats.accumulate(slave.stats);
+            slave.stats.reset();
+        });
+
+        if (frame >= _numWarmupFrames) {
+            frameTimes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(frameEnd - frameStart).count());
+            totalMixTime += std::chrono::duration_cast<std::chrono::microseconds>(frameEnd - mixStart).count();
+            totalStats.accumulate(frameStats);
+            totalSentBytes += sentBytes - sentBytesBefore;
+        }
+    }
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+    auto percentile = [&](float ratio) {
+        size_t index = std::min(frameTimes.size() - 1, (size_t)(ratio * frameTimes.size()));
+        return frameTimes[index] / (float)USECS_PER_MSEC;
+    };
+
+    uint64_t totalFrameTime = 0;
+    for (auto time : frameTimes) {
+        totalFrameTime += time;
+    }
+
+    // the mixer starts budgeting renders when its trailing frame time passes 90% of a network frame
+    float frameRatio = (totalFrameTime / (float)_numFrames) / AudioConstants::NETWORK_FRAME_USECS;
+
+    float perFrame = 1.0f / _numFrames;
+    float rendersPerSecond = totalMixTime > 0 ? totalStats.hrtfRenders * (USECS_PER_SECOND / (float)totalMixTime) : 0.0f;
+
+    printf("%9d %9d %8d | %8.3f %8.3f %8.3f %8.3f %6.0f%% | %9.1f %9.1f %9.1f %9.1f %10.0f | %8.1f %8.1f\n",
+        scenario.numListeners, scenario.numInjectors, scenario.rendersPerListener,
+        percentile(0.5f), percentile(0.9f), percentile(0.99f), frameTimes.back() / (float)USECS_PER_MSEC, frameRatio * 100.0f,
+        totalStats.hrtfRenders * perFrame, totalStats.hrtfSilentRenders * perFrame,
+        totalStats.downmixMixes * perFrame, totalStats.hrtfThrottleRenders * perFrame, rendersPerSecond,
+        totalStats.farFieldDecodes * perFrame, totalSentBytes * perFrame / BYTES_PER_KILOBYTE);
+    fflush(stdout);
+}
+
+void AudioMixerBenchApp::addSource(std::vector<Source>& sources, bool isTalker) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    Source source;
+    source.streamID = isTalker ? QUuid() : QUuid::createUuid();
+    source.position = glm::vec3(unit(_generator), 0.0f, unit(_generator)) * _worldSize;
+    source.orientation = glm::angleAxis(unit(_generator) * TWO_PI, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // voices sit low with varying levels, injectors play at full volume across the range
+    source.frequency = isTalker ? 100.0f + 200.0f * unit(_generator) : 100.0f + 900.0f * unit(_generator);
+    source.amplitude = isTalker ? 0.05f + 0.25f * unit(_generator) : 0.25f;
+
+    if (isTalker) {
+        source.isTalking = unit(_generator) < _talkRatio;
+        source.framesLeftInState = (int)(unit(_generator) * MEAN_TALK_CYCLE_FRAMES);
+    }
+
+    sources.push_back(source);
+}
+
+void AudioMixerBenchApp::generateFrame(Source& source, AudioConstants::AudioSample* samples) {
+    std::uniform_real_distribution<float> noise(-0.1f, 0.1f);
+
+    const float phaseStep = TWO_PI * source.frequency / AudioConstants::SAMPLE_RATE;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++i) {
+        float sample = glm::sin(source.phase) + 0.5f * glm::sin(2.0f * source.phase) + noise(_generator);
+        samples[i] = (AudioConstants::AudioSample)(source.amplitude * sample * AudioConstants::MAX_SAMPLE_VALUE);
+
+        source.phase += phaseStep;
+        if (source.phase > TWO_PI) {
+            source.phase -= TWO_PI;
+        }
+    }
+}
+
+void AudioMixerBenchApp::sendMicrophoneFrame(const SharedNodePointer& node, Source& source) {
+    if (--source.framesLeftInState <= 0) {
+        // exponentially distributed talk spurts and pauses
+        source.isTalking = !source.isTalking;
+        float meanFrames = MEAN_TALK_CYCLE_FRAMES * (source.isTalking ? _talkRatio : 1.0f - _talkRatio);
+        std::exponential_distribution<float> duration(1.0f / std::max(meanFrames, 1.0f));
+        source.framesLeftInState = 1 + (int)duration(_generator);
+    }
+
+    // laid out as in AbstractAudioInterface::emitAudioPacket
+    auto packet = NLPacket::create(source.isTalking ? PacketType::MicrophoneAudioNoEcho : PacketType::SilentAudioFrame);
+    packet->writePrimitive(source.sequence++);
+    packet->writeString(QString());
+
+    if (source.isTalking) {
+        quint8 isStereo = 0;
+        packet->writePrimitive(isStereo);
+    } else {
+        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+        packet->writePrimitive(numSilentSamples);
+    }
+
+    const glm::vec3 AVATAR_BOUNDING_BOX_SCALE { 0.5f, 1.8f, 0.5f };
+    packet->writePrimitive(source.position);
+    packet->writePrimitive(source.orientation);
+    packet->writePrimitive(source.position - 0.5f * AVATAR_BOUNDING_BOX_SCALE);
+    packet->writePrimitive(AVATAR_BOUNDING_BOX_SCALE);
+
+    if (source.isTalking) {
+        AudioConstants::AudioSample samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+        generateFrame(source, samples);
+        packet->write(reinterpret_cast<const char*>(samples), sizeof(samples));
+    }
+
+    ReceivedMessage message(*packet);
+    node->getLinkedData()->parseData(message);
+}
+
+void AudioMixerBenchApp::sendInjectorFrame(const SharedNodePointer& node, Source& source) {
+    // laid out as in AudioInjector::injectNextFrame
+    auto packet = NLPacket::create(PacketType::InjectAudio);
+    packet->writePrimitive(source.sequence++);
+    packet->writeString(QString());
+
+    QDataStream packetStream(packet.get());
+    packetStream << source.streamID;
+    packetStream << false; // stereo
+    packetStream << (uchar)0; // loopback
+    packetStream.writeRawData(reinterpret_cast<const char*>(&source.position), sizeof(source.position));
+    packetStream.writeRawData(reinterpret_cast<const char*>(&source.orientation), sizeof(source.orientation));
+    packetStream.writeRawData(reinterpret_cast<const char*>(&source.position), sizeof(source.position));
+    glm::vec3 boxCorner = glm::vec3(0);
+    packetStream.writeRawData(reinterpret_cast<const char*>(&boxCorner), sizeof(boxCorner));
+    packetStream << 0.0f; // radius
+    packetStream << packFloatGainToByte(1.0f);
+    packetStream << false; // ignore penumbra
+
+    AudioConstants::AudioSample samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    generateFrame(source, samples);
+    packet->write(reinterpret_cast<const char*>(samples), sizeof(samples));
+
+    ReceivedMessage message(*packet);
+    node->getLinkedData()->parseData(message);
+}
@@ -0,0 +1,78 @@
+//
+//  AudioMixerBenchApp.h
+//  tools/audio-mixer-bench/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerBenchApp_h
+#define hifi_AudioMixerBenchApp_h
+
+#include <random>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <AudioConstants.h>
+#include <Node.h>
+
+// Mixes generated audio from fake listeners and injectors through the audio-mixer slave pool, encoding
+// the mixes and sending them into a sink instead of the network, and reports frame times and HRTF render
+// counts as the load grows.
+class AudioMixerBenchApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    AudioMixerBenchApp(int argc, char* argv[]);
+
+    int getReturnCode() const { return _returnCode; }
+
+private:
+    struct Scenario {
+        int numListeners;
+        int numInjectors;
+        int rendersPerListener;
+    };
+
+    // a generated source of audio, standing in for a client microphone or an injector
+    struct Source {
+        QUuid streamID;
+        glm::vec3 position;
+        glm::quat orientation;
+        quint16 sequence { 0 };
+
+        float frequency;
+        float phase { 0.0f };
+        float amplitude;
+
+        // microphones alternate between talking and silence, injectors always play
+        bool isTalking { true };
+        int framesLeftInState { 0 };
+    };
+
+    void runScenario(const Scenario& scenario);
+
+    void addSource(std::vector<Source>& sources, bool isTalker);
+    void generateFrame(Source& source, AudioConstants::AudioSample* samples);
+    void sendMicrophoneFrame(const SharedNodePointer& node, Source& source);
+    void sendInjectorFrame(const SharedNodePointer& node, Source& source);
+
+    std::mt19937 _generator;
+
+    int _numFrames { 1000 };
+    int _numWarmupFrames { 100 };
+    int _numThreads { 0 };
+    float _worldSize { 50.0f };
+    float _talkRatio { 0.5f };
+    float _farFieldDistance { 0.0f };
+    float _farFieldCellSize { 10.0f };
+
+    int _returnCode { 0 };
+};
+
+#endif // hifi_AudioMixerBenchApp_h
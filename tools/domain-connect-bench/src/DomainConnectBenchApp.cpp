@@ -0,0 +1,186 @@
+//
+//  DomainConnectBenchApp.cpp
+//  tools/domain-connect-bench/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DomainConnectBenchApp.h"
+
+#include <algorithm>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDataStream>
+
+#include <DomainHandler.h>
+#include <NodeType.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <UUID.h>
+#include <udt/PacketHeaders.h>
+
+const quint16 DEFAULT_API_PORT = 40181;
+const int CHECK_IN_INTERVAL_MSECS = 1000;
+
+DomainConnectBenchApp::DomainConnectBenchApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity domain-server connect benchmark");
+    parser.addHelpOption();
+
+    const QCommandLineOption domainServerOption("d", "domain-server address", "IP:PORT", "127.0.0.1");
+    parser.addOption(domainServerOption);
+
+    const QCommandLineOption numAgentsOption("n", "number of agents connecting at once", "agents", "200");
+    parser.addOption(numAgentsOption);
+
+    const QCommandLineOption apiPortOption("api-port", "port of the metaverse API stand-in", "port",
+        QString::number(DEFAULT_API_PORT));
+    parser.addOption(apiPortOption);
+
+    const QCommandLineOption durationOption("duration", "seconds to give up after", "seconds", "60");
+    parser.addOption(durationOption);
+
+    const QCommandLineOption anonymousOption("anonymous", "connect without usernames");
+    parser.addOption(anonymousOption);
+
+    parser.process(*this);
+
+    QString hostnamePortString = parser.value(domainServerOption);
+    int portIndex = hostnamePortString.indexOf(':');
+    quint16 port = portIndex == -1 ? DEFAULT_DOMAIN_SERVER_PORT : (quint16)hostnamePortString.mid(portIndex + 1).toUInt();
+    _domainServerAddr = HifiSockAddr(QHostAddress(hostnamePortString.left(portIndex)), port);
+
+    _isAnonymous = parser.isSet(anonymousOption);
+    _durationSecs = parser.value(durationOption).toInt();
+
+    quint16 apiPort = parser.value(apiPortOption).toUShort();
+    _metaverseAPI.reset(new FakeMetaverseAPI(apiPort));
+
+    int numAgents = parser.value(numAgentsOption).toInt();
+    _agents.resize(numAgents);
+    for (int i = 0; i < numAgents; ++i) {
+        Agent& agent = _agents[i];
+        agent.username = _isAnonymous ? QString() : QString("bench_agent_%1").arg(i);
+        agent.socket.reset(new udt::Socket());
+        agent.socket->bind(QHostAddress::AnyIPv4, 0);
+
+        // the domain list is sent as a message, everything else as single packets
+        auto handler = [this, &agent](std::unique_ptr<udt::Packet> packet) { processPacket(agent, std::move(packet)); };
+        agent.socket->setPacketHandler(handler);
+        agent.socket->setMessageHandler(handler);
+    }
+
+    qDebug() << "Connecting" << numAgents << (_isAnonymous ? "anonymous" : "logged in") << "agents to"
+        << _domainServerAddr << "- metaverse API stand-in is listening on port" << apiPort;
+
+    connect(&_checkInTimer, &QTimer::timeout, this, &DomainConnectBenchApp::checkIn);
+    _checkInTimer.start(CHECK_IN_INTERVAL_MSECS);
+    checkIn();
+}
+
+void DomainConnectBenchApp::checkIn() {
+    int numAdmitted = (int)std::count_if(_agents.begin(), _agents.end(), [](const Agent& agent) {
+        return agent.admittedUsecs != 0;
+    });
+
+    if (_elapsedSecs > 0) {
+        qDebug() << "second" << _elapsedSecs << "- admitted" << _numAdmittedThisSecond << "denied" << _numDeniedThisSecond
+            << "- served" << _metaverseAPI->takeNumKeyRequests() << "public keys -" << numAdmitted << "/" << _agents.size()
+            << "agents in";
+    }
+    _numAdmittedThisSecond = _numDeniedThisSecond = 0;
+
+    if (numAdmitted == (int)_agents.size() || _elapsedSecs++ >= _durationSecs) {
+        _checkInTimer.stop();
+        printSummary();
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
+
+    // like interface, agents re-send their connect request every second until they are in
+    for (auto& agent : _agents) {
+        if (agent.admittedUsecs == 0) {
+            sendConnectRequest(agent);
+        }
+    }
+}
+
+void DomainConnectBenchApp::sendConnectRequest(Agent& agent) {
+    if (agent.startUsecs == 0) {
+        agent.startUsecs = usecTimestampNow();
+    }
+
+    auto packet = NLPacket::create(PacketType::DomainConnectRequest);
+    QDataStream packetStream(packet.get());
+
+    packetStream << QUuid();
+
+    QByteArray protocolVersionSig = protocolVersionsSignature();
+    packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+    // no hardware address, and a null machine fingerprint as a logged in interface sends
+    packetStream << QString() << QUuid();
+
+    // the domain-server fills in a null public address from where the request came from
+    HifiSockAddr publicSockAddr(QHostAddress(), agent.socket->localPort());
+    HifiSockAddr localSockAddr(QHostAddress::LocalHost, agent.socket->localPort());
+    QList<NodeType_t> interestList { NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::EntityServer };
+    packetStream << (NodeType_t)NodeType::Agent << publicSockAddr << localSockAddr << interestList << QString();
+
+    packetStream << agent.username;
+
+    if (!agent.connectionToken.isNull()) {
+        QByteArray lowercaseUsernameUTF8 = agent.username.toLower().toUtf8();
+        packetStream << _metaverseAPI->sign(lowercaseUsernameUTF8.append(agent.connectionToken.toRfc4122()));
+    }
+
+    agent.socket->writePacket(*packet, _domainServerAddr);
+}
+
+void DomainConnectBenchApp::processPacket(Agent& agent, std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    switch (nlPacket->getType()) {
+        case PacketType::DomainServerConnectionToken:
+            // answer with the signed token right away, like interface does
+            agent.connectionToken = QUuid::fromRfc4122(nlPacket->read(NUM_BYTES_RFC4122_UUID));
+            sendConnectRequest(agent);
+            break;
+        case PacketType::DomainList:
+            if (agent.admittedUsecs == 0) {
+                agent.admittedUsecs = usecTimestampNow();
+                ++_numAdmittedThisSecond;
+            }
+            break;
+        case PacketType::DomainConnectionDenied:
+            ++agent.numDenials;
+            ++_numDeniedThisSecond;
+            break;
+        default:
+            break;
+    }
+}
+
+void DomainConnectBenchApp::printSummary() {
+    std::vector<quint64> waits;
+    int numDenials = 0;
+    for (auto& agent : _agents) {
+        if (agent.admittedUsecs != 0) {
+            waits.push_back(agent.admittedUsecs - agent.startUsecs);
+        }
+        numDenials += agent.numDenials;
+    }
+    std::sort(waits.begin(), waits.end());
+
+    qDebug() << waits.size() << "/" << _agents.size() << "agents admitted," << numDenials << "denials";
+    if (!waits.empty()) {
+        auto msecs = [](quint64 usecs) { return (float)usecs / USECS_PER_MSEC; };
+        qDebug() << "time to admission (ms): median" << msecs(waits[waits.size() / 2])
+            << "90th" << msecs(waits[waits.size() * 9 / 10]) << "max" << msecs(waits.back());
+    }
+}
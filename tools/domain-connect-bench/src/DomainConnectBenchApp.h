@@ -0,0 +1,62 @@
+//
+//  DomainConnectBenchApp.h
+//  tools/domain-connect-bench/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DomainConnectBenchApp_h
+#define hifi_DomainConnectBenchApp_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+
+#include <NLPacket.h>
+#include <udt/Socket.h>
+
+#include "FakeMetaverseAPI.h"
+
+// Connects a crowd of simulated agents to a domain-server at once, and reports how long they wait to be admitted.
+//   Agents log in with usernames signed by the keypair of a local stand-in for the metaverse API,
+//   so the domain-server needs to be started with --oauth-provider http://127.0.0.1:<api-port>.
+//   Admitted agents stop checking in, and are timed out by the domain-server after a few seconds.
+class DomainConnectBenchApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    DomainConnectBenchApp(int argc, char* argv[]);
+
+private:
+    struct Agent {
+        std::unique_ptr<udt::Socket> socket;
+        QString username;
+        QUuid connectionToken;
+        quint64 startUsecs { 0 };
+        quint64 admittedUsecs { 0 };
+        int numDenials { 0 };
+    };
+
+    void checkIn();
+    void sendConnectRequest(Agent& agent);
+    void processPacket(Agent& agent, std::unique_ptr<udt::Packet> packet);
+    void printSummary();
+
+    HifiSockAddr _domainServerAddr;
+    bool _isAnonymous { false };
+    int _durationSecs { 60 };
+    int _elapsedSecs { 0 };
+
+    std::unique_ptr<FakeMetaverseAPI> _metaverseAPI;
+    std::vector<Agent> _agents;
+    QTimer _checkInTimer;
+
+    int _numAdmittedThisSecond { 0 };
+    int _numDeniedThisSecond { 0 };
+};
+
+#endif // hifi_DomainConnectBenchApp_h
@@ -0,0 +1,15 @@
+//
+//  main.cpp
+//  tools/domain-connect-bench/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+
+#include "DomainConnectBenchApp.h"
+
+int main(int argc, char* argv[]) {
+    DomainConnectBenchApp app(argc, argv);
+    return app.exec();
+}
@@ -17,6 +17,10 @@
 #include <NetworkLogging.h>
 
 #include "ICEClientApp.h"
+#include "ICELoadTest.h"
+
+const quint16 DEFAULT_LOAD_TEST_API_PORT = 40180;
+const int DEFAULT_LOAD_TEST_DURATION_SECS = 30;
 
 ICEClientApp::ICEClientApp(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
@@ -43,6 +47,19 @@ ICEClientApp::ICEClientApp(int argc, char* argv[]) :
     const QCommandLineOption cacheSTUNOption("s", "cache stun-server response");
     parser.addOption(cacheSTUNOption);
 
+    const QCommandLineOption loadTestOption("load-test",
+        "heartbeat this many simulated domains to the ice-server, which should be run with "
+        "--metaverse-url http://127.0.0.1:<api-port>", "domains");
+    parser.addOption(loadTestOption);
+
+    const QCommandLineOption apiPortOption("api-port", "port of the load test's public key API stand-in",
+        QString::number(DEFAULT_LOAD_TEST_API_PORT));
+    parser.addOption(apiPortOption);
+
+    const QCommandLineOption durationOption("duration", "seconds to run the load test for",
+        QString::number(DEFAULT_LOAD_TEST_DURATION_SECS));
+    parser.addOption(durationOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -103,6 +120,15 @@ ICEClientApp::ICEClientApp(int argc, char* argv[]) :
         qDebug() << "ICE-server address is" << _iceServerAddr;
     }
 
+    if (parser.isSet(loadTestOption)) {
+        quint16 apiPort = parser.isSet(apiPortOption) ? parser.value(apiPortOption).toUShort() : DEFAULT_LOAD_TEST_API_PORT;
+        int duration = parser.isSet(durationOption) ? parser.value(durationOption).toInt() : DEFAULT_LOAD_TEST_DURATION_SECS;
+
+        auto loadTest = new ICELoadTest(_iceServerAddr, parser.value(loadTestOption).toInt(), apiPort, duration, this);
+        connect(loadTest, &ICELoadTest::finished, this, &QCoreApplication::quit);
+        return;
+    }
+
     setState(lookUpStunServer);
 
     QTimer* doTimer = new QTimer(this);
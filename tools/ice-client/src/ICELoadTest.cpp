@@ -0,0 +1,83 @@
+//
+//  ICELoadTest.cpp
+//  tools/ice-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ICELoadTest.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QUuid>
+
+const int HEARTBEAT_INTERVAL_MSECS = 1000;
+
+ICELoadTest::ICELoadTest(const HifiSockAddr& iceServerAddr, int numDomains, quint16 apiPort, int durationSecs,
+        QObject* parent) :
+    QObject(parent),
+    _iceServerAddr(iceServerAddr),
+    _durationSecs(durationSecs),
+    _metaverseAPI(apiPort)
+{
+    _socket.bind(QHostAddress::AnyIPv4, 0);
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) { processPacket(std::move(packet)); });
+
+    // domains re-send the same heartbeat, so each one is only signed once
+    HifiSockAddr localSockAddr("127.0.0.1", _socket.localPort());
+    _heartbeatPackets.reserve(numDomains);
+    for (int i = 0; i < numDomains; ++i) {
+        auto packet = NLPacket::create(PacketType::ICEServerHeartbeat);
+
+        QDataStream heartbeatStream(packet.get());
+        heartbeatStream << QUuid::createUuid() << localSockAddr << localSockAddr;
+
+        auto plaintext = QByteArray::fromRawData(packet->getPayload(), packet->getPayloadSize());
+        heartbeatStream << _metaverseAPI.sign(plaintext);
+        _heartbeatPackets.push_back(std::move(packet));
+    }
+
+    qDebug() << "Heartbeating" << numDomains << "domains to" << _iceServerAddr << "for" << durationSecs << "seconds";
+    qDebug() << "Public key API stand-in is listening on port" << apiPort;
+
+    connect(&_heartbeatTimer, &QTimer::timeout, this, &ICELoadTest::sendHeartbeats);
+    _heartbeatTimer.start(HEARTBEAT_INTERVAL_MSECS);
+}
+
+void ICELoadTest::sendHeartbeats() {
+    if (_elapsedSecs > 0) {
+        qDebug() << "sent" << _numSent << "heartbeats, received" << _numACKs << "ACKs and" << _numDenials
+            << "denials, served" << _metaverseAPI.takeNumKeyRequests() << "public keys";
+    }
+
+    _totalSent += _numSent;
+    _totalACKs += _numACKs;
+    _totalDenials += _numDenials;
+    _numSent = _numACKs = _numDenials = 0;
+
+    if (_elapsedSecs++ >= _durationSecs) {
+        _heartbeatTimer.stop();
+
+        qDebug() << "total: sent" << _totalSent << "heartbeats, received" << _totalACKs << "ACKs and"
+            << _totalDenials << "denials," << (_totalSent - _totalACKs - _totalDenials) << "unanswered";
+        emit finished();
+        return;
+    }
+
+    for (auto& packet : _heartbeatPackets) {
+        _socket.writePacket(*packet, _iceServerAddr);
+        ++_numSent;
+    }
+}
+
+void ICELoadTest::processPacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    if (nlPacket->getType() == PacketType::ICEServerHeartbeatACK) {
+        ++_numACKs;
+    } else if (nlPacket->getType() == PacketType::ICEServerHeartbeatDenied) {
+        ++_numDenials;
+    }
+}
@@ -0,0 +1,60 @@
+//
+//  ICELoadTest.h
+//  tools/ice-client/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ICELoadTest_h
+#define hifi_ICELoadTest_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <NLPacket.h>
+#include <udt/Socket.h>
+
+#include "FakeMetaverseAPI.h"
+
+// Load test for an ice-server, heartbeating as many simulated domains.
+//   Domains sign their heartbeats with the keypair of a local stand-in for the metaverse API,
+//   the ice-server needs to be started with --metaverse-url pointing at it.
+//   Prints the heartbeats sent and the ACKs and denials received every second.
+class ICELoadTest : public QObject {
+    Q_OBJECT
+public:
+    ICELoadTest(const HifiSockAddr& iceServerAddr, int numDomains, quint16 apiPort, int durationSecs,
+        QObject* parent = nullptr);
+
+signals:
+    void finished();
+
+private:
+    void sendHeartbeats();
+    void processPacket(std::unique_ptr<udt::Packet> packet);
+
+    HifiSockAddr _iceServerAddr;
+    int _durationSecs;
+    int _elapsedSecs { 0 };
+
+    std::vector<std::unique_ptr<NLPacket>> _heartbeatPackets;
+
+    udt::Socket _socket;
+    FakeMetaverseAPI _metaverseAPI;
+    QTimer _heartbeatTimer;
+
+    int _numSent { 0 };
+    int _numACKs { 0 };
+    int _numDenials { 0 };
+    quint64 _totalSent { 0 };
+    quint64 _totalACKs { 0 };
+    quint64 _totalDenials { 0 };
+};
+
+#endif // hifi_ICELoadTest_h
@@ -0,0 +1,82 @@
+//
+//  FakeMetaverseAPI.cpp
+//  tools/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FakeMetaverseAPI.h"
+
+#include <openssl/bn.h>
+#include <openssl/x509.h>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QRegExp>
+
+#include <HTTPConnection.h>
+
+const int KEYPAIR_BITS = 2048;
+
+FakeMetaverseAPI::FakeMetaverseAPI(quint16 port, QObject* parent) :
+    QObject(parent),
+    _server(QHostAddress::LocalHost, port, QString(), this, this)
+{
+    _keyPair = RSA_new();
+    BIGNUM* exponent = BN_new();
+    BN_set_word(exponent, RSA_F4);
+    RSA_generate_key_ex(_keyPair, KEYPAIR_BITS, exponent, NULL);
+    BN_free(exponent);
+
+    QByteArray publicKey(i2d_RSA_PUBKEY(_keyPair, NULL), 0);
+    unsigned char* publicKeyData = reinterpret_cast<unsigned char*>(publicKey.data());
+    i2d_RSA_PUBKEY(_keyPair, &publicKeyData);
+    _publicKey = publicKey.toBase64();
+}
+
+FakeMetaverseAPI::~FakeMetaverseAPI() {
+    RSA_free(_keyPair);
+}
+
+bool FakeMetaverseAPI::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
+    // users are looked up by username, domains by ID
+    static const QString PUBLIC_KEY_PATH_REGEX_STRING = "^/api/v1/(users|domains)/[A-Za-z0-9_\\.-]+/public_key$";
+    QRegExp publicKeyPathRegex(PUBLIC_KEY_PATH_REGEX_STRING);
+
+    if (publicKeyPathRegex.indexIn(url.path()) == -1) {
+        connection->respond(HTTPConnection::StatusCode404);
+        return true;
+    }
+
+    QJsonObject dataObject;
+    dataObject["public_key"] = QString::fromUtf8(_publicKey);
+
+    QJsonObject responseObject;
+    responseObject["status"] = "success";
+    responseObject["data"] = dataObject;
+
+    connection->respond(HTTPConnection::StatusCode200, QJsonDocument(responseObject).toJson(), "application/json");
+    ++_numKeyRequests;
+    return true;
+}
+
+QByteArray FakeMetaverseAPI::sign(const QByteArray& plaintext) const {
+    auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
+
+    QByteArray signature(RSA_size(_keyPair), 0);
+    unsigned int signatureBytes = 0;
+    RSA_sign(NID_sha256,
+             reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()), hashedPlaintext.size(),
+             reinterpret_cast<unsigned char*>(signature.data()), &signatureBytes, _keyPair);
+    return signature;
+}
+
+int FakeMetaverseAPI::takeNumKeyRequests() {
+    int numKeyRequests = _numKeyRequests;
+    _numKeyRequests = 0;
+    return numKeyRequests;
+}
@@ -0,0 +1,43 @@
+//
+//  FakeMetaverseAPI.h
+//  tools/shared
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FakeMetaverseAPI_h
+#define hifi_FakeMetaverseAPI_h
+
+#include <QtCore/QObject>
+
+#include <openssl/rsa.h>
+
+#include <HTTPManager.h>
+
+// Local stand-in for the public key endpoints of the metaverse API, for the load test tools.
+//   A single keypair signs for every simulated user and domain, generating one each would take minutes,
+//   and its public key is handed out for any of them. Any other request is answered with a 404.
+class FakeMetaverseAPI : public QObject, public HTTPRequestHandler {
+    Q_OBJECT
+public:
+    FakeMetaverseAPI(quint16 port, QObject* parent = nullptr);
+    ~FakeMetaverseAPI();
+
+    bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
+
+    // RSA signature of the SHA-256 hash of plaintext, as interface and domain-servers sign
+    QByteArray sign(const QByteArray& plaintext) const;
+
+    int takeNumKeyRequests();
+
+private:
+    RSA* _keyPair { nullptr };
+    QByteArray _publicKey; // base 64 DER, as the API returns it
+    HTTPManager _server;
+    int _numKeyRequests { 0 };
+};
+
+#endif // hifi_FakeMetaverseAPI_h
@@ -0,0 +1,39 @@
+//
+//  main.cpp
+//  tools/trace-convert/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Converts binary traces, as written by the tracer for .hftrace paths, to the Chrome tracing JSON format.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <Trace.h>
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity Trace Converter");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "binary trace", "trace" + tracing::BINARY_TRACE_EXTENSION);
+    parser.addPositionalArgument("output", "JSON trace, gzipped if it ends in .gz", "trace.json[.gz]");
+    parser.process(app);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 2) {
+        parser.showHelp(1);
+    }
+
+    if (!tracing::convertTrace(arguments[0], arguments[1])) {
+        qCritical() << "Failed to convert" << arguments[0] << "to" << arguments[1];
+        return 2;
+    }
+    return 0;
+}